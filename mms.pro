@@ -1,3 +1,4 @@
 TEMPLATE = subdirs
 SUBDIRS += src/sim
+SUBDIRS += src/cli
 SUBDIRS += src/tests
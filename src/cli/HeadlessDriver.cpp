@@ -0,0 +1,309 @@
+#include "HeadlessDriver.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+
+#include "Assert.h"
+#include "FontImage.h"
+#include "HeadlessRunner.h"
+#include "Param.h"
+#include "Settings.h"
+#include "SettingsMouseAlgos.h"
+#include "SimUtilities.h"
+#include "Tournament.h"
+
+namespace mms {
+
+int HeadlessDriver::drive(int argc, char* argv[]) {
+
+    // Make sure that this function is called just once
+    ASSERT_RUNS_JUST_ONCE();
+
+    // Initialize Qt, without any of the GUI machinery
+    QCoreApplication app(argc, argv);
+
+    // The first argument determines the mode
+    if (app.arguments().value(1) == "tournament") {
+        return runTournament(&app);
+    }
+    return runSingle(&app);
+}
+
+int HeadlessDriver::runSingle(QCoreApplication* app) {
+
+    // Describe the command line interface
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Runs a mouse algorithm without a display, and writes the resulting"
+        " mouse stats as JSON. Run \"tournament --help\" to see how to run many"
+        " algorithms on many mazes at once.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("maze", "The maze file to load.");
+    parser.addPositionalArgument("mouse", "The mouse file to load.");
+    parser.addPositionalArgument("command", "The algorithm's run command.");
+    QCommandLineOption dirOption(
+        {"d", "directory"},
+        "The directory in which to execute the run command.",
+        "directory",
+        QDir::currentPath());
+    QCommandLineOption seedOption(
+        {"s", "seed"},
+        "The random seed passed to the algorithm.",
+        "seed");
+    QCommandLineOption outputOption(
+        {"o", "output"},
+        "The file to write the JSON results to (defaults to stdout).",
+        "file");
+    parser.addOption(dirOption);
+    parser.addOption(seedOption);
+    parser.addOptions(runOptions());
+    parser.addOption(outputOption);
+    parser.process(*app);
+
+    // Validate the arguments
+    QStringList args = parser.positionalArguments();
+    if (args.size() != 3) {
+        parser.showHelp(1);
+    }
+    if (parser.isSet(seedOption) && !SimUtilities::isInt(parser.value(seedOption))) {
+        qCritical().noquote().nospace()
+            << "\"" << parser.value(seedOption) << "\" is not a valid seed.";
+        return 1;
+    }
+    HeadlessRunConfig config;
+    if (!parseRunOptions(parser, &config)) {
+        return 1;
+    }
+
+    init();
+
+    // The algorithm is always passed a seed, just like in the GUI
+    config.mazeFilePath = args.at(0);
+    config.mouseFilePath = args.at(1);
+    config.runCommand = args.at(2);
+    config.dirPath = parser.value(dirOption);
+    config.seed = (
+        parser.isSet(seedOption)
+        ? SimUtilities::strToInt(parser.value(seedOption))
+        : SimUtilities::randomNonNegativeInt()
+    );
+
+    // Create the runner
+    HeadlessRunner runner(config);
+
+    // Write the results once the run is over
+    QObject::connect(&runner, &HeadlessRunner::finished, app, [&](){
+        QByteArray json = QJsonDocument(runner.getResults()).toJson();
+        app->exit(write(parser.value(outputOption), json) ? 0 : 1);
+    });
+
+    // Start the run
+    if (!runner.start()) {
+        qCritical().noquote() << runner.errorString();
+        return 1;
+    }
+
+    // Start the event loop
+    return app->exec();
+}
+
+int HeadlessDriver::runTournament(QCoreApplication* app) {
+
+    // Describe the command line interface
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Runs every combination of algorithm, maze, and seed, each in its own"
+        " simulation, and writes a CSV leaderboard of the algorithms. The"
+        " algorithms are the ones configured in the simulator, and must"
+        " already be built.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("tournament", "The mode.");
+    parser.addPositionalArgument(
+        "mazes",
+        "The maze files to load; directories are expanded to their files.",
+        "mazes...");
+    QCommandLineOption algoOption(
+        {"a", "algo"},
+        "The name of an algorithm to enter; may be specified more than once.",
+        "name");
+    QCommandLineOption seedsOption(
+        "seeds",
+        "A comma-separated list of the random seeds passed to the algorithms.",
+        "seeds",
+        "0");
+    QCommandLineOption jobsOption(
+        {"j", "jobs"},
+        "The number of simulations to run at once.",
+        "count",
+        QString::number(QThread::idealThreadCount()));
+    QCommandLineOption outputOption(
+        {"o", "output"},
+        "The file to write the leaderboard to (defaults to stdout).",
+        "file");
+    QCommandLineOption resultsOption(
+        {"r", "results"},
+        "The file to write the results of every run to.",
+        "file");
+    parser.addOption(algoOption);
+    parser.addOption(seedsOption);
+    parser.addOption(jobsOption);
+    parser.addOptions(runOptions());
+    parser.addOption(outputOption);
+    parser.addOption(resultsOption);
+    parser.process(*app);
+
+    // Validate the arguments
+    QStringList args = parser.positionalArguments();
+    args.removeFirst();
+    if (args.isEmpty() || !parser.isSet(algoOption)) {
+        parser.showHelp(1);
+    }
+    QVector<int> seeds;
+    for (const QString& seed : parser.value(seedsOption).split(",")) {
+        if (!SimUtilities::isInt(seed)) {
+            qCritical().noquote().nospace()
+                << "\"" << seed << "\" is not a valid seed.";
+            return 1;
+        }
+        seeds.append(SimUtilities::strToInt(seed));
+    }
+    QString jobs = parser.value(jobsOption);
+    if (!SimUtilities::isInt(jobs) || SimUtilities::strToInt(jobs) < 1) {
+        qCritical().noquote().nospace()
+            << "\"" << jobs << "\" is not a valid number of jobs.";
+        return 1;
+    }
+    HeadlessRunConfig baseConfig;
+    if (!parseRunOptions(parser, &baseConfig)) {
+        return 1;
+    }
+
+    init();
+
+    // Look up the algorithms
+    QVector<TournamentAlgo> algos;
+    for (const QString& name : parser.values(algoOption)) {
+        if (!SettingsMouseAlgos::names().contains(name)) {
+            qCritical().noquote().nospace()
+                << "\"" << name << "\" is not a configured algorithm.";
+            return 1;
+        }
+        algos.append({
+            name,
+            SettingsMouseAlgos::getDirPath(name),
+            SettingsMouseAlgos::getRunCommand(name),
+            SettingsMouseAlgos::getMouseFilePath(name),
+        });
+    }
+
+    // Expand the maze directories
+    QStringList mazeFilePaths;
+    for (const QString& path : args) {
+        QFileInfo info(path);
+        if (info.isDir()) {
+            QDir dir(path);
+            for (const QString& name : dir.entryList(QDir::Files, QDir::Name)) {
+                mazeFilePaths.append(dir.filePath(name));
+            }
+        }
+        else {
+            mazeFilePaths.append(path);
+        }
+    }
+
+    // Run the tournament, and write the results
+    Tournament tournament(algos, mazeFilePaths, seeds, baseConfig);
+    tournament.run(SimUtilities::strToInt(jobs));
+    if (parser.isSet(resultsOption) &&
+            !write(parser.value(resultsOption), tournament.getResultsCsv().toUtf8())) {
+        return 1;
+    }
+    return write(parser.value(outputOption), tournament.getLeaderboardCsv().toUtf8()) ? 0 : 1;
+}
+
+QList<QCommandLineOption> HeadlessDriver::runOptions() {
+    return {
+        QCommandLineOption(
+            "speed",
+            "The sim speed, as a multiple of real time.",
+            "factor",
+            "1.0"),
+        QCommandLineOption(
+            {"t", "time-limit"},
+            "The number of (real) seconds after which to stop the algorithm,"
+            " or zero for no limit.",
+            "seconds",
+            "0"),
+        QCommandLineOption(
+            {"l", "lock-step"},
+            "Advance sim time in fixed ticks, only while the algorithm is"
+            " blocked on a command, so that runs are reproducible (ignores"
+            " --speed)."),
+        QCommandLineOption(
+            {"i", "instant"},
+            "Perform DISCRETE movements instantly, rather than animating them"
+            " (requires --lock-step)."),
+    };
+}
+
+bool HeadlessDriver::parseRunOptions(
+        const QCommandLineParser& parser,
+        HeadlessRunConfig* config) {
+    for (const char* option : {"speed", "time-limit"}) {
+        QString value = parser.value(option);
+        if (!SimUtilities::isDouble(value)) {
+            qCritical().noquote().nospace()
+                << "\"" << value << "\" is not a valid value for the option \""
+                << option << "\".";
+            return false;
+        }
+    }
+    config->simSpeed = SimUtilities::strToDouble(parser.value("speed"));
+    config->timeLimit = SimUtilities::strToDouble(parser.value("time-limit"));
+    config->lockStep = parser.isSet("lock-step");
+    config->instantMovements = parser.isSet("instant");
+    if (config->instantMovements && !config->lockStep) {
+        qCritical().noquote()
+            << "The option \"instant\" requires the option \"lock-step\".";
+        return false;
+    }
+    return true;
+}
+
+void HeadlessDriver::init() {
+
+    // Note that we purposefully don't initialize the Logging object, since
+    // it writes to stdout; the default handler writes to stderr instead,
+    // which keeps stdout free for the results
+
+    // Initialize the Settings object
+    Settings::init();
+
+    P(); // Initialize the Param object
+
+    // Initialize the FontImage object
+    FontImage::init(P()->tileTextFontImage());
+}
+
+bool HeadlessDriver::write(const QString& path, const QByteArray& bytes) {
+    if (path.isEmpty()) {
+        QTextStream(stdout) << bytes;
+        return true;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCritical().noquote().nospace()
+            << "Could not open \"" << file.fileName() << "\" for writing.";
+        return false;
+    }
+    file.write(bytes);
+    return true;
+}
+
+} // namespace mms
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QList>
+
+#include "HeadlessRunConfig.h"
+
+namespace mms {
+
+class HeadlessDriver {
+
+public:
+    HeadlessDriver() = delete;
+    static int drive(int argc, char* argv[]);
+
+private:
+
+    // Runs a single algorithm on a single maze
+    static int runSingle(QCoreApplication* app);
+
+    // Runs a tournament of many algorithms on many mazes
+    static int runTournament(QCoreApplication* app);
+
+    // The options shared by both modes, i.e., those that configure each run
+    static QList<QCommandLineOption> runOptions();
+    static bool parseRunOptions(
+        const QCommandLineParser& parser,
+        HeadlessRunConfig* config);
+
+    // Initializes the simulator's process-wide objects
+    static void init();
+
+    // Writes the bytes to the given file, or to stdout if the path is empty
+    static bool write(const QString& path, const QByteArray& bytes);
+
+};
+
+} // namespace mms
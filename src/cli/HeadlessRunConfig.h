@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QString>
+
+namespace mms {
+
+// Everything needed to run a single mouse algorithm on a single maze
+struct HeadlessRunConfig {
+
+    QString mazeFilePath;
+    QString mouseFilePath;
+    QString runCommand;
+    QString dirPath;
+    int seed = 0;
+
+    double simSpeed = 1.0;
+    double timeLimit = 0.0; // Real seconds, or zero for no limit
+    bool lockStep = false;
+    bool instantMovements = false; // Requires lockStep
+
+    // Whether or not to forward the algorithm's stdout to the log
+    bool forwardAlgoOutput = true;
+};
+
+} // namespace mms
@@ -0,0 +1,282 @@
+#include "HeadlessRunner.h"
+
+#include <QJsonValue>
+
+#include "Assert.h"
+#include "ProcessUtilities.h"
+
+namespace mms {
+
+HeadlessRunner::HeadlessRunner(const HeadlessRunConfig& config) :
+        m_config(config),
+        m_maze(nullptr),
+        m_mouse(nullptr),
+        m_view(nullptr),
+        m_mouseInterface(nullptr),
+        m_mouseAlgoRunProcess(nullptr),
+        m_started(false),
+        m_stopped(false),
+        m_timedOut(false),
+        m_exitCode(-1),
+        m_elapsedSimTime(Seconds(0)),
+        m_crashed(false) {
+
+    // Stop the algorithm if it crashes, or if it runs for too long
+    connect(this, &HeadlessRunner::mouseCrashed, this, &HeadlessRunner::stop);
+    m_timeLimitTimer.setSingleShot(true);
+    connect(&m_timeLimitTimer, &QTimer::timeout, this, [=](){
+        m_timedOut = true;
+        stop();
+    });
+}
+
+HeadlessRunner::~HeadlessRunner() {
+    // Ensure that nothing is running before we delete the objects
+    if (m_started && !m_stopped) {
+        stop();
+    }
+    delete m_mouseAlgoRunProcess;
+    delete m_mouseInterface;
+    delete m_view;
+    delete m_mouse;
+    delete m_maze;
+}
+
+bool HeadlessRunner::start() {
+
+    // A runner can only be used once
+    ASSERT_FA(m_started);
+
+    // Instant movements add their own durations to the sim time, so the
+    // model mustn't also be advancing it on the wall clock
+    if (m_config.instantMovements && !m_config.lockStep) {
+        m_errorString = "Instant movements require lock-step mode.";
+        return false;
+    }
+
+    // Load the maze
+    m_maze = Maze::fromFile(m_config.mazeFilePath);
+    if (m_maze == nullptr) {
+        m_errorString = QString("Maze file \"%1\" could not be loaded.").arg(
+            m_config.mazeFilePath
+        );
+        return false;
+    }
+
+    // Generate the mouse, check mouse file success
+    m_mouse = new Mouse(m_maze);
+    if (!m_mouse->reload(m_config.mouseFilePath)) {
+        m_errorString = QString("Mouse file \"%1\" could not be loaded.").arg(
+            m_config.mouseFilePath
+        );
+        return false;
+    }
+
+    // Create the rest of the objects
+    m_view = new MazeView(
+        m_maze,
+        false, // wallTruthVisible
+        false, // tileColorsVisible
+        false, // tileFogVisible
+        false, // tileTextVisible
+        false // autopopulateTextWithDistance
+    );
+    m_mouseInterface = new MouseInterface(
+        m_maze,
+        m_mouse,
+        m_view,
+        &m_model
+    );
+    m_mouseInterface->setInstantMovementsEnabled(m_config.instantMovements);
+    m_mouseInterface->setRandomSeed(m_config.seed);
+
+    // Start the physics loop, with the mouse already in the maze
+    connect(
+        &m_modelThread, &QThread::started,
+        &m_model, &Model::simulate);
+    m_model.moveToThread(&m_modelThread);
+    m_model.setSimSpeed(m_config.simSpeed);
+    m_model.setMaze(m_maze);
+    m_model.setMouse(m_mouse);
+    m_model.getSimTime()->setLockStepEnabled(m_config.lockStep);
+    m_modelThread.start();
+
+    // Append the random seed to the command
+    QString command = m_config.runCommand;
+    command += " ";
+    command += QString::number(m_config.seed);
+
+    // Just like in the Window, the algorithm's QProcess object lives in a
+    // separate thread so that blocking mouse commands can be interrupted
+    connect(&m_mouseAlgoThread, &QThread::started, m_mouseInterface, [=](){
+
+        // Create the subprocess on which we'll execute the mouse algorithm
+        QProcess* newProcess = new QProcess();
+        m_mouseAlgoRunProcess = newProcess;
+
+        // The process belongs to this thread, so make sure it's dead, and
+        // delete it, from this thread too; the thread emits finished() once
+        // its event loop has stopped, and stop() waits for that to return
+        connect(&m_mouseAlgoThread, &QThread::finished, [=](){
+            newProcess->terminate();
+            newProcess->waitForFinished();
+            delete newProcess;
+            m_mouseAlgoRunProcess = nullptr;
+        });
+
+        // Forward the algorithm's output to stderr (our stdout is reserved
+        // for the results); see Window::mouseAlgoRunStart for why this
+        // requires two connect() calls
+        connect(
+            newProcess,
+            &QProcess::readyReadStandardOutput,
+            m_mouseInterface,
+            [=](){
+                QString output = newProcess->readAllStandardOutput();
+                m_mouseInterface->handleStandardOutput(output);
+            }
+        );
+        connect(
+            m_mouseInterface,
+            &MouseInterface::algoOutput,
+            this,
+            [=](QString output){
+                if (m_config.forwardAlgoOutput) {
+                    qInfo().noquote() << output;
+                }
+            }
+        );
+
+        // Process all stderr commands as appropriate
+        connect(
+            newProcess,
+            &QProcess::readyReadStandardError,
+            m_mouseInterface,
+            [=](){
+                QByteArray replies = m_mouseInterface->handleStandardError(
+                    newProcess->readAllStandardError());
+                if (!replies.isEmpty()) {
+                    newProcess->write(replies);
+                }
+                // Once the mouse has crashed it can't move anymore, and so
+                // there's no point in letting the algorithm continue (note
+                // that, since the algorithm waits for the reply to every
+                // movement, only non-blocking commands can follow the crash)
+                if (m_model.getState()->crashed()) {
+                    emit mouseCrashed();
+                }
+            }
+        );
+
+        // Record the exit code, and stop the run
+        connect(
+            newProcess,
+            static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(
+                &QProcess::finished
+            ),
+            this,
+            [=](int exitCode, QProcess::ExitStatus exitStatus){
+                if (m_stopped) {
+                    return;
+                }
+                m_exitCode = (exitStatus == QProcess::NormalExit ? exitCode : -1);
+                stop();
+            }
+        );
+
+        // If the process fails to start, stop the run
+        bool success = ProcessUtilities::start(command, m_config.dirPath, newProcess);
+        if (!success) {
+            connect(
+                m_mouseInterface,
+                &MouseInterface::mouseAlgoCannotStart,
+                this,
+                [=](QString errorString){
+                    m_errorString = errorString;
+                    stop();
+                }
+            );
+            m_mouseInterface->emitMouseAlgoCannotStart(
+                newProcess->errorString()
+            );
+        }
+    });
+
+    // Start the mouse interface thread
+    m_mouseInterface->moveToThread(&m_mouseAlgoThread);
+    m_mouseAlgoThread.start();
+
+    // Start enforcing the time limit, if there is one
+    if (0.0 < m_config.timeLimit) {
+        m_timeLimitTimer.start(static_cast<int>(m_config.timeLimit * 1000));
+    }
+
+    m_started = true;
+    return true;
+}
+
+QString HeadlessRunner::errorString() const {
+    return m_errorString;
+}
+
+QJsonObject HeadlessRunner::getResults() const {
+    QJsonObject results;
+    results.insert("mazeFile", m_config.mazeFilePath);
+    results.insert("mouseFile", m_config.mouseFilePath);
+    results.insert("runCommand", m_config.runCommand);
+    results.insert("seed", m_config.seed);
+    results.insert("simSpeed", m_config.simSpeed);
+    results.insert("lockStep", m_config.lockStep);
+    results.insert("instantMovements", m_config.instantMovements);
+    results.insert("error",
+        m_errorString.isEmpty()
+        ? QJsonValue()
+        : QJsonValue(m_errorString));
+    results.insert("exitCode", m_exitCode);
+    results.insert("timedOut", m_timedOut);
+    results.insert("crashed", m_crashed);
+    results.insert("tilesTraversed", m_stats.traversedTileLocations.size());
+    results.insert("totalTiles",
+        m_maze == nullptr
+        ? 0
+        : m_maze->getWidth() * m_maze->getHeight());
+    results.insert("closestDistanceToCenter", m_stats.closestDistanceToCenter);
+    results.insert("bestTimeToCenter",
+        m_stats.bestTimeToCenter < Seconds(0)
+        ? QJsonValue()
+        : QJsonValue(m_stats.bestTimeToCenter.getSeconds()));
+    results.insert("elapsedSimTime", m_elapsedSimTime.getSeconds());
+    return results;
+}
+
+void HeadlessRunner::stop() {
+
+    // The run may only be stopped once
+    if (m_stopped) {
+        return;
+    }
+    m_stopped = true;
+    m_timeLimitTimer.stop();
+
+    // Stop the algo thread, which also kills the algorithm process; the
+    // request to stop returns control to the event loop quickly, even if the
+    // interface is in the middle of a movement
+    m_mouseAlgoThread.quit();
+    m_mouseInterface->requestStop();
+    m_mouseAlgoThread.wait();
+
+    // Record the results before removing the mouse from the model
+    m_stats = m_model.getMouseStats();
+    m_elapsedSimTime = m_model.getSimTime()->elapsedSimTime();
+    m_crashed = m_model.getState()->crashed();
+
+    // Stop the physics loop
+    m_model.removeMouse();
+    m_modelThread.quit();
+    m_model.shutdown();
+    m_modelThread.wait();
+
+    emit finished();
+}
+
+} // namespace mms
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+
+#include "units/Seconds.h"
+
+#include "HeadlessRunConfig.h"
+#include "Maze.h"
+#include "MazeView.h"
+#include "Model.h"
+#include "Mouse.h"
+#include "MouseInterface.h"
+#include "MouseStats.h"
+
+namespace mms {
+
+// Runs a single mouse algorithm on a single maze, without creating a window or
+// ticking a render timer; it's the headless counterpart to the mouse algorithm
+// logic in Window (see Window::mouseAlgoRunStart). Each runner owns its own
+// Model, and thus its own sim time and state, so that many runners can be
+// used at once, each from its own thread (see Tournament).
+class HeadlessRunner : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    HeadlessRunner(const HeadlessRunConfig& config);
+    ~HeadlessRunner();
+
+    // Loads the maze and the mouse, and starts the algorithm; returns false
+    // if the run could not be started (see errorString() for details)
+    bool start();
+
+    // Returns a description of the most recent error
+    QString errorString() const;
+
+    // Returns the results of the run, suitable for serializing as JSON
+    QJsonObject getResults() const;
+
+signals:
+
+    // Emitted once the algorithm has exited, crashed, or timed out
+    void finished();
+
+    // Emitted (from the algo thread) when the mouse crashes
+    void mouseCrashed();
+
+private:
+
+    // The configuration of the run
+    HeadlessRunConfig m_config;
+
+    // The model object, and the thread on which it simulates
+    Model m_model;
+    QThread m_modelThread;
+
+    // The simulation objects; the view is never drawn, but the algorithm's
+    // tile color, text, wall, and fog commands still need somewhere to go
+    Maze* m_maze;
+    Mouse* m_mouse;
+    MazeView* m_view;
+    MouseInterface* m_mouseInterface;
+
+    // The event loop for the mouse algo process, so that blocking algo
+    // commands don't prevent us from enforcing the time limit
+    QThread m_mouseAlgoThread;
+    QProcess* m_mouseAlgoRunProcess;
+
+    // Stops the algorithm once the time limit has elapsed
+    QTimer m_timeLimitTimer;
+
+    // The state and results of the run
+    bool m_started;
+    bool m_stopped;
+    bool m_timedOut;
+    int m_exitCode;
+    QString m_errorString;
+    MouseStats m_stats;
+    Seconds m_elapsedSimTime;
+    bool m_crashed;
+
+    // Stops the algorithm and the model, records the results, and emits finished()
+    void stop();
+
+};
+
+} // namespace mms
@@ -0,0 +1,5 @@
+#include "HeadlessDriver.h"
+
+int main(int argc, char* argv[]) {
+    return mms::HeadlessDriver::drive(argc, argv);
+}
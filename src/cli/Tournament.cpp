@@ -0,0 +1,212 @@
+#include "Tournament.h"
+
+#include <QDebug>
+#include <QEventLoop>
+#include <QMap>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <algorithm>
+
+#include "HeadlessRunner.h"
+
+namespace mms {
+
+// A single simulation; since the runner relies on signals and slots, each
+// job spins its own event loop on whichever pool thread it's given
+class TournamentJob : public QRunnable {
+
+public:
+
+    TournamentJob(const HeadlessRunConfig& config, QJsonObject* results) :
+            m_config(config),
+            m_results(results) {
+    }
+
+    void run() override {
+        QEventLoop loop;
+        HeadlessRunner runner(m_config);
+        QObject::connect(
+            &runner, &HeadlessRunner::finished,
+            &loop, &QEventLoop::quit);
+        if (runner.start()) {
+            loop.exec();
+        }
+        else {
+            qWarning().noquote() << runner.errorString();
+        }
+        *m_results = runner.getResults();
+    }
+
+private:
+
+    HeadlessRunConfig m_config;
+
+    // Each job writes to its own slot, so no synchronization is needed
+    QJsonObject* m_results;
+
+};
+
+Tournament::Tournament(
+        const QVector<TournamentAlgo>& algos,
+        const QStringList& mazeFilePaths,
+        const QVector<int>& seeds,
+        const HeadlessRunConfig& baseConfig) {
+    for (const TournamentAlgo& algo : algos) {
+        for (const QString& mazeFilePath : mazeFilePaths) {
+            for (int seed : seeds) {
+                HeadlessRunConfig config = baseConfig;
+                config.mazeFilePath = mazeFilePath;
+                config.mouseFilePath = algo.mouseFilePath;
+                config.runCommand = algo.runCommand;
+                config.dirPath = algo.dirPath;
+                config.seed = seed;
+                // Interleaved output from many algorithms isn't useful
+                config.forwardAlgoOutput = false;
+                m_jobAlgoNames.append(algo.name);
+                m_jobs.append(config);
+            }
+        }
+    }
+    m_results.resize(m_jobs.size());
+}
+
+void Tournament::run(int numThreads) {
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+    for (int i = 0; i < m_jobs.size(); i += 1) {
+        pool.start(new TournamentJob(m_jobs.at(i), &m_results[i]));
+    }
+    pool.waitForDone();
+}
+
+QString Tournament::getResultsCsv() const {
+    QString csv = toCsvRow({
+        "algorithm",
+        "maze",
+        "seed",
+        "exitCode",
+        "timedOut",
+        "crashed",
+        "tilesTraversed",
+        "totalTiles",
+        "closestDistanceToCenter",
+        "bestTimeToCenter",
+        "elapsedSimTime",
+        "error",
+    });
+    for (int i = 0; i < m_jobs.size(); i += 1) {
+        const QJsonObject& result = m_results.at(i);
+        csv += toCsvRow({
+            m_jobAlgoNames.at(i),
+            m_jobs.at(i).mazeFilePath,
+            QString::number(m_jobs.at(i).seed),
+            QString::number(result.value("exitCode").toInt()),
+            result.value("timedOut").toBool() ? "TRUE" : "FALSE",
+            result.value("crashed").toBool() ? "TRUE" : "FALSE",
+            QString::number(result.value("tilesTraversed").toInt()),
+            QString::number(result.value("totalTiles").toInt()),
+            QString::number(result.value("closestDistanceToCenter").toInt()),
+            (
+                result.value("bestTimeToCenter").isNull()
+                ? "NONE"
+                : QString::number(result.value("bestTimeToCenter").toDouble())
+            ),
+            QString::number(result.value("elapsedSimTime").toDouble()),
+            result.value("error").toString(),
+        });
+    }
+    return csv;
+}
+
+QString Tournament::getLeaderboardCsv() const {
+
+    struct Entry {
+        QString name;
+        int runs = 0;
+        int solved = 0;
+        int crashes = 0;
+        int timeouts = 0;
+        double totalBestTimeToCenter = 0.0;
+    };
+
+    // Aggregate the results of each algorithm's jobs
+    QVector<Entry> entries;
+    QMap<QString, int> indices;
+    for (int i = 0; i < m_jobs.size(); i += 1) {
+        const QString& name = m_jobAlgoNames.at(i);
+        if (!indices.contains(name)) {
+            indices.insert(name, entries.size());
+            entries.append(Entry());
+            entries.last().name = name;
+        }
+        Entry& entry = entries[indices.value(name)];
+        const QJsonObject& result = m_results.at(i);
+        entry.runs += 1;
+        if (!result.value("bestTimeToCenter").isNull()) {
+            entry.solved += 1;
+            entry.totalBestTimeToCenter +=
+                result.value("bestTimeToCenter").toDouble();
+        }
+        if (result.value("crashed").toBool()) {
+            entry.crashes += 1;
+        }
+        if (result.value("timedOut").toBool()) {
+            entry.timeouts += 1;
+        }
+    }
+
+    // Rank by number of solves, then by average time to center
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b){
+            if (a.solved != b.solved) {
+                return a.solved > b.solved;
+            }
+            return (
+                a.totalBestTimeToCenter * b.solved <
+                b.totalBestTimeToCenter * a.solved
+            );
+        }
+    );
+
+    QString csv = toCsvRow({
+        "rank",
+        "algorithm",
+        "runs",
+        "solved",
+        "crashes",
+        "timeouts",
+        "meanBestTimeToCenter",
+    });
+    for (int i = 0; i < entries.size(); i += 1) {
+        const Entry& entry = entries.at(i);
+        csv += toCsvRow({
+            QString::number(i + 1),
+            entry.name,
+            QString::number(entry.runs),
+            QString::number(entry.solved),
+            QString::number(entry.crashes),
+            QString::number(entry.timeouts),
+            (
+                entry.solved == 0
+                ? "NONE"
+                : QString::number(entry.totalBestTimeToCenter / entry.solved)
+            ),
+        });
+    }
+    return csv;
+}
+
+QString Tournament::toCsvRow(const QStringList& fields) {
+    QStringList quoted;
+    for (QString field : fields) {
+        if (field.contains(',') || field.contains('"') || field.contains('\n')) {
+            field.replace("\"", "\"\"");
+            field = "\"" + field + "\"";
+        }
+        quoted.append(field);
+    }
+    return quoted.join(",") + "\n";
+}
+
+} // namespace mms
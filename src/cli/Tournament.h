@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "HeadlessRunConfig.h"
+
+namespace mms {
+
+// A single entrant in a tournament
+struct TournamentAlgo {
+    QString name;
+    QString dirPath;
+    QString runCommand;
+    QString mouseFilePath;
+};
+
+// Runs every (algorithm, maze, seed) combination, each in its own independent
+// simulation, on a pool of threads, and then ranks the algorithms
+class Tournament {
+
+public:
+
+    // The base config determines the sim speed, time limit, etc., of every job
+    Tournament(
+        const QVector<TournamentAlgo>& algos,
+        const QStringList& mazeFilePaths,
+        const QVector<int>& seeds,
+        const HeadlessRunConfig& baseConfig);
+
+    // Runs all of the jobs, using at most numThreads at once; blocks until
+    // every job has finished
+    void run(int numThreads);
+
+    // Returns one row for each job
+    QString getResultsCsv() const;
+
+    // Returns one row for each algorithm, best first
+    QString getLeaderboardCsv() const;
+
+private:
+
+    QVector<QString> m_jobAlgoNames;
+    QVector<HeadlessRunConfig> m_jobs;
+    QVector<QJsonObject> m_results;
+
+    // Joins the fields into a single CSV row, quoting where necessary
+    static QString toCsvRow(const QStringList& fields);
+
+};
+
+} // namespace mms
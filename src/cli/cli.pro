@@ -0,0 +1,21 @@
+QT += core
+QT += xml
+QT -= gui
+
+TEMPLATE = app
+
+CONFIG += console
+CONFIG += debug
+CONFIG += object_parallel_to_source
+CONFIG += qt
+CONFIG -= app_bundle
+
+include(../sim/core.pri)
+
+SOURCES += $$files(*.cpp, true)
+HEADERS += $$files(*.h, true)
+
+DESTDIR     = ../../bin
+MOC_DIR     = ../../build/moc/cli
+OBJECTS_DIR = ../../build/obj/cli
+RCC_DIR     = ../../build/rcc/cli
@@ -1,336 +1,315 @@
 #include "Interface.h"
 
-#include "Printer.h"
-#include "Reader.h"
-
 void Interface::useContinuousInterface() {
-    PRINT("useContinuousInterface");
-    READ();
+    m_protocol.call(Commands::USE_CONTINUOUS_INTERFACE);
 }
 
 void Interface::setInitialDirection(char initialDirection) {
-    PRINT("setInitialDirection", initialDirection);
-    READ();
+    m_protocol.call(Commands::SET_INITIAL_DIRECTION, initialDirection);
 }
 
 void Interface::setTileTextRowsAndCols(int numRows, int numCols) {
-    PRINT("setTileTextRowsAndCols", numRows, numCols);
-    READ();
+    m_protocol.call(Commands::SET_TILE_TEXT_ROWS_AND_COLS, numRows, numCols);
 }
 
 void Interface::setWheelSpeedFraction(double wheelSpeedFraction) {
-    PRINT("setWheelSpeedFraction", wheelSpeedFraction);
-    READ();
+    m_protocol.call(Commands::SET_WHEEL_SPEED_FRACTION, wheelSpeedFraction);
 }
 
 void Interface::updateAllowOmniscience(bool allowOmniscience) {
-    PRINT("updateAllowOmniscience", boolToString(allowOmniscience));
-    READ();
+    m_protocol.call(Commands::UPDATE_ALLOW_OMNISCIENCE, allowOmniscience);
 }
 
 void Interface::updateAutomaticallyClearFog(bool automaticallyClearFog) {
-    PRINT("updateAutomaticallyClearFog", boolToString(automaticallyClearFog));
-    READ();
+    m_protocol.call(
+        Commands::UPDATE_AUTOMATICALLY_CLEAR_FOG,
+        automaticallyClearFog);
 }
 
 void Interface::updateDeclareBothWallHalves(bool declareBothWallHalves) {
-    PRINT("updateDeclareBothWallHalves", boolToString(declareBothWallHalves));
-    READ();
+    m_protocol.call(
+        Commands::UPDATE_DECLARE_BOTH_WALL_HALVES,
+        declareBothWallHalves);
 }
 
 void Interface::updateSetTileTextWhenDistanceDeclared(
         bool setTileTextWhenDistanceDeclared) {
-    PRINT("updateSetTileTextWhenDistanceDeclared",
-        boolToString(setTileTextWhenDistanceDeclared));
-    READ();
+    m_protocol.call(
+        Commands::UPDATE_SET_TILE_TEXT_WHEN_DISTANCE_DECLARED,
+        setTileTextWhenDistanceDeclared);
 }
 
 void Interface::updateSetTileBaseColorWhenDistanceDeclaredCorrectly(
         bool setTileBaseColorWhenDistanceDeclaredCorrectly) {
-    PRINT("updateSetTileBaseColorWhenDistanceDeclaredCorrectly",
-        boolToString(setTileBaseColorWhenDistanceDeclaredCorrectly));
-    READ();
+    m_protocol.call(
+        Commands::UPDATE_SET_TILE_BASE_COLOR_WHEN_DISTANCE_DECLARED_CORRECTLY,
+        setTileBaseColorWhenDistanceDeclaredCorrectly);
 }
 
 void Interface::updateDeclareWallOnRead(bool declareWallOnRead) {
-    PRINT("updateDeclareWallOnRead", boolToString(declareWallOnRead));
-    READ();
+    m_protocol.call(Commands::UPDATE_DECLARE_WALL_ON_READ, declareWallOnRead);
 }
 
 void Interface::updateUseTileEdgeMovements(bool useTileEdgeMovements) {
-    PRINT("updateUseTileEdgeMovements", boolToString(useTileEdgeMovements));
-    READ();
+    m_protocol.call(
+        Commands::UPDATE_USE_TILE_EDGE_MOVEMENTS,
+        useTileEdgeMovements);
 }
 
 int Interface::mazeWidth() {
-    PRINT("mazeWidth");
-    READ_AND_RETURN_INT();
+    return m_protocol.query<int>(Commands::MAZE_WIDTH);
 }
 
 int Interface::mazeHeight() {
-    PRINT("mazeHeight");
-    READ_AND_RETURN_INT();
+    return m_protocol.query<int>(Commands::MAZE_HEIGHT);
 }
 
 bool Interface::isOfficialMaze() {
-    PRINT("isOfficialMaze");
-    READ_AND_RETURN_BOOL();
+    return m_protocol.query<bool>(Commands::IS_OFFICIAL_MAZE);
 }
 
 char Interface::initialDirection() {
-    PRINT("initialDirection");
-    READ_AND_RETURN_CHAR();
+    return m_protocol.query<char>(Commands::INITIAL_DIRECTION);
 }
 
 double Interface::getRandomFloat() {
-    PRINT("getRandomFloat");
-    READ_AND_RETURN_DOUBLE();
+    return m_protocol.query<double>(Commands::GET_RANDOM_FLOAT);
 }
 
 int Interface::millis() {
-    PRINT("millis");
-    READ_AND_RETURN_INT();
+    return m_protocol.query<int>(Commands::MILLIS);
 }
 
 void Interface::delay(int milliseconds) {
-    PRINT("delay", milliseconds);
-    READ();
+    m_protocol.call(Commands::DELAY, milliseconds);
 }
 
 void Interface::setTileColor(int x, int y, char color) {
-    PRINT("setTileColor", x, y, color);
+    m_protocol.send(Commands::SET_TILE_COLOR, x, y, color);
 }
 
 void Interface::clearTileColor(int x, int y) {
-    PRINT("clearTileColor", x, y);
+    m_protocol.send(Commands::CLEAR_TILE_COLOR, x, y);
 }
 
 void Interface::clearAllTileColor() {
-    PRINT("clearAllTileColor");
+    m_protocol.send(Commands::CLEAR_ALL_TILE_COLOR);
 }
 
 void Interface::setTileText(int x, int y, const std::string& text) {
-    PRINT("setTileText", x, y, text);
+    m_protocol.send(Commands::SET_TILE_TEXT, x, y, text);
 }
 
 void Interface::clearTileText(int x, int y) {
-    PRINT("clearTileText", x, y);
+    m_protocol.send(Commands::CLEAR_TILE_TEXT, x, y);
 }
 
 void Interface::clearAllTileText() {
-    PRINT("clearAllTileText");
+    m_protocol.send(Commands::CLEAR_ALL_TILE_TEXT);
 }
 
 void Interface::declareWall(int x, int y, char direction, bool wallExists) {
-    PRINT("declareWall", x, y, direction, boolToString(wallExists));
+    m_protocol.send(Commands::DECLARE_WALL, x, y, direction, wallExists);
 }
 
 void Interface::undeclareWall(int x, int y, char direction) {
-    PRINT("undeclareWall", x, y, direction);
+    m_protocol.send(Commands::UNDECLARE_WALL, x, y, direction);
 }
 
 void Interface::setTileFogginess(int x, int y, bool foggy) {
-    PRINT("setTileFogginess", x, y, boolToString(foggy));
+    m_protocol.send(Commands::SET_TILE_FOGGINESS, x, y, foggy);
 }
 
 void Interface::declareTileDistance(int x, int y, int distance) {
-    PRINT("declareTileDistance", x, y, distance);
+    m_protocol.send(Commands::DECLARE_TILE_DISTANCE, x, y, distance);
 }
 
 void Interface::undeclareTileDistance(int x, int y) {
-    PRINT("undeclareTileDistance", x, y);
+    m_protocol.send(Commands::UNDECLARE_TILE_DISTANCE, x, y);
+}
+
+void Interface::setTileColors(const std::vector<TileColor>& colors) {
+    m_protocol.send(Commands::SET_TILE_COLORS, colors);
+}
+
+void Interface::fillTileColor(int x, int y, int width, int height, char color) {
+    m_protocol.send(Commands::FILL_TILE_COLOR, x, y, width, height, color);
+}
+
+void Interface::setTileTexts(const std::vector<TileText>& texts) {
+    m_protocol.send(Commands::SET_TILE_TEXTS, texts);
+}
+
+void Interface::fillTileText(
+        int x, int y, int width, int height, const std::string& text) {
+    m_protocol.send(Commands::FILL_TILE_TEXT, x, y, width, height, text);
+}
+
+void Interface::setTileFogginesses(const std::vector<TileFogginess>& fogginesses) {
+    m_protocol.send(Commands::SET_TILE_FOGGINESSES, fogginesses);
+}
+
+void Interface::fillTileFogginess(int x, int y, int width, int height, bool foggy) {
+    m_protocol.send(Commands::FILL_TILE_FOGGINESS, x, y, width, height, foggy);
+}
+
+void Interface::declareWalls(const std::vector<WallDeclaration>& walls) {
+    m_protocol.send(Commands::DECLARE_WALLS, walls);
+}
+
+void Interface::declareTileDistances(const std::vector<int>& distances) {
+    m_protocol.send(Commands::DECLARE_TILE_DISTANCES, distances);
 }
 
 void Interface::resetPosition() {
-    PRINT("resetPosition");
-    READ();
+    m_protocol.call(Commands::RESET_POSITION);
 }
 
 bool Interface::inputButtonPressed(int inputButton) {
-    PRINT("inputButtonPressed", inputButton);
-    READ_AND_RETURN_BOOL();
+    return m_protocol.query<bool>(Commands::INPUT_BUTTON_PRESSED, inputButton);
 }
 
 void Interface::acknowledgeInputButtonPressed(int inputButton) {
-    PRINT("acknowledgeInputButtonPressed", inputButton);
-    READ();
+    m_protocol.call(Commands::ACKNOWLEDGE_INPUT_BUTTON_PRESSED, inputButton);
 }
 
 double Interface::getWheelMaxSpeed(const std::string& name) {
-    PRINT("getWheelMaxSpeed", name);
-    READ_AND_RETURN_DOUBLE();
+    return m_protocol.query<double>(Commands::GET_WHEEL_MAX_SPEED, name);
 }
 
 void Interface::setWheelSpeed(const std::string& name, double rpm) {
-    PRINT("setWheelSpeed", name, rpm);
-    READ();
+    m_protocol.call(Commands::SET_WHEEL_SPEED, name, rpm);
 }
 
 double Interface::getWheelEncoderTicksPerRevolution(const std::string& name) {
-    PRINT("getWheelEncoderTicksPerRevolution", name);
-    READ_AND_RETURN_DOUBLE();
+    return m_protocol.query<double>(
+        Commands::GET_WHEEL_ENCODER_TICKS_PER_REVOLUTION, name);
 }
 
 int Interface::readWheelEncoder(const std::string& name) {
-    PRINT("readWheelEncoder", name);
-    READ_AND_RETURN_INT();
+    return m_protocol.query<int>(Commands::READ_WHEEL_ENCODER, name);
 }
 
 void Interface::resetWheelEncoder(const std::string& name) {
-    PRINT("resetWheelEncoder", name);
-    READ();
+    m_protocol.call(Commands::RESET_WHEEL_ENCODER, name);
 }
 
 double Interface::readSensor(const std::string& name) {
-    PRINT("readSensor", name);
-    READ_AND_RETURN_DOUBLE();
+    return m_protocol.query<double>(Commands::READ_SENSOR, name);
 }
 
 double Interface::readGyro() {
-    PRINT("readGyro");
-    READ_AND_RETURN_DOUBLE();
+    return m_protocol.query<double>(Commands::READ_GYRO);
 }
 
 bool Interface::wallFront() {
-    PRINT("wallFront");
-    READ_AND_RETURN_BOOL();
+    return m_protocol.query<bool>(Commands::WALL_FRONT);
 }
 
 bool Interface::wallRight() {
-    PRINT("wallRight");
-    READ_AND_RETURN_BOOL();
+    return m_protocol.query<bool>(Commands::WALL_RIGHT);
 }
 
 bool Interface::wallLeft() {
-    PRINT("wallLeft");
-    READ_AND_RETURN_BOOL();
+    return m_protocol.query<bool>(Commands::WALL_LEFT);
 }
 
 void Interface::moveForward() {
-    PRINT("moveForward");
-    READ();
+    m_protocol.call(Commands::MOVE_FORWARD);
 }
 
 void Interface::moveForward(int count) {
-    PRINT("moveForward", count);
-    READ();
+    m_protocol.call(Commands::MOVE_FORWARD, count);
 }
 
 void Interface::turnLeft() {
-    PRINT("turnLeft");
-    READ();
+    m_protocol.call(Commands::TURN_LEFT);
 }
 
 void Interface::turnRight() {
-    PRINT("turnRight");
-    READ();
+    m_protocol.call(Commands::TURN_RIGHT);
 }
 
 void Interface::turnAroundLeft() {
-    PRINT("turnAroundLeft");
-    READ();
+    m_protocol.call(Commands::TURN_AROUND_LEFT);
 }
 
 void Interface::turnAroundRight() {
-    PRINT("turnAroundRight");
-    READ();
+    m_protocol.call(Commands::TURN_AROUND_RIGHT);
 }
 
 void Interface::originMoveForwardToEdge() {
-    PRINT("originMoveForwardToEdge");
-    READ();
+    m_protocol.call(Commands::ORIGIN_MOVE_FORWARD_TO_EDGE);
 }
 
 void Interface::originTurnLeftInPlace() {
-    PRINT("originTurnLeftInPlace");
-    READ();
+    m_protocol.call(Commands::ORIGIN_TURN_LEFT_IN_PLACE);
 }
 
 void Interface::originTurnRightInPlace() {
-    PRINT("originTurnRightInPlace");
-    READ();
+    m_protocol.call(Commands::ORIGIN_TURN_RIGHT_IN_PLACE);
 }
 
 void Interface::moveForwardToEdge() {
-    PRINT("moveForwardToEdge");
-    READ();
+    m_protocol.call(Commands::MOVE_FORWARD_TO_EDGE);
 }
 
 void Interface::moveForwardToEdge(int count) {
-    PRINT("moveForwardToEdge", count);
-    READ();
+    m_protocol.call(Commands::MOVE_FORWARD_TO_EDGE, count);
 }
 
 void Interface::turnLeftToEdge() {
-    PRINT("turnLeftToEdge");
-    READ();
+    m_protocol.call(Commands::TURN_LEFT_TO_EDGE);
 }
 
 void Interface::turnRightToEdge() {
-    PRINT("turnRightToEdge");
-    READ();
+    m_protocol.call(Commands::TURN_RIGHT_TO_EDGE);
 }
 
 void Interface::turnAroundLeftToEdge() {
-    PRINT("turnAroundLeftToEdge");
-    READ();
+    m_protocol.call(Commands::TURN_AROUND_LEFT_TO_EDGE);
 }
 
 void Interface::turnAroundRightToEdge() {
-    PRINT("turnAroundRightToEdge");
-    READ();
+    m_protocol.call(Commands::TURN_AROUND_RIGHT_TO_EDGE);
 }
 
 void Interface::diagonalLeftLeft(int count) {
-    PRINT("diagonalLeftLeft", count);
-    READ();
+    m_protocol.call(Commands::DIAGONAL_LEFT_LEFT, count);
 }
 
 void Interface::diagonalLeftRight(int count) {
-    PRINT("diagonalLeftRight", count);
-    READ();
+    m_protocol.call(Commands::DIAGONAL_LEFT_RIGHT, count);
 }
 
 void Interface::diagonalRightLeft(int count) {
-    PRINT("diagonalRightLeft", count);
-    READ();
+    m_protocol.call(Commands::DIAGONAL_RIGHT_LEFT, count);
 }
 
 void Interface::diagonalRightRight(int count) {
-    PRINT("diagonalRightRight", count);
-    READ();
+    m_protocol.call(Commands::DIAGONAL_RIGHT_RIGHT, count);
 }
 
 int Interface::currentXTile() {
-    PRINT("currentXTile");
-    READ_AND_RETURN_INT();
+    return m_protocol.query<int>(Commands::CURRENT_X_TILE);
 }
 
 int Interface::currentYTile() {
-    PRINT("currentYTile");
-    READ_AND_RETURN_INT();
+    return m_protocol.query<int>(Commands::CURRENT_Y_TILE);
 }
 
 char Interface::currentDirection() {
-    PRINT("currentDirection");
-    READ_AND_RETURN_CHAR();
+    return m_protocol.query<char>(Commands::CURRENT_DIRECTION);
 }
 
 double Interface::currentXPosMeters() {
-    PRINT("currentXPosMeters");
-    READ_AND_RETURN_DOUBLE();
+    return m_protocol.query<double>(Commands::CURRENT_X_POS_METERS);
 }
 
 double Interface::currentYPosMeters() {
-    PRINT("currentYPosMeters");
-    READ_AND_RETURN_DOUBLE();
+    return m_protocol.query<double>(Commands::CURRENT_Y_POS_METERS);
 }
 
 double Interface::currentRotationDegrees() {
-    PRINT("currentRotationDegrees");
-    READ_AND_RETURN_DOUBLE();
-}
-
-std::string Interface::boolToString(bool value) {
-    return value ? "true" : "false";
+    return m_protocol.query<double>(Commands::CURRENT_ROTATION_DEGREES);
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+#include "Protocol.h"
 
 class Interface {
 
@@ -66,6 +69,21 @@ public:
     void declareTileDistance(int x, int y, int distance);
     void undeclareTileDistance(int x, int y);
 
+    // Bulk tile appearance functions, which are much faster than calling the
+    // above for every tile. The fill functions apply to the width x height
+    // rectangle of tiles whose lower left tile is (x, y).
+    void setTileColors(const std::vector<TileColor>& colors);
+    void fillTileColor(int x, int y, int width, int height, char color);
+    void setTileTexts(const std::vector<TileText>& texts);
+    void fillTileText(int x, int y, int width, int height, const std::string& text);
+    void setTileFogginesses(const std::vector<TileFogginess>& fogginesses);
+    void fillTileFogginess(int x, int y, int width, int height, bool foggy);
+    void declareWalls(const std::vector<WallDeclaration>& walls);
+
+    // Declares the distance of every tile, column by column, i.e., the
+    // distance of tile (x, y) is distances[x * mazeHeight() + y]
+    void declareTileDistances(const std::vector<int>& distances);
+
     // ----- Continuous interface methods ----- //
 
     // Get the magnitude of the max speed of any one wheel in rpm
@@ -137,6 +155,7 @@ public:
     double currentRotationDegrees();
 
 private:
-    std::string boolToString(bool value);
+
+    Protocol m_protocol;
 
 };
@@ -0,0 +1,437 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "SharedMemory.h"
+
+// A command's opcode in the binary protocol, and its name in the text
+// protocol. The opcodes must match those in the simulator (src/sim/Opcode.h).
+struct Command {
+    std::uint8_t opcode;
+    const char* name;
+};
+
+namespace Commands {
+
+const Command USE_CONTINUOUS_INTERFACE = {1, "useContinuousInterface"};
+const Command SET_INITIAL_DIRECTION = {2, "setInitialDirection"};
+const Command SET_TILE_TEXT_ROWS_AND_COLS = {3, "setTileTextRowsAndCols"};
+const Command SET_WHEEL_SPEED_FRACTION = {4, "setWheelSpeedFraction"};
+const Command USE_BINARY_PROTOCOL = {5, "useBinaryProtocol"};
+const Command USE_SHARED_MEMORY_TRANSPORT = {6, "useSharedMemoryTransport"};
+
+const Command UPDATE_ALLOW_OMNISCIENCE = {10, "updateAllowOmniscience"};
+const Command UPDATE_AUTOMATICALLY_CLEAR_FOG = {11, "updateAutomaticallyClearFog"};
+const Command UPDATE_DECLARE_BOTH_WALL_HALVES = {12, "updateDeclareBothWallHalves"};
+const Command UPDATE_SET_TILE_TEXT_WHEN_DISTANCE_DECLARED =
+    {13, "updateSetTileTextWhenDistanceDeclared"};
+const Command UPDATE_SET_TILE_BASE_COLOR_WHEN_DISTANCE_DECLARED_CORRECTLY =
+    {14, "updateSetTileBaseColorWhenDistanceDeclaredCorrectly"};
+const Command UPDATE_DECLARE_WALL_ON_READ = {15, "updateDeclareWallOnRead"};
+const Command UPDATE_USE_TILE_EDGE_MOVEMENTS = {16, "updateUseTileEdgeMovements"};
+
+const Command MAZE_WIDTH = {20, "mazeWidth"};
+const Command MAZE_HEIGHT = {21, "mazeHeight"};
+const Command IS_OFFICIAL_MAZE = {22, "isOfficialMaze"};
+const Command INITIAL_DIRECTION = {23, "initialDirection"};
+const Command GET_RANDOM_FLOAT = {24, "getRandomFloat"};
+const Command MILLIS = {25, "millis"};
+const Command DELAY = {26, "delay"};
+const Command RESET_POSITION = {27, "resetPosition"};
+const Command INPUT_BUTTON_PRESSED = {28, "inputButtonPressed"};
+const Command ACKNOWLEDGE_INPUT_BUTTON_PRESSED = {29, "acknowledgeInputButtonPressed"};
+
+const Command SET_TILE_COLOR = {30, "setTileColor"};
+const Command CLEAR_TILE_COLOR = {31, "clearTileColor"};
+const Command CLEAR_ALL_TILE_COLOR = {32, "clearAllTileColor"};
+const Command SET_TILE_TEXT = {33, "setTileText"};
+const Command CLEAR_TILE_TEXT = {34, "clearTileText"};
+const Command CLEAR_ALL_TILE_TEXT = {35, "clearAllTileText"};
+const Command DECLARE_WALL = {36, "declareWall"};
+const Command UNDECLARE_WALL = {37, "undeclareWall"};
+const Command SET_TILE_FOGGINESS = {38, "setTileFogginess"};
+const Command DECLARE_TILE_DISTANCE = {39, "declareTileDistance"};
+const Command UNDECLARE_TILE_DISTANCE = {40, "undeclareTileDistance"};
+
+const Command SET_TILE_COLORS = {41, "setTileColors"};
+const Command FILL_TILE_COLOR = {42, "fillTileColor"};
+const Command SET_TILE_TEXTS = {43, "setTileTexts"};
+const Command FILL_TILE_TEXT = {44, "fillTileText"};
+const Command SET_TILE_FOGGINESSES = {45, "setTileFogginesses"};
+const Command FILL_TILE_FOGGINESS = {46, "fillTileFogginess"};
+const Command DECLARE_WALLS = {47, "declareWalls"};
+const Command DECLARE_TILE_DISTANCES = {48, "declareTileDistances"};
+
+const Command GET_WHEEL_MAX_SPEED = {50, "getWheelMaxSpeed"};
+const Command SET_WHEEL_SPEED = {51, "setWheelSpeed"};
+const Command GET_WHEEL_ENCODER_TICKS_PER_REVOLUTION =
+    {52, "getWheelEncoderTicksPerRevolution"};
+const Command READ_WHEEL_ENCODER = {53, "readWheelEncoder"};
+const Command RESET_WHEEL_ENCODER = {54, "resetWheelEncoder"};
+const Command READ_SENSOR = {55, "readSensor"};
+const Command READ_GYRO = {56, "readGyro"};
+
+const Command WALL_FRONT = {60, "wallFront"};
+const Command WALL_RIGHT = {61, "wallRight"};
+const Command WALL_LEFT = {62, "wallLeft"};
+const Command MOVE_FORWARD = {63, "moveForward"};
+const Command TURN_LEFT = {64, "turnLeft"};
+const Command TURN_RIGHT = {65, "turnRight"};
+const Command TURN_AROUND_LEFT = {66, "turnAroundLeft"};
+const Command TURN_AROUND_RIGHT = {67, "turnAroundRight"};
+
+const Command ORIGIN_MOVE_FORWARD_TO_EDGE = {70, "originMoveForwardToEdge"};
+const Command ORIGIN_TURN_LEFT_IN_PLACE = {71, "originTurnLeftInPlace"};
+const Command ORIGIN_TURN_RIGHT_IN_PLACE = {72, "originTurnRightInPlace"};
+const Command MOVE_FORWARD_TO_EDGE = {73, "moveForwardToEdge"};
+const Command TURN_LEFT_TO_EDGE = {74, "turnLeftToEdge"};
+const Command TURN_RIGHT_TO_EDGE = {75, "turnRightToEdge"};
+const Command TURN_AROUND_LEFT_TO_EDGE = {76, "turnAroundLeftToEdge"};
+const Command TURN_AROUND_RIGHT_TO_EDGE = {77, "turnAroundRightToEdge"};
+const Command DIAGONAL_LEFT_LEFT = {78, "diagonalLeftLeft"};
+const Command DIAGONAL_LEFT_RIGHT = {79, "diagonalLeftRight"};
+const Command DIAGONAL_RIGHT_LEFT = {80, "diagonalRightLeft"};
+const Command DIAGONAL_RIGHT_RIGHT = {81, "diagonalRightRight"};
+
+const Command CURRENT_X_TILE = {90, "currentXTile"};
+const Command CURRENT_Y_TILE = {91, "currentYTile"};
+const Command CURRENT_DIRECTION = {92, "currentDirection"};
+const Command CURRENT_X_POS_METERS = {93, "currentXPosMeters"};
+const Command CURRENT_Y_POS_METERS = {94, "currentYPosMeters"};
+const Command CURRENT_ROTATION_DEGREES = {95, "currentRotationDegrees"};
+
+} // namespace Commands
+
+// The records of the bulk tile commands, i.e., the arguments of the
+// corresponding single-tile commands
+struct TileColor {
+    int x;
+    int y;
+    char color;
+};
+
+struct TileText {
+    int x;
+    int y;
+    std::string text;
+};
+
+struct TileFogginess {
+    int x;
+    int y;
+    bool foggy;
+};
+
+struct WallDeclaration {
+    int x;
+    int y;
+    char direction;
+    bool wallExists;
+};
+
+// Sends commands to the simulator (over stderr) and reads its replies (from
+// stdin). On construction, we ask the simulator to switch to the binary
+// protocol, in which each message is a frame: a little-endian u16 payload
+// length, followed by the payload. A command's payload is its opcode (u8)
+// followed by its arguments (int as i32, double as f64, char and bool as u8,
+// and string as a u8 length followed by its bytes), all little-endian. A
+// reply's payload is a status (u8, 0 for success) followed by its value, if
+// any. Simulators that don't know the binary protocol reject the request, in
+// which case we fall back to the text protocol, i.e., one line per message.
+// In either protocol, the records of a bulk command (a vector argument) are
+// just appended to the command, one field after another.
+//
+// If the simulator offers a shared memory segment (see SharedMemory.h), we
+// first ask to use that instead, in which case the binary frames go through
+// the segment rather than through stderr and stdin.
+class Protocol {
+
+public:
+
+    Protocol() : m_binary(false), m_sharedMemory(false), m_position(0) {
+        std::cerr << std::boolalpha;
+        const char* name = std::getenv("MMS_SHARED_MEMORY");
+        if (name != nullptr && m_segment.open(name)) {
+            m_sharedMemory = negotiate(Commands::USE_SHARED_MEMORY_TRANSPORT);
+            if (m_sharedMemory) {
+                m_binary = true;
+                return;
+            }
+            m_segment.close();
+        }
+        m_binary = negotiate(Commands::USE_BINARY_PROTOCOL);
+    }
+
+    // Sends a command that the simulator doesn't reply to
+    template <class... Args>
+    void send(const Command& command, const Args&... args) {
+        write(command, args...);
+    }
+
+    // Sends a command and waits for the simulator to acknowledge it
+    template <class... Args>
+    void call(const Command& command, const Args&... args) {
+        write(command, args...);
+        if (m_binary) {
+            readFrame();
+        }
+        else {
+            readLine();
+        }
+    }
+
+    // Sends a command and returns the value that the simulator replies with
+    template <class R, class... Args>
+    R query(const Command& command, const Args&... args) {
+        write(command, args...);
+        R value;
+        if (m_binary) {
+            readFrame();
+            decode(&value);
+        }
+        else {
+            parse(readLine(), &value);
+        }
+        return value;
+    }
+
+private:
+
+    // Whether or not the simulator accepted the binary protocol, and the
+    // shared memory transport, respectively
+    bool m_binary;
+    bool m_sharedMemory;
+    SharedMemory m_segment;
+
+    // Buffers for the outgoing and incoming frames, reused to avoid allocating
+    std::string m_frame;
+    std::string m_reply;
+    std::size_t m_position;
+
+    // Sends a command in the text protocol, returning whether or not the
+    // simulator acknowledged it
+    bool negotiate(const Command& command) {
+        std::cerr << command.name << std::endl;
+        std::string reply;
+        std::getline(std::cin, reply);
+        return reply == "ACK";
+    }
+
+    template <class... Args>
+    void write(const Command& command, const Args&... args) {
+        if (m_binary) {
+            m_frame.assign(2, '\0');
+            m_frame.push_back(static_cast<char>(command.opcode));
+            encode(args...);
+            std::size_t size = m_frame.size() - 2;
+            if (0xFFFF < size) {
+                throw std::length_error("Command too large for a single frame");
+            }
+            m_frame[0] = static_cast<char>(size & 0xFF);
+            m_frame[1] = static_cast<char>((size >> 8) & 0xFF);
+            if (m_sharedMemory) {
+                m_segment.write(m_frame.data(), m_frame.size());
+            }
+            else {
+                std::fwrite(m_frame.data(), 1, m_frame.size(), stderr);
+                std::fflush(stderr);
+            }
+        }
+        else {
+            std::cerr << command.name;
+            print(args...);
+            std::cerr << std::endl;
+        }
+    }
+
+    // ----- Binary encoding ----- //
+
+    void encode() {
+    }
+
+    template <class T, class... Rest>
+    void encode(const T& first, const Rest&... rest) {
+        put(first);
+        encode(rest...);
+    }
+
+    void putUnsigned(std::uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i += 1) {
+            m_frame.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void put(int value) {
+        putUnsigned(static_cast<std::uint32_t>(value), 4);
+    }
+
+    void put(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putUnsigned(bits, 8);
+    }
+
+    void put(char value) {
+        m_frame.push_back(value);
+    }
+
+    void put(bool value) {
+        m_frame.push_back(value ? 1 : 0);
+    }
+
+    void put(const std::string& value) {
+        std::size_t length = value.size() < 255 ? value.size() : 255;
+        m_frame.push_back(static_cast<char>(length));
+        m_frame.append(value, 0, length);
+    }
+
+    template <class T>
+    void put(const std::vector<T>& records) {
+        for (const T& record : records) {
+            put(record);
+        }
+    }
+
+    void put(const TileColor& record) {
+        encode(record.x, record.y, record.color);
+    }
+
+    void put(const TileText& record) {
+        encode(record.x, record.y, record.text);
+    }
+
+    void put(const TileFogginess& record) {
+        encode(record.x, record.y, record.foggy);
+    }
+
+    void put(const WallDeclaration& record) {
+        encode(record.x, record.y, record.direction, record.wallExists);
+    }
+
+    void readBytes(char* data, std::size_t size) {
+        if (m_sharedMemory) {
+            m_segment.read(data, size);
+        }
+        else if (std::fread(data, 1, size, stdin) != size) {
+            throw std::runtime_error("Lost the connection to the simulator");
+        }
+    }
+
+    void readFrame() {
+        char header[2];
+        readBytes(header, 2);
+        std::size_t size =
+            static_cast<unsigned char>(header[0]) |
+            static_cast<unsigned char>(header[1]) << 8;
+        m_reply.resize(size);
+        if (0 < size) {
+            readBytes(&m_reply[0], size);
+        }
+        if (size < 1 || m_reply[0] != 0) {
+            throw std::runtime_error("The simulator rejected a command");
+        }
+        m_position = 1;
+    }
+
+    std::uint64_t getUnsigned(int bytes) {
+        if (m_reply.size() < m_position + bytes) {
+            throw std::runtime_error("Truncated reply from the simulator");
+        }
+        std::uint64_t value = 0;
+        for (int i = 0; i < bytes; i += 1) {
+            value |= static_cast<std::uint64_t>(
+                static_cast<unsigned char>(m_reply[m_position + i])) << (8 * i);
+        }
+        m_position += bytes;
+        return value;
+    }
+
+    void decode(int* value) {
+        *value = static_cast<std::int32_t>(getUnsigned(4));
+    }
+
+    void decode(double* value) {
+        std::uint64_t bits = getUnsigned(8);
+        std::memcpy(value, &bits, sizeof(bits));
+    }
+
+    void decode(char* value) {
+        *value = static_cast<char>(getUnsigned(1));
+    }
+
+    void decode(bool* value) {
+        *value = (getUnsigned(1) != 0);
+    }
+
+    // ----- Text encoding ----- //
+
+    void print() {
+    }
+
+    template <class T, class... Rest>
+    void print(const T& first, const Rest&... rest) {
+        printValue(first);
+        print(rest...);
+    }
+
+    template <class T>
+    void printValue(const T& value) {
+        std::cerr << " " << value;
+    }
+
+    template <class T>
+    void printValue(const std::vector<T>& records) {
+        for (const T& record : records) {
+            printValue(record);
+        }
+    }
+
+    void printValue(const TileColor& record) {
+        print(record.x, record.y, record.color);
+    }
+
+    void printValue(const TileText& record) {
+        print(record.x, record.y, record.text);
+    }
+
+    void printValue(const TileFogginess& record) {
+        print(record.x, record.y, record.foggy);
+    }
+
+    void printValue(const WallDeclaration& record) {
+        print(record.x, record.y, record.direction, record.wallExists);
+    }
+
+    std::string readLine() {
+        std::string input;
+        std::cin >> input;
+        if (input.empty() || input.at(0) == '!') {
+            throw std::runtime_error("The simulator rejected a command");
+        }
+        return input;
+    }
+
+    void parse(const std::string& input, int* value) {
+        *value = std::stoi(input);
+    }
+
+    void parse(const std::string& input, double* value) {
+        *value = std::stod(input);
+    }
+
+    void parse(const std::string& input, char* value) {
+        *value = input.at(0);
+    }
+
+    void parse(const std::string& input, bool* value) {
+        *value = (input == "true");
+    }
+
+};
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define MMS_HAS_SHARED_MEMORY 1
+#endif
+
+#if defined(__linux__)
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+// The algorithm's end of the simulator's shared memory transport (see
+// src/sim/SharedMemoryTransport.h, whose layout this must match): a pair of
+// single-producer, single-consumer byte rings in a shared memory segment that
+// the simulator creates, and whose name it passes to us via the environment.
+// We produce commands and consume replies, both as binary protocol frames.
+class SharedMemory {
+
+public:
+
+    SharedMemory() : m_memory(nullptr) {
+    }
+
+    ~SharedMemory() {
+        close();
+    }
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    // Maps the segment with the given name, returning whether or not it's one
+    // that we know how to use
+    bool open(const char* name) {
+#ifdef MMS_HAS_SHARED_MEMORY
+        int fd = shm_open(name, O_RDWR, 0600);
+        if (fd == -1) {
+            return false;
+        }
+        void* memory = mmap(
+            nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            return false;
+        }
+        m_memory = static_cast<char*>(memory);
+        if (counter(MAGIC_OFFSET)->load() != MAGIC ||
+            counter(VERSION_OFFSET)->load() != VERSION ||
+            counter(CAPACITY_OFFSET)->load() != CAPACITY) {
+            munmap(m_memory, SEGMENT_SIZE);
+            m_memory = nullptr;
+            return false;
+        }
+        return true;
+#else
+        (void) name;
+        return false;
+#endif
+    }
+
+    // Tells the simulator that we're done with the segment, and unmaps it
+    void close() {
+#ifdef MMS_HAS_SHARED_MEMORY
+        if (m_memory != nullptr) {
+            counter(CLOSED_OFFSET)->store(1);
+            wake(counter(COMMAND_HEAD_OFFSET));
+            munmap(m_memory, SEGMENT_SIZE);
+            m_memory = nullptr;
+        }
+#endif
+    }
+
+    // Writes bytes to the command ring, waiting for space if necessary
+    void write(const char* bytes, std::size_t size) {
+        std::atomic<std::uint32_t>* head = counter(COMMAND_HEAD_OFFSET);
+        std::atomic<std::uint32_t>* tail = counter(COMMAND_TAIL_OFFSET);
+        while (0 < size) {
+            std::uint32_t written = head->load(std::memory_order_relaxed);
+            std::uint32_t space =
+                CAPACITY - (written - tail->load(std::memory_order_acquire));
+            if (space == 0) {
+                checkClosed();
+                std::this_thread::yield();
+                continue;
+            }
+            std::uint32_t count = size < space ? size : space;
+            copyIn(commandData(), written, bytes, count);
+            head->store(written + count);
+            if (counter(COMMAND_SLEEPING_OFFSET)->load() != 0) {
+                wake(head);
+            }
+            bytes += count;
+            size -= count;
+        }
+    }
+
+    // Reads exactly size bytes from the reply ring, waiting if necessary
+    void read(char* bytes, std::size_t size) {
+        std::atomic<std::uint32_t>* head = counter(REPLY_HEAD_OFFSET);
+        std::atomic<std::uint32_t>* tail = counter(REPLY_TAIL_OFFSET);
+        while (0 < size) {
+            std::uint32_t read = tail->load(std::memory_order_relaxed);
+            std::uint32_t available = head->load(std::memory_order_acquire) - read;
+            if (available == 0) {
+                waitForReplies(read);
+                continue;
+            }
+            std::uint32_t count = size < available ? size : available;
+            copyOut(replyData(), read, bytes, count);
+            tail->store(read + count, std::memory_order_release);
+            bytes += count;
+            size -= count;
+        }
+    }
+
+private:
+
+    static const std::uint32_t MAGIC = 0x314D4D53;
+    static const std::uint32_t VERSION = 1;
+    static const std::uint32_t CAPACITY = 1 << 16;
+
+    static const int MAGIC_OFFSET = 0;
+    static const int VERSION_OFFSET = 4;
+    static const int CAPACITY_OFFSET = 8;
+    static const int CLOSED_OFFSET = 12;
+    static const int COMMAND_HEAD_OFFSET = 64;
+    static const int COMMAND_TAIL_OFFSET = 128;
+    static const int COMMAND_SLEEPING_OFFSET = 192;
+    static const int REPLY_HEAD_OFFSET = 256;
+    static const int REPLY_TAIL_OFFSET = 320;
+    static const int REPLY_SLEEPING_OFFSET = 384;
+    static const int DATA_OFFSET = 512;
+    static const int SEGMENT_SIZE = DATA_OFFSET + 2 * CAPACITY;
+
+    // How many times to check for a reply before sleeping
+    static const int SPIN_ITERATIONS = 4096;
+
+    char* m_memory;
+
+    std::atomic<std::uint32_t>* counter(int offset) const {
+        return reinterpret_cast<std::atomic<std::uint32_t>*>(m_memory + offset);
+    }
+
+    char* commandData() const {
+        return m_memory + DATA_OFFSET;
+    }
+
+    char* replyData() const {
+        return m_memory + DATA_OFFSET + CAPACITY;
+    }
+
+    static void copyIn(
+            char* ring, std::uint32_t position, const char* bytes, std::uint32_t count) {
+        std::uint32_t start = position & (CAPACITY - 1);
+        std::uint32_t first = count < CAPACITY - start ? count : CAPACITY - start;
+        std::memcpy(ring + start, bytes, first);
+        std::memcpy(ring, bytes + first, count - first);
+    }
+
+    static void copyOut(
+            const char* ring, std::uint32_t position, char* bytes, std::uint32_t count) {
+        std::uint32_t start = position & (CAPACITY - 1);
+        std::uint32_t first = count < CAPACITY - start ? count : CAPACITY - start;
+        std::memcpy(bytes, ring + start, first);
+        std::memcpy(bytes + first, ring, count - first);
+    }
+
+    void checkClosed() const {
+        if (counter(CLOSED_OFFSET)->load(std::memory_order_acquire) != 0) {
+            throw std::runtime_error("Lost the connection to the simulator");
+        }
+    }
+
+    // Spins for a while, and then sleeps, until the reply ring's head moves
+    // past tail (or the simulator goes away)
+    void waitForReplies(std::uint32_t tail) {
+        std::atomic<std::uint32_t>* head = counter(REPLY_HEAD_OFFSET);
+        for (int i = 0; i < SPIN_ITERATIONS; i += 1) {
+            if (head->load(std::memory_order_acquire) != tail) {
+                return;
+            }
+        }
+        checkClosed();
+
+        // The simulator checks the sleeping flag after advancing the head, and
+        // we check the head after setting the flag, so it can't miss us
+        std::atomic<std::uint32_t>* sleeping = counter(REPLY_SLEEPING_OFFSET);
+        sleeping->store(1);
+        std::uint32_t observed = head->load();
+        if (observed == tail) {
+            wait(head, observed);
+        }
+        sleeping->store(0, std::memory_order_relaxed);
+    }
+
+    // Sleeps while *address equals expected (for at most a millisecond, so
+    // that we notice if the simulator closes the segment), and wakes up any
+    // such sleepers, respectively
+    static void wait(std::atomic<std::uint32_t>* address, std::uint32_t expected) {
+#if defined(__linux__)
+        struct timespec timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_nsec = 1000000;
+        syscall(
+            SYS_futex, reinterpret_cast<std::uint32_t*>(address),
+            FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else
+        (void) address;
+        (void) expected;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+#endif
+    }
+
+    static void wake(std::atomic<std::uint32_t>* address) {
+#if defined(__linux__)
+        syscall(
+            SYS_futex, reinterpret_cast<std::uint32_t*>(address),
+            FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+        (void) address;
+#endif
+    }
+
+};
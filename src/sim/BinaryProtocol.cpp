@@ -0,0 +1,184 @@
+#include "BinaryProtocol.h"
+
+#include <QString>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "Assert.h"
+#include "CommandTable.h"
+
+namespace mms {
+
+int BinaryProtocol::frameSize(const char* data, int size) {
+    if (size < HEADER_SIZE) {
+        return 0;
+    }
+    int payloadSize = qFromLittleEndian<quint16>(
+        reinterpret_cast<const uchar*>(data));
+    if (size < HEADER_SIZE + payloadSize) {
+        return 0;
+    }
+    return HEADER_SIZE + payloadSize;
+}
+
+bool BinaryProtocol::decodeCommand(
+        const char* payload, int size, MouseCommand* command) {
+
+    const CommandEntry* entry = decodeEntry(payload, size);
+    if (entry == nullptr) {
+        return false;
+    }
+    command->opcode = entry->opcode;
+
+    const CommandSchema& schema = entry->schema;
+    const uchar* position = reinterpret_cast<const uchar*>(payload) + 1;
+    const uchar* end = reinterpret_cast<const uchar*>(payload) + size;
+
+    int numArguments = 0;
+    while (position < end && numArguments < schema.arguments.size()) {
+        if (!decodeValue(
+                schema.arguments.at(numArguments),
+                &position,
+                end,
+                &command->arguments[numArguments])) {
+            return false;
+        }
+        numArguments += 1;
+    }
+    if (!schema.acceptsNumArguments(numArguments)) {
+        return false;
+    }
+    command->numArguments = numArguments;
+
+    // Whatever's left is records, which must all be complete
+    int numRecords = 0;
+    int numValues = 0;
+    while (position < end) {
+        if (schema.record.isEmpty()) {
+            return false;
+        }
+        for (ValueType type : schema.record) {
+            if (!decodeValue(
+                    type, &position, end, command->recordValue(numValues))) {
+                return false;
+            }
+            numValues += 1;
+        }
+        numRecords += 1;
+    }
+    command->numRecords = numRecords;
+    return true;
+}
+
+const CommandEntry* BinaryProtocol::decodeEntry(const char* payload, int size) {
+    if (size < 1) {
+        return nullptr;
+    }
+    return CommandTable::get(static_cast<quint8>(payload[0]));
+}
+
+bool BinaryProtocol::decodeValue(
+        ValueType type, const uchar** position, const uchar* end, MouseValue* value) {
+    const uchar* p = *position;
+    if (p == end) {
+        return false;
+    }
+    switch (type) {
+        case ValueType::INT:
+            if (end - p < 4) {
+                return false;
+            }
+            value->integer = qFromLittleEndian<qint32>(p);
+            p += 4;
+            break;
+        case ValueType::DOUBLE: {
+            if (end - p < 8) {
+                return false;
+            }
+            quint64 bits = qFromLittleEndian<quint64>(p);
+            std::memcpy(&value->real, &bits, sizeof(double));
+            p += 8;
+            break;
+        }
+        case ValueType::CHAR:
+            value->character = static_cast<char>(*p);
+            p += 1;
+            break;
+        case ValueType::BOOL:
+            if (1 < *p) {
+                return false;
+            }
+            value->boolean = (*p == 1);
+            p += 1;
+            break;
+        case ValueType::STRING: {
+            int length = *p;
+            p += 1;
+            if (end - p < length) {
+                return false;
+            }
+            value->string = QString::fromUtf8(
+                reinterpret_cast<const char*>(p), length);
+            p += length;
+            break;
+        }
+    }
+    *position = p;
+    return true;
+}
+
+void BinaryProtocol::encodeReply(
+        ReplyType type, const MouseValue& value, QByteArray* output) {
+
+    // The largest reply is a status followed by a double
+    char payload[9];
+    payload[0] = STATUS_OK;
+    int size = 1;
+
+    switch (type) {
+        case ReplyType::NONE:
+            return;
+        case ReplyType::ACK:
+            break;
+        case ReplyType::INT:
+            qToLittleEndian<qint32>(
+                value.integer, reinterpret_cast<uchar*>(payload + size));
+            size += 4;
+            break;
+        case ReplyType::DOUBLE: {
+            quint64 bits;
+            std::memcpy(&bits, &value.real, sizeof(double));
+            qToLittleEndian<quint64>(
+                bits, reinterpret_cast<uchar*>(payload + size));
+            size += 8;
+            break;
+        }
+        case ReplyType::CHAR:
+            payload[size] = value.character;
+            size += 1;
+            break;
+        case ReplyType::BOOL:
+            payload[size] = value.boolean ? 1 : 0;
+            size += 1;
+            break;
+    }
+
+    appendFrame(payload, size, output);
+}
+
+void BinaryProtocol::encodeError(QByteArray* output) {
+    char payload = STATUS_ERROR;
+    appendFrame(&payload, 1, output);
+}
+
+void BinaryProtocol::appendFrame(const char* payload, int size, QByteArray* output) {
+    ASSERT_LE(size, MAX_PAYLOAD_SIZE);
+    char header[HEADER_SIZE];
+    qToLittleEndian<quint16>(
+        static_cast<quint16>(size), reinterpret_cast<uchar*>(header));
+    output->append(header, HEADER_SIZE);
+    output->append(payload, size);
+}
+
+} // namespace mms
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QByteArray>
+
+#include "CommandTable.h"
+#include "MouseCommand.h"
+
+namespace mms {
+
+// A compact protocol that an algorithm may switch to by sending the text
+// command "useBinaryProtocol" (and receiving "ACK"). From then on, in both
+// directions, each message is a frame: a payload length (u16), followed by
+// the payload. All integers are little-endian and fixed-width.
+//
+// A command's payload is its opcode (u8), followed by its arguments, encoded
+// by type: INT as i32, DOUBLE as f64, CHAR and BOOL as u8, and STRING as a
+// length (u8) followed by that many UTF-8 bytes, just as the text protocol
+// decodes them. Optional arguments may be
+// omitted from the end, as in the text protocol. A bulk command's records
+// simply follow its arguments, encoded the same way, up to the end of the
+// payload; thus a bulk command is limited by the frame size (e.g., to about
+// 16,000 tile distances).
+//
+// A reply's payload is a status (u8, 0 for success and 1 for error),
+// followed by the value, if any, encoded as above. As in the text protocol,
+// commands of reply type NONE get no reply at all.
+class BinaryProtocol {
+
+public:
+
+    // The BinaryProtocol class is not constructible
+    BinaryProtocol() = delete;
+
+    static const int HEADER_SIZE = 2;
+    static const int MAX_PAYLOAD_SIZE = 0xFFFF;
+
+    // Returns the size of the frame (header and payload) at the start of
+    // data, or 0 if the frame isn't complete yet
+    static int frameSize(const char* data, int size);
+
+    // Decodes the payload of a frame into command, returning false if the
+    // opcode doesn't exist or the arguments don't match its schema
+    static bool decodeCommand(const char* payload, int size, MouseCommand* command);
+
+    // Returns the entry of the payload's opcode, without decoding its
+    // arguments, or nullptr if there's no such opcode
+    static const CommandEntry* decodeEntry(const char* payload, int size);
+
+    // Appends the reply frame for a successful command to output; nothing is
+    // appended for commands of type NONE
+    static void encodeReply(ReplyType type, const MouseValue& value, QByteArray* output);
+
+    // Appends the reply frame for a command that couldn't be decoded
+    static void encodeError(QByteArray* output);
+
+private:
+
+    static const char STATUS_OK = 0;
+    static const char STATUS_ERROR = 1;
+
+    // Decodes a single value of the given type, advancing position past it
+    static bool decodeValue(
+        ValueType type, const uchar** position, const uchar* end, MouseValue* value);
+
+    static void appendFrame(const char* payload, int size, QByteArray* output);
+
+};
+
+} // namespace mms
@@ -1,17 +1,36 @@
 #include "BufferInterface.h"
 
+#include "Assert.h"
+#include "FontImage.h"
+#include "Param.h"
 #include "RGB.h"
 #include "SimUtilities.h"
+#include "Tile.h"
 
 namespace mms {
 
 BufferInterface::BufferInterface(
         QPair<int, int> mazeSize,
         QVector<TriangleGraphic>* graphicCpuBuffer,
-        QVector<TriangleTexture>* textureCpuBuffer) :
+        QVector<TriangleTexture>* textureCpuBuffer,
+        QVector<TileInstance>* tileInstanceCpuBuffer,
+        QVector<TileTextCharacter>* tileTextCpuBuffer,
+        QVector<TileMeshVertex>* tileMeshCpuBuffer) :
         m_mazeSize(mazeSize),
         m_graphicCpuBuffer(graphicCpuBuffer),
-        m_textureCpuBuffer(textureCpuBuffer) {
+        m_textureCpuBuffer(textureCpuBuffer),
+        m_tileInstanceCpuBuffer(tileInstanceCpuBuffer),
+        m_tileTextCpuBuffer(tileTextCpuBuffer),
+        m_tileMeshCpuBuffer(tileMeshCpuBuffer),
+        m_graphicDirtyTiles(mazeSize.first * mazeSize.second, false),
+        m_textureDirtyTiles(mazeSize.first * mazeSize.second, false),
+        m_dirty(false) {
+    initTileInstances();
+    initTileMesh();
+}
+
+QMutex* BufferInterface::getMutex() const {
+    return &m_mutex;
 }
 
 void BufferInterface::initTileGraphicText(
@@ -28,17 +47,37 @@ void BufferInterface::initTileGraphicText(
         borderFraction,
         tileTextAlignment
     );
+
+    // Every tile gets a (blank) character for each possible location
+    m_tileTextCpuBuffer->clear();
+    m_tileTextCpuBuffer->resize(
+        m_mazeSize.first * m_mazeSize.second * tileTextCharactersPerTile());
+    m_tileTextCpuBuffer->fill(TileTextCharacter());
+    for (int i = 0; i < m_textureDirtyTiles.size(); i += 1) {
+        markDirty(&m_textureDirtyTiles, i);
+    }
 }
 
 QPair<int, int> BufferInterface::getTileGraphicTextMaxSize() {
     return m_tileGraphicTextCache.getTileGraphicTextMaxSize();
 }
 
+Cartesian BufferInterface::getTileGraphicTextOrigin() const {
+    return m_tileGraphicTextCache.getTextOrigin();
+}
+
+Cartesian BufferInterface::getTileGraphicTextCharacterSize() const {
+    return m_tileGraphicTextCache.getCharacterSize();
+}
+
 void BufferInterface::insertIntoGraphicCpuBuffer(const Polygon& polygon, Color color, double alpha) {
-    QVector<TriangleGraphic> tgs = SimUtilities::polygonToTriangleGraphics(polygon, color, alpha);
-    for (int i = 0; i < tgs.size(); i += 1) {
-        m_graphicCpuBuffer->push_back(tgs.at(i));
+    // The polygons are inserted tile by tile, so the tile they belong to
+    // follows from where they're inserted
+    int tileIndex = m_graphicCpuBuffer->size() / trianglesPerTile();
+    if (tileIndex < m_graphicDirtyTiles.size()) {
+        markDirty(&m_graphicDirtyTiles, tileIndex);
     }
+    SimUtilities::polygonToTriangleGraphics(polygon, color, alpha, m_graphicCpuBuffer);
 }
 
 void BufferInterface::insertIntoTextureCpuBuffer() {
@@ -57,42 +96,70 @@ void BufferInterface::insertIntoTextureCpuBuffer() {
         {0.0, 0.0, 0.0, 1.0},
         {0.0, 0.0, 0.0, 0.0},
     };
+    int tileIndex = m_textureCpuBuffer->size() / triangleTexturesPerTile();
+    if (tileIndex < m_textureDirtyTiles.size()) {
+        markDirty(&m_textureDirtyTiles, tileIndex);
+    }
     m_textureCpuBuffer->push_back(t1);
     m_textureCpuBuffer->push_back(t2);
 }
 
 void BufferInterface::updateTileGraphicBaseColor(int x, int y, Color color) {
-    int index = getTileGraphicBaseStartingIndex(x, y);
+    markDirty(&m_graphicDirtyTiles, getTileIndex(x, y));
     RGB rgb = COLOR_TO_RGB().value(color);
+    TileInstance* tileInstance = &(*m_tileInstanceCpuBuffer)[getTileIndex(x, y)];
+    tileInstance->r = SimUtilities::toColorByte(rgb.r);
+    tileInstance->g = SimUtilities::toColorByte(rgb.g);
+    tileInstance->b = SimUtilities::toColorByte(rgb.b);
+    if (!isGraphicCpuBufferFilled()) {
+        return;
+    }
+    int index = getTileGraphicBaseStartingIndex(x, y);
     for (int i = 0; i < 2; i += 1) {
         TriangleGraphic* triangleGraphic = &(*m_graphicCpuBuffer)[index + i];
-        triangleGraphic->p1.rgb = rgb;
-        triangleGraphic->p2.rgb = rgb;
-        triangleGraphic->p3.rgb = rgb;
+        setColor(&triangleGraphic->p1, rgb);
+        setColor(&triangleGraphic->p2, rgb);
+        setColor(&triangleGraphic->p3, rgb);
     }
 }
 
 void BufferInterface::updateTileGraphicWallColor(int x, int y, Direction direction, Color color, double alpha) {
-    int index = getTileGraphicWallStartingIndex(x, y, direction);
+    markDirty(&m_graphicDirtyTiles, getTileIndex(x, y));
     RGB rgb = COLOR_TO_RGB().value(color);
+    quint8 a = SimUtilities::toColorByte(alpha);
+    quint8* wall = (*m_tileInstanceCpuBuffer)[getTileIndex(x, y)].walls[DIRECTIONS().indexOf(direction)];
+    wall[0] = SimUtilities::toColorByte(rgb.r);
+    wall[1] = SimUtilities::toColorByte(rgb.g);
+    wall[2] = SimUtilities::toColorByte(rgb.b);
+    wall[3] = a;
+    if (!isGraphicCpuBufferFilled()) {
+        return;
+    }
+    int index = getTileGraphicWallStartingIndex(x, y, direction);
     for (int i = 0; i < 2; i += 1) {
         TriangleGraphic* triangleGraphic = &(*m_graphicCpuBuffer)[index + i];
-        triangleGraphic->p1.rgb = rgb;
-        triangleGraphic->p2.rgb = rgb;
-        triangleGraphic->p3.rgb = rgb;
-        triangleGraphic->p1.a = alpha;
-        triangleGraphic->p2.a = alpha;
-        triangleGraphic->p3.a = alpha;
+        setColor(&triangleGraphic->p1, rgb);
+        setColor(&triangleGraphic->p2, rgb);
+        setColor(&triangleGraphic->p3, rgb);
+        triangleGraphic->p1.a = a;
+        triangleGraphic->p2.a = a;
+        triangleGraphic->p3.a = a;
     }
 }
 
 void BufferInterface::updateTileGraphicFog(int x, int y, double alpha) {
+    markDirty(&m_graphicDirtyTiles, getTileIndex(x, y));
+    quint8 a = SimUtilities::toColorByte(alpha);
+    (*m_tileInstanceCpuBuffer)[getTileIndex(x, y)].fog = a;
+    if (!isGraphicCpuBufferFilled()) {
+        return;
+    }
     int index = getTileGraphicFogStartingIndex(x, y);
     for (int i = 0; i < 2; i += 1) {
         TriangleGraphic* triangleGraphic = &(*m_graphicCpuBuffer)[index + i];
-        triangleGraphic->p1.a = alpha;
-        triangleGraphic->p2.a = alpha;
-        triangleGraphic->p3.a = alpha;
+        triangleGraphic->p1.a = a;
+        triangleGraphic->p2.a = a;
+        triangleGraphic->p3.a = a;
     }
 }
 
@@ -106,13 +173,33 @@ void BufferInterface::updateTileGraphicText(int x, int y, int numRows, int numCo
     //    | /         |    | /       /         |
     //   [LL]---------+   [p1]     [p1]------[p3]
 
-    QPair<double, double> fontImageCharacterPosition =
-        m_tileGraphicTextCache.getFontImageCharacterPosition(c);
+    markDirty(&m_textureDirtyTiles, getTileIndex(x, y));
+    int glyphIndex = FontImage::get()->glyphIndex(c);
+    bool visible = row < numRows && col < numCols;
+    QPair<int, int> cell = visible
+        ? m_tileGraphicTextCache.getTileGraphicTextCell(numRows, numCols, row, col)
+        : qMakePair(0, 0);
+    TileTextCharacter* character = &(*m_tileTextCpuBuffer)[getTileTextIndex(x, y, row, col)];
+    character->glyph = glyphIndex;
+    character->column = cell.first;
+    character->row = cell.second;
+    character->visible = visible ? 255 : 0;
+
+    // The texture cpu buffer is filled lazily, tile by tile, so we only
+    // update the triangles if they've been inserted already
+    int triangleTextureIndex = getTileGraphicTextStartingIndex(x, y, row, col);
+    if (m_textureCpuBuffer->size() <= triangleTextureIndex + 1) {
+        return;
+    }
+
+    QPair<double, double> fontImageCharacterPosition = {
+        static_cast<double>(glyphIndex + 0) / FontImage::get()->glyphCount(),
+        static_cast<double>(glyphIndex + 1) / FontImage::get()->glyphCount(),
+    };
 
     QPair<Cartesian, Cartesian> LL_UR =
         m_tileGraphicTextCache.getTileGraphicTextPosition(x, y, numRows, numCols, row, col);
 
-    int triangleTextureIndex = getTileGraphicTextStartingIndex(x, y, row, col);
     TriangleTexture* t1 = &(*m_textureCpuBuffer)[triangleTextureIndex];
     TriangleTexture* t2 = &(*m_textureCpuBuffer)[triangleTextureIndex + 1];
 
@@ -137,7 +224,183 @@ void BufferInterface::updateTileGraphicText(int x, int y, int numRows, int numCo
     t2->p3.u = fontImageCharacterPosition.second;
 }
 
-int BufferInterface::trianglesPerTile() {
+void BufferInterface::getGraphicCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const {
+    getDirtyRanges(m_graphicDirtyTiles, trianglesPerTile(), ranges);
+}
+
+void BufferInterface::getTextureCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const {
+    getDirtyRanges(m_textureDirtyTiles, triangleTexturesPerTile(), ranges);
+}
+
+void BufferInterface::getTileInstanceCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const {
+    // Every update to a tile's triangles is also an update to its instance
+    getDirtyRanges(m_graphicDirtyTiles, 1, ranges);
+}
+
+void BufferInterface::getTileTextCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const {
+    // Likewise, every update to a tile's text is also an update to its characters
+    getDirtyRanges(m_textureDirtyTiles, tileTextCharactersPerTile(), ranges);
+}
+
+void BufferInterface::clearDirtyRanges() {
+    m_graphicDirtyTiles.fill(false);
+    m_textureDirtyTiles.fill(false);
+    m_dirty = false;
+}
+
+bool BufferInterface::isDirty() const {
+    return m_dirty;
+}
+
+void BufferInterface::markDirty(QVector<bool>* dirtyTiles, int tileIndex) {
+    (*dirtyTiles)[tileIndex] = true;
+    m_dirty = true;
+}
+
+void BufferInterface::getDirtyRanges(
+        const QVector<bool>& dirtyTiles,
+        int trianglesPerTile,
+        QVector<QPair<int, int>>* ranges) {
+
+    // Runs of dirty tiles separated by at most this many clean tiles are
+    // uploaded together
+    static const int MAX_CLEAN_TILES_BETWEEN_RUNS = 4;
+
+    ranges->clear();
+    int runStart = -1;
+    int runEnd = -1;
+    for (int i = 0; i < dirtyTiles.size(); i += 1) {
+        if (!dirtyTiles.at(i)) {
+            continue;
+        }
+        if (runStart != -1 && i - runEnd <= MAX_CLEAN_TILES_BETWEEN_RUNS) {
+            runEnd = i + 1;
+            continue;
+        }
+        if (runStart != -1) {
+            ranges->append({
+                runStart * trianglesPerTile,
+                (runEnd - runStart) * trianglesPerTile});
+        }
+        runStart = i;
+        runEnd = i + 1;
+    }
+    if (runStart != -1) {
+        ranges->append({
+            runStart * trianglesPerTile,
+            (runEnd - runStart) * trianglesPerTile});
+    }
+}
+
+void BufferInterface::initTileInstances() {
+    Meters tileLength = Meters(P()->wallLength() + P()->wallWidth());
+    m_tileInstanceCpuBuffer->clear();
+    m_tileInstanceCpuBuffer->resize(m_mazeSize.first * m_mazeSize.second);
+    for (int x = 0; x < m_mazeSize.first; x += 1) {
+        for (int y = 0; y < m_mazeSize.second; y += 1) {
+            TileInstance* tileInstance = &(*m_tileInstanceCpuBuffer)[getTileIndex(x, y)];
+            *tileInstance = TileInstance();
+            tileInstance->x = (tileLength * x).getMeters();
+            tileInstance->y = (tileLength * y).getMeters();
+            tileInstance->edges[0] = x == 0 ? 255 : 0;
+            tileInstance->edges[1] = x == m_mazeSize.first - 1 ? 255 : 0;
+            tileInstance->edges[2] = y == 0 ? 255 : 0;
+            tileInstance->edges[3] = y == m_mazeSize.second - 1 ? 255 : 0;
+            markDirty(&m_graphicDirtyTiles, getTileIndex(x, y));
+        }
+    }
+}
+
+void BufferInterface::initTileMesh() {
+
+    // Every tile that's not on the edge of the maze has the same shape, so we
+    // use the middle tile of a 3x3 maze as the mesh. Tiles on the edges only
+    // differ in the x coordinates of their vertices (for west and east edges)
+    // or the y coordinates (for south and north edges), so the edge offsets
+    // are just the differences between the middle tile and the tiles next to
+    // it, and they add up for tiles on more than one edge.
+    static const QVector<QPair<int, int>> positions = {
+        {1, 1}, // middle
+        {0, 1}, // west
+        {2, 1}, // east
+        {1, 0}, // south
+        {1, 2}, // north
+    };
+    Meters tileLength = Meters(P()->wallLength() + P()->wallWidth());
+
+    QVector<QVector<Cartesian>> vertices;
+    QVector<int> parts;
+    for (const QPair<int, int>& position : positions) {
+
+        Tile tile;
+        tile.setPos(position.first, position.second);
+        tile.initPolygons(3, 3);
+        Cartesian origin(tileLength * position.first, tileLength * position.second);
+
+        // The parts of the tile, in the same order as TileGraphic::drawPolygons,
+        // numbered as follows: 0 is the base, 1 through 4 are the walls, 5 is
+        // any corner, and 6 is the fog
+        QVector<QPair<Polygon, int>> polygonsAndParts;
+        polygonsAndParts.append({tile.getFullPolygon(), 0});
+        for (Direction direction : DIRECTIONS()) {
+            polygonsAndParts.append({
+                tile.getWallPolygon(direction),
+                1 + DIRECTIONS().indexOf(direction)});
+        }
+        for (const Polygon& polygon : tile.getCornerPolygons()) {
+            polygonsAndParts.append({polygon, 5});
+        }
+        polygonsAndParts.append({tile.getFullPolygon(), 6});
+
+        QVector<Cartesian> tileVertices;
+        for (const QPair<Polygon, int>& polygonAndPart : polygonsAndParts) {
+            for (const Triangle& triangle : polygonAndPart.first.getTriangles()) {
+                for (const Cartesian& vertex : {triangle.p1, triangle.p2, triangle.p3}) {
+                    tileVertices.append(vertex - origin);
+                    if (vertices.isEmpty()) {
+                        parts.append(polygonAndPart.second);
+                    }
+                }
+            }
+        }
+        vertices.append(tileVertices);
+    }
+
+    m_tileMeshCpuBuffer->clear();
+    for (int i = 0; i < parts.size(); i += 1) {
+        const Cartesian& middle = vertices.at(0).at(i);
+        TileMeshVertex vertex = TileMeshVertex();
+        vertex.x = middle.getX().getMeters();
+        vertex.y = middle.getY().getMeters();
+        for (int edge = 0; edge < 4; edge += 1) {
+            ASSERT_EQ(vertices.at(1 + edge).size(), parts.size());
+            const Cartesian& other = vertices.at(1 + edge).at(i);
+            vertex.edgeOffsets[edge] = edge < 2
+                ? (other.getX() - middle.getX()).getMeters()
+                : (other.getY() - middle.getY()).getMeters();
+        }
+        int part = parts.at(i);
+        if (1 <= part && part <= 4) {
+            vertex.wallSelector[part - 1] = 255;
+        }
+        else {
+            vertex.partSelector[part == 0 ? 0 : (part == 5 ? 1 : 2)] = 255;
+        }
+        m_tileMeshCpuBuffer->append(vertex);
+    }
+}
+
+bool BufferInterface::isGraphicCpuBufferFilled() const {
+    return m_graphicCpuBuffer->size() == trianglesPerTile() * m_mazeSize.first * m_mazeSize.second;
+}
+
+void BufferInterface::setColor(VertexGraphic* vertex, const RGB& rgb) {
+    vertex->r = SimUtilities::toColorByte(rgb.r);
+    vertex->g = SimUtilities::toColorByte(rgb.g);
+    vertex->b = SimUtilities::toColorByte(rgb.b);
+}
+
+int BufferInterface::trianglesPerTile() const {
     // This value must be predetermined, and was done so as follows:
     // Base polygon:      2 (2 triangles x 1 polygon  per tile)
     // Wall polygon:      8 (2 triangles x 4 polygons per tile)
@@ -148,6 +411,19 @@ int BufferInterface::trianglesPerTile() {
     return 20;
 }
 
+int BufferInterface::triangleTexturesPerTile() const {
+    return 2 * tileTextCharactersPerTile();
+}
+
+int BufferInterface::tileTextCharactersPerTile() const {
+    QPair<int, int> maxRowsAndCols = m_tileGraphicTextCache.getTileGraphicTextMaxSize();
+    return maxRowsAndCols.first * maxRowsAndCols.second;
+}
+
+int BufferInterface::getTileIndex(int x, int y) const {
+    return m_mazeSize.second * x + y;
+}
+
 int BufferInterface::getTileGraphicBaseStartingIndex(int x, int y) {
     return  0 + trianglesPerTile() * (m_mazeSize.second * x + y);
 }
@@ -164,10 +440,13 @@ int BufferInterface::getTileGraphicFogStartingIndex(int x, int y) {
     return 18 + trianglesPerTile() * (m_mazeSize.second * x + y);
 }
 
-int BufferInterface::getTileGraphicTextStartingIndex(int x, int y, int row, int col) {
-    QPair<int, int> maxRowsAndCols = getTileGraphicTextMaxSize();
-    int triangleTexturesPerTile = 2 * maxRowsAndCols.first * maxRowsAndCols.second;
-    return triangleTexturesPerTile * (m_mazeSize.second * x + y) + 2 * (row * maxRowsAndCols.second + col);
+int BufferInterface::getTileTextIndex(int x, int y, int row, int col) const {
+    QPair<int, int> maxRowsAndCols = m_tileGraphicTextCache.getTileGraphicTextMaxSize();
+    return tileTextCharactersPerTile() * getTileIndex(x, y) + row * maxRowsAndCols.second + col;
+}
+
+int BufferInterface::getTileGraphicTextStartingIndex(int x, int y, int row, int col) const {
+    return 2 * getTileTextIndex(x, y, row, col);
 }
 
 } // namespace mms
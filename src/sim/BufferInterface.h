@@ -1,16 +1,24 @@
 #pragma once
 
 #include <QChar>
+#include <QMutex>
 #include <QPair>
 #include <QVector>
 
+#include <atomic>
+
 #include "Color.h"
 #include "Direction.h"
 #include "Polygon.h"
+#include "RGB.h"
 #include "TileGraphicTextCache.h"
+#include "TileInstance.h"
+#include "TileMeshVertex.h"
+#include "TileTextCharacter.h"
 #include "TileTextAlignment.h"
 #include "TriangleGraphic.h"
 #include "TriangleTexture.h"
+#include "VertexGraphic.h"
 
 namespace mms {
 
@@ -21,7 +29,16 @@ public:
     BufferInterface(
         QPair<int, int> mazeSize,
         QVector<TriangleGraphic>* graphicCpuBuffer,
-        QVector<TriangleTexture>* textureCpuBuffer);
+        QVector<TriangleTexture>* textureCpuBuffer,
+        QVector<TileInstance>* tileInstanceCpuBuffer,
+        QVector<TileTextCharacter>* tileTextCpuBuffer,
+        QVector<TileMeshVertex>* tileMeshCpuBuffer);
+
+    // The algorithm's thread updates the cpu buffers (and marks tiles dirty)
+    // while the GUI thread uploads them (and clears the dirty tiles), so both
+    // must hold this mutex while doing so. The methods of this class don't
+    // lock it themselves, and isDirty() doesn't need it.
+    QMutex* getMutex() const;
 
     // Initializes and caches all possible tile text positions. We need this
     // extra initialization function since the max size is from the algorithm.
@@ -35,16 +52,38 @@ public:
     // Returns the maximum number of rows and columns of text in a tile graphic
     QPair<int, int> getTileGraphicTextMaxSize();
 
+    // The lower left corner of the text area of tile (0, 0), and the size of
+    // each character, from which the GPU places the tile text characters
+    Cartesian getTileGraphicTextOrigin() const;
+    Cartesian getTileGraphicTextCharacterSize() const;
+
     // Fills the graphic cpu buffer and texture cpu buffer
     void insertIntoGraphicCpuBuffer(const Polygon& polygon, Color color, double alpha);
     void insertIntoTextureCpuBuffer();
 
-    // These methods are inexpensive, and may be called many times
+    // These methods are inexpensive, and may be called many times. They
+    // update the tile instance (or tile text) cpu buffer, as well as the
+    // graphic (or texture) cpu buffer if it's been filled.
     void updateTileGraphicBaseColor(int x, int y, Color color);
     void updateTileGraphicWallColor(int x, int y, Direction direction, Color color, double alpha);
     void updateTileGraphicFog(int x, int y, double alpha);
     void updateTileGraphicText(int x, int y, int numRows, int numCols, int row, int col, QChar c);
 
+    // Fills ranges with the (starting index, count) of each run of triangles
+    // that has been inserted or updated since the last call to
+    // clearDirtyRanges(), so that only those need to be uploaded to the GPU.
+    // Runs separated by just a few clean tiles are merged, since a slightly
+    // larger upload is cheaper than an extra one.
+    void getGraphicCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const;
+    void getTextureCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const;
+    void getTileInstanceCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const;
+    void getTileTextCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const;
+    void clearDirtyRanges();
+
+    // Whether anything has changed since the last call to clearDirtyRanges();
+    // this is just a hint, for deciding whether or not to repaint
+    bool isDirty() const;
+
 private:
 
     // The width and height of the maze
@@ -53,20 +92,51 @@ private:
     // CPU-side buffers
     QVector<TriangleGraphic>* m_graphicCpuBuffer;
     QVector<TriangleTexture>* m_textureCpuBuffer;
+    QVector<TileInstance>* m_tileInstanceCpuBuffer;
+    QVector<TileTextCharacter>* m_tileTextCpuBuffer;
+    QVector<TileMeshVertex>* m_tileMeshCpuBuffer;
+
+    // Fill the tile instance cpu buffer (with each tile's position, but not
+    // yet its colors) and the tile mesh cpu buffer
+    void initTileInstances();
+    void initTileMesh();
+
+    // Whether the graphic cpu buffer has been filled, in which case it must
+    // be updated along with the tile instances
+    bool isGraphicCpuBufferFilled() const;
 
     // A cache for tile graphic text information
     TileGraphicTextCache m_tileGraphicTextCache;
 
+    // Whether or not each tile's triangles have changed since the dirty
+    // ranges were last cleared, indexed in the same order as the buffers
+    QVector<bool> m_graphicDirtyTiles;
+    QVector<bool> m_textureDirtyTiles;
+    std::atomic<bool> m_dirty;
+    mutable QMutex m_mutex;
+    void markDirty(QVector<bool>* dirtyTiles, int tileIndex);
+    static void getDirtyRanges(
+        const QVector<bool>& dirtyTiles,
+        int trianglesPerTile,
+        QVector<QPair<int, int>>* ranges);
+
+    // Sets the color (but not the alpha value) of the vertex
+    static void setColor(VertexGraphic* vertex, const RGB& rgb);
+
     // Retrieve the indices into the graphic cpu buffer,
     // for each specific type of Tile triangle
-    int trianglesPerTile();
+    int trianglesPerTile() const;
+    int triangleTexturesPerTile() const;
+    int tileTextCharactersPerTile() const;
+    int getTileIndex(int x, int y) const;
     int getTileGraphicBaseStartingIndex(int x, int y);
     int getTileGraphicWallStartingIndex(int x, int y, Direction direction);
     int getTileGraphicCornerStartingIndex(int x, int y, int cornerNumber);
     int getTileGraphicFogStartingIndex(int x, int y);
 
-    // Retrieve the indices into the texture cpu buffer
-    int getTileGraphicTextStartingIndex(int x, int y, int row, int col);
+    // Retrieve the indices into the tile text and texture cpu buffers
+    int getTileTextIndex(int x, int y, int row, int col) const;
+    int getTileGraphicTextStartingIndex(int x, int y, int row, int col) const;
 
 };
 
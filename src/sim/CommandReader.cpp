@@ -0,0 +1,112 @@
+#include "CommandReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "BinaryProtocol.h"
+
+namespace mms {
+
+CommandReader::CommandReader() :
+        m_position(0),
+        m_scanned(0),
+        m_newline(-1),
+        m_newlineScanned(0),
+        m_skipNewline(false) {
+    // Reserving marks the capacity as reserved, so that it's kept (and not
+    // freed and reallocated) whenever the consumed bytes are discarded
+    m_buffer.reserve(4096);
+}
+
+void CommandReader::append(const QByteArray& bytes) {
+    append(bytes.constData(), bytes.size());
+}
+
+void CommandReader::append(const char* bytes, int size) {
+    // Only the trailing partial command, if any, is ever moved
+    if (0 < m_position) {
+        m_buffer.remove(0, m_position);
+        m_scanned -= m_position;
+        m_newline -= m_position;
+        m_newlineScanned = std::max(m_newlineScanned - m_position, 0);
+        m_position = 0;
+    }
+    m_buffer.append(bytes, size);
+}
+
+bool CommandReader::nextLine(const char** line, int* size) {
+
+    skipNewline();
+
+    // The C library's memchr is vectorized, which makes this much faster
+    // than checking each byte ourselves. Since carriage returns are rare, we
+    // first find the next newline, and then only look for a carriage return
+    // before it.
+    const char* data = m_buffer.constData();
+    if (m_newline < m_scanned) {
+        int start = std::max(m_scanned, m_newlineScanned);
+        const char* newline = static_cast<const char*>(
+            std::memchr(data + start, '\n', m_buffer.size() - start));
+        m_newline = (newline == nullptr ? -1 : static_cast<int>(newline - data));
+        m_newlineScanned = (newline == nullptr ? m_buffer.size() : m_newline + 1);
+    }
+    int end = (m_newline < 0 ? m_buffer.size() : m_newline);
+    const char* carriageReturn = static_cast<const char*>(
+        std::memchr(data + m_scanned, '\r', end - m_scanned));
+
+    int next = 0;
+    if (carriageReturn != nullptr) {
+        end = static_cast<int>(carriageReturn - data);
+        next = end + 1;
+        if (next == m_newline) {
+            next += 1;
+        }
+        else if (next == m_buffer.size()) {
+            m_skipNewline = true;
+        }
+    }
+    else if (0 <= m_newline) {
+        next = end + 1;
+    }
+    else {
+        m_scanned = m_buffer.size();
+        return false;
+    }
+
+    *line = data + m_position;
+    *size = end - m_position;
+    m_position = next;
+    m_scanned = m_position;
+    return true;
+}
+
+bool CommandReader::nextFrame(const char** payload, int* size) {
+    // The line that switched to the binary protocol may have ended with a
+    // carriage return and newline that arrived separately
+    skipNewline();
+    const char* data = m_buffer.constData() + m_position;
+    int frameSize = BinaryProtocol::frameSize(data, m_buffer.size() - m_position);
+    if (frameSize == 0) {
+        return false;
+    }
+    *payload = data + BinaryProtocol::HEADER_SIZE;
+    *size = frameSize - BinaryProtocol::HEADER_SIZE;
+    m_position += frameSize;
+    if (m_scanned < m_position) {
+        m_scanned = m_position;
+    }
+    return true;
+}
+
+void CommandReader::skipNewline() {
+    if (!m_skipNewline || m_position == m_buffer.size()) {
+        return;
+    }
+    m_skipNewline = false;
+    if (m_buffer.at(m_position) == '\n') {
+        m_position += 1;
+        m_scanned = std::max(m_scanned, m_position);
+    }
+}
+
+} // namespace mms
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QByteArray>
+
+namespace mms {
+
+// Accumulates the bytes that a mouse algorithm writes to stderr, and splits
+// them into complete commands, i.e., lines of the text protocol or frames of
+// the binary protocol. Commands are returned as views into the buffer, rather
+// than as copies, and are only valid until the next call to append(). Each
+// byte is scanned at most once, even when a line arrives in many pieces.
+class CommandReader {
+
+public:
+
+    CommandReader();
+
+    // Adds bytes to the end of the stream, first discarding the bytes of any
+    // commands that have already been read
+    void append(const QByteArray& bytes);
+    void append(const char* bytes, int size);
+
+    // If a complete line is available, points line at it (excluding its
+    // line ending, which is "\n", "\r\n", or a lone "\r"), consumes it, and
+    // returns true; otherwise returns false
+    bool nextLine(const char** line, int* size);
+
+    // If a complete frame is available, points payload at its payload,
+    // consumes it, and returns true; otherwise returns false
+    bool nextFrame(const char** payload, int* size);
+
+private:
+
+    // The bytes before m_position have been consumed, and the bytes before
+    // m_scanned are known not to contain a line ending (or have been consumed)
+    QByteArray m_buffer;
+    int m_position;
+    int m_scanned;
+
+    // Where the next newline is, if it's at or after m_scanned, and the
+    // bytes before m_newlineScanned are known not to contain any other, so
+    // that lines ending in a lone carriage return don't cause the same bytes
+    // to be searched for a newline over and over
+    int m_newline;
+    int m_newlineScanned;
+
+    // Whether the last line ended with a carriage return at the end of the
+    // buffer, in which case a newline that arrives next belongs to it
+    bool m_skipNewline;
+
+    // Consumes the newline of a carriage return and newline that arrived
+    // separately, if there is one
+    void skipNewline();
+
+};
+
+} // namespace mms
@@ -0,0 +1,85 @@
+#include "CommandTable.h"
+
+#include <QMapIterator>
+
+#include <algorithm>
+
+#include "Assert.h"
+
+namespace mms {
+
+const CommandEntry* CommandTable::get(Opcode opcode) {
+    return get(static_cast<quint8>(opcode));
+}
+
+const CommandEntry* CommandTable::get(quint8 opcode) {
+    const Table& t = table();
+    int index = t.entryByOpcode.at(opcode);
+    return index < 0 ? nullptr : &t.entries.at(index);
+}
+
+const CommandEntry* CommandTable::get(const char* name, int length) {
+    const Table& t = table();
+    int index = t.entryByNameSlot.at(nameSlot(name, length));
+    if (index < 0) {
+        return nullptr;
+    }
+    const CommandEntry& entry = t.entries.at(index);
+    if (entry.name.size() != length ||
+        !std::equal(name, name + length, entry.name.constData())) {
+        return nullptr;
+    }
+    return &entry;
+}
+
+const CommandTable::Table& CommandTable::table() {
+    static const Table table = build();
+    return table;
+}
+
+CommandTable::Table CommandTable::build() {
+
+    Table t;
+    t.entryByOpcode.fill(-1, OPCODE_SLOTS);
+    QMapIterator<Opcode, QString> iterator(OPCODE_TO_STRING());
+    while (iterator.hasNext()) {
+        auto pair = iterator.next();
+        ASSERT_TR(OPCODE_TO_SCHEMA().contains(pair.key()));
+        CommandSchema schema = OPCODE_TO_SCHEMA().value(pair.key());
+        ASSERT_LE(schema.arguments.size(), MouseCommand::MAX_ARGUMENTS);
+        // Otherwise, it would be ambiguous where the records begin
+        ASSERT_TR(
+            schema.record.isEmpty() ||
+            schema.numRequiredArguments == schema.arguments.size());
+        t.entryByOpcode[static_cast<quint8>(pair.key())] = t.entries.size();
+        CommandEntry entry = {
+            pair.key(),
+            pair.value().toLatin1(),
+            schema,
+        };
+        t.entries.append(entry);
+    }
+    ASSERT_LT(t.entries.size(), NAME_SLOTS);
+
+    t.entryByNameSlot.fill(-1, NAME_SLOTS);
+    for (int i = 0; i < t.entries.size(); i += 1) {
+        const QByteArray& name = t.entries.at(i).name;
+        int slot = nameSlot(name.constData(), name.size());
+        // Otherwise, NAME_SEED must be changed
+        ASSERT_EQ(t.entryByNameSlot.at(slot), -1);
+        t.entryByNameSlot[slot] = i;
+    }
+    return t;
+}
+
+int CommandTable::nameSlot(const char* name, int length) {
+    // FNV-1a, seeded, keeping the (better mixed) high bits
+    quint32 hash = 2166136261u ^ (NAME_SEED * 2654435761u);
+    for (int i = 0; i < length; i += 1) {
+        hash ^= static_cast<quint8>(name[i]);
+        hash *= 16777619u;
+    }
+    return static_cast<int>(hash >> (32 - NAME_SLOTS_LOG2));
+}
+
+} // namespace mms
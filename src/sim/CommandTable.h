@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+#include "MouseCommand.h"
+#include "Opcode.h"
+
+namespace mms {
+
+// Everything needed to decode a command and to encode its reply
+struct CommandEntry {
+    Opcode opcode;
+    QByteArray name;
+    CommandSchema schema;
+};
+
+// The table of every command, built once from OPCODE_TO_STRING() and
+// OPCODE_TO_SCHEMA(). Names are stored as (ASCII) bytes, so that commands
+// can be looked up straight from the algorithm's output. Commands are looked
+// up by opcode with a direct index, and by name with a perfect hash (i.e., a
+// hash that's collision-free over the command names), followed by a single
+// string compare. Thus the cost of a lookup doesn't depend on which command
+// is being looked up.
+class CommandTable {
+
+public:
+
+    // The CommandTable class is not constructible
+    CommandTable() = delete;
+
+    // Returns the entry for the opcode or name, or nullptr if none exists
+    static const CommandEntry* get(Opcode opcode);
+    static const CommandEntry* get(quint8 opcode);
+    static const CommandEntry* get(const char* name, int length);
+
+private:
+
+    // The number of name slots, which is a power of two, and large enough
+    // relative to the number of commands that a collision-free seed is easy
+    // to find
+    static const int NAME_SLOTS_LOG2 = 10;
+    static const int NAME_SLOTS = 1 << NAME_SLOTS_LOG2;
+    static const int OPCODE_SLOTS = 256;
+
+    // The first seed for which the command names hash to distinct slots. If
+    // a new command collides (which build() asserts against), try the seeds
+    // that follow until one works.
+    static constexpr quint32 NAME_SEED = 4;
+
+    struct Table {
+        QVector<CommandEntry> entries;
+        QVector<qint16> entryByOpcode;
+        QVector<qint16> entryByNameSlot;
+    };
+
+    static const Table& table();
+    static Table build();
+    static int nameSlot(const char* name, int length);
+
+};
+
+} // namespace mms
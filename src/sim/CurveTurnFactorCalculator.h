@@ -21,7 +21,7 @@ public:
     // Returns a linear combination of forward and turn movement components
     // such that the mouse turns along the arc with the given radius. Note that
     // these factors are not necessarily between [-1.0, 1.0]
-    QPair<double, double> getCurveTurnFactors(const Meters& radius);
+    QPair<double, double> getCurveTurnFactors(const Meters& radius) const;
 
 private:
     // The components if the desired radius was 1m (hence "unit")
@@ -6,8 +6,6 @@
 #include "Logging.h"
 #include "Screen.h"
 #include "Settings.h"
-#include "SimTime.h"
-#include "State.h"
 #include "Model.h"
 #include "Window.h"
 
@@ -21,9 +19,6 @@ int Driver::drive(int argc, char* argv[]) {
     // Initialize Qt
     QApplication app(argc, argv);
 
-    // Initialize the Time object
-    SimTime::init();
-
     // Initialize the Screen object
     Screen::init();
 
@@ -34,7 +29,6 @@ int Driver::drive(int argc, char* argv[]) {
     Settings::init();
 
     P(); // Initialize the Param object
-    S(); // Initialize the State object
 
     // Initialize the FontImage object
     FontImage::init(P()->tileTextFontImage());
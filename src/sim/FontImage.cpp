@@ -24,8 +24,17 @@ QString FontImage::imageFilePath() {
     return m_imageFilePath;
 }
 
-QMap<QChar, QPair<double, double>> FontImage::positions() {
-    return m_positions;
+bool FontImage::contains(QChar c) const {
+    return FIRST_CHARACTER <= c.unicode() && c.unicode() <= LAST_CHARACTER;
+}
+
+int FontImage::glyphIndex(QChar c) const {
+    ASSERT_TR(contains(c));
+    return c.unicode() - FIRST_CHARACTER;
+}
+
+int FontImage::glyphCount() const {
+    return LAST_CHARACTER - FIRST_CHARACTER + 1;
 }
 
 FontImage::FontImage(const QString& imageFile) :
@@ -39,21 +48,15 @@ FontImage::FontImage(const QString& imageFile) :
         SimUtilities::quit();
     }
 
-    // These values must perfectly reflect the font image being used,
-    // else the wrong characters will be displayed on the tiles
-    QString fontImageChars =
-        " !\"#$%&'()*+,-./0123456789:;<=>?"
-        "@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_"
-        "`abcdefghijklmnopqrstuvwxyz{|}~";
-
-    // Create a map of the font image chars (allowable tile text chars) to
-    // their horizontal position in the png image (a fraction from 0.0 to 1.0)
-    int size = fontImageChars.size();
-    for (int i = 0; i < size; i += 1) {
-        double start = static_cast<double>(i + 0) / static_cast<double>(size);
-        double end   = static_cast<double>(i + 1) / static_cast<double>(size);
-        m_positions.insert(fontImageChars.at(i), {start, end});
-    }
+    // The font image must contain exactly these characters, in this order,
+    // else the wrong characters will be displayed on the tiles:
+    //
+    //     " !"#$%&'()*+,-./0123456789:;<=>?"
+    //     "@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_"
+    //     "`abcdefghijklmnopqrstuvwxyz{|}~"
+    //
+    // i.e., the printable ASCII characters, from FIRST_CHARACTER to
+    // LAST_CHARACTER
 }
 
 } // namespace mms
@@ -1,8 +1,7 @@
 #pragma once
 
 #include <QChar>
-#include <QMap>
-#include <QPair>
+#include <QString>
 
 namespace mms {
 
@@ -12,13 +11,21 @@ public:
     static void init(const QString& imageFile);
     static FontImage* get();
     QString imageFilePath();
-    QMap<QChar, QPair<double, double>> positions();
+
+    // The font image is a single row of glyphs, one for each of the printable
+    // ASCII characters, in order, so that finding a character's glyph is just
+    // arithmetic. Glyph i spans [i / glyphCount, (i + 1) / glyphCount] of the
+    // width of the image.
+    bool contains(QChar c) const;
+    int glyphIndex(QChar c) const;
+    int glyphCount() const;
 
 private:
     FontImage(const QString& imageFile);
     static FontImage* INSTANCE;
+    static const char FIRST_CHARACTER = ' ';
+    static const char LAST_CHARACTER = '~';
     QString m_imageFilePath;
-    QMap<QChar, QPair<double, double>> m_positions;
 
 };
 
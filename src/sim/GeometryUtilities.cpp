@@ -1,12 +1,12 @@
 #include "GeometryUtilities.h"
 
-#include <QPair>
 #include <QtMath>
 
 #include <algorithm>
-#include <functional>
+#include <limits>
 
 #include "Assert.h"
+#include "Transform.h"
 #include "units/Polar.h"
 
 namespace mms {
@@ -16,28 +16,26 @@ Cartesian GeometryUtilities::translateVertex(const Cartesian& vertex, const Coor
 }
 
 Cartesian GeometryUtilities::rotateVertexAroundPoint(const Cartesian& vertex, const Angle& angle, const Coordinate& point) {
-    Cartesian relativeVertex(
-        vertex.getX() - point.getX(),
-        vertex.getY() - point.getY()
-    );
-    Polar rotatedRelativeVertex(
-        relativeVertex.getRho(),
-        relativeVertex.getTheta() + angle
-    );
-    Cartesian rotatedVertex(
-        rotatedRelativeVertex.getX() + point.getX(),
-        rotatedRelativeVertex.getY() + point.getY()
-    );
-    return rotatedVertex;
+    return rotateVertexAroundPoint(
+        vertex.getVector(),
+        angle.getCos(),
+        angle.getSin(),
+        point.getVector());
+}
+
+units::Vector GeometryUtilities::rotateVertexAroundPoint(
+        units::Vector vertex, double cosAngle, double sinAngle, units::Vector point) {
+    return Transform::rotationAround(cosAngle, sinAngle, point).apply(vertex);
 }
 
 Polygon GeometryUtilities::createCirclePolygon(const Cartesian& position, const Distance& radius, int numberOfEdges) {
     ASSERT_LE(3, numberOfEdges);
-    QVector<Cartesian> vertices;
+    Polygon::VertexArray vertices;
     for (int i = 0; i < numberOfEdges; i += 1) {
-        vertices.push_back(Polar(radius, Radians(i * 2 * M_PI / numberOfEdges)) + position);
+        vertices.append(Polar(radius, Radians(i * 2 * M_PI / numberOfEdges)) + position);
     }
-    return Polygon(vertices);
+    // A circle is convex, and thus star-shaped about any of its vertices
+    return Polygon::starShaped(vertices);
 }
 
 MetersSquared GeometryUtilities::crossProduct(const Cartesian& Z, const Cartesian& A, const Cartesian& B) {
@@ -100,22 +98,24 @@ Polygon GeometryUtilities::convexHull(const QVector<Polygon>& polygons) {
 Cartesian GeometryUtilities::castRay(
         const Cartesian& start, const Cartesian& end, const Maze& maze,
         const Meters& halfWallWidth, const Meters& tileLength) {
+    return castRay(
+        start.getVector(),
+        end.getVector(),
+        maze,
+        units::Length(halfWallWidth.getMeters()),
+        units::Length(tileLength.getMeters()));
+}
+
+units::Vector GeometryUtilities::castRay(
+        units::Vector start, units::Vector end, const Maze& maze,
+        units::Length halfWallWidth, units::Length tileLength) {
 
     // This is an implementation of ray-casting, a quick way to determine the
     // first object with which a ray collides. It relies on the fact that we
     // know where the walls are ahead of time.
 
-    // First, determine the difference between the points. This allows us to
-    // determine the direction of the ray, and thus the logical starting and
-    // ending tiles (different from the actual starting and ending tiles).
-    Meters dx = end.getX() - start.getX();
-    Meters dy = end.getY() - start.getY();
-
-    // Determine the direction of the ray
-    QPair<int, int> direction = {
-        (0 < dx.getMeters() ? 1 : -1),
-        (0 < dy.getMeters() ? 1 : -1)
-    };
+    // The direction of the ray determines the logical starting and ending
+    // tiles (different from the actual starting and ending tiles).
 
     //  Logical Tiles
     //  =============
@@ -167,96 +167,288 @@ Cartesian GeometryUtilities::castRay(
     // boundaries to align with QRST. The same follows for south east and south
     // west rays, and IJKL and MNOP, respectively.
 
+    // Since the direction of the ray determines the logical tile boundaries,
+    // the walls to inspect, and which way to step, the loop is specialized for
+    // each of the four directions, so that it has no branches other than the
+    // ones that decide where the ray goes next
+    bool east = 0 < (end.x() - start.x()).value();
+    bool north = 0 < (end.y() - start.y()).value();
+    if (east) {
+        return (north
+            ? castRayInQuadrant<1, 1>(start, end, maze, halfWallWidth, tileLength)
+            : castRayInQuadrant<1, -1>(start, end, maze, halfWallWidth, tileLength));
+    }
+    return (north
+        ? castRayInQuadrant<-1, 1>(start, end, maze, halfWallWidth, tileLength)
+        : castRayInQuadrant<-1, -1>(start, end, maze, halfWallWidth, tileLength));
+}
+
+template <int DX, int DY>
+units::Vector GeometryUtilities::castRayInQuadrant(
+        units::Vector start, units::Vector end, const Maze& maze,
+        units::Length halfWallWidth, units::Length tileLength) {
+
+    // Everything below is in meters, and positions along the ray are given as
+    // fractions of its length, i.e., 0.0 is the start and 1.0 is the end
+    double h = halfWallWidth.value();
+    double t = tileLength.value();
+    double x0 = start.x().value();
+    double y0 = start.y().value();
+    double dx = end.x().value() - x0;
+    double dy = end.y().value() - y0;
+
     // We want to shift the walls in the opposite direction of the ray
-    Cartesian logicalShift = Cartesian(
-        halfWallWidth * direction.first  * -1,
-        halfWallWidth * direction.second * -1
-    );
-
-    // The current x and y positions that are tracked in the loop
-    Meters cx = start.getX();
-    Meters cy = start.getY();
-
-    // Determine the logical starting tile
-    int sx = static_cast<int>(std::floor((start - logicalShift).getX() / tileLength));
-    int sy = static_cast<int>(std::floor((start - logicalShift).getY() / tileLength)); 
-
-    // The initial integer tile offset from the starting tile
-    int px = (direction.first  == 1 ? 1 : 0);
-    int py = (direction.second == 1 ? 1 : 0);
-
-    // The current integer tile offset from the starting tile
-    int ox = px;
-    int oy = py;
-
-    // The increment to take on the offset values
-    int ix = direction.first;
-    int iy = direction.second;
-
-    // The x and y values of the next potential collision
-    Meters nx = tileLength * (sx + ox) + logicalShift.getX();
-    Meters ny = tileLength * (sy + oy) + logicalShift.getY();
-
-    // The direction of wall to inspect for a potential collision
-    Direction wx = (direction.first  == 1 ? Direction::EAST  : Direction::WEST );
-    Direction wy = (direction.second == 1 ? Direction::NORTH : Direction::SOUTH);
-
-    // The x and y conditions on which to continue looping
-    static std::function<bool(const Meters&, const Meters&)> east = [](const Meters& nx, const Meters& ex) {
-        return nx < ex;
-    };
-    static std::function<bool(const Meters&, const Meters&)> west = [](const Meters& nx, const Meters& ex) {
-        return ex < nx;
-    };
-    static std::function<bool(const Meters&, const Meters&)> north = [](const Meters& ny, const Meters& ey) {
-        return ny < ey;
-    };
-    static std::function<bool(const Meters&, const Meters&)> south = [](const Meters& ny, const Meters& ey) {
-        return ey < ny;
-    };
-    std::function<bool(const Meters&, const Meters&)>* bx = (direction.first  == 1 ? &east  : &west );
-    std::function<bool(const Meters&, const Meters&)>* by = (direction.second == 1 ? &north : &south);
+    double shiftX = -h * DX;
+    double shiftY = -h * DY;
+
+    // The logical tile containing the start of the ray; as the ray progresses,
+    // this is always the tile on the near side of the next x and y boundaries
+    int x = static_cast<int>(std::floor((x0 - shiftX) / t));
+    int y = static_cast<int>(std::floor((y0 - shiftY) / t));
+
+    // The x and y values of the next potential collisions
+    double nx = t * (x + (DX == 1 ? 1 : 0)) + shiftX;
+    double ny = t * (y + (DY == 1 ? 1 : 0)) + shiftY;
+
+    // The positions along the ray of the next potential collisions, and the
+    // distance along the ray between consecutive ones; a ray that's parallel
+    // to an axis never reaches the boundaries perpendicular to that axis
+    double inf = std::numeric_limits<double>::infinity();
+    double tMaxX = (dx == 0.0 ? inf : (nx - x0) / dx);
+    double tMaxY = (dy == 0.0 ? inf : (ny - y0) / dy);
+    double tDeltaX = (dx == 0.0 ? inf : t / (dx * DX));
+    double tDeltaY = (dy == 0.0 ? inf : t / (dy * DY));
+
+    // The walls to inspect for a potential collision
+    const quint8 wallX = 1 << static_cast<int>(DX == 1 ? Direction::EAST : Direction::WEST);
+    const quint8 wallY = 1 << static_cast<int>(DY == 1 ? Direction::NORTH : Direction::SOUTH);
+    const quint8* walls = maze.getWallMasks().constData();
+    unsigned int width = maze.getWidth();
+    unsigned int height = maze.getHeight();
+
+    // The ray hits a corner (i.e., a post) if it crosses a boundary within a
+    // wall width of the previous boundary in the other direction. Since the
+    // ray is always between the previous and next boundaries, this is just a
+    // comparison, rather than a modulo. Note that, for consistency with the
+    // original implementation, everything at negative x or y is a corner.
+    double wallLength = t - 2 * h;
 
     // Loop until we've exhausted the entirety of the ray
-    while ((*bx)(nx, end.getX()) || (*by)(ny, end.getY())) {
+    while (tMaxX < 1.0 || tMaxY < 1.0) {
 
         // x collision will happen first
-        if (std::abs((nx - cx) / dx) < std::abs((ny - cy) / dy)) {
-            cy = cy + (nx - cx) * (dy / dx);
-            cx = nx;
-            int x = sx + ox - px;
-            int y = sy + oy - py;
-            if (isOnTileEdge(cy, halfWallWidth, tileLength) ||
-                    (maze.withinMaze(x, y) && maze.getTile(x, y)->isWall(wx))) {
-                return Cartesian(cx, cy);
+        if (tMaxX < tMaxY) {
+            double cy = y0 + tMaxX * dy;
+            if (cy < 0.0 || wallLength < (ny - cy) * DY || (
+                    static_cast<unsigned int>(x) < width &&
+                    static_cast<unsigned int>(y) < height &&
+                    (walls[x * height + y] & wallX))) {
+                return units::Vector(units::Length(nx), units::Length(cy));
             }
-            ox += ix;
-            nx = tileLength * (sx + ox) + logicalShift.getX();
+            x += DX;
+            nx += t * DX;
+            tMaxX += tDeltaX;
         }
 
         // y collision will happen first
         else {
-            cx = cx + (ny - cy) * (dx / dy);
-            cy = ny;
-            int x = sx + ox - px;
-            int y = sy + oy - py;
-            if (isOnTileEdge(cx, halfWallWidth, tileLength) ||
-                    (maze.withinMaze(x, y) && maze.getTile(x, y)->isWall(wy))) {
-                return Cartesian(cx, cy);
+            double cx = x0 + tMaxY * dx;
+            if (cx < 0.0 || wallLength < (nx - cx) * DX || (
+                    static_cast<unsigned int>(x) < width &&
+                    static_cast<unsigned int>(y) < height &&
+                    (walls[x * height + y] & wallY))) {
+                return units::Vector(units::Length(cx), units::Length(ny));
             }
-            oy += iy;
-            ny = tileLength * (sy + oy) + logicalShift.getY();
+            y += DY;
+            ny += t * DY;
+            tMaxY += tDeltaY;
         }
     }
 
     return end;
 }
 
-bool GeometryUtilities::isOnTileEdge(
-        const Meters& position, const Meters& halfWallWidth, const Meters& tileLength) {
-    Meters tileLengthMinusHalfWallWidth = tileLength - halfWallWidth;
-    Meters mod = Meters(std::fmod(position.getMeters(), tileLength.getMeters()));
-    return (mod < halfWallWidth || tileLengthMinusHalfWallWidth < mod);
+units::Area GeometryUtilities::getVisibleConeArea(
+        units::Vector apex, units::Angle direction, units::Angle halfWidth,
+        units::Length range, const Maze& maze,
+        units::Length halfWallWidth, units::Length tileLength) {
+
+    // The walls and posts are axis-aligned rectangles with disjoint interiors
+    // (see the diagram in castRay). Only the faces of the rectangles that
+    // face the apex can be seen, and since the interiors are disjoint, those
+    // faces never cross except at their endpoints. Thus, if we sort the
+    // angles at which the nearest obstacle can change - the endpoints of the
+    // faces, and the points where the faces cross the edge of the range - the
+    // same face (or the edge of the range) is nearest throughout each of the
+    // resulting angular intervals. The visible area within an interval is
+    // then either a triangle or a sector of a circle, each of which we can
+    // compute exactly. Everything below is in meters and radians, relative to
+    // the apex.
+
+    // A face of a rectangle, either horizontal (y == c, for x in [lo, hi]) or
+    // vertical (x == c, for y in [lo, hi])
+    struct Face {
+        bool horizontal;
+        double c;
+        double lo;
+        double hi;
+    };
+
+    double r = range.value();
+    double h = halfWallWidth.value();
+    double t = tileLength.value();
+    double ax = apex.x().value();
+    double ay = apex.y().value();
+
+    // The faces, and the angles below, are kept from call to call so that,
+    // once they've grown to fit the busiest part of the maze, a reading
+    // doesn't touch the heap; they're per thread since each model simulates
+    // (and thus reads its sensors) on a thread of its own
+    static thread_local QVector<Face> faces;
+    static thread_local QVector<double> angles;
+    faces.clear();
+    angles.clear();
+
+    // Collect the faces of the nearby rectangles that face the apex; if the
+    // apex is inside an obstacle, then the sensor is completely blocked
+    bool apexIsBlocked = false;
+    auto addRectangle = [&](double x0, double x1, double y0, double y1) {
+        x0 -= ax;
+        x1 -= ax;
+        y0 -= ay;
+        y1 -= ay;
+        double nearestX = std::max(x0, std::min(0.0, x1));
+        double nearestY = std::max(y0, std::min(0.0, y1));
+        if (r * r < nearestX * nearestX + nearestY * nearestY) {
+            return;
+        }
+        if (x0 < 0 && 0 < x1 && y0 < 0 && 0 < y1) {
+            apexIsBlocked = true;
+        }
+        if (0 <= y0) {
+            faces.append({true, y0, x0, x1});
+        }
+        if (y1 <= 0) {
+            faces.append({true, y1, x0, x1});
+        }
+        if (0 <= x0) {
+            faces.append({false, x0, y0, y1});
+        }
+        if (x1 <= 0) {
+            faces.append({false, x1, y0, y1});
+        }
+    };
+    auto hasWall = [&](int x, int y, Direction direction) {
+        return maze.withinMaze(x, y) && maze.getTile(x, y)->isWall(direction);
+    };
+    int i0 = static_cast<int>(std::floor((ax - r) / t));
+    int i1 = static_cast<int>(std::ceil((ax + r) / t));
+    int j0 = static_cast<int>(std::floor((ay - r) / t));
+    int j1 = static_cast<int>(std::ceil((ay + r) / t));
+    for (int i = i0; i <= i1; i += 1) {
+        for (int j = j0; j <= j1; j += 1) {
+            // The post at the corner of tiles (i - 1, j - 1) and (i, j)
+            addRectangle(i * t - h, i * t + h, j * t - h, j * t + h);
+            // The wall between tiles (i - 1, j) and (i, j)
+            if (hasWall(i - 1, j, Direction::EAST) || hasWall(i, j, Direction::WEST)) {
+                addRectangle(i * t - h, i * t + h, j * t + h, (j + 1) * t - h);
+            }
+            // The wall between tiles (i, j - 1) and (i, j)
+            if (hasWall(i, j - 1, Direction::NORTH) || hasWall(i, j, Direction::SOUTH)) {
+                addRectangle(i * t + h, (i + 1) * t - h, j * t - h, j * t + h);
+            }
+        }
+    }
+    if (apexIsBlocked) {
+        return units::Area(0.0);
+    }
+
+    // The angles are all measured from the start of the cone, in [0, 2pi)
+    double start = direction.value() - halfWidth.value();
+    double width = std::min(2 * halfWidth.value(), 2 * M_PI);
+    auto addAngleOf = [&](double x, double y, QVector<double>* angles) {
+        double angle = std::fmod(std::atan2(y, x) - start, 2 * M_PI);
+        if (angle < 0) {
+            angle += 2 * M_PI;
+        }
+        if (angle < width) {
+            angles->append(angle);
+        }
+    };
+    angles.append(0.0);
+    angles.append(width);
+    for (const Face& face : faces) {
+        // The endpoints of the face, and where it crosses the edge of the range
+        double points[4] = {face.lo, face.hi};
+        int numPoints = 2;
+        double crossing = r * r - face.c * face.c;
+        if (0 < crossing) {
+            points[numPoints++] = -std::sqrt(crossing);
+            points[numPoints++] = std::sqrt(crossing);
+        }
+        for (int p = 0; p < numPoints; p += 1) {
+            double u = points[p];
+            if (u < face.lo || face.hi < u) {
+                continue;
+            }
+            if (face.horizontal) {
+                addAngleOf(u, face.c, &angles);
+            }
+            else {
+                addAngleOf(face.c, u, &angles);
+            }
+        }
+    }
+    std::sort(angles.begin(), angles.end());
+
+    // Sum the visible area of each interval
+    double area = 0.0;
+    for (int k = 0; k + 1 < angles.size(); k += 1) {
+        double a = start + angles.at(k);
+        double b = start + angles.at(k + 1);
+        if (b - a < 1e-12) {
+            continue;
+        }
+
+        // Find the nearest face in the middle of the interval
+        double cosMiddle = std::cos((a + b) / 2.0);
+        double sinMiddle = std::sin((a + b) / 2.0);
+        double nearestDistance = r;
+        const Face* nearest = nullptr;
+        for (const Face& face : faces) {
+            double denominator = (face.horizontal ? sinMiddle : cosMiddle);
+            if (denominator == 0.0) {
+                continue;
+            }
+            double distance = face.c / denominator;
+            if (distance <= 0.0 || nearestDistance <= distance) {
+                continue;
+            }
+            double u = distance * (face.horizontal ? cosMiddle : sinMiddle);
+            if (face.lo <= u && u <= face.hi) {
+                nearestDistance = distance;
+                nearest = &face;
+            }
+        }
+
+        // Nothing is in the way, so the area is a sector of the range circle
+        if (nearest == nullptr) {
+            area += r * r * (b - a) / 2.0;
+        }
+
+        // Otherwise it's the triangle between the apex and the face
+        else {
+            double cosA = std::cos(a);
+            double sinA = std::sin(a);
+            double cosB = std::cos(b);
+            double sinB = std::sin(b);
+            double distanceA = nearest->c / (nearest->horizontal ? sinA : cosA);
+            double distanceB = nearest->c / (nearest->horizontal ? sinB : cosB);
+            area += distanceA * distanceB * std::abs(cosA * sinB - sinA * cosB) / 2.0;
+        }
+    }
+
+    return units::Area(area);
 }
 
 } // namespace mms
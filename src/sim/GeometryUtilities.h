@@ -6,6 +6,7 @@
 #include "units/Cartesian.h"
 #include "units/Distance.h"
 #include "units/MetersSquared.h"
+#include "units/Quantity.h"
 
 namespace mms {
 
@@ -22,6 +23,11 @@ public:
     // Returns the result of rotating the vertex around point by the amount specified by angle
     static Cartesian rotateVertexAroundPoint(const Cartesian& vertex, const Angle& angle, const Coordinate& point);
 
+    // Same as above, but given the cosine and sine of the angle, so that they
+    // may be computed just once when rotating many vertices by the same angle
+    static units::Vector rotateVertexAroundPoint(
+        units::Vector vertex, double cosAngle, double sinAngle, units::Vector point);
+
     // Creates a circle polygon
     static Polygon createCirclePolygon(const Cartesian& position, const Distance& radius, int numberOfEdges);
 
@@ -36,10 +42,26 @@ public:
     static Cartesian castRay(
         const Cartesian& start, const Cartesian& end, const Maze& maze,
         const Meters& halfWallWidth, const Meters& tileLength);
+    static units::Vector castRay(
+        units::Vector start, units::Vector end, const Maze& maze,
+        units::Length halfWallWidth, units::Length tileLength);
+
+    // Returns the exact area of the part of the view cone (i.e., the circular
+    // sector with the given apex, direction, half width, and range) that's
+    // visible from its apex, and not hidden behind the walls or posts of maze
+    static units::Area getVisibleConeArea(
+        units::Vector apex, units::Angle direction, units::Angle halfWidth,
+        units::Length range, const Maze& maze,
+        units::Length halfWallWidth, units::Length tileLength);
+
+private:
 
-    // Returns true if position is located on the edge of a tile, based on halfWallWidth and tileLength
-    static bool isOnTileEdge(
-        const Meters& position, const Meters& halfWallWidth, const Meters& tileLength);
+    // The implementation of castRay, specialized for rays that travel in the
+    // direction (DX, DY), where each of DX and DY is either 1 or -1
+    template <int DX, int DY>
+    static units::Vector castRayInQuadrant(
+        units::Vector start, units::Vector end, const Maze& maze,
+        units::Length halfWallWidth, units::Length tileLength);
 };
 
 } // namespace mms
@@ -1,14 +1,34 @@
 #include "Map.h"
 
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
 #include <QPair>
+#include <QPointF>
+#include <QSurfaceFormat>
+#include <QMatrix4x4>
+#include <QMutexLocker>
+#include <QVector2D>
+#include <QVector3D>
+#include <QVector4D>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
 
 #include "Assert.h"
+#include "Color.h"
 #include "FontImage.h"
 #include "Layout.h"
 #include "Logging.h"
 #include "Param.h"
 #include "Screen.h"
+#include "TileInstance.h"
+#include "TileMeshVertex.h"
+#include "TileTextCharacter.h"
 #include "TransformationMatrix.h"
+#include "VertexGraphic.h"
+#include "VertexTexture.h"
 
 namespace mms {
 
@@ -21,32 +41,55 @@ Map::Map(QWidget* parent) :
         m_windowHeight(0),
         m_layoutType(LayoutType::FULL),
         m_zoomedMapScale(0.1),
-        m_rotateZoomedMap(false) {
+        m_rotateZoomedMap(false),
+        m_tilesInstanced(false),
+        m_polygonVBOCapacity(0),
+        m_textureVBOCapacity(0),
+        m_uploadedGraphicTriangles(-1),
+        m_uploadedTextureTriangles(-1),
+        m_tileInstanceVBOCapacity(0),
+        m_uploadedTileInstances(-1),
+        m_uploadedMouseTriangles(-1),
+        m_tileTextVBOCapacity(0),
+        m_uploadedTileTextCharacters(-1),
+        m_tileInstanceAttributesFirstInstance(-1),
+        m_tileTextAttributesFirstTile(-1),
+        m_tileTextAttributesCharactersPerTile(-1),
+        m_drawnMouseAppearanceVersion(-1) {
 
     // The Map widget should only ever be constructed once
     ASSERT_RUNS_JUST_ONCE();
 
-    // Continuously refresh the widget
-    connect(
-        &m_timer, &QTimer::timeout,
-        this, static_cast<void (Map::*)()>(&Map::update)
-    );
-    // TODO: upforgrabs
-    // Make this configurable
-    m_timer.start(24); // 45 fps
+    // Sync buffer swaps to the display's refresh
+    QSurfaceFormat surfaceFormat = format();
+    surfaceFormat.setSwapInterval(1);
+    setFormat(surfaceFormat);
+
+    // Check for changes at the max frame rate, but only repaint the widget if
+    // something actually changed, so that an idle map costs (almost) nothing
+    connect(&m_timer, &QTimer::timeout, this, &Map::updateIfChanged);
+    m_timer.start(qRound(1000.0 / P()->maxFrameRate()));
 }
 
 void Map::setMaze(const Maze* maze) {
     ASSERT_TR(m_mouseGraphic == nullptr);
     m_maze = maze;
     m_view = nullptr;
+    update();
 }
 
-void Map::setView(const MazeView* view) {
+void Map::setView(MazeView* view) {
     if (view != nullptr) {
         ASSERT_FA(m_maze == nullptr);
     }
     m_view = view;
+    // The buffers hold the old view's triangles, so the next frame must
+    // upload all of the new view's triangles
+    m_uploadedGraphicTriangles = -1;
+    m_uploadedTextureTriangles = -1;
+    m_uploadedTileInstances = -1;
+    m_uploadedTileTextCharacters = -1;
+    update();
 }
 
 void Map::setMouseGraphic(const MouseGraphic* mouseGraphic) {
@@ -55,18 +98,33 @@ void Map::setMouseGraphic(const MouseGraphic* mouseGraphic) {
         ASSERT_FA(m_view == nullptr);
     }
     m_mouseGraphic = mouseGraphic;
+    m_uploadedMouseTriangles = -1;
+    update();
 }
 
 void Map::setLayoutType(LayoutType layoutType) {
     m_layoutType = layoutType;
+    update();
 }
 
 void Map::setZoomedMapScale(double zoomedMapScale) {
     m_zoomedMapScale = zoomedMapScale;
+    update();
 }
 
 void Map::setRotateZoomedMap(bool rotateZoomedMap) {
     m_rotateZoomedMap = rotateZoomedMap;
+    update();
+}
+
+void Map::updateIfChanged() {
+    bool viewChanged = m_view != nullptr && m_view->isDirty();
+    bool mouseChanged =
+        m_mouseGraphic != nullptr &&
+        m_mouseGraphic->getAppearanceVersion() != m_drawnMouseAppearanceVersion;
+    if (viewChanged || mouseChanged) {
+        update();
+    }
 }
 
 QVector<QString> Map::getOpenGLVersionInfo() {
@@ -126,6 +184,13 @@ void Map::initializeGL() {
     // Initialize the polygon and texture programs
     initPolygonProgram();
     initTextureProgram();
+
+    // Draw the tiles as instances, if possible
+    m_tilesInstanced = isInstancingSupported();
+    if (m_tilesInstanced) {
+        initTileProgram();
+        initTileTextProgram();
+    }
 }
 
 void Map::paintGL() {
@@ -138,18 +203,22 @@ void Map::paintGL() {
 
     Cartesian currentMouseTranslation;
     Radians currentMouseRotation;
-    QVector<TriangleGraphic> mouseBuffer;
+    m_mouseBuffer.clear();
     if (m_mouseGraphic != nullptr) {
+        // Note that we get the version before the position, so that we never
+        // miss a change that happens in between
+        m_drawnMouseAppearanceVersion = m_mouseGraphic->getAppearanceVersion();
         auto currentPosition = m_mouseGraphic->getCurrentMousePosition();
         currentMouseTranslation = currentPosition.first;
         currentMouseRotation = currentPosition.second;
-        mouseBuffer = m_mouseGraphic->draw(
+        m_mouseGraphic->draw(
             currentMouseTranslation,
-            currentMouseRotation);
+            currentMouseRotation,
+            &m_mouseBuffer);
     }
 
     // Re-populate both vertex buffer objects
-    repopulateVertexBufferObjects(mouseBuffer);
+    repopulateVertexBufferObjects(m_mouseBuffer);
 
     // Clear the screen
     glClear(GL_COLOR_BUFFER_BIT);
@@ -157,40 +226,101 @@ void Map::paintGL() {
     // Enable scissoring so that the maps are only draw in specified locations.
     glEnable(GL_SCISSOR_TEST);
 
-    // Determine the starting index of the mouse
-    int mouseTrianglesStartingIndex = m_view->getGraphicCpuBuffer()->size();
+    // Determine the starting index of the mouse. Note that the view's
+    // buffers may only be read with its mutex held, so we use the sizes that
+    // were just uploaded instead.
+    int mouseTrianglesStartingIndex = m_uploadedGraphicTriangles;
 
-    // Draw the tiles
-    drawMap(
-        m_layoutType,
-        currentMouseTranslation,
-        currentMouseRotation,
-        &m_polygonProgram,
-        &m_polygonVAO,
-        0,
-        3 * m_view->getGraphicCpuBuffer()->size()
-    );
+    // Every tile has the same number of triangles, so that only the tiles
+    // that are visible have to be drawn
+    int numTiles = m_maze->getWidth() * m_maze->getHeight();
 
-    // Overlay the tile text
-    drawMap(
-        m_layoutType,
-        currentMouseTranslation,
-        currentMouseRotation,
-        &m_textureProgram,
-        &m_textureVAO,
-        0,
-        3 * m_view->getTextureCpuBuffer()->size()
-    );
+    // Draw the tiles; for the tile program, the mesh is drawn once per tile
+    if (m_tilesInstanced) {
+        int meshVertices = m_view->getTileMeshCpuBuffer()->size();
+        drawMap(
+            m_layoutType,
+            currentMouseTranslation,
+            currentMouseRotation,
+            &m_tileProgram,
+            &m_tileVAO,
+            0,
+            meshVertices,
+            meshVertices
+        );
+    }
+    else {
+        drawMap(
+            m_layoutType,
+            currentMouseTranslation,
+            currentMouseRotation,
+            &m_polygonProgram,
+            &m_polygonVAO,
+            0,
+            3 * mouseTrianglesStartingIndex,
+            3 * mouseTrianglesStartingIndex / numTiles
+        );
+    }
+
+    // Overlay the tile text; for the tile text program, the quad is drawn
+    // once per character
+    if (m_tilesInstanced) {
+        drawMap(
+            m_layoutType,
+            currentMouseTranslation,
+            currentMouseRotation,
+            &m_tileTextProgram,
+            &m_tileTextVAO,
+            0,
+            6,
+            6
+        );
+    }
+    else {
+        drawMap(
+            m_layoutType,
+            currentMouseTranslation,
+            currentMouseRotation,
+            &m_textureProgram,
+            &m_textureVAO,
+            0,
+            3 * m_uploadedTextureTriangles,
+            3 * m_uploadedTextureTriangles / numTiles
+        );
+    }
 
-    // Draw the mouse
+    // Draw the mouse: first the rigid parts, which are moved into place by
+    // the model matrix, and then the parts that change shape
+    if (m_mouseGraphic != nullptr) {
+        Transform transform = m_mouseGraphic->getCurrentTransform(
+            currentMouseTranslation,
+            currentMouseRotation);
+        QMatrix4x4 modelMatrix(
+            transform.xx(), transform.xy(), 0.0, transform.translation().x().value(),
+            transform.yx(), transform.yy(), 0.0, transform.translation().y().value(),
+            0.0, 0.0, 1.0, 0.0,
+            0.0, 0.0, 0.0, 1.0
+        );
+        drawMap(
+            m_layoutType,
+            currentMouseTranslation,
+            currentMouseRotation,
+            &m_polygonProgram,
+            &m_mouseVAO,
+            0,
+            3 * m_mouseGraphic->getStaticTriangles()->size(),
+            0,
+            modelMatrix
+        );
+    }
     drawMap(
         m_layoutType,
         currentMouseTranslation,
         currentMouseRotation,
         &m_polygonProgram,
         &m_polygonVAO,
-        3 * m_view->getGraphicCpuBuffer()->size(),
-        3 * mouseBuffer.size()
+        3 * mouseTrianglesStartingIndex,
+        3 * m_mouseBuffer.size()
     );
 
     // Disable scissoring so that the glClear can take effect, and so that
@@ -209,11 +339,12 @@ void Map::initPolygonProgram() {
         QOpenGLShader::Vertex,
         R"(
             uniform mat4 transformationMatrix;
+            uniform mat4 modelMatrix;
             attribute vec2 coordinate;
             attribute vec4 inColor;
             varying vec4 outColor;
             void main(void) {
-                gl_Position = transformationMatrix * vec4(coordinate, 0.0, 1.0);
+                gl_Position = transformationMatrix * modelMatrix * vec4(coordinate, 0.0, 1.0);
                 outColor = inColor;
             }
         )"
@@ -230,34 +361,48 @@ void Map::initPolygonProgram() {
     m_polygonProgram.link();
     m_polygonProgram.bind();
 
-    m_polygonVAO.create();
-    m_polygonVAO.bind();
+    // The rigid parts of the mouse have their own buffer, since they're only
+    // uploaded once per mouse, and are then moved by the model matrix
+    initPolygonVertexArrayObject(&m_polygonVAO, &m_polygonVBO, QOpenGLBuffer::DynamicDraw);
+    initPolygonVertexArrayObject(&m_mouseVAO, &m_mouseVBO, QOpenGLBuffer::StaticDraw);
 
-    m_polygonVBO.create();
-    m_polygonVBO.bind();
-    m_polygonVBO.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_polygonProgram.release();
+}
+
+void Map::initPolygonVertexArrayObject(
+        QOpenGLVertexArrayObject* vao,
+        QOpenGLBuffer* vbo,
+        QOpenGLBuffer::UsagePattern usagePattern) {
+
+    vao->create();
+    vao->bind();
+
+    vbo->create();
+    vbo->bind();
+    vbo->setUsagePattern(usagePattern);
 
     m_polygonProgram.enableAttributeArray("coordinate");
     m_polygonProgram.setAttributeBuffer(
         "coordinate", // name
-        GL_DOUBLE, // type
+        GL_FLOAT, // type
         0, // offset (bytes)
         2, // tupleSize (number of elements in the attribute array)
-        6 * sizeof(double) // stride (bytes between vertices)
+        sizeof(VertexGraphic) // stride (bytes between vertices)
     );
 
+    // Note that QOpenGLShaderProgram always normalizes integer attributes, so
+    // the color bytes arrive in the shader as values in [0.0, 1.0]
     m_polygonProgram.enableAttributeArray("inColor");
     m_polygonProgram.setAttributeBuffer(
         "inColor", // name
-        GL_DOUBLE, // type
-        2 * sizeof(double), // offset (bytes)
+        GL_UNSIGNED_BYTE, // type
+        2 * sizeof(float), // offset (bytes)
         4, // tupleSize (number of elements in the attribute array)
-        6 * sizeof(double) // stride (bytes between vertices)
+        sizeof(VertexGraphic) // stride (bytes between vertices)
     );
 
-    m_polygonVBO.release();
-    m_polygonVAO.release();
-    m_polygonProgram.release();
+    vbo->release();
+    vao->release();
 }
 
 void Map::initTextureProgram() {
@@ -298,19 +443,19 @@ void Map::initTextureProgram() {
     m_textureProgram.enableAttributeArray("coordinate");
     m_textureProgram.setAttributeBuffer(
         "coordinate", // name
-        GL_DOUBLE, // type
+        GL_FLOAT, // type
         0, // offset (bytes)
         2, // tupleSize (number of elements in the attribute array)
-        4 * sizeof(double) // stride (bytes between vertices)
+        sizeof(VertexTexture) // stride (bytes between vertices)
     );
 
     m_textureProgram.enableAttributeArray("inTextureCoordinate");
     m_textureProgram.setAttributeBuffer(
         "inTextureCoordinate", // name
-        GL_DOUBLE, // type
-        2 * sizeof(double), // offset (bytes)
+        GL_FLOAT, // type
+        2 * sizeof(float), // offset (bytes)
         2, // tupleSize (number of elements in the attribute array)
-        4 * sizeof(double) // stride (bytes between vertices)
+        sizeof(VertexTexture) // stride (bytes between vertices)
     );
 
     // Load the bitmap texture into the texture atlas
@@ -322,37 +467,425 @@ void Map::initTextureProgram() {
     m_polygonProgram.release();
 }
 
-void Map::repopulateVertexBufferObjects(const QVector<TriangleGraphic>& mouseBuffer) {
+bool Map::isInstancingSupported() {
+    QOpenGLContext* glContext = context();
+    QPair<int, int> version = glContext->format().version();
+    return glContext->isOpenGLES()
+        ? qMakePair(3, 0) <= version
+        : qMakePair(3, 3) <= version;
+}
 
-    // Overwrite the polygon vertex buffer object data
-    m_polygonVBO.bind();
-    m_polygonVBO.allocate(sizeof(TriangleGraphic) * (
-        m_view->getGraphicCpuBuffer()->size() +
-        mouseBuffer.size()
-    ));
-    // Write the maze
-    m_polygonVBO.write(
-        0,
-        &(m_view->getGraphicCpuBuffer()->front()),
-        sizeof(TriangleGraphic) * m_view->getGraphicCpuBuffer()->size()
+void Map::initTileProgram() {
+
+    // Each vertex of the mesh picks its color from the tile's instance, by
+    // way of the selectors (each of which is a one-hot vector), and is moved
+    // outward if the tile is on the edge of the maze
+    m_tileProgram.addShaderFromSourceCode(
+        QOpenGLShader::Vertex,
+        R"(
+            uniform mat4 transformationMatrix;
+            uniform vec4 cornerColor;
+            uniform vec3 fogColor;
+            attribute vec2 coordinate;
+            attribute vec4 edgeOffsets;
+            attribute vec4 wallSelector;
+            attribute vec4 partSelector;
+            attribute vec2 tilePosition;
+            attribute vec4 tileBase;
+            attribute vec4 northWall;
+            attribute vec4 eastWall;
+            attribute vec4 southWall;
+            attribute vec4 westWall;
+            attribute vec4 tileEdges;
+            varying vec4 outColor;
+            void main(void) {
+                vec2 offset = vec2(
+                    dot(edgeOffsets.xy, tileEdges.xy),
+                    dot(edgeOffsets.zw, tileEdges.zw));
+                gl_Position = transformationMatrix *
+                    vec4(tilePosition + coordinate + offset, 0.0, 1.0);
+                outColor =
+                    partSelector.x * vec4(tileBase.rgb, 1.0) +
+                    mat4(northWall, eastWall, southWall, westWall) * wallSelector +
+                    partSelector.y * cornerColor +
+                    partSelector.z * vec4(fogColor, tileBase.a);
+            }
+        )"
+    );
+    m_tileProgram.addShaderFromSourceCode(
+        QOpenGLShader::Fragment,
+        R"(
+            varying vec4 outColor;
+            void main(void) {
+               gl_FragColor = outColor;
+            }
+        )"
+    );
+    m_tileProgram.link();
+    m_tileProgram.bind();
+
+    // The corners and fog are the same color for every tile
+    RGB cornerColor = COLOR_TO_RGB().value(STRING_TO_COLOR().value(P()->tileCornerColor()));
+    RGB fogColor = COLOR_TO_RGB().value(STRING_TO_COLOR().value(P()->tileFogColor()));
+    m_tileProgram.setUniformValue("cornerColor", QVector4D(cornerColor.r, cornerColor.g, cornerColor.b, 1.0));
+    m_tileProgram.setUniformValue("fogColor", QVector3D(fogColor.r, fogColor.g, fogColor.b));
+
+    m_tileVAO.create();
+    m_tileVAO.bind();
+
+    // The mesh is uploaded along with the first instances of each view
+    m_tileMeshVBO.create();
+    m_tileMeshVBO.bind();
+    m_tileMeshVBO.setUsagePattern(QOpenGLBuffer::StaticDraw);
+
+    m_tileProgram.enableAttributeArray("coordinate");
+    m_tileProgram.setAttributeBuffer(
+        "coordinate", // name
+        GL_FLOAT, // type
+        offsetof(TileMeshVertex, x), // offset (bytes)
+        2, // tupleSize (number of elements in the attribute array)
+        sizeof(TileMeshVertex) // stride (bytes between vertices)
+    );
+    m_tileProgram.enableAttributeArray("edgeOffsets");
+    m_tileProgram.setAttributeBuffer(
+        "edgeOffsets", // name
+        GL_FLOAT, // type
+        offsetof(TileMeshVertex, edgeOffsets), // offset (bytes)
+        4, // tupleSize (number of elements in the attribute array)
+        sizeof(TileMeshVertex) // stride (bytes between vertices)
     );
-    // Write the mouse
-    if (!mouseBuffer.isEmpty()) {
-        m_polygonVBO.write(
-            sizeof(TriangleGraphic) * m_view->getGraphicCpuBuffer()->size(),
-            &(mouseBuffer.front()),
-            sizeof(TriangleGraphic) * mouseBuffer.size()
+    m_tileProgram.enableAttributeArray("wallSelector");
+    m_tileProgram.setAttributeBuffer(
+        "wallSelector", // name
+        GL_UNSIGNED_BYTE, // type
+        offsetof(TileMeshVertex, wallSelector), // offset (bytes)
+        4, // tupleSize (number of elements in the attribute array)
+        sizeof(TileMeshVertex) // stride (bytes between vertices)
+    );
+    m_tileProgram.enableAttributeArray("partSelector");
+    m_tileProgram.setAttributeBuffer(
+        "partSelector", // name
+        GL_UNSIGNED_BYTE, // type
+        offsetof(TileMeshVertex, partSelector), // offset (bytes)
+        4, // tupleSize (number of elements in the attribute array)
+        sizeof(TileMeshVertex) // stride (bytes between vertices)
+    );
+
+    // The instance attributes advance once per tile, rather than per vertex
+    m_tileInstanceVBO.create();
+    m_tileInstanceVBO.bind();
+    m_tileInstanceVBO.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_tileInstanceVBO.release();
+    setTileInstanceAttributeBuffers(0);
+
+    m_tileVAO.release();
+    m_tileProgram.release();
+}
+
+void Map::setTileInstanceAttributeBuffers(int firstInstance) {
+
+    // Only the zoomed map draws a subset of the tiles, so the attributes
+    // usually already point where they should
+    if (firstInstance == m_tileInstanceAttributesFirstInstance) {
+        return;
+    }
+    m_tileInstanceAttributesFirstInstance = firstInstance;
+
+    // Note that this assumes that the program and vertex array object are
+    // bound, and leaves them bound
+    m_tileInstanceVBO.bind();
+    int firstInstanceOffset = sizeof(TileInstance) * firstInstance;
+    static const QVector<QPair<const char*, QPair<GLenum, int>>> instanceAttributes = {
+        // name            type                offset (bytes)
+        {"tilePosition", {GL_FLOAT,         offsetof(TileInstance, x)}},
+        {"tileBase",     {GL_UNSIGNED_BYTE, offsetof(TileInstance, r)}},
+        {"northWall",    {GL_UNSIGNED_BYTE, offsetof(TileInstance, walls) + 0 * 4}},
+        {"eastWall",     {GL_UNSIGNED_BYTE, offsetof(TileInstance, walls) + 1 * 4}},
+        {"southWall",    {GL_UNSIGNED_BYTE, offsetof(TileInstance, walls) + 2 * 4}},
+        {"westWall",     {GL_UNSIGNED_BYTE, offsetof(TileInstance, walls) + 3 * 4}},
+        {"tileEdges",    {GL_UNSIGNED_BYTE, offsetof(TileInstance, edges)}},
+    };
+    QOpenGLExtraFunctions* extraFunctions = context()->extraFunctions();
+    for (const auto& attribute : instanceAttributes) {
+        int location = m_tileProgram.attributeLocation(attribute.first);
+        m_tileProgram.enableAttributeArray(location);
+        m_tileProgram.setAttributeBuffer(
+            location,
+            attribute.second.first, // type
+            firstInstanceOffset + attribute.second.second, // offset (bytes)
+            attribute.second.first == GL_FLOAT ? 2 : 4, // tupleSize
+            sizeof(TileInstance) // stride (bytes between instances)
         );
+        extraFunctions->glVertexAttribDivisor(location, 1);
+    }
+    m_tileInstanceVBO.release();
+}
+
+void Map::initTileTextProgram() {
+
+    // Each vertex is a corner of the unit quad, which is moved to the
+    // character's position, and stretched to the character's size (or
+    // collapsed, if the character isn't visible). Note that the bytes of the
+    // character are normalized, so we scale them back up first.
+    m_tileTextProgram.addShaderFromSourceCode(
+        QOpenGLShader::Vertex,
+        R"(
+            uniform mat4 transformationMatrix;
+            uniform vec2 textOrigin;
+            uniform vec2 characterSize;
+            uniform float glyphCount;
+            attribute vec2 corner;
+            attribute vec2 tilePosition;
+            attribute vec4 character;
+            varying vec2 outTextureCoordinate;
+            void main() {
+                vec3 bytes = floor(255.0 * character.xyz + 0.5);
+                vec2 cell = 0.5 * bytes.yz + character.w * corner;
+                gl_Position = transformationMatrix *
+                    vec4(tilePosition + textOrigin + characterSize * cell, 0.0, 1.0);
+                outTextureCoordinate = vec2((bytes.x + corner.x) / glyphCount, corner.y);
+            }
+        )"
+    );
+    m_tileTextProgram.addShaderFromSourceCode(
+        QOpenGLShader::Fragment,
+        R"(
+            uniform sampler2D texture;
+            varying vec2 outTextureCoordinate;
+            void main() {
+                gl_FragColor = texture2D(texture, outTextureCoordinate);
+            }
+        )"
+    );
+    m_tileTextProgram.link();
+    m_tileTextProgram.bind();
+
+    m_tileTextVAO.create();
+    m_tileTextVAO.bind();
+
+    // The quad is the same two triangles as for the texture program
+    static const float corners[] = {
+        0.0, 0.0,   0.0, 1.0,   1.0, 1.0,
+        0.0, 0.0,   1.0, 1.0,   1.0, 0.0,
+    };
+    m_tileTextMeshVBO.create();
+    m_tileTextMeshVBO.bind();
+    m_tileTextMeshVBO.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    m_tileTextMeshVBO.allocate(corners, sizeof(corners));
+
+    m_tileTextProgram.enableAttributeArray("corner");
+    m_tileTextProgram.setAttributeBuffer(
+        "corner", // name
+        GL_FLOAT, // type
+        0, // offset (bytes)
+        2, // tupleSize (number of elements in the attribute array)
+        2 * sizeof(float) // stride (bytes between vertices)
+    );
+    m_tileTextMeshVBO.release();
+
+    // The characters are uploaded along with the tile instances
+    m_tileTextVBO.create();
+    m_tileTextVBO.bind();
+    m_tileTextVBO.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_tileTextVBO.release();
+
+    m_tileTextVAO.release();
+    m_tileTextProgram.release();
+}
+
+void Map::setTileTextAttributeBuffers(int firstTile, int charactersPerTile) {
+
+    if (
+        firstTile == m_tileTextAttributesFirstTile &&
+        charactersPerTile == m_tileTextAttributesCharactersPerTile
+    ) {
+        return;
+    }
+    m_tileTextAttributesFirstTile = firstTile;
+    m_tileTextAttributesCharactersPerTile = charactersPerTile;
+
+    // Note that this assumes that the program and vertex array object are
+    // bound, and leaves them bound
+    QOpenGLExtraFunctions* extraFunctions = context()->extraFunctions();
+
+    // Each character advances once per instance ...
+    m_tileTextVBO.bind();
+    int characterLocation = m_tileTextProgram.attributeLocation("character");
+    m_tileTextProgram.enableAttributeArray(characterLocation);
+    m_tileTextProgram.setAttributeBuffer(
+        characterLocation,
+        GL_UNSIGNED_BYTE, // type
+        sizeof(TileTextCharacter) * charactersPerTile * firstTile, // offset (bytes)
+        4, // tupleSize
+        sizeof(TileTextCharacter) // stride (bytes between instances)
+    );
+    extraFunctions->glVertexAttribDivisor(characterLocation, 1);
+    m_tileTextVBO.release();
+
+    // ... whereas the tile position advances once per tile
+    m_tileInstanceVBO.bind();
+    int tilePositionLocation = m_tileTextProgram.attributeLocation("tilePosition");
+    m_tileTextProgram.enableAttributeArray(tilePositionLocation);
+    m_tileTextProgram.setAttributeBuffer(
+        tilePositionLocation,
+        GL_FLOAT, // type
+        sizeof(TileInstance) * firstTile + offsetof(TileInstance, x), // offset (bytes)
+        2, // tupleSize
+        sizeof(TileInstance) // stride (bytes between instances)
+    );
+    extraFunctions->glVertexAttribDivisor(tilePositionLocation, charactersPerTile);
+    m_tileInstanceVBO.release();
+}
+
+template <class T>
+void Map::writeElements(
+        QOpenGLBuffer* vbo,
+        int offset,
+        const QVector<T>& elements,
+        int start,
+        int count) {
+    if (count <= 0) {
+        return;
+    }
+    vbo->write(
+        sizeof(T) * (offset + start),
+        elements.constData() + start,
+        sizeof(T) * count
+    );
+}
+
+void Map::repopulateVertexBufferObjects(const QVector<TriangleGraphic>& mouseBuffer) {
+
+    // The algorithm may be updating the tiles right now, so we hold the
+    // view's mutex until the dirty tiles have been uploaded and cleared;
+    // anything marked dirty after that is uploaded on the next frame. The
+    // mutex also guards the lazily generated triangles, since the algorithm
+    // may clear them (when it changes the tile text layout) at any time.
+    QMutexLocker locker(m_view->getMutex());
+    m_tileTextOrigin = m_view->getTileTextOrigin();
+    m_tileTextCharacterSize = m_view->getTileTextCharacterSize();
+
+    // If the tiles are instanced, only the tiles that changed have to be
+    // uploaded, and the polygon vertex buffer object holds just the mouse.
+    if (m_tilesInstanced) {
+        const QVector<TileInstance>& tileInstanceCpuBuffer = *m_view->getTileInstanceCpuBuffer();
+        m_tileInstanceVBO.bind();
+        if (m_tileInstanceVBOCapacity < tileInstanceCpuBuffer.size()) {
+            m_tileInstanceVBO.allocate(sizeof(TileInstance) * tileInstanceCpuBuffer.size());
+            m_tileInstanceVBOCapacity = tileInstanceCpuBuffer.size();
+            m_uploadedTileInstances = -1;
+        }
+        bool uploadMesh = m_uploadedTileInstances == -1;
+        if (m_uploadedTileInstances != tileInstanceCpuBuffer.size()) {
+            writeElements(&m_tileInstanceVBO, 0, tileInstanceCpuBuffer, 0, tileInstanceCpuBuffer.size());
+            m_uploadedTileInstances = tileInstanceCpuBuffer.size();
+        }
+        else {
+            m_view->getTileInstanceCpuBufferDirtyRanges(&m_dirtyRanges);
+            for (const QPair<int, int>& range : m_dirtyRanges) {
+                writeElements(&m_tileInstanceVBO, 0, tileInstanceCpuBuffer, range.first, range.second);
+            }
+        }
+        m_tileInstanceVBO.release();
+
+        // The mesh is the same for every view, but it's cheap enough to
+        // upload again whenever the view changes
+        if (uploadMesh) {
+            const QVector<TileMeshVertex>& tileMeshCpuBuffer = *m_view->getTileMeshCpuBuffer();
+            m_tileMeshVBO.bind();
+            m_tileMeshVBO.allocate(
+                tileMeshCpuBuffer.constData(),
+                sizeof(TileMeshVertex) * tileMeshCpuBuffer.size());
+            m_tileMeshVBO.release();
+        }
+
+        // The tile text characters are uploaded the same way as the tile
+        // instances. At four bytes per character, even rewriting the text of
+        // every tile is a small upload.
+        const QVector<TileTextCharacter>& tileTextCpuBuffer = *m_view->getTileTextCpuBuffer();
+        m_tileTextVBO.bind();
+        if (m_tileTextVBOCapacity < tileTextCpuBuffer.size()) {
+            m_tileTextVBO.allocate(sizeof(TileTextCharacter) * tileTextCpuBuffer.size());
+            m_tileTextVBOCapacity = tileTextCpuBuffer.size();
+            m_uploadedTileTextCharacters = -1;
+        }
+        if (m_uploadedTileTextCharacters != tileTextCpuBuffer.size()) {
+            writeElements(&m_tileTextVBO, 0, tileTextCpuBuffer, 0, tileTextCpuBuffer.size());
+            m_uploadedTileTextCharacters = tileTextCpuBuffer.size();
+        }
+        else {
+            m_view->getTileTextCpuBufferDirtyRanges(&m_dirtyRanges);
+            for (const QPair<int, int>& range : m_dirtyRanges) {
+                writeElements(&m_tileTextVBO, 0, tileTextCpuBuffer, range.first, range.second);
+            }
+        }
+        m_tileTextVBO.release();
+    }
+
+    // Otherwise, the polygon vertex buffer object holds the maze, followed by
+    // the mouse. The maze only changes when the algorithm updates its tiles,
+    // so we only upload the tiles that changed, unless the buffer has to be
+    // reallocated, the view changed, or the number of triangles changed.
+    static const QVector<TriangleGraphic> noTriangles;
+    const QVector<TriangleGraphic>& graphicCpuBuffer =
+        m_tilesInstanced ? noTriangles : *m_view->getGraphicCpuBuffer();
+    m_polygonVBO.bind();
+    int polygonTriangles = graphicCpuBuffer.size() + mouseBuffer.size();
+    if (m_polygonVBOCapacity < polygonTriangles) {
+        m_polygonVBO.allocate(sizeof(TriangleGraphic) * polygonTriangles);
+        m_polygonVBOCapacity = polygonTriangles;
+        m_uploadedGraphicTriangles = -1;
+    }
+    if (m_uploadedGraphicTriangles != graphicCpuBuffer.size()) {
+        writeElements(&m_polygonVBO, 0, graphicCpuBuffer, 0, graphicCpuBuffer.size());
+        m_uploadedGraphicTriangles = graphicCpuBuffer.size();
+    }
+    else if (!m_tilesInstanced) {
+        m_view->getGraphicCpuBufferDirtyRanges(&m_dirtyRanges);
+        for (const QPair<int, int>& range : m_dirtyRanges) {
+            writeElements(&m_polygonVBO, 0, graphicCpuBuffer, range.first, range.second);
+        }
     }
+    // The mouse moves every frame, so it's always uploaded
+    writeElements(&m_polygonVBO, graphicCpuBuffer.size(), mouseBuffer, 0, mouseBuffer.size());
     m_polygonVBO.release();
 
-    // Overwrite the texture vertex buffer object data
+    // The rigid parts of the mouse only have to be uploaded once per mouse
+    if (m_mouseGraphic != nullptr && m_uploadedMouseTriangles == -1) {
+        const QVector<TriangleGraphic>& staticTriangles = *m_mouseGraphic->getStaticTriangles();
+        m_mouseVBO.bind();
+        m_mouseVBO.allocate(
+            staticTriangles.constData(),
+            sizeof(TriangleGraphic) * staticTriangles.size());
+        m_mouseVBO.release();
+        m_uploadedMouseTriangles = staticTriangles.size();
+    }
+
+    // The texture vertex buffer object, which holds just the maze, is
+    // uploaded the same way, unless the tile text is instanced
+    static const QVector<TriangleTexture> noTriangleTextures;
+    const QVector<TriangleTexture>& textureCpuBuffer =
+        m_tilesInstanced ? noTriangleTextures : *m_view->getTextureCpuBuffer();
     m_textureVBO.bind();
-    m_textureVBO.allocate(
-        &(m_view->getTextureCpuBuffer()->front()),
-        sizeof(TriangleTexture) * m_view->getTextureCpuBuffer()->size()
-    );
+    if (m_textureVBOCapacity < textureCpuBuffer.size()) {
+        m_textureVBO.allocate(sizeof(TriangleTexture) * textureCpuBuffer.size());
+        m_textureVBOCapacity = textureCpuBuffer.size();
+        m_uploadedTextureTriangles = -1;
+    }
+    if (m_uploadedTextureTriangles != textureCpuBuffer.size()) {
+        writeElements(&m_textureVBO, 0, textureCpuBuffer, 0, textureCpuBuffer.size());
+        m_uploadedTextureTriangles = textureCpuBuffer.size();
+    }
+    else if (!m_tilesInstanced) {
+        m_view->getTextureCpuBufferDirtyRanges(&m_dirtyRanges);
+        for (const QPair<int, int>& range : m_dirtyRanges) {
+            writeElements(&m_textureVBO, 0, textureCpuBuffer, range.first, range.second);
+        }
+    }
     m_textureVBO.release();
+
+    // Everything that changed is now on the GPU
+    m_view->clearDirtyRanges();
 }
 
 void Map::drawMap(
@@ -362,7 +895,9 @@ void Map::drawMap(
         QOpenGLShaderProgram* program,
         QOpenGLVertexArrayObject* vao,
         int vboStartingIndex,
-        int count) {
+        int count,
+        int verticesPerTile,
+        const QMatrix4x4& modelMatrix) {
 
     // Get the physical size of the maze (in meters)
     double physicalMazeWidth = P()->wallWidth() + m_maze->getWidth() * (P()->wallWidth() + P()->wallLength());
@@ -374,13 +909,32 @@ void Map::drawMap(
     program->bind();
     vao->bind();
 
-    // If it's the texture program, bind the texture and set the uniform
-    if (program == &m_textureProgram) {
+    // If it's a texture program, bind the texture and set the uniform
+    bool textured = program == &m_textureProgram || program == &m_tileTextProgram;
+    if (textured) {
         glActiveTexture(GL_TEXTURE0);
         m_textureAtlas->bind();
         program->setUniformValue("texture", 0);
     }
+
+    // The tile text program places the characters itself
+    if (program == &m_tileTextProgram) {
+        program->setUniformValue("textOrigin", QVector2D(
+            m_tileTextOrigin.getX().getMeters(),
+            m_tileTextOrigin.getY().getMeters()));
+        program->setUniformValue("characterSize", QVector2D(
+            m_tileTextCharacterSize.getX().getMeters(),
+            m_tileTextCharacterSize.getY().getMeters()));
+        program->setUniformValue(
+            "glyphCount",
+            static_cast<GLfloat>(FontImage::get()->glyphCount()));
+    }
     
+    // Only the polygon program moves its vertices
+    if (program == &m_polygonProgram) {
+        program->setUniformValue("modelMatrix", modelMatrix);
+    }
+
     // Render the full map
     if (type == LayoutType::FULL || m_mouseGraphic == nullptr) {
 
@@ -404,7 +958,12 @@ void Map::drawMap(
 
         glScissor(fullMapPosition.first, fullMapPosition.second, fullMapSize.first, fullMapSize.second);
         program->setUniformValue("transformationMatrix", transformationMatrix);
-        glDrawArrays(GL_TRIANGLES, vboStartingIndex, count);
+        drawArrays(
+            program,
+            vboStartingIndex,
+            count,
+            verticesPerTile,
+            QRect(0, 0, m_maze->getWidth(), m_maze->getHeight()));
 
     }
 
@@ -436,11 +995,16 @@ void Map::drawMap(
 
         glScissor(zoomedMapPosition.first, zoomedMapPosition.second, zoomedMapSize.first, zoomedMapSize.second);
         program->setUniformValue("transformationMatrix", transformationMatrix2);
-        glDrawArrays(GL_TRIANGLES, vboStartingIndex, count);
+        drawArrays(
+            program,
+            vboStartingIndex,
+            count,
+            verticesPerTile,
+            getVisibleTiles(transformationMatrix2, zoomedMapPosition, zoomedMapSize));
     }
 
-    // If it's the texture program, we should additionally unbind the texture
-    if (program == &m_textureProgram) {
+    // If it's a texture program, we should additionally unbind the texture
+    if (textured) {
         m_textureAtlas->release();
     }
 
@@ -448,4 +1012,112 @@ void Map::drawMap(
     vao->release();
 }
 
+QRect Map::getVisibleTiles(
+        const QMatrix4x4& transformationMatrix,
+        QPair<int, int> mapPosition,
+        QPair<int, int> mapSize) {
+
+    int mazeWidth = m_maze->getWidth();
+    int mazeHeight = m_maze->getHeight();
+    bool invertible = false;
+    QMatrix4x4 inverseMatrix = transformationMatrix.inverted(&invertible);
+    if (!invertible || m_windowWidth == 0 || m_windowHeight == 0) {
+        return QRect(0, 0, mazeWidth, mazeHeight);
+    }
+
+    // Map the corners of the map back to physical coordinates (in meters).
+    // Since the map might be rotated, the visible area is the bounding box of
+    // those corners, rather than the rectangle that they span.
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+    for (int i = 0; i < 4; i += 1) {
+        double pixelX = mapPosition.first + (i % 2) * mapSize.first;
+        double pixelY = mapPosition.second + (i / 2) * mapSize.second;
+        QPointF corner = inverseMatrix.map(QPointF(
+            2.0 * pixelX / m_windowWidth - 1.0,
+            2.0 * pixelY / m_windowHeight - 1.0));
+        minX = std::min(minX, corner.x());
+        minY = std::min(minY, corner.y());
+        maxX = std::max(maxX, corner.x());
+        maxY = std::max(maxY, corner.y());
+    }
+
+    // Tile (x, y) spans [x, x + 1] * tileLength horizontally (and similarly
+    // vertically), except that the tiles on the edge of the maze reach half a
+    // wall further out, which the clamping takes care of
+    double tileLength = P()->wallLength() + P()->wallWidth();
+    int left = static_cast<int>(std::floor(qBound(0.0, minX / tileLength, mazeWidth - 1.0)));
+    int right = static_cast<int>(std::floor(qBound(0.0, maxX / tileLength, mazeWidth - 1.0)));
+    int bottom = static_cast<int>(std::floor(qBound(0.0, minY / tileLength, mazeHeight - 1.0)));
+    int top = static_cast<int>(std::floor(qBound(0.0, maxY / tileLength, mazeHeight - 1.0)));
+    return QRect(QPoint(left, bottom), QPoint(right, top));
+}
+
+void Map::drawArrays(
+        QOpenGLShaderProgram* program,
+        int vboStartingIndex,
+        int count,
+        int verticesPerTile,
+        const QRect& visibleTiles) {
+
+    // Anything other than the tiles is always drawn in full
+    if (verticesPerTile <= 0) {
+        glDrawArrays(GL_TRIANGLES, vboStartingIndex, count);
+        return;
+    }
+
+    // The tile text program draws the quad once per character, rather than
+    // once per tile
+    int instancesPerTile = 1;
+    if (program == &m_tileTextProgram) {
+        int numTiles = m_maze->getWidth() * m_maze->getHeight();
+        instancesPerTile = m_uploadedTileTextCharacters / numTiles;
+        if (instancesPerTile == 0) {
+            return;
+        }
+    }
+
+    // The tiles are stored column by column, so each column of the visible
+    // tiles is a single range. If the columns are whole, then so is the
+    // entire rectangle, which is always the case for the full map.
+    int mazeHeight = m_maze->getHeight();
+    int numColumns = visibleTiles.width();
+    int numRows = visibleTiles.height();
+    if (numRows == mazeHeight) {
+        numRows *= numColumns;
+        numColumns = 1;
+    }
+    for (int i = 0; i < numColumns; i += 1) {
+        int firstTile = mazeHeight * (visibleTiles.left() + i) + visibleTiles.top();
+
+        // The tile program draws every tile as an instance of the tile mesh
+        if (program == &m_tileProgram) {
+            setTileInstanceAttributeBuffers(firstTile);
+            context()->extraFunctions()->glDrawArraysInstanced(
+                GL_TRIANGLES,
+                vboStartingIndex,
+                count,
+                numRows
+            );
+        }
+        else if (program == &m_tileTextProgram) {
+            setTileTextAttributeBuffers(firstTile, instancesPerTile);
+            context()->extraFunctions()->glDrawArraysInstanced(
+                GL_TRIANGLES,
+                vboStartingIndex,
+                count,
+                instancesPerTile * numRows
+            );
+        }
+        else {
+            glDrawArrays(
+                GL_TRIANGLES,
+                vboStartingIndex + verticesPerTile * firstTile,
+                verticesPerTile * numRows);
+        }
+    }
+}
+
 } // namespace mms
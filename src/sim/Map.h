@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QMatrix4x4>
 #include <QOpenGLBuffer> 
 #include <QOpenGLDebugLogger>
 #include <QOpenGLFunctions>
@@ -7,6 +8,8 @@
 #include <QOpenGLTexture> 
 #include <QOpenGLVertexArrayObject> 
 #include <QOpenGLWidget>
+#include <QPair>
+#include <QRect>
 #include <QTimer>
 #include <QVector>
 
@@ -15,6 +18,7 @@
 #include "MazeView.h"
 #include "MouseGraphic.h"
 #include "TriangleGraphic.h"
+#include "units/Cartesian.h"
 
 namespace mms {
 
@@ -30,7 +34,7 @@ public:
     Map(QWidget* parent = 0);
 
     void setMaze(const Maze* maze);
-    void setView(const MazeView* view);
+    void setView(MazeView* view);
     void setMouseGraphic(const MouseGraphic* mouseGraphic);
 
     void setLayoutType(LayoutType layoutType);
@@ -54,14 +58,21 @@ private:
     QOpenGLDebugLogger m_openGLLogger;
     void initOpenGLLogger();
 
-    // Frame refresh timer
+    // Frame refresh timer, and the version of the mouse as last drawn; the
+    // map is only repainted when the mouse, the view, or the layout changes
     QTimer m_timer;
+    qint64 m_drawnMouseAppearanceVersion;
+    void updateIfChanged();
 
     // No ownership here - only pointers
     const Maze* m_maze;
-    const MazeView* m_view;
+    MazeView* m_view;
     const MouseGraphic* m_mouseGraphic;
 
+    // The triangles of the parts of the mouse that change shape, redrawn every
+    // frame; kept between frames so that its storage can be reused
+    QVector<TriangleGraphic> m_mouseBuffer;
+
     // The map's window size, in pixels
     int m_windowWidth;
     int m_windowHeight;
@@ -75,6 +86,8 @@ private:
     QOpenGLShaderProgram m_polygonProgram;
     QOpenGLVertexArrayObject m_polygonVAO;
     QOpenGLBuffer m_polygonVBO;
+    QOpenGLVertexArrayObject m_mouseVAO;
+    QOpenGLBuffer m_mouseVBO;
 
     // Texture program variables
     QOpenGLTexture* m_textureAtlas;
@@ -82,13 +95,79 @@ private:
     QOpenGLVertexArrayObject m_textureVAO;
     QOpenGLBuffer m_textureVBO;
 
+    // Tile program variables. If the context supports instancing (OpenGL 3.3
+    // or OpenGL ES 3.0), every tile is drawn as an instance of a single mesh,
+    // colored by the tile's instance, rather than with its own triangles.
+    bool m_tilesInstanced;
+    QOpenGLShaderProgram m_tileProgram;
+    QOpenGLVertexArrayObject m_tileVAO;
+    QOpenGLBuffer m_tileMeshVBO;
+    QOpenGLBuffer m_tileInstanceVBO;
+
+    // Tile text program variables. Likewise, if the context supports
+    // instancing, every character of the tile text is drawn as an instance of
+    // a single quad, which is placed and textured by the GPU.
+    QOpenGLShaderProgram m_tileTextProgram;
+    QOpenGLVertexArrayObject m_tileTextVAO;
+    QOpenGLBuffer m_tileTextMeshVBO;
+    QOpenGLBuffer m_tileTextVBO;
+
+    // The vertex buffer objects are only reallocated when they're outgrown,
+    // and otherwise only the tiles that changed are uploaded. These are the
+    // capacities of the buffers, and the number of triangles (or instances)
+    // of the view that they hold (or -1 if the view changed since they were
+    // uploaded).
+    int m_polygonVBOCapacity;
+    int m_textureVBOCapacity;
+    int m_uploadedGraphicTriangles;
+    int m_uploadedTextureTriangles;
+    int m_tileInstanceVBOCapacity;
+    int m_uploadedTileInstances;
+    int m_uploadedMouseTriangles;
+    int m_tileTextVBOCapacity;
+    int m_uploadedTileTextCharacters;
+    QVector<QPair<int, int>> m_dirtyRanges;
+
+    // The layout of the tile text characters, which is read along with the
+    // buffers, since the algorithm may change it at any time
+    Cartesian m_tileTextOrigin;
+    Cartesian m_tileTextCharacterSize;
+
+    // The tile instance attributes point at the instance of this tile, so
+    // that drawing n instances draws this tile and the n - 1 that follow it
+    int m_tileInstanceAttributesFirstInstance;
+    void setTileInstanceAttributeBuffers(int firstInstance);
+
+    // Similarly, the tile text attributes point at the characters of this
+    // tile, and at its position, which is shared by its characters
+    int m_tileTextAttributesFirstTile;
+    int m_tileTextAttributesCharactersPerTile;
+    void setTileTextAttributeBuffers(int firstTile, int charactersPerTile);
+
     // Initialize the graphics
     void initPolygonProgram();
+    void initPolygonVertexArrayObject(
+        QOpenGLVertexArrayObject* vao,
+        QOpenGLBuffer* vbo,
+        QOpenGLBuffer::UsagePattern usagePattern);
     void initTextureProgram();
+    void initTileProgram();
+    void initTileTextProgram();
+    bool isInstancingSupported();
 
     // Drawing helper methods
     void repopulateVertexBufferObjects(
         const QVector<TriangleGraphic>& mouseBuffer);
+    // Writes elements (triangles or tile instances) [start, start + count) to
+    // the same position in the buffer, relative to offset (all in elements,
+    // not bytes)
+    template <class T>
+    void writeElements(
+        QOpenGLBuffer* vbo,
+        int offset,
+        const QVector<T>& elements,
+        int start,
+        int count);
     void drawMap(
         LayoutType type,
         const Coordinate& currentMouseTranslation,
@@ -96,7 +175,26 @@ private:
         QOpenGLShaderProgram* program,
         QOpenGLVertexArrayObject* vao,
         int vboStartingIndex,
-        int count);
+        int count,
+        int verticesPerTile = 0,
+        const QMatrix4x4& modelMatrix = QMatrix4x4());
+
+    // If verticesPerTile is positive, the range holds that many vertices per
+    // tile, in tile order (or, for the tile program, the mesh of each tile
+    // instance), and only the tiles within visibleTiles are drawn
+    void drawArrays(
+        QOpenGLShaderProgram* program,
+        int vboStartingIndex,
+        int count,
+        int verticesPerTile,
+        const QRect& visibleTiles);
+
+    // The rectangle (in tile coordinates) of the tiles that could be visible
+    // in the part of the window that the transformation matrix maps onto
+    QRect getVisibleTiles(
+        const QMatrix4x4& transformationMatrix,
+        QPair<int, int> mapPosition,
+        QPair<int, int> mapSize);
 };
 
 } // namespace mms
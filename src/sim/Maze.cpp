@@ -109,6 +109,7 @@ Maze::Maze(BasicMaze basicMaze) {
 
     // Load the maze given by the maze generation algorithm
     m_maze = initializeFromBasicMaze(basicMaze);
+    m_wallMasks = initializeWallMasks(m_maze);
 }
 
 int Maze::getWidth() const {
@@ -128,6 +129,10 @@ const Tile* Maze::getTile(int x, int y) const {
     return &m_maze.at(x).at(y);
 }
 
+const QVector<quint8>& Maze::getWallMasks() const {
+    return m_wallMasks;
+}
+
 int Maze::getMaximumDistance() const {
     int max = 0;
     for (int x = 0; x < getWidth(); x += 1) {
@@ -183,6 +188,22 @@ QVector<QVector<Tile>> Maze::initializeFromBasicMaze(const BasicMaze& basicMaze)
     return maze;
 }
 
+QVector<quint8> Maze::initializeWallMasks(const QVector<QVector<Tile>>& maze) {
+    QVector<quint8> wallMasks;
+    for (int x = 0; x < maze.size(); x += 1) {
+        for (int y = 0; y < maze.at(x).size(); y += 1) {
+            quint8 wallMask = 0;
+            for (Direction direction : DIRECTIONS()) {
+                if (maze.at(x).at(y).isWall(direction)) {
+                    wallMask |= (1 << static_cast<int>(direction));
+                }
+            }
+            wallMasks.append(wallMask);
+        }
+    }
+    return wallMasks;
+}
+
 BasicMaze Maze::mirrorAcrossVertical(const BasicMaze& basicMaze) {
     static QMap<Direction, Direction> verticalOpposites {
         {Direction::NORTH, Direction::NORTH},
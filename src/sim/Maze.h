@@ -21,6 +21,12 @@ public:
     bool withinMaze(int x, int y) const;
     const Tile* getTile(int x, int y) const;
 
+    // The walls of every tile, packed into one byte per tile and indexed by
+    // x * height + y; the bit (1 << direction) is set if the tile has a wall
+    // in that direction. This is the same information as Tile::isWall, but
+    // without any lookups, for use in the innermost loops (e.g., castRay).
+    const QVector<quint8>& getWallMasks() const;
+
     int getMaximumDistance() const;
     bool isValidMaze() const;
     bool isOfficialMaze() const;
@@ -36,6 +42,9 @@ private:
     // Vector to hold all of the tiles
     QVector<QVector<Tile>> m_maze;
 
+    // The packed walls of each of the tiles, see getWallMasks()
+    QVector<quint8> m_wallMasks;
+
     // Cache results to these functions
     bool m_isValidMaze;
     bool m_isOfficialMaze;
@@ -43,6 +52,9 @@ private:
     // Initializes all of the tiles of the basic maze
     static QVector<QVector<Tile>> initializeFromBasicMaze(const BasicMaze& basicMaze);
 
+    // Packs the walls of all of the tiles, see getWallMasks()
+    static QVector<quint8> initializeWallMasks(const QVector<QVector<Tile>>& maze);
+
     // Basic maze geometric transformations
     static BasicMaze mirrorAcrossVertical(const BasicMaze& basicMaze);
     static BasicMaze rotateCounterClockwise(const BasicMaze& basicMaze);
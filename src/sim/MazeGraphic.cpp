@@ -1,5 +1,7 @@
 #include "MazeGraphic.h"
 
+#include <QMutexLocker>
+
 #include "Assert.h"
 
 namespace mms {
@@ -11,7 +13,8 @@ MazeGraphic::MazeGraphic(
         bool tileColorsVisible,
         bool tileFogVisible,
         bool tileTextVisible,
-        bool autopopulateTextWithDistance) {
+        bool autopopulateTextWithDistance) :
+        m_bufferInterface(bufferInterface) {
     for (int x = 0; x < maze->getWidth(); x += 1) {
         QVector<TileGraphic> column;
         for (int y = 0; y < maze->getHeight(); y += 1) {
@@ -31,31 +34,92 @@ MazeGraphic::MazeGraphic(
 }
 
 void MazeGraphic::setTileColor(int x, int y, Color color) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
     ASSERT_TR(withinMaze(x, y));
     m_tileGraphics[x][y].setColor(color);
 }
 
 void MazeGraphic::declareWall(int x, int y, Direction direction, bool isWall) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
     ASSERT_TR(withinMaze(x, y));
     m_tileGraphics[x][y].declareWall(direction, isWall);
 }
 
 void MazeGraphic::undeclareWall(int x, int y, Direction direction) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
     ASSERT_TR(withinMaze(x, y));
     m_tileGraphics[x][y].undeclareWall(direction);
 }
 
 void MazeGraphic::setTileFogginess(int x, int y, bool foggy) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
     ASSERT_TR(withinMaze(x, y));
     m_tileGraphics[x][y].setFogginess(foggy);
 }
 
 void MazeGraphic::setTileText(int x, int y, const QString& text) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
     ASSERT_TR(withinMaze(x, y));
     m_tileGraphics[x][y].setText(text);
 }
 
+void MazeGraphic::update(const TileUpdates& updates) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
+    for (const TileUpdates::Value<Color>& color : updates.colors) {
+        ASSERT_TR(withinMaze(color.x, color.y));
+        m_tileGraphics[color.x][color.y].setColor(color.value);
+    }
+    for (const TileUpdates::Value<QString>& text : updates.texts) {
+        ASSERT_TR(withinMaze(text.x, text.y));
+        m_tileGraphics[text.x][text.y].setText(text.value);
+    }
+    for (const TileUpdates::Value<bool>& fogginess : updates.fogginesses) {
+        ASSERT_TR(withinMaze(fogginess.x, fogginess.y));
+        m_tileGraphics[fogginess.x][fogginess.y].setFogginess(fogginess.value);
+    }
+    for (const TileUpdates::Wall& wall : updates.walls) {
+        ASSERT_TR(withinMaze(wall.x, wall.y));
+        m_tileGraphics[wall.x][wall.y].declareWall(wall.direction, wall.isWall);
+    }
+}
+
+void MazeGraphic::fillTileColor(int x, int y, int width, int height, Color color) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
+    ASSERT_TR(regionWithinMaze(x, y, width, height));
+    for (int i = x; i < x + width; i += 1) {
+        for (int j = y; j < y + height; j += 1) {
+            m_tileGraphics[i][j].setColor(color);
+        }
+    }
+}
+
+void MazeGraphic::fillTileText(int x, int y, int width, int height, const QString& text) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
+    ASSERT_TR(regionWithinMaze(x, y, width, height));
+    for (int i = x; i < x + width; i += 1) {
+        for (int j = y; j < y + height; j += 1) {
+            m_tileGraphics[i][j].setText(text);
+        }
+    }
+}
+
+void MazeGraphic::fillTileFogginess(int x, int y, int width, int height, bool foggy) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
+    ASSERT_TR(regionWithinMaze(x, y, width, height));
+    for (int i = x; i < x + width; i += 1) {
+        for (int j = y; j < y + height; j += 1) {
+            m_tileGraphics[i][j].setFogginess(foggy);
+        }
+    }
+}
+
+const TileGraphic& MazeGraphic::getTileGraphic(int x, int y) const {
+    ASSERT_TR(withinMaze(x, y));
+    return m_tileGraphics.at(x).at(y);
+}
+
 void MazeGraphic::setWallTruthVisible(bool visible) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
     for (int x = 0; x < getWidth(); x += 1) {
         for (int y = 0; y < getHeight(); y += 1) {
             m_tileGraphics[x][y].setWallTruthVisible(visible);
@@ -64,6 +128,7 @@ void MazeGraphic::setWallTruthVisible(bool visible) {
 }
 
 void MazeGraphic::setTileColorsVisible(bool visible) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
     for (int x = 0; x < getWidth(); x += 1) {
         for (int y = 0; y < getHeight(); y += 1) {
             m_tileGraphics[x][y].setTileColorsVisible(visible);
@@ -72,6 +137,7 @@ void MazeGraphic::setTileColorsVisible(bool visible) {
 }
 
 void MazeGraphic::setTileFogVisible(bool visible) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
     for (int x = 0; x < getWidth(); x += 1) {
         for (int y = 0; y < getHeight(); y += 1) {
             m_tileGraphics[x][y].setTileFogVisible(visible);
@@ -80,6 +146,7 @@ void MazeGraphic::setTileFogVisible(bool visible) {
 }
 
 void MazeGraphic::setTileTextVisible(bool visible) {
+    QMutexLocker locker(m_bufferInterface->getMutex());
     for (int x = 0; x < getWidth(); x += 1) {
         for (int y = 0; y < getHeight(); y += 1) {
             m_tileGraphics[x][y].setTileTextVisible(visible);
@@ -105,6 +172,24 @@ void MazeGraphic::drawTextures() {
     }
 }
 
+void MazeGraphic::drawInstances() const {
+    // Fill the TILE_INSTANCE_CPU_BUFFER
+    for (int x = 0; x < m_tileGraphics.size(); x += 1) {
+        for (int y = 0; y < m_tileGraphics.at(x).size(); y += 1) {
+            m_tileGraphics.at(x).at(y).drawInstance();
+        }
+    }
+}
+
+void MazeGraphic::drawTextInstances() const {
+    // Fill the TILE_TEXT_CPU_BUFFER
+    for (int x = 0; x < m_tileGraphics.size(); x += 1) {
+        for (int y = 0; y < m_tileGraphics.at(x).size(); y += 1) {
+            m_tileGraphics.at(x).at(y).updateText();
+        }
+    }
+}
+
 int MazeGraphic::getWidth() const {
     return m_tileGraphics.size();
 }
@@ -117,4 +202,14 @@ bool MazeGraphic::withinMaze(int x, int y) const {
     return 0 <= x && x < getWidth() && 0 <= y && y < getHeight();
 }
 
+bool MazeGraphic::regionWithinMaze(int x, int y, int width, int height) const {
+    if (width < 0 || height < 0) {
+        return false;
+    }
+    if (width == 0 || height == 0) {
+        return true;
+    }
+    return withinMaze(x, y) && withinMaze(x + width - 1, y + height - 1);
+}
+
 } // namespace mms
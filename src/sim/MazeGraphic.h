@@ -6,6 +6,7 @@
 #include "Color.h"
 #include "Maze.h"
 #include "TileGraphic.h"
+#include "TileUpdates.h"
 
 namespace mms {
 
@@ -28,6 +29,17 @@ public:
     void setTileFogginess(int x, int y, bool foggy);
     void setTileText(int x, int y, const QString& text);
 
+    // Changes many tiles while holding the mutex once, so that the view
+    // never shows part of the change. The fill methods change every tile of
+    // the rectangle whose lower left tile is (x, y).
+    void update(const TileUpdates& updates);
+    void fillTileColor(int x, int y, int width, int height, Color color);
+    void fillTileText(int x, int y, int width, int height, const QString& text);
+    void fillTileFogginess(int x, int y, int width, int height, bool foggy);
+
+    // The state of the tile at (x, y), as last set through the methods above
+    const TileGraphic& getTileGraphic(int x, int y) const;
+
     void setWallTruthVisible(bool visible);
     void setTileColorsVisible(bool visible);
     void setTileFogVisible(bool visible);
@@ -37,14 +49,19 @@ public:
     // TODO: MACK - why is only one of these const?
     void drawPolygons() const;
     void drawTextures();
+    void drawInstances() const;
+    void drawTextInstances() const;
 
 private:
 
+    // Every method that changes the tiles locks the buffer interface's mutex
+    BufferInterface* m_bufferInterface;
     QVector<QVector<TileGraphic>> m_tileGraphics;
 
     int getWidth() const;
     int getHeight() const;
     bool withinMaze(int x, int y) const;
+    bool regionWithinMaze(int x, int y, int width, int height) const;
 
 };
 
@@ -1,5 +1,8 @@
 #include "MazeView.h"
 
+#include <QDebug>
+#include <QMutexLocker>
+
 #include "BufferInterface.h"
 #include "MazeGraphic.h"
 #include "Param.h"
@@ -16,7 +19,10 @@ MazeView::MazeView(
         m_bufferInterface(
             {maze->getWidth(), maze->getHeight()},
             &m_graphicCpuBuffer,
-            &m_textureCpuBuffer),
+            &m_textureCpuBuffer,
+            &m_tileInstanceCpuBuffer,
+            &m_tileTextCpuBuffer,
+            &m_tileMeshCpuBuffer),
         m_mazeGraphic(
             maze,
             &m_bufferInterface,
@@ -26,12 +32,13 @@ MazeView::MazeView(
             tileTextVisible,
             autopopulateTextWithDistance) {
 
-    // Establish the coordinates for the tile text characters
+    // Establish the coordinates for the tile text characters, and populate
+    // the tile text characters
     initText(2, 4);
 
-    // Populate the data vectors with wall polygons and tile distance text.
-    m_mazeGraphic.drawPolygons();
-    m_mazeGraphic.drawTextures();
+    // Populate the data vectors with tile instances. Note that the wall
+    // polygons and tile text triangles are populated lazily.
+    m_mazeGraphic.drawInstances();
 }
 
 MazeGraphic* MazeView::getMazeGraphic() {
@@ -39,17 +46,84 @@ MazeGraphic* MazeView::getMazeGraphic() {
 }
 
 void MazeView::initTileGraphicText(int numRows, int numCols) {
+    int maxRowsOrCols = TileGraphicTextCache::MAX_ROWS_OR_COLS;
+    if (
+        numRows < 0 || maxRowsOrCols < numRows ||
+        numCols < 0 || maxRowsOrCols < numCols
+    ) {
+        qWarning().noquote().nospace()
+            << "The tile text must have between 0 and " << maxRowsOrCols
+            << " rows and cols, but " << numRows << " rows and " << numCols
+            << " cols were requested.";
+        numRows = qBound(0, numRows, maxRowsOrCols);
+        numCols = qBound(0, numCols, maxRowsOrCols);
+    }
+    QMutexLocker locker(m_bufferInterface.getMutex());
     initText(numRows, numCols);
 }
 
-const QVector<TriangleGraphic>* MazeView::getGraphicCpuBuffer() const {
+const QVector<TriangleGraphic>* MazeView::getGraphicCpuBuffer() {
+    if (m_graphicCpuBuffer.isEmpty()) {
+        m_mazeGraphic.drawPolygons();
+    }
     return &m_graphicCpuBuffer;
 }
 
-const QVector<TriangleTexture>* MazeView::getTextureCpuBuffer() const {
+const QVector<TriangleTexture>* MazeView::getTextureCpuBuffer() {
+    if (m_textureCpuBuffer.isEmpty()) {
+        m_mazeGraphic.drawTextures();
+    }
     return &m_textureCpuBuffer;
 }
 
+const QVector<TileInstance>* MazeView::getTileInstanceCpuBuffer() const {
+    return &m_tileInstanceCpuBuffer;
+}
+
+const QVector<TileTextCharacter>* MazeView::getTileTextCpuBuffer() const {
+    return &m_tileTextCpuBuffer;
+}
+
+const QVector<TileMeshVertex>* MazeView::getTileMeshCpuBuffer() const {
+    return &m_tileMeshCpuBuffer;
+}
+
+Cartesian MazeView::getTileTextOrigin() const {
+    return m_bufferInterface.getTileGraphicTextOrigin();
+}
+
+Cartesian MazeView::getTileTextCharacterSize() const {
+    return m_bufferInterface.getTileGraphicTextCharacterSize();
+}
+
+void MazeView::getGraphicCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const {
+    m_bufferInterface.getGraphicCpuBufferDirtyRanges(ranges);
+}
+
+void MazeView::getTextureCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const {
+    m_bufferInterface.getTextureCpuBufferDirtyRanges(ranges);
+}
+
+void MazeView::getTileInstanceCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const {
+    m_bufferInterface.getTileInstanceCpuBufferDirtyRanges(ranges);
+}
+
+void MazeView::getTileTextCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const {
+    m_bufferInterface.getTileTextCpuBufferDirtyRanges(ranges);
+}
+
+void MazeView::clearDirtyRanges() {
+    m_bufferInterface.clearDirtyRanges();
+}
+
+bool MazeView::isDirty() const {
+    return m_bufferInterface.isDirty();
+}
+
+QMutex* MazeView::getMutex() const {
+    return m_bufferInterface.getMutex();
+}
+
 void MazeView::initText(int numRows, int numCols) {
 
     // Initialze the tile text in the buffer class,
@@ -61,10 +135,11 @@ void MazeView::initText(int numRows, int numCols) {
         P()->tileTextBorderFraction(),
         STRING_TO_TILE_TEXT_ALIGNMENT().value(P()->tileTextAlignment()));
         
-    // TODO: MACK - this is kind of confusing
-    // - I should insert and then update (get rid of draw method)
+    // The number of characters per tile may have changed, so the triangles
+    // (if any) have to be inserted again, lazily, whereas the characters are
+    // updated right away
     m_textureCpuBuffer.clear();
-    m_mazeGraphic.drawTextures();
+    m_mazeGraphic.drawTextInstances();
 }
 
 } // namespace mms
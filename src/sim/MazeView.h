@@ -1,10 +1,15 @@
 #pragma once
 
+#include <QMutex>
+#include <QPair>
 #include <QVector>
 
 #include "BufferInterface.h"
 #include "Maze.h"
 #include "MazeGraphic.h"
+#include "TileInstance.h"
+#include "TileMeshVertex.h"
+#include "TileTextCharacter.h"
 #include "TriangleGraphic.h"
 #include "TriangleTexture.h"
 
@@ -24,8 +29,37 @@ public:
 
     MazeGraphic* getMazeGraphic();
     void initTileGraphicText(int numRows, int numCols);
-    const QVector<TriangleGraphic>* getGraphicCpuBuffer() const;
-    const QVector<TriangleTexture>* getTextureCpuBuffer() const;
+
+    // Whether anything has changed since the last call to clearDirtyRanges()
+    bool isDirty() const;
+
+    // Held by the MazeGraphic while it updates the buffers. The methods below
+    // read the buffers (or, for the lazily generated triangles, fill them),
+    // so they must only be called with this held.
+    QMutex* getMutex() const;
+
+    const QVector<TileInstance>* getTileInstanceCpuBuffer() const;
+    const QVector<TileTextCharacter>* getTileTextCpuBuffer() const;
+    const QVector<TileMeshVertex>* getTileMeshCpuBuffer() const;
+
+    // The layout of the tile text characters, in meters
+    Cartesian getTileTextOrigin() const;
+    Cartesian getTileTextCharacterSize() const;
+
+    // The triangles of every tile, and of every tile text character, for when
+    // tiles can't be drawn as instances. Since these take far more memory
+    // than the tile instances and characters, they're only generated the
+    // first time they're requested.
+    const QVector<TriangleGraphic>* getGraphicCpuBuffer();
+    const QVector<TriangleTexture>* getTextureCpuBuffer();
+
+    // The parts of the above buffers that have changed since the last call to
+    // clearDirtyRanges(), as (starting index, count) pairs
+    void getGraphicCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const;
+    void getTextureCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const;
+    void getTileInstanceCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const;
+    void getTileTextCpuBufferDirtyRanges(QVector<QPair<int, int>>* ranges) const;
+    void clearDirtyRanges();
 
 private:
 
@@ -33,6 +67,12 @@ private:
     QVector<TriangleGraphic> m_graphicCpuBuffer;
     QVector<TriangleTexture> m_textureCpuBuffer;
 
+    // Alternatively, each tile is drawn as an instance of the tile mesh, and
+    // each character of its text is placed and textured on the GPU
+    QVector<TileInstance> m_tileInstanceCpuBuffer;
+    QVector<TileTextCharacter> m_tileTextCpuBuffer;
+    QVector<TileMeshVertex> m_tileMeshCpuBuffer;
+
     // The buffer interface provides abstractions which the MazeGraphic
     // uses to populate the vector of TriangleGraphic objects
     BufferInterface m_bufferInterface;
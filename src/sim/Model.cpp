@@ -23,7 +23,6 @@ Model::Model() :
         m_shutdownRequested(false),
         m_paused(false),
         m_simSpeed(1.0) {
-    ASSERT_RUNS_JUST_ONCE();
 }
 
 void Model::simulate() {
@@ -35,13 +34,23 @@ void Model::simulate() {
     // Use this thread to perform mouse position updates
     while (!m_shutdownRequested) {
 
-        // If we've crashed, let this thread exit
-        if (S()->crashed()) {
+        // If we've crashed, let this thread exit; in lock-step mode, the
+        // algorithm may be waiting for a tick that will never come
+        if (m_state.crashed()) {
+            m_simTime.interruptTicks();
             // TODO: MACK
             // collisionDetector.join();
             return;
         }
 
+        // In lock-step mode, only perform an update once the algorithm is
+        // blocked on a command (and has thus requested a tick)
+        bool lockStep = m_simTime.lockStepEnabled();
+        if (lockStep && !m_simTime.awaitTickRequest(
+                Milliseconds(P()->minSleepDuration()))) {
+            continue;
+        }
+
         // Ensure the maze/mouse aren't updated in this loop
         m_mutex.lock();
 
@@ -58,62 +67,37 @@ void Model::simulate() {
 
         // Calculate the amount of sim time that should pass during this iteration
         static Seconds realTimePerUpdate = Seconds(1.0 / P()->mousePositionUpdateRate());
-        Seconds elapsedSimTimeForThisIteration = realTimePerUpdate * m_simSpeed;
+        // Lock-step ticks are always the same size, since the sim speed is a
+        // multiple of real time, which doesn't apply to lock-step mode
+        Seconds elapsedSimTimeForThisIteration = (
+            lockStep ? realTimePerUpdate : realTimePerUpdate * m_simSpeed
+        );
 
         // Update the sim time
-        SimTime::get()->incrementElapsedSimTime(elapsedSimTimeForThisIteration);
+        m_simTime.incrementElapsedSimTime(elapsedSimTimeForThisIteration);
 
         // Update the position of the mouse
         m_mouse->update(elapsedSimTimeForThisIteration);
 
-        // Retrieve the current discretized location of the mouse
-        QPair<int, int> location = m_mouse->getCurrentDiscretizedTranslation();
-
-        // If we're ever outside of the maze, crash. It would be cool to have
-        // some "out of bounds" state but I haven't implemented that yet. We
-        // continue here to make sure that we join with the other thread.
-        if (!m_maze->withinMaze(location.first, location.second)) {
-            S()->setCrashed();
+        // Update the mouse stats; if we're ever outside of the maze, crash.
+        // It would be cool to have some "out of bounds" state but I haven't
+        // implemented that yet. We continue here to make sure that we join
+        // with the other thread.
+        if (!updateMouseStats()) {
+            m_state.setCrashed();
             m_mutex.unlock();
             continue;
-
-        }
-
-        // Retrieve the tile at current location
-        const Tile* tileAtLocation = m_maze->getTile(location.first, location.second);
-
-        // If this is a new tile, update the set of traversed tiles
-        if (!m_stats->traversedTileLocations.contains(location)) {
-            m_stats->traversedTileLocations.insert(location);
-            if (m_stats->closestDistanceToCenter == -1 ||
-                    tileAtLocation->getDistance() < m_stats->closestDistanceToCenter) {
-                m_stats->closestDistanceToCenter = tileAtLocation->getDistance(); 
-            }
-            // Alert any listeners that a new tile was entered
-            emit newTileLocationTraversed(location.first, location.second);
-        }
-
-        // If we've returned to the origin, reset the departure time
-        if (location.first == 0 && location.second == 0) {
-            m_stats->timeOfOriginDeparture = Seconds(-1);
-        }
-
-        // Otherwise, if we've just left the origin, update the departure time
-        else if (m_stats->timeOfOriginDeparture < Seconds(0)) {
-            m_stats->timeOfOriginDeparture = SimTime::get()->elapsedSimTime();
-        }
-
-        // Separately, if we're in the center, update the best time to center
-        if (m_maze->isCenterTile(location.first, location.second)) {
-            Seconds timeToCenter = SimTime::get()->elapsedSimTime() - m_stats->timeOfOriginDeparture;
-            if (m_stats->bestTimeToCenter < Seconds(0) || timeToCenter < m_stats->bestTimeToCenter) {
-                m_stats->bestTimeToCenter = timeToCenter;
-            }
         }
 
         // Release the mutex
         m_mutex.unlock();
 
+        // In lock-step mode, let the algorithm proceed; there's no need to sleep
+        if (lockStep) {
+            m_simTime.completeTick();
+            continue;
+        }
+
         // Get the duration of the mouse position update, in seconds. Note that this duration
         // is simply the total number of real seconds that have passed, which is exactly
         // what we want (since the framerate is perceived in real-time and not CPU time).
@@ -137,6 +121,7 @@ void Model::simulate() {
 
 void Model::shutdown() {
     m_shutdownRequested = true;
+    m_simTime.interruptTicks();
 }
 
 void Model::setMaze(const Maze* maze) {
@@ -155,7 +140,7 @@ void Model::setMouse(Mouse* mouse) {
     ASSERT_TR(m_stats == nullptr);
     m_mouse = mouse;
     m_stats = new MouseStats();
-    SimTime::get()->reset();
+    m_simTime.reset();
     m_mutex.unlock();
 }
 
@@ -173,6 +158,14 @@ void Model::removeMouse() {
     m_mutex.unlock();
 }
 
+SimTime* Model::getSimTime() {
+    return &m_simTime;
+}
+
+State* Model::getState() {
+    return &m_state;
+}
+
 MouseStats Model::getMouseStats() const {
     m_mutex.lock();
     MouseStats stats;
@@ -191,6 +184,68 @@ void Model::setSimSpeed(double factor) {
     m_simSpeed = factor;
 }
 
+void Model::advanceMouse(
+        const Duration& elapsed,
+        const Cartesian& translation,
+        const Radians& rotation) {
+    m_mutex.lock();
+    if (m_mouse == nullptr) {
+        m_mutex.unlock();
+        return;
+    }
+    m_simTime.incrementElapsedSimTime(elapsed);
+    m_mouse->teleport(translation, rotation);
+    if (!updateMouseStats()) {
+        m_state.setCrashed();
+    }
+    m_mutex.unlock();
+}
+
+bool Model::updateMouseStats() {
+
+    // Retrieve the current discretized location of the mouse
+    QPair<int, int> location = m_mouse->getCurrentDiscretizedTranslation();
+
+    // If we're outside of the maze, the caller should crash
+    if (!m_maze->withinMaze(location.first, location.second)) {
+        return false;
+    }
+
+    // Retrieve the tile at current location
+    const Tile* tileAtLocation = m_maze->getTile(location.first, location.second);
+
+    // If this is a new tile, update the set of traversed tiles
+    if (!m_stats->traversedTileLocations.contains(location)) {
+        m_stats->traversedTileLocations.insert(location);
+        if (m_stats->closestDistanceToCenter == -1 ||
+                tileAtLocation->getDistance() < m_stats->closestDistanceToCenter) {
+            m_stats->closestDistanceToCenter = tileAtLocation->getDistance(); 
+        }
+        // Alert any listeners that a new tile was entered
+        emit newTileLocationTraversed(location.first, location.second);
+    }
+
+    // If we've returned to the origin, reset the departure time
+    if (location.first == 0 && location.second == 0) {
+        m_stats->timeOfOriginDeparture = Seconds(-1);
+    }
+
+    // Otherwise, if we've just left the origin, update the departure time
+    else if (m_stats->timeOfOriginDeparture < Seconds(0)) {
+        m_stats->timeOfOriginDeparture = m_simTime.elapsedSimTime();
+    }
+
+    // Separately, if we're in the center, update the best time to center
+    if (m_maze->isCenterTile(location.first, location.second)) {
+        Seconds timeToCenter = m_simTime.elapsedSimTime() - m_stats->timeOfOriginDeparture;
+        if (m_stats->bestTimeToCenter < Seconds(0) || timeToCenter < m_stats->bestTimeToCenter) {
+            m_stats->bestTimeToCenter = timeToCenter;
+        }
+    }
+
+    return true;
+}
+
 void Model::checkCollision() {
 
     // If collision detectino isn't enabled, let this thread exit
@@ -216,9 +271,10 @@ void Model::checkCollision() {
         static const Meters tileLength = Meters(P()->wallLength() + P()->wallWidth());
 
         // Retrieve the current collision polygon
-        QVector<Cartesian> currentCollisionPolygonVertices =
-            m_mouse->getCurrentCollisionPolygon(
-                m_mouse->getCurrentTranslation(), m_mouse->getCurrentRotation()).getVertices();
+        Polygon currentCollisionPolygon = m_mouse->getCurrentCollisionPolygon(
+            m_mouse->getCurrentTranslation(), m_mouse->getCurrentRotation());
+        const Polygon::VertexArray& currentCollisionPolygonVertices =
+            currentCollisionPolygon.getVertices();
 
         // Check for collisions
         for (int i = 0; i < currentCollisionPolygonVertices.size(); i += 1) {
@@ -227,7 +283,7 @@ void Model::checkCollision() {
             Cartesian v2 = currentCollisionPolygonVertices.at(j);
             // If a wall has come between the two vertices, then we have a collision
             if (GeometryUtilities::castRay(v1, v2, *m_maze, halfWallWidth, tileLength) != v2) {
-                S()->setCrashed();
+                m_state.setCrashed();
                 return; // If we've crashed, let this thread exit
             }
         }
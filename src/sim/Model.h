@@ -3,9 +3,15 @@
 #include <QObject>
 #include <QMutex>
 
+#include "units/Cartesian.h"
+#include "units/Duration.h"
+#include "units/Radians.h"
+
 #include "Maze.h"
 #include "Mouse.h"
 #include "MouseStats.h"
+#include "SimTime.h"
+#include "State.h"
 
 namespace mms {
 
@@ -23,8 +29,20 @@ public:
     void setMouse(Mouse* mouse);
     void removeMouse();
 
+    // The sim time and state of this particular simulation
+    SimTime* getSimTime();
+    State* getState();
+
     MouseStats getMouseStats() const;
 
+    // Advances the sim time and moves the mouse to the given pose, updating
+    // the mouse stats as if the movement had been simulated; used to perform
+    // movements instantly, without waiting on the simulation thread
+    void advanceMouse(
+        const Duration& elapsed,
+        const Cartesian& translation,
+        const Radians& rotation);
+
     void setPaused(bool paused);
     void setSimSpeed(double factor);
 
@@ -37,6 +55,9 @@ private:
     mutable QMutex m_mutex;
     bool m_shutdownRequested;
 
+    SimTime m_simTime;
+    State m_state;
+
     const Maze* m_maze;
     Mouse* m_mouse;
     MouseStats* m_stats;
@@ -44,6 +65,10 @@ private:
     bool m_paused;
     double m_simSpeed;
 
+    // Updates the stats based on the mouse's current location (with the mutex
+    // held); returns false if the mouse is outside of the maze
+    bool updateMouseStats();
+
     void checkCollision();
 };
 
@@ -1,6 +1,5 @@
 #include "Mouse.h"
 
-#include <QMutableMapIterator>
 #include <QPair>
 #include <QVector>
 #include <QtMath>
@@ -14,10 +13,15 @@
 #include "MouseParser.h"
 #include "Param.h"
 #include "State.h"
+#include "Transform.h"
 
 namespace mms {
 
-Mouse::Mouse(const Maze* maze) : m_maze(maze) {
+Mouse::Mouse(const Maze* maze) :
+        m_maze(maze),
+        m_isDifferentialDrive(false),
+        m_poseVersion(0),
+        m_appearanceVersion(0) {
 
     // The initial translation of the mouse is just the center of the starting tile
     Meters halfOfTileDistance = Meters((P()->wallLength() + P()->wallWidth()) / 2.0);
@@ -46,18 +50,29 @@ bool Mouse::reload(const QString& mouseFile) {
     // Initialize the body, wheels, and sensors, such that they have the
     // correct initial translation and rotation
     m_initialBodyPolygon = parser.getBody(m_initialTranslation, m_initialRotation, &success);
-    m_wheels = parser.getWheels(m_initialTranslation, m_initialRotation, &success);
-    m_sensors = parser.getSensors(m_initialTranslation, m_initialRotation, *m_maze, &success);
+    QMap<QString, Wheel> wheels =
+        parser.getWheels(m_initialTranslation, m_initialRotation, &success);
+    QMap<QString, Sensor> sensors =
+        parser.getSensors(m_initialTranslation, m_initialRotation, &success);
 
     // Initialize the wheel effects and speed adjustment factors
-    m_wheelEffects = getWheelEffects(m_initialTranslation, m_initialRotation, m_wheels);
-    m_wheelSpeedAdjustmentFactors = getWheelSpeedAdjustmentFactors(m_wheels, m_wheelEffects);
+    QMap<QString, WheelEffect> wheelEffects =
+        getWheelEffects(m_initialTranslation, m_initialRotation, wheels);
+    QMap<QString, QPair<double, double>> wheelSpeedAdjustmentFactors =
+        getWheelSpeedAdjustmentFactors(wheels, wheelEffects);
+
+    // Determine whether or not we can use the differential drive fast path
+    m_isDifferentialDrive = isDifferentialDrive(wheels, wheelEffects);
 
     // Initialize the curve turn factors, based on previously determined info
     m_curveTurnFactorCalculator = CurveTurnFactorCalculator(
-        m_wheels,
-        m_wheelEffects,
-        m_wheelSpeedAdjustmentFactors);
+        wheels,
+        wheelEffects,
+        wheelSpeedAdjustmentFactors);
+
+    // Compile the wheels and sensors into the flat tables used every tick
+    compileWheels(wheels, wheelEffects, wheelSpeedAdjustmentFactors);
+    compileSensors(sensors);
 
     // Initialize the collision polygon; this is technically not correct since
     // we should be using union, not convexHull, but it's a good approximation
@@ -111,8 +126,12 @@ void Mouse::reset() {
 }
 
 void Mouse::teleport(const Coordinate& translation, const Angle& rotation) {
+    m_mutex.lock();
     m_currentTranslation = translation;
     m_currentRotation = rotation;
+    m_poseVersion += 1;
+    m_appearanceVersion += 1;
+    m_mutex.unlock();
 }
 
 Direction Mouse::getStartedDirection() const {
@@ -127,6 +146,22 @@ Cartesian Mouse::getInitialTranslation() const {
     return m_initialTranslation;
 }
 
+Radians Mouse::getInitialRotation() const {
+    return m_initialRotation;
+}
+
+Transform Mouse::getCurrentTransform(
+        const Coordinate& currentTranslation,
+        const Angle& currentRotation) const {
+    // Translate and then rotate, in a single transform
+    Radians rotation = Radians(currentRotation) - m_initialRotation;
+    return Transform::translation((Cartesian(currentTranslation) - getInitialTranslation()).getVector())
+        .then(Transform::rotationAround(
+            rotation.getCos(),
+            rotation.getSin(),
+            currentTranslation.getVector()));
+}
+
 Cartesian Mouse::getCurrentTranslation() const {
     return m_currentTranslation;
 }
@@ -135,6 +170,13 @@ Radians Mouse::getCurrentRotation() const {
     return m_currentRotation;
 }
 
+qint64 Mouse::getAppearanceVersion() const {
+    m_mutex.lock();
+    qint64 appearanceVersion = m_appearanceVersion;
+    m_mutex.unlock();
+    return appearanceVersion;
+}
+
 QPair<int, int> Mouse::getCurrentDiscretizedTranslation() const {
     static Meters tileLength = Meters(P()->wallLength() + P()->wallWidth());
     Cartesian currentTranslation = getCurrentTranslation();
@@ -189,80 +231,72 @@ Polygon Mouse::getCurrentCenterOfMassPolygon(
         currentRotation);
 }
 
-QVector<Polygon> Mouse::getCurrentWheelPolygons(
+int Mouse::getWheelCount() const {
+    return m_wheels.size();
+}
+
+int Mouse::getSensorCount() const {
+    return m_sensors.size();
+}
+
+Polygon Mouse::getCurrentWheelPolygon(
+        int wheel,
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const {
-    QVector<Polygon> polygons;
-    // TODO: upforgrabs
-    // All getPolygons functions require a lock to deal with the implicit
-    // sharing problem:
-    // http://doc.qt.io/qt-5/containers.html#implicit-sharing-iterator-problem.
-    // Ideally, this shouldn't be the case (we should be able to perform reads
-    // without having to worry about writes). Your task is to figure out how to
-    // remove the lock without causing segfaults.
+    // The polygons themselves are never shared, but the wheels and sensors
+    // may be reloaded, and the wheel speeds set, by another thread
     m_mutex.lock();
-    for (const Wheel& wheel : m_wheels.values()) {
-        polygons.push_back(
-            getCurrentPolygon(
-                wheel.getInitialPolygon(),
-                currentTranslation,
-                currentRotation));
-    }
+    Polygon polygon = getCurrentPolygon(
+        m_wheels.at(wheel).getInitialPolygon(),
+        currentTranslation,
+        currentRotation);
     m_mutex.unlock();
-    return polygons;
+    return polygon;
 }
 
-QVector<Polygon> Mouse::getCurrentWheelSpeedIndicatorPolygons(
+Polygon Mouse::getCurrentWheelSpeedIndicatorPolygon(
+        int wheel,
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const {
-    QVector<Polygon> polygons;
     m_mutex.lock();
-    for (const Wheel& wheel : m_wheels.values()) {
-        polygons.push_back(
-            getCurrentPolygon(
-                wheel.getSpeedIndicatorPolygon(),
-                currentTranslation,
-                currentRotation));
-    }
+    Polygon polygon = getCurrentPolygon(
+        m_wheels.at(wheel).getSpeedIndicatorPolygon(
+            RadiansPerSecond(m_wheelSpeeds.at(wheel))),
+        currentTranslation,
+        currentRotation);
     m_mutex.unlock();
-    return polygons;
+    return polygon;
 }
 
-QVector<Polygon> Mouse::getCurrentSensorPolygons(
+Polygon Mouse::getCurrentSensorPolygon(
+        int sensor,
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const {
-    QVector<Polygon> polygons;
     m_mutex.lock();
-    for (const Sensor& sensor : m_sensors.values()) {
-        polygons.push_back(
-            getCurrentPolygon(
-                sensor.getInitialPolygon(),
-                currentTranslation,
-                currentRotation));
-    }
+    Polygon polygon = getCurrentPolygon(
+        m_sensors.at(sensor).getInitialPolygon(),
+        currentTranslation,
+        currentRotation);
     m_mutex.unlock();
-    return polygons;
+    return polygon;
 }
 
-QVector<Polygon> Mouse::getCurrentSensorViewPolygons(
+Polygon Mouse::getCurrentSensorViewPolygon(
+        int sensor,
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const {
-    QVector<Polygon> polygons;
     m_mutex.lock();
-    for (const Sensor& sensor : m_sensors.values()) {
-        QPair<Cartesian, Radians> translationAndRotation =
-            getCurrentSensorPositionAndDirection(
-                sensor,
-                currentTranslation,
-                currentRotation);
-        polygons.push_back(
-            sensor.getCurrentViewPolygon(
-                translationAndRotation.first,
-                translationAndRotation.second,
-                *m_maze));
-    }
+    QPair<Cartesian, Radians> translationAndRotation =
+        getCurrentSensorPositionAndDirection(
+            sensor,
+            currentTranslation,
+            currentRotation);
+    Polygon polygon = m_sensors.at(sensor).getCurrentViewPolygon(
+        translationAndRotation.first,
+        translationAndRotation.second,
+        *m_maze);
     m_mutex.unlock();
-    return polygons;
+    return polygon;
 }
 
 void Mouse::update(const Duration& elapsed) {
@@ -271,79 +305,98 @@ void Mouse::update(const Duration& elapsed) {
 
     m_mutex.lock();
 
-    MetersPerSecond sumDx(0);
-    MetersPerSecond sumDy(0);
-    RadiansPerSecond sumDr(0);
-
-    // Iterate over all of the wheels
-    QMutableMapIterator<QString, Wheel> wheelIterator(m_wheels);
-    while (wheelIterator.hasNext()) {
-        auto pair = wheelIterator.next();
-
-        // Update the rotation of the wheel
-        pair.value().updateRotation(pair.value().getAngularVelocity() * elapsed);
-
-        // Get the effects on the rate of change of translation, both forward
-        // and sideways, and rotation of the mouse due to this particular wheel
-        std::tuple<MetersPerSecond, MetersPerSecond, RadiansPerSecond> effects =
-            m_wheelEffects.value(pair.key()).getEffects(pair.value().getAngularVelocity());
-
-        // The effect of the forward component
-        sumDx += std::get<0>(effects) * getCurrentRotation().getCos();
-        sumDy += std::get<0>(effects) * getCurrentRotation().getSin();
-
-        // The effect of the sideways component
-        sumDx += std::get<1>(effects) * getCurrentRotation().getSin();
-        sumDy += std::get<1>(effects) * getCurrentRotation().getCos() * -1;
-
-        // The effect of the rotation component
-        sumDr += std::get<2>(effects);
+    // The rates of change of the mouse, in its own frame of reference, are the
+    // average of the effects of each of the wheels. Note that positive
+    // sideways movement is to the right of the mouse.
+    double forwardRate = 0.0; // Meters per second
+    double sidewaysRate = 0.0; // Meters per second
+    double turnRate = 0.0; // Radians per second
+
+    // Iterate over all of the wheels, updating their rotations and summing
+    // their effects; each effect is just the wheel speed times a constant
+    double seconds = elapsed.getSeconds();
+    int numWheels = m_wheelSpeeds.size();
+    const double* speeds = m_wheelSpeeds.constData();
+    const double* unitForwardEffects = m_wheelUnitForwardEffects.constData();
+    const double* unitSidewaysEffects = m_wheelUnitSidewaysEffects.constData();
+    const double* unitTurnEffects = m_wheelUnitTurnEffects.constData();
+    double* absoluteRotations = m_wheelAbsoluteRotations.data();
+    double* relativeRotations = m_wheelRelativeRotations.data();
+    for (int i = 0; i < numWheels; i += 1) {
+        double rotation = speeds[i] * seconds;
+        absoluteRotations[i] += rotation;
+        relativeRotations[i] += rotation;
+        forwardRate += unitForwardEffects[i] * speeds[i];
+        turnRate += unitTurnEffects[i] * speeds[i];
     }
 
-    MetersPerSecond aveDx = sumDx / static_cast<double>(m_wheels.size());
-    MetersPerSecond aveDy = sumDy / static_cast<double>(m_wheels.size());
-    RadiansPerSecond aveDr = sumDr / static_cast<double>(m_wheels.size());
+    // Differential drive mice never move sideways
+    if (!m_isDifferentialDrive) {
+        for (int i = 0; i < numWheels; i += 1) {
+            sidewaysRate += unitSidewaysEffects[i] * speeds[i];
+        }
+    }
 
-    m_currentGyro = aveDr;
-    m_currentRotation += Radians(aveDr * elapsed);
-    m_currentTranslation += Cartesian(aveDx * elapsed, aveDy * elapsed);
+    forwardRate /= static_cast<double>(numWheels);
+    sidewaysRate /= static_cast<double>(numWheels);
+    turnRate /= static_cast<double>(numWheels);
+
+    // Since the wheel speeds (and thus the rates) are constant throughout the
+    // step, the mouse travels along an arc (or a line, if it's not turning).
+    // We integrate along that arc exactly, rather than assuming that the
+    // rotation is fixed at its initial value, so that large steps (i.e., high
+    // sim speeds) don't cause the mouse to drift. When the change in rotation
+    // is tiny, we use the Taylor expansions, which are numerically stable.
+    double rotationDelta = turnRate * seconds;
+    double sinFactor = 0.0; // sin(rotationDelta) / turnRate
+    double cosFactor = 0.0; // (1 - cos(rotationDelta)) / turnRate
+    if (std::abs(rotationDelta) < 1e-4) {
+        sinFactor = seconds * (1.0 - rotationDelta * rotationDelta / 6.0);
+        cosFactor = seconds * rotationDelta / 2.0;
+    }
+    else {
+        sinFactor = std::sin(rotationDelta) / turnRate;
+        cosFactor = (1.0 - std::cos(rotationDelta)) / turnRate;
+    }
 
-    // Update all of the sensor readings
-    QMutableMapIterator<QString, Sensor> sensorIterator(m_sensors);
-    while (sensorIterator.hasNext()) {
-        auto pair = sensorIterator.next();
-        QPair<Cartesian, Radians> translationAndRotation =
-            getCurrentSensorPositionAndDirection(
-                pair.value(),
-                m_currentTranslation,
-                m_currentRotation);
-        pair.value().updateReading(
-            translationAndRotation.first,
-            translationAndRotation.second,
-            *m_maze);
+    // The displacement in the mouse's frame of reference, where y is to the left
+    double leftwardRate = -1 * sidewaysRate;
+    double dx = sinFactor * forwardRate - cosFactor * leftwardRate;
+    double dy = cosFactor * forwardRate + sinFactor * leftwardRate;
+
+    // Rotate the displacement into the maze's frame of reference
+    units::Vector displacement = units::Vector(units::Length(dx), units::Length(dy));
+    m_currentTranslation += Cartesian(displacement.rotate(
+        m_currentRotation.getCos(),
+        m_currentRotation.getSin()));
+    m_currentRotation += Radians(rotationDelta);
+    m_currentGyro = RadiansPerSecond(turnRate);
+
+    // Note that we don't update the sensor readings here; instead, they're
+    // invalidated, and then recomputed only if they're actually read. A
+    // mouse that isn't moving keeps its readings.
+    if (dx != 0.0 || dy != 0.0 || rotationDelta != 0.0) {
+        m_poseVersion += 1;
+        m_appearanceVersion += 1;
     }
 
     m_mutex.unlock();
 }
 
-bool Mouse::hasWheel(const QString& name) const {
-    return m_wheels.contains(name);
+int Mouse::getWheelHandle(const QString& name) const {
+    return m_wheelHandles.value(name, -1);
 }
 
-RadiansPerSecond Mouse::getWheelMaxSpeed(const QString& name) const {
-    ASSERT_TR(m_wheels.contains(name));
-    return m_wheels.value(name).getMaxAngularVelocityMagnitude();
+RadiansPerSecond Mouse::getWheelMaxSpeed(int wheel) const {
+    return RadiansPerSecond(m_wheelMaxSpeeds.at(wheel));
 }
 
-void Mouse::setWheelSpeeds(const QMap<QString, RadiansPerSecond>& wheelSpeeds) {
+void Mouse::setWheelSpeed(int wheel, const AngularVelocity& speed) {
+    double radiansPerSecond = RadiansPerSecond(speed).getRadiansPerSecond();
+    ASSERT_LE(std::abs(radiansPerSecond), m_wheelMaxSpeeds.at(wheel));
     m_mutex.lock();
-    for (const auto& pair : ContainerUtilities::items(wheelSpeeds)) {
-        ASSERT_TR(m_wheels.contains(pair.first));
-        ASSERT_LE(
-            std::abs(pair.second.getRevolutionsPerMinute()),
-            getWheelMaxSpeed(pair.first).getRevolutionsPerMinute());
-        m_wheels[pair.first].setAngularVelocity(pair.second);
-    }
+    m_wheelSpeeds[wheel] = radiansPerSecond;
+    m_appearanceVersion += 1;
     m_mutex.unlock();
 }
 
@@ -370,55 +423,91 @@ void Mouse::setWheelSpeedsForCurveRight(double fractionOfMaxSpeed, const Meters&
 }
 
 void Mouse::stopAllWheels() {
-    QMap<QString, RadiansPerSecond> wheelSpeeds;
-    for (const QString& name : m_wheels.keys()) {
-        wheelSpeeds.insert(name, RadiansPerSecond(0));
-    }
-    setWheelSpeeds(wheelSpeeds);
+    m_mutex.lock();
+    m_wheelSpeeds.fill(0.0);
+    m_appearanceVersion += 1;
+    m_mutex.unlock();
+}
+
+QPair<MetersPerSecond, RadiansPerSecond> Mouse::getRatesOfChangeForMoveForward(
+        double fractionOfMaxSpeed) const {
+    return getRatesOfChangeForMovement(fractionOfMaxSpeed, 1.0, 0.0);
 }
 
-EncoderType Mouse::getWheelEncoderType(const QString& name) const {
-    ASSERT_TR(hasWheel(name));
-    return m_wheels.value(name).getEncoderType();
+QPair<MetersPerSecond, RadiansPerSecond> Mouse::getRatesOfChangeForCurveLeft(
+        double fractionOfMaxSpeed, const Meters& radius) const {
+    QPair<double, double> curveTurnFactors =
+        m_curveTurnFactorCalculator.getCurveTurnFactors(radius);
+    return getRatesOfChangeForMovement(
+        fractionOfMaxSpeed,
+        curveTurnFactors.first,
+        curveTurnFactors.second);
 }
 
-double Mouse::getWheelEncoderTicksPerRevolution(const QString& name) const {
-    ASSERT_TR(hasWheel(name));
-    return m_wheels.value(name).getEncoderTicksPerRevolution();
+QPair<MetersPerSecond, RadiansPerSecond> Mouse::getRatesOfChangeForCurveRight(
+        double fractionOfMaxSpeed, const Meters& radius) const {
+    QPair<double, double> curveTurnFactors =
+        m_curveTurnFactorCalculator.getCurveTurnFactors(radius);
+    return getRatesOfChangeForMovement(
+        fractionOfMaxSpeed,
+        curveTurnFactors.first,
+        -1 * curveTurnFactors.second);
+}
+
+EncoderType Mouse::getWheelEncoderType(int wheel) const {
+    return m_wheels.at(wheel).getEncoderType();
 }
 
-int Mouse::readWheelAbsoluteEncoder(const QString& name) const {
-    ASSERT_TR(hasWheel(name));
+double Mouse::getWheelEncoderTicksPerRevolution(int wheel) const {
+    return m_wheels.at(wheel).getEncoderTicksPerRevolution();
+}
+
+int Mouse::readWheelAbsoluteEncoder(int wheel) const {
     m_mutex.lock();
-    int encoderReading = m_wheels.value(name).readAbsoluteEncoder();
+    Radians rotation(m_wheelAbsoluteRotations.at(wheel));
     m_mutex.unlock();
-    return encoderReading;
+    return static_cast<int>(std::floor(
+        getWheelEncoderTicksPerRevolution(wheel) *
+        rotation.getRadiansZeroTo2pi() / (2 * M_PI)));
 }
 
-int Mouse::readWheelRelativeEncoder(const QString& name) const {
-    ASSERT_TR(hasWheel(name));
+int Mouse::readWheelRelativeEncoder(int wheel) const {
     m_mutex.lock();
-    int encoderReading = m_wheels.value(name).readRelativeEncoder();
+    double rotation = m_wheelRelativeRotations.at(wheel);
     m_mutex.unlock();
-    return encoderReading;
+    // We use std::trunc instead of std::floor so we round towards zero in the
+    // case of a negative relative rotation
+    return static_cast<int>(std::trunc(
+        getWheelEncoderTicksPerRevolution(wheel) * rotation / (2 * M_PI)));
 }
 
-void Mouse::resetWheelRelativeEncoder(const QString& name) {
-    ASSERT_TR(hasWheel(name));
+void Mouse::resetWheelRelativeEncoder(int wheel) {
     m_mutex.lock();
-    // TODO: upforgrabs
-    // Use value() here instead of [] notation
-    m_wheels[name].resetRelativeEncoder();
+    m_wheelRelativeRotations[wheel] = 0.0;
     m_mutex.unlock();
 }
 
-bool Mouse::hasSensor(const QString& name) const {
-    return m_sensors.contains(name);
+int Mouse::getSensorHandle(const QString& name) const {
+    return m_sensorHandles.value(name, -1);
 }
 
-double Mouse::readSensor(const QString& name) const {
-    ASSERT_TR(hasSensor(name));
-    return m_sensors.value(name).read();
+double Mouse::readSensor(int sensor) const {
+    m_mutex.lock();
+    if (m_sensorReadingPoseVersions.at(sensor) != m_poseVersion) {
+        QPair<Cartesian, Radians> translationAndRotation =
+            getCurrentSensorPositionAndDirection(
+                sensor,
+                m_currentTranslation,
+                m_currentRotation);
+        m_sensorReadings[sensor] = m_sensors.at(sensor).getReading(
+            translationAndRotation.first,
+            translationAndRotation.second,
+            *m_maze);
+        m_sensorReadingPoseVersions[sensor] = m_poseVersion;
+    }
+    double reading = m_sensorReadings.at(sensor);
+    m_mutex.unlock();
+    return reading;
 }
 
 RadiansPerSecond Mouse::readGyro() const {
@@ -429,29 +518,58 @@ Polygon Mouse::getCurrentPolygon(
         const Polygon& initialPolygon,
         const Cartesian& currentTranslation,
         const Radians& currentRotation) const {
-    return initialPolygon
-        .translate(currentTranslation - getInitialTranslation())
-        .rotateAroundPoint(currentRotation - m_initialRotation, currentTranslation);
+    return initialPolygon.transform(
+        getCurrentTransform(currentTranslation, currentRotation));
 }
 
 QPair<Cartesian, Radians> Mouse::getCurrentSensorPositionAndDirection(
-        const Sensor& sensor,
+        int sensor,
         const Cartesian& currentTranslation,
         const Radians& currentRotation) const {
-    Cartesian translationDelta = currentTranslation - getInitialTranslation();
-    Radians rotationDelta = currentRotation - m_initialRotation;
+    // The pose of the mouse, as a transform from its frame of reference
+    Transform pose = Transform::rotation(
+        currentRotation.getCos(),
+        currentRotation.getSin()
+    ).then(Transform::translation(currentTranslation.getVector()));
     return {
-        GeometryUtilities::rotateVertexAroundPoint(
-            GeometryUtilities::translateVertex(
-                sensor.getInitialPosition(),
-                translationDelta),
-            rotationDelta,
-            currentTranslation),
-        sensor.getInitialDirection() + rotationDelta
+        pose.apply(m_sensorOffsets.at(sensor)),
+        currentRotation + Radians(m_sensorDirectionOffsets.at(sensor).value())
     };
 }
 
 void Mouse::setWheelSpeedsForMovement(double fractionOfMaxSpeed, double forwardFactor, double turnFactor) {
+    QPair<double, double> normalizedFactors =
+        getNormalizedMovementFactors(forwardFactor, turnFactor);
+    m_mutex.lock();
+    for (int i = 0; i < m_wheelSpeeds.size(); i += 1) {
+        m_wheelSpeeds[i] = getWheelSpeedForMovement(i, fractionOfMaxSpeed, normalizedFactors);
+    }
+    m_appearanceVersion += 1;
+    m_mutex.unlock();
+}
+
+QPair<MetersPerSecond, RadiansPerSecond> Mouse::getRatesOfChangeForMovement(
+        double fractionOfMaxSpeed, double forwardFactor, double turnFactor) const {
+
+    // Just like in update(), the mouse's rates of change are the average of
+    // the effects of each of the wheels
+    QPair<double, double> normalizedFactors =
+        getNormalizedMovementFactors(forwardFactor, turnFactor);
+    double forwardRate = 0.0;
+    double turnRate = 0.0;
+    for (int i = 0; i < m_wheels.size(); i += 1) {
+        double speed = getWheelSpeedForMovement(i, fractionOfMaxSpeed, normalizedFactors);
+        forwardRate += m_wheelUnitForwardEffects.at(i) * speed;
+        turnRate += m_wheelUnitTurnEffects.at(i) * speed;
+    }
+    return {
+        MetersPerSecond(forwardRate / static_cast<double>(m_wheels.size())),
+        RadiansPerSecond(turnRate / static_cast<double>(m_wheels.size()))
+    };
+}
+
+QPair<double, double> Mouse::getNormalizedMovementFactors(
+        double forwardFactor, double turnFactor) const {
 
     // We can think about setting the wheels speeds for particular movements as
     // a linear combination of the forward movement and the turn movement. For
@@ -474,24 +592,84 @@ void Mouse::setWheelSpeedsForMovement(double fractionOfMaxSpeed, double forwardF
     ASSERT_LE(0.0, normalizedFactorMagnitude);
     ASSERT_LE(normalizedFactorMagnitude, 1.0);
 
-    // Now set the wheel speeds based on the normalized factors
-    QMap<QString, RadiansPerSecond> wheelSpeeds;
-    for (const auto& pair : ContainerUtilities::items(m_wheels)) {
-        ASSERT_TR(m_wheelSpeedAdjustmentFactors.contains(pair.first));
-        QPair<double, double> adjustmentFactors = m_wheelSpeedAdjustmentFactors.value(pair.first);
-        wheelSpeeds.insert(
-            pair.first,
-            (
-                pair.second.getMaxAngularVelocityMagnitude() *
-                fractionOfMaxSpeed *
-                (
-                    normalizedForwardFactor * adjustmentFactors.first +
-                    normalizedTurnFactor * adjustmentFactors.second
-                )
-            )
-        );
+    return {normalizedForwardFactor, normalizedTurnFactor};
+}
+
+double Mouse::getWheelSpeedForMovement(
+        int wheel,
+        double fractionOfMaxSpeed,
+        const QPair<double, double>& normalizedFactors) const {
+    return (
+        m_wheelMaxSpeeds.at(wheel) *
+        fractionOfMaxSpeed *
+        (
+            normalizedFactors.first * m_wheelForwardAdjustmentFactors.at(wheel) +
+            normalizedFactors.second * m_wheelTurnAdjustmentFactors.at(wheel)
+        )
+    );
+}
+
+void Mouse::compileWheels(
+        const QMap<QString, Wheel>& wheels,
+        const QMap<QString, WheelEffect>& wheelEffects,
+        const QMap<QString, QPair<double, double>>& wheelSpeedAdjustmentFactors) {
+    m_wheels.clear();
+    m_wheelHandles.clear();
+    m_wheelUnitForwardEffects.clear();
+    m_wheelUnitSidewaysEffects.clear();
+    m_wheelUnitTurnEffects.clear();
+    m_wheelForwardAdjustmentFactors.clear();
+    m_wheelTurnAdjustmentFactors.clear();
+    m_wheelMaxSpeeds.clear();
+    m_wheelSpeeds.clear();
+    m_wheelAbsoluteRotations.clear();
+    m_wheelRelativeRotations.clear();
+    for (const auto& pair : ContainerUtilities::items(wheels)) {
+        ASSERT_TR(wheelEffects.contains(pair.first));
+        ASSERT_TR(wheelSpeedAdjustmentFactors.contains(pair.first));
+        std::tuple<MetersPerSecond, MetersPerSecond, RadiansPerSecond> unitEffects =
+            wheelEffects.value(pair.first).getEffects(RadiansPerSecond(1.0));
+        QPair<double, double> adjustmentFactors =
+            wheelSpeedAdjustmentFactors.value(pair.first);
+        m_wheelHandles.insert(pair.first, m_wheels.size());
+        m_wheels.append(pair.second);
+        m_wheelUnitForwardEffects.append(std::get<0>(unitEffects).getMetersPerSecond());
+        m_wheelUnitSidewaysEffects.append(std::get<1>(unitEffects).getMetersPerSecond());
+        m_wheelUnitTurnEffects.append(std::get<2>(unitEffects).getRadiansPerSecond());
+        m_wheelForwardAdjustmentFactors.append(adjustmentFactors.first);
+        m_wheelTurnAdjustmentFactors.append(adjustmentFactors.second);
+        m_wheelMaxSpeeds.append(
+            pair.second.getMaxAngularVelocityMagnitude().getRadiansPerSecond());
+        m_wheelSpeeds.append(0.0);
+        m_wheelAbsoluteRotations.append(0.0);
+        m_wheelRelativeRotations.append(0.0);
+    }
+}
+
+void Mouse::compileSensors(const QMap<QString, Sensor>& sensors) {
+    m_sensors.clear();
+    m_sensorHandles.clear();
+    m_sensorOffsets.clear();
+    m_sensorDirectionOffsets.clear();
+    m_sensorReadings.clear();
+    m_sensorReadingPoseVersions.clear();
+
+    // The sensors are positioned relative to the initial translation and
+    // rotation of the mouse, so we undo that rotation to get the offsets
+    double cosRotation = m_initialRotation.getCos();
+    double sinRotation = m_initialRotation.getSin();
+    for (const auto& pair : ContainerUtilities::items(sensors)) {
+        units::Vector delta =
+            pair.second.getInitialPosition().getVector() -
+            m_initialTranslation.getVector();
+        m_sensorHandles.insert(pair.first, m_sensors.size());
+        m_sensors.append(pair.second);
+        m_sensorOffsets.append(delta.rotate(cosRotation, -1 * sinRotation));
+        m_sensorDirectionOffsets.append(units::Angle(
+            (pair.second.getInitialDirection() - m_initialRotation).getRadiansNotBounded()));
+        m_sensorReadings.append(0.0);
+        m_sensorReadingPoseVersions.append(-1);
     }
-    setWheelSpeeds(wheelSpeeds);
 }
 
 QMap<QString, WheelEffect> Mouse::getWheelEffects(
@@ -512,6 +690,27 @@ QMap<QString, WheelEffect> Mouse::getWheelEffects(
     return wheelEffects;
 }
 
+bool Mouse::isDifferentialDrive(
+        const QMap<QString, Wheel>& wheels,
+        const QMap<QString, WheelEffect>& wheelEffects) const {
+
+    // A differential drive mouse has exactly two wheels, neither of which
+    // causes the mouse to move sideways (e.g., res/mouse/default.xml)
+    if (wheels.size() != 2) {
+        return false;
+    }
+    for (const WheelEffect& wheelEffect : wheelEffects) {
+        std::tuple<MetersPerSecond, MetersPerSecond, RadiansPerSecond> effects =
+            wheelEffect.getEffects(RadiansPerSecond(1.0));
+        double forward = std::abs(std::get<0>(effects).getMetersPerSecond());
+        double sideways = std::abs(std::get<1>(effects).getMetersPerSecond());
+        if (1e-9 * forward < sideways) {
+            return false;
+        }
+    }
+    return true;
+}
+
 QMap<QString, QPair<double, double>> Mouse::getWheelSpeedAdjustmentFactors(
         const QMap<QString, Wheel>& wheels,
         const QMap<QString, WheelEffect>& wheelEffects) const {
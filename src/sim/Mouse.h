@@ -7,6 +7,9 @@
 #include <QVector>
 
 #include "units/Cartesian.h"
+#include "units/Meters.h"
+#include "units/MetersPerSecond.h"
+#include "units/Quantity.h"
 #include "units/RadiansPerSecond.h"
 
 #include "CurveTurnFactorCalculator.h"
@@ -15,6 +18,7 @@
 #include "Maze.h"
 #include "Polygon.h"
 #include "Sensor.h"
+#include "Transform.h"
 #include "Wheel.h"
 #include "WheelEffect.h"
 
@@ -45,13 +49,25 @@ public:
     // Set the direction that the mouse should face whenever reset
     void setStartingDirection(Direction startingDirection);
 
-    // Gets the initial translation of the mouse
+    // Gets the initial translation and rotation of the mouse, i.e., the pose
+    // of the mouse at the most recent reload
     Cartesian getInitialTranslation() const;
+    Radians getInitialRotation() const;
+
+    // Returns the transform that moves the parts of the mouse from the
+    // initial pose to the given pose
+    Transform getCurrentTransform(
+        const Coordinate& currentTranslation,
+        const Angle& currentRotation) const;
 
     // Gets the current translation and rotation of the mouse
     Cartesian getCurrentTranslation() const;
     Radians getCurrentRotation() const;
 
+    // Returns a number that changes whenever the mouse would be drawn
+    // differently, i.e., whenever its pose or its wheel speeds change
+    qint64 getAppearanceVersion() const;
+
     // Gets the current discretized translation and rotation of the mouse
     QPair<int, int> getCurrentDiscretizedTranslation() const;
     Direction getCurrentDiscretizedRotation() const;
@@ -72,23 +88,32 @@ public:
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const;
 
-    // Retrieves the polygons of the wheels of the robot
-    QVector<Polygon> getCurrentWheelPolygons(
+    // Returns the number of wheels and sensors, respectively; the handles of
+    // the wheels and sensors are exactly the integers in [0, count)
+    int getWheelCount() const;
+    int getSensorCount() const;
+
+    // Retrieves the polygon of a wheel of the robot
+    Polygon getCurrentWheelPolygon(
+        int wheel,
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const;
 
-    // Retrieves the speed indicator polygons of the wheels of the robot
-    QVector<Polygon> getCurrentWheelSpeedIndicatorPolygons(
+    // Retrieves the speed indicator polygon of a wheel of the robot
+    Polygon getCurrentWheelSpeedIndicatorPolygon(
+        int wheel,
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const;
 
-    // Retrieves the polygons of the sensors of the robot
-    QVector<Polygon> getCurrentSensorPolygons(
+    // Retrieves the polygon of a sensor of the robot
+    Polygon getCurrentSensorPolygon(
+        int sensor,
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const;
 
-    // Retrieve the polygons corresponding to the views of the sensors
-    QVector<Polygon> getCurrentSensorViewPolygons(
+    // Retrieve the polygon corresponding to the view of a sensor
+    Polygon getCurrentSensorViewPolygon(
+        int sensor,
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const;
 
@@ -96,14 +121,16 @@ public:
     // based on how much simulation time has elapsed
     void update(const Duration& elapsed);
 
-    // Returns whether or not the mouse has a wheel by a particular name
-    bool hasWheel(const QString& name) const;
+    // Returns the handle of the wheel by a particular name, or -1 if the mouse
+    // has no such wheel; all other wheel functions take a valid handle, so
+    // that names only need to be resolved once
+    int getWheelHandle(const QString& name) const;
 
     // Returns the magnitde of the max angular velocity of the wheel
-    RadiansPerSecond getWheelMaxSpeed(const QString& name) const;
+    RadiansPerSecond getWheelMaxSpeed(int wheel) const;
 
-    // An atomic interface for setting the wheel speeds
-    void setWheelSpeeds(const QMap<QString, RadiansPerSecond>& wheelSpeeds);
+    // Sets the speed of a single wheel
+    void setWheelSpeed(int wheel, const AngularVelocity& speed);
 
     // Helper methods for setting many wheel speeds at once, without having to
     // know the names of each of the wheels
@@ -112,28 +139,39 @@ public:
     void setWheelSpeedsForCurveRight(double fractionOfMaxSpeed, const Meters& radius);
     void stopAllWheels();
 
-    // Returns the encoder type of the wheel given by name
-    EncoderType getWheelEncoderType(const QString& name) const;
+    // Returns the rates at which the mouse would move forward and turn,
+    // respectively, if the wheel speeds were set by the corresponding helper
+    // method above; used to perform movements instantly, without simulation
+    QPair<MetersPerSecond, RadiansPerSecond> getRatesOfChangeForMoveForward(
+        double fractionOfMaxSpeed) const;
+    QPair<MetersPerSecond, RadiansPerSecond> getRatesOfChangeForCurveLeft(
+        double fractionOfMaxSpeed, const Meters& radius) const;
+    QPair<MetersPerSecond, RadiansPerSecond> getRatesOfChangeForCurveRight(
+        double fractionOfMaxSpeed, const Meters& radius) const;
+
+    // Returns the encoder type of the wheel
+    EncoderType getWheelEncoderType(int wheel) const;
 
-    // Returns the number of encoder ticks per revolution
-    // for a particular wheel given by name
-    double getWheelEncoderTicksPerRevolution(const QString& name) const;
+    // Returns the number of encoder ticks per revolution of the wheel
+    double getWheelEncoderTicksPerRevolution(int wheel) const;
 
-    // Returns the reading of the encoder of the wheel given by name
-    int readWheelAbsoluteEncoder(const QString& name) const;
+    // Returns the reading of the absolute encoder of the wheel
+    int readWheelAbsoluteEncoder(int wheel) const;
 
-    // Returns the reading of the encoder of the wheel given by name
-    int readWheelRelativeEncoder(const QString& name) const;
+    // Returns the reading of the relative encoder of the wheel
+    int readWheelRelativeEncoder(int wheel) const;
 
     // Sets the value of the relative encoder to zero
-    void resetWheelRelativeEncoder(const QString& name);
+    void resetWheelRelativeEncoder(int wheel);
 
-    // Returns whether or not the mouse has a sensor by a particular name
-    bool hasSensor(const QString& name) const;
+    // Returns the handle of the sensor by a particular name, or -1 if the
+    // mouse has no such sensor
+    int getSensorHandle(const QString& name) const;
 
     // Read a sensor, and returns a value from 0.0
-    // (completely free) to 1.0 (completely blocked)
-    double readSensor(const QString& name) const;
+    // (completely free) to 1.0 (completely blocked); the reading is computed
+    // on demand, and reused until the mouse moves
+    double readSensor(int sensor) const;
 
     // Returns the value of the gyroscope
     RadiansPerSecond readGyro() const;
@@ -159,16 +197,58 @@ private:
     Polygon m_initialBodyPolygon; // The polygon of strictly the body of the mouse
     Polygon m_initialCollisionPolygon; // The polygon containing all collidable parts of the mouse
     Polygon m_initialCenterOfMassPolygon; // The polygon overlaying the center of mass of the mouse
-    QMap<QString, Wheel> m_wheels; // The wheels of the mouse
-    QMap<QString, Sensor> m_sensors; // The sensors on the mouse
+
+    // The wheels and sensors of the mouse, indexed by handle (i.e., in order
+    // of name), and the handles of each of the names
+    QVector<Wheel> m_wheels;
+    QVector<Sensor> m_sensors;
+    QMap<QString, int> m_wheelHandles;
+    QMap<QString, int> m_sensorHandles;
+
+    // The per-wheel data that's needed every tick, compiled at reload() into
+    // flat tables indexed by handle, so that update() is a tight loop with
+    // no lookups or allocation. The unit effects are the forward, sideways,
+    // and turn rates caused by the wheel at a speed of 1.0 rad/s, and the
+    // adjustment factors are as described in getWheelSpeedAdjustmentFactors.
+    QVector<double> m_wheelUnitForwardEffects; // Meters per second
+    QVector<double> m_wheelUnitSidewaysEffects; // Meters per second
+    QVector<double> m_wheelUnitTurnEffects; // Radians per second
+    QVector<double> m_wheelForwardAdjustmentFactors;
+    QVector<double> m_wheelTurnAdjustmentFactors;
+    QVector<double> m_wheelMaxSpeeds; // Radians per second
+    QVector<double> m_wheelSpeeds; // Radians per second
+    QVector<double> m_wheelAbsoluteRotations; // Radians
+    QVector<double> m_wheelRelativeRotations; // Radians
+    void compileWheels(
+        const QMap<QString, Wheel>& wheels,
+        const QMap<QString, WheelEffect>& wheelEffects,
+        const QMap<QString, QPair<double, double>>& wheelSpeedAdjustmentFactors);
+
+    // The pose of each sensor in the mouse's frame of reference, i.e.,
+    // relative to the center of the mouse when it's facing east
+    QVector<units::Vector> m_sensorOffsets;
+    QVector<units::Angle> m_sensorDirectionOffsets;
+
+    // The most recent reading of each sensor, and the pose version at which
+    // it was taken. Readings are expensive (each casts many rays), and most
+    // algorithms read few sensors, if any, so they're computed lazily.
+    mutable QVector<double> m_sensorReadings;
+    mutable QVector<qint64> m_sensorReadingPoseVersions;
+    void compileSensors(const QMap<QString, Sensor>& sensors);
 
     // The effect that each wheel has on mouse forward, sideways, and turn movements
-    QMap<QString, WheelEffect> m_wheelEffects;
     QMap<QString, WheelEffect> getWheelEffects(
         const Cartesian& initialTranslation,
         const Radians& initialRotation,
         const QMap<QString, Wheel>& wheels) const;
 
+    // Whether or not the mouse is a two-wheel differential drive, in which
+    // case update() can skip the sideways effects, which are all zero
+    bool m_isDifferentialDrive;
+    bool isDifferentialDrive(
+        const QMap<QString, Wheel>& wheels,
+        const QMap<QString, WheelEffect>& wheelEffects) const;
+
     // The fractions of a each wheel's max speed that cause the mouse to
     // perform the move forward and turn movements, respectively, as optimally
     // as possible. Note that "as optimally as possible" is purposefully
@@ -176,7 +256,6 @@ private:
     // moving sideways, and/or turn without moving forward or sideways.
     // Also note that the fractions are in [-1.0, 1.0], so that the max wheel
     // speed is never exceeded.
-    QMap<QString, QPair<double, double>> m_wheelSpeedAdjustmentFactors;
     QMap<QString, QPair<double, double>> getWheelSpeedAdjustmentFactors(
         const QMap<QString, Wheel>& wheels,
         const QMap<QString, WheelEffect>& wheelEffects) const;
@@ -192,6 +271,12 @@ private:
     Cartesian m_currentTranslation;
     Radians m_currentRotation;
 
+    // Incremented whenever the translation or rotation changes
+    qint64 m_poseVersion;
+
+    // Incremented whenever the translation, rotation, or wheel speeds change
+    qint64 m_appearanceVersion;
+
     // Ensures that reads/updates happen atomically,
     // mutable so we can use it in const functions
     mutable QMutex m_mutex;
@@ -204,13 +289,27 @@ private:
 
     // Retrieve the current position/rotation of sensor based on position/rotation of mouse
     QPair<Cartesian, Radians> getCurrentSensorPositionAndDirection(
-        const Sensor& sensor,
+        int sensor,
         const Cartesian& currentTranslation,
         const Radians& currentRotation) const;
 
     // Sets the wheel speed for a particular movement, based on the linear combo of the two factors
     void setWheelSpeedsForMovement(double fractionOfMaxSpeed, double forwardFactor, double turnFactor);
 
+    // Returns the rates at which the mouse moves forward and turns for a
+    // particular movement, based on the linear combo of the two factors
+    QPair<MetersPerSecond, RadiansPerSecond> getRatesOfChangeForMovement(
+        double fractionOfMaxSpeed, double forwardFactor, double turnFactor) const;
+
+    // Returns the forward and turn factors scaled such that the sum of their
+    // magnitudes is in [0.0, 1.0], and the resulting speed of a single wheel
+    QPair<double, double> getNormalizedMovementFactors(
+        double forwardFactor, double turnFactor) const;
+    double getWheelSpeedForMovement(
+        int wheel,
+        double fractionOfMaxSpeed,
+        const QPair<double, double>& normalizedFactors) const;
+
 };
 
 } // namespace mms
@@ -0,0 +1,108 @@
+#include "MouseCommand.h"
+
+namespace mms {
+
+const QMap<Opcode, CommandSchema>& OPCODE_TO_SCHEMA() {
+    using V = ValueType;
+    using R = ReplyType;
+    static const QMap<Opcode, CommandSchema> map = {
+
+        {Opcode::USE_CONTINUOUS_INTERFACE, {{}, 0, R::ACK}},
+        {Opcode::SET_INITIAL_DIRECTION, {{V::CHAR}, 1, R::ACK}},
+        {Opcode::SET_TILE_TEXT_ROWS_AND_COLS, {{V::INT, V::INT}, 2, R::ACK}},
+        {Opcode::SET_WHEEL_SPEED_FRACTION, {{V::DOUBLE}, 1, R::ACK}},
+        {Opcode::USE_BINARY_PROTOCOL, {{}, 0, R::ACK}},
+        {Opcode::USE_SHARED_MEMORY_TRANSPORT, {{}, 0, R::ACK}},
+
+        {Opcode::UPDATE_ALLOW_OMNISCIENCE, {{V::BOOL}, 1, R::ACK}},
+        {Opcode::UPDATE_AUTOMATICALLY_CLEAR_FOG, {{V::BOOL}, 1, R::ACK}},
+        {Opcode::UPDATE_DECLARE_BOTH_WALL_HALVES, {{V::BOOL}, 1, R::ACK}},
+        {Opcode::UPDATE_SET_TILE_TEXT_WHEN_DISTANCE_DECLARED,
+            {{V::BOOL}, 1, R::ACK}},
+        {Opcode::UPDATE_SET_TILE_BASE_COLOR_WHEN_DISTANCE_DECLARED_CORRECTLY,
+            {{V::BOOL}, 1, R::ACK}},
+        {Opcode::UPDATE_DECLARE_WALL_ON_READ, {{V::BOOL}, 1, R::ACK}},
+        {Opcode::UPDATE_USE_TILE_EDGE_MOVEMENTS, {{V::BOOL}, 1, R::ACK}},
+
+        {Opcode::MAZE_WIDTH, {{}, 0, R::INT}},
+        {Opcode::MAZE_HEIGHT, {{}, 0, R::INT}},
+        {Opcode::IS_OFFICIAL_MAZE, {{}, 0, R::BOOL}},
+        {Opcode::INITIAL_DIRECTION, {{}, 0, R::CHAR}},
+        {Opcode::GET_RANDOM_FLOAT, {{}, 0, R::DOUBLE}},
+        {Opcode::MILLIS, {{}, 0, R::INT}},
+        {Opcode::DELAY, {{V::INT}, 1, R::ACK}},
+        {Opcode::RESET_POSITION, {{}, 0, R::ACK}},
+        {Opcode::INPUT_BUTTON_PRESSED, {{V::INT}, 1, R::BOOL}},
+        {Opcode::ACKNOWLEDGE_INPUT_BUTTON_PRESSED, {{V::INT}, 1, R::ACK}},
+
+        {Opcode::SET_TILE_COLOR, {{V::INT, V::INT, V::CHAR}, 3, R::NONE}},
+        {Opcode::CLEAR_TILE_COLOR, {{V::INT, V::INT}, 2, R::NONE}},
+        {Opcode::CLEAR_ALL_TILE_COLOR, {{}, 0, R::NONE}},
+        {Opcode::SET_TILE_TEXT, {{V::INT, V::INT, V::STRING}, 2, R::NONE}},
+        {Opcode::CLEAR_TILE_TEXT, {{V::INT, V::INT}, 2, R::NONE}},
+        {Opcode::CLEAR_ALL_TILE_TEXT, {{}, 0, R::NONE}},
+        {Opcode::DECLARE_WALL,
+            {{V::INT, V::INT, V::CHAR, V::BOOL}, 4, R::NONE}},
+        {Opcode::UNDECLARE_WALL, {{V::INT, V::INT, V::CHAR}, 3, R::NONE}},
+        {Opcode::SET_TILE_FOGGINESS, {{V::INT, V::INT, V::BOOL}, 3, R::NONE}},
+        {Opcode::DECLARE_TILE_DISTANCE, {{V::INT, V::INT, V::INT}, 3, R::NONE}},
+        {Opcode::UNDECLARE_TILE_DISTANCE, {{V::INT, V::INT}, 2, R::NONE}},
+
+        // The fill commands take a rectangle (x, y, width, height), and the
+        // rest take a list of records, one per tile (or wall)
+        {Opcode::SET_TILE_COLORS, {{}, 0, R::NONE, {V::INT, V::INT, V::CHAR}}},
+        {Opcode::FILL_TILE_COLOR,
+            {{V::INT, V::INT, V::INT, V::INT, V::CHAR}, 5, R::NONE}},
+        {Opcode::SET_TILE_TEXTS, {{}, 0, R::NONE, {V::INT, V::INT, V::STRING}}},
+        {Opcode::FILL_TILE_TEXT,
+            {{V::INT, V::INT, V::INT, V::INT, V::STRING}, 5, R::NONE}},
+        {Opcode::SET_TILE_FOGGINESSES,
+            {{}, 0, R::NONE, {V::INT, V::INT, V::BOOL}}},
+        {Opcode::FILL_TILE_FOGGINESS,
+            {{V::INT, V::INT, V::INT, V::INT, V::BOOL}, 5, R::NONE}},
+        {Opcode::DECLARE_WALLS,
+            {{}, 0, R::NONE, {V::INT, V::INT, V::CHAR, V::BOOL}}},
+        {Opcode::DECLARE_TILE_DISTANCES, {{}, 0, R::NONE, {V::INT}}},
+
+        {Opcode::GET_WHEEL_MAX_SPEED, {{V::STRING}, 1, R::DOUBLE}},
+        {Opcode::SET_WHEEL_SPEED, {{V::STRING, V::DOUBLE}, 2, R::ACK}},
+        {Opcode::GET_WHEEL_ENCODER_TICKS_PER_REVOLUTION,
+            {{V::STRING}, 1, R::DOUBLE}},
+        {Opcode::READ_WHEEL_ENCODER, {{V::STRING}, 1, R::INT}},
+        {Opcode::RESET_WHEEL_ENCODER, {{V::STRING}, 1, R::ACK}},
+        {Opcode::READ_SENSOR, {{V::STRING}, 1, R::DOUBLE}},
+        {Opcode::READ_GYRO, {{}, 0, R::DOUBLE}},
+
+        {Opcode::WALL_FRONT, {{}, 0, R::BOOL}},
+        {Opcode::WALL_RIGHT, {{}, 0, R::BOOL}},
+        {Opcode::WALL_LEFT, {{}, 0, R::BOOL}},
+        {Opcode::MOVE_FORWARD, {{V::INT}, 0, R::ACK}},
+        {Opcode::TURN_LEFT, {{}, 0, R::ACK}},
+        {Opcode::TURN_RIGHT, {{}, 0, R::ACK}},
+        {Opcode::TURN_AROUND_LEFT, {{}, 0, R::ACK}},
+        {Opcode::TURN_AROUND_RIGHT, {{}, 0, R::ACK}},
+
+        {Opcode::ORIGIN_MOVE_FORWARD_TO_EDGE, {{}, 0, R::ACK}},
+        {Opcode::ORIGIN_TURN_LEFT_IN_PLACE, {{}, 0, R::ACK}},
+        {Opcode::ORIGIN_TURN_RIGHT_IN_PLACE, {{}, 0, R::ACK}},
+        {Opcode::MOVE_FORWARD_TO_EDGE, {{V::INT}, 0, R::ACK}},
+        {Opcode::TURN_LEFT_TO_EDGE, {{}, 0, R::ACK}},
+        {Opcode::TURN_RIGHT_TO_EDGE, {{}, 0, R::ACK}},
+        {Opcode::TURN_AROUND_LEFT_TO_EDGE, {{}, 0, R::ACK}},
+        {Opcode::TURN_AROUND_RIGHT_TO_EDGE, {{}, 0, R::ACK}},
+        {Opcode::DIAGONAL_LEFT_LEFT, {{V::INT}, 1, R::ACK}},
+        {Opcode::DIAGONAL_LEFT_RIGHT, {{V::INT}, 1, R::ACK}},
+        {Opcode::DIAGONAL_RIGHT_LEFT, {{V::INT}, 1, R::ACK}},
+        {Opcode::DIAGONAL_RIGHT_RIGHT, {{V::INT}, 1, R::ACK}},
+
+        {Opcode::CURRENT_X_TILE, {{}, 0, R::INT}},
+        {Opcode::CURRENT_Y_TILE, {{}, 0, R::INT}},
+        {Opcode::CURRENT_DIRECTION, {{}, 0, R::CHAR}},
+        {Opcode::CURRENT_X_POS_METERS, {{}, 0, R::DOUBLE}},
+        {Opcode::CURRENT_Y_POS_METERS, {{}, 0, R::DOUBLE}},
+        {Opcode::CURRENT_ROTATION_DEGREES, {{}, 0, R::DOUBLE}},
+    };
+    return map;
+}
+
+} // namespace mms
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include "Opcode.h"
+
+namespace mms {
+
+// The type of an argument of a command, or of the value in its reply
+enum class ValueType {
+    INT,
+    DOUBLE,
+    CHAR,
+    BOOL,
+    STRING,
+};
+
+// What, if anything, the simulator replies to a command with. Tile appearance
+// commands don't get a reply at all (so that they don't block the algorithm),
+// and commands that don't return a value are simply acknowledged.
+enum class ReplyType {
+    NONE,
+    ACK,
+    INT,
+    DOUBLE,
+    CHAR,
+    BOOL,
+};
+
+// The arguments of a command, and the type of its reply. Only the trailing
+// arguments past numRequiredArguments may be omitted. Bulk commands also have
+// a record, i.e., a group of arguments that follows all of the others and
+// that may be repeated any number of times (e.g., a cell and its color).
+struct CommandSchema {
+    QVector<ValueType> arguments;
+    int numRequiredArguments;
+    ReplyType reply;
+    QVector<ValueType> record;
+    bool acceptsNumArguments(int numArguments) const {
+        return numRequiredArguments <= numArguments &&
+            numArguments <= arguments.size();
+    }
+};
+
+const QMap<Opcode, CommandSchema>& OPCODE_TO_SCHEMA();
+
+// An argument of a command or the value of a reply; only the member
+// corresponding to the ValueType (or ReplyType) is meaningful
+struct MouseValue {
+    int integer = 0;
+    double real = 0.0;
+    char character = '\0';
+    bool boolean = false;
+    QString string;
+};
+
+// A decoded command, independent of the protocol it was sent with. The
+// values of the records, if any, are stored one after another, and only the
+// first numRecords * schema.record.size() of them are meaningful; since that
+// vector never shrinks, reusing a command avoids allocating for every record.
+struct MouseCommand {
+    static const int MAX_ARGUMENTS = 5;
+    Opcode opcode;
+    int numArguments = 0;
+    MouseValue arguments[MAX_ARGUMENTS];
+    int numRecords = 0;
+    QVector<MouseValue> records;
+    MouseValue* recordValue(int index) {
+        if (records.size() <= index) {
+            records.resize(index + 1);
+        }
+        return &records[index];
+    }
+};
+
+} // namespace mms
@@ -8,7 +8,44 @@
 namespace mms {
 
 MouseGraphic::MouseGraphic(const Mouse* mouse) :
-    m_mouse(mouse) {
+        m_mouse(mouse),
+        m_wheelSpeedIndicatorColor(STRING_TO_COLOR().value(P()->mouseWheelSpeedIndicatorColor())),
+        m_viewColor(STRING_TO_COLOR().value(P()->mouseViewColor())) {
+
+    // The rigid parts of the mouse, at the initial pose
+    Cartesian translation = m_mouse->getInitialTranslation();
+    Radians rotation = m_mouse->getInitialRotation();
+
+    // First, we draw the body
+    SimUtilities::polygonToTriangleGraphics(
+        m_mouse->getCurrentBodyPolygon(translation, rotation),
+        STRING_TO_COLOR().value(P()->mouseBodyColor()), 1.0, &m_staticTriangles);
+
+    // Next, draw the center of mass
+    SimUtilities::polygonToTriangleGraphics(
+        m_mouse->getCurrentCenterOfMassPolygon(translation, rotation),
+        STRING_TO_COLOR().value(P()->mouseCenterOfMassColor()), 1.0, &m_staticTriangles);
+
+    // Next, we draw the wheels
+    for (int i = 0; i < m_mouse->getWheelCount(); i += 1) {
+        SimUtilities::polygonToTriangleGraphics(
+            m_mouse->getCurrentWheelPolygon(i, translation, rotation),
+            STRING_TO_COLOR().value(P()->mouseWheelColor()), 1.0, &m_staticTriangles);
+    }
+
+    // Lastly, we draw the sensors
+    for (int i = 0; i < m_mouse->getSensorCount(); i += 1) {
+        SimUtilities::polygonToTriangleGraphics(
+            m_mouse->getCurrentSensorPolygon(i, translation, rotation),
+            STRING_TO_COLOR().value(P()->mouseSensorColor()), 1.0, &m_staticTriangles);
+    }
+
+    // Uncomment to draw collision polygon
+    /*
+    SimUtilities::polygonToTriangleGraphics(
+        m_mouse->getCurrentCollisionPolygon(translation, rotation),
+        Color::GRAY, .5, &m_staticTriangles);
+    */
 }
 
 Cartesian MouseGraphic::getInitialMouseTranslation() const {
@@ -22,62 +59,38 @@ QPair<Cartesian, Radians> MouseGraphic::getCurrentMousePosition() const {
     };
 }
 
-QVector<TriangleGraphic> MouseGraphic::draw(
-        const Coordinate& currentTranslation,
-        const Angle& currentRotation) const {
-
-    QVector<TriangleGraphic> buffer;
-
-    // First, we draw the body
-    buffer.append(SimUtilities::polygonToTriangleGraphics(
-        m_mouse->getCurrentBodyPolygon(currentTranslation, currentRotation),
-        STRING_TO_COLOR().value(P()->mouseBodyColor()), 1.0));
-
-    // Next, draw the center of mass
-    buffer.append(SimUtilities::polygonToTriangleGraphics(
-        m_mouse->getCurrentCenterOfMassPolygon(currentTranslation, currentRotation),
-        STRING_TO_COLOR().value(P()->mouseCenterOfMassColor()), 1.0));
+qint64 MouseGraphic::getAppearanceVersion() const {
+    return m_mouse->getAppearanceVersion();
+}
 
-    // Next, we draw the wheels
-    for (const Polygon& wheelPolygon :
-            m_mouse->getCurrentWheelPolygons(currentTranslation, currentRotation)) {
-        buffer.append(SimUtilities::polygonToTriangleGraphics(
-            wheelPolygon,
-            STRING_TO_COLOR().value(P()->mouseWheelColor()), 1.0));
-    }
+const QVector<TriangleGraphic>* MouseGraphic::getStaticTriangles() const {
+    return &m_staticTriangles;
+}
 
-    // Next, we draw the wheel speed indicators
-    for (const Polygon& wheelSpeedIndicatorPolygon :
-            m_mouse->getCurrentWheelSpeedIndicatorPolygons(currentTranslation, currentRotation)) {
-        buffer.append(SimUtilities::polygonToTriangleGraphics(
-            wheelSpeedIndicatorPolygon,
-            STRING_TO_COLOR().value(P()->mouseWheelSpeedIndicatorColor()), 1.0));
-    }
+Transform MouseGraphic::getCurrentTransform(
+        const Coordinate& currentTranslation,
+        const Angle& currentRotation) const {
+    return m_mouse->getCurrentTransform(currentTranslation, currentRotation);
+}
 
-    // Next, we draw the sensors
-    for (const Polygon& sensorPolygon :
-            m_mouse->getCurrentSensorPolygons(currentTranslation, currentRotation)) {
-        buffer.append(SimUtilities::polygonToTriangleGraphics(
-            sensorPolygon,
-            STRING_TO_COLOR().value(P()->mouseSensorColor()), 1.0));
+void MouseGraphic::draw(
+        const Coordinate& currentTranslation,
+        const Angle& currentRotation,
+        QVector<TriangleGraphic>* buffer) const {
+
+    // First, we draw the wheel speed indicators
+    for (int i = 0; i < m_mouse->getWheelCount(); i += 1) {
+        SimUtilities::polygonToTriangleGraphics(
+            m_mouse->getCurrentWheelSpeedIndicatorPolygon(i, currentTranslation, currentRotation),
+            m_wheelSpeedIndicatorColor, 1.0, buffer);
     }
 
     // Lastly, we draw the sensor views
-    for (const Polygon& polygon :
-            m_mouse->getCurrentSensorViewPolygons(currentTranslation, currentRotation)) {
-        buffer.append(SimUtilities::polygonToTriangleGraphics(
-            polygon,
-            STRING_TO_COLOR().value(P()->mouseViewColor()), 1.0));
+    for (int i = 0; i < m_mouse->getSensorCount(); i += 1) {
+        SimUtilities::polygonToTriangleGraphics(
+            m_mouse->getCurrentSensorViewPolygon(i, currentTranslation, currentRotation),
+            m_viewColor, 1.0, buffer);
     }
-
-    // Uncomment to draw collision polygon
-    /*
-    buffer.append(SimUtilities::polygonToTriangleGraphics(
-        m_mouse->getCurrentCollisionPolygon(currentTranslation, currentRotation),
-        Color::GRAY, .5);
-    */
-
-    return buffer;
 }
 
 } // namespace mms
@@ -3,7 +3,9 @@
 #include <QPair>
 #include <QVector>
 
+#include "Color.h"
 #include "Mouse.h"
+#include "Transform.h"
 #include "TriangleGraphic.h"
 #include "units/Cartesian.h"
 #include "units/Radians.h"
@@ -14,18 +16,42 @@ class MouseGraphic {
 
 public:
 
+    // Note that the mouse must already be loaded, since its rigid parts are
+    // converted to triangles just once, here
     MouseGraphic(const Mouse* mouse);
 
     Cartesian getInitialMouseTranslation() const;
     QPair<Cartesian, Radians> getCurrentMousePosition() const;
 
-    QVector<TriangleGraphic> draw(
+    // Changes whenever the mouse would be drawn differently
+    qint64 getAppearanceVersion() const;
+
+    // The triangles of the rigid parts of the mouse (the body, center of
+    // mass, wheels, and sensors), as positioned at the mouse's initial pose.
+    // These never change, so they only need to be uploaded once, and can be
+    // drawn at any pose by applying getCurrentTransform() to them.
+    const QVector<TriangleGraphic>* getStaticTriangles() const;
+    Transform getCurrentTransform(
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const;
 
+    // Appends the triangles of the parts of the mouse that change shape (the
+    // wheel speed indicators and the sensor views) to buffer; this doesn't
+    // allocate, so long as the buffer already has enough capacity (e.g., if
+    // it's reused from the previous frame)
+    void draw(
+        const Coordinate& currentTranslation,
+        const Angle& currentRotation,
+        QVector<TriangleGraphic>* buffer) const;
+
 private:
 
     const Mouse* m_mouse;
+    QVector<TriangleGraphic> m_staticTriangles;
+
+    // Looked up once, rather than on every frame
+    Color m_wheelSpeedIndicatorColor;
+    Color m_viewColor;
 
 };
 
@@ -1,8 +1,11 @@
 #include "MouseInterface.h"
 
 #include <QChar>
+#include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QPair>
+#include <QTimer>
 #include <QtMath>
 
 #include "units/Meters.h"
@@ -13,13 +16,16 @@
 #include "units/Seconds.h"
 
 #include "Assert.h"
+#include "BinaryProtocol.h"
 #include "Color.h"
+#include "CommandTable.h"
 #include "FontImage.h"
 #include "Logging.h"
 #include "Param.h"
 #include "SimTime.h"
 #include "SimUtilities.h"
 #include "State.h"
+#include "TextProtocol.h"
 
 // Helper function/macro that ensures that user-requested stops
 // can always interrupt the currently executing algorithm
@@ -27,7 +33,12 @@
     if (m_stopRequested) {\
         break;\
     }\
-    SimUtilities::sleep(Milliseconds(P()->minSleepDuration()));\
+    if (m_model->getSimTime()->lockStepEnabled()) {\
+        m_model->getSimTime()->awaitTick();\
+    }\
+    else {\
+        SimUtilities::sleep(Milliseconds(P()->minSleepDuration()));\
+    }\
 }
 
 namespace mms {
@@ -35,10 +46,17 @@ namespace mms {
 MouseInterface::MouseInterface(
         const Maze* maze,
         Mouse* mouse,
-        MazeView* view) :
+        MazeView* view,
+        Model* model) :
         m_maze(maze),
         m_mouse(mouse),
         m_view(view),
+        m_model(model),
+        m_useBinaryProtocol(false),
+        m_sharedMemoryTransport(nullptr),
+        m_sharedMemoryTransportStarted(false),
+        m_instantMovementsEnabled(false),
+        m_generator(P()->randomSeed()),
         m_interfaceType(InterfaceType::DISCRETE),
         m_interfaceTypeFinalized(false),
         m_stopRequested(false),
@@ -57,348 +75,430 @@ void MouseInterface::emitMouseAlgoCannotStart(QString errorString) {
     emit mouseAlgoCannotStart(errorString);
 }
 
-QString MouseInterface::dispatch(const QString& command) {
-
-    // TODO: upforgrabs
-    // These functions should have sanity checks, e.g., correct
-    // types, not finalizing static options more than once, etc.
-
-    static const QString ACK_STRING = "ACK";
-    static const QString NO_ACK_STRING = "";
-    static const QString ERROR_STRING = "!";
+QByteArray MouseInterface::handleStandardError(const QByteArray& bytes) {
 
-    QStringList tokens = command.split(" ", QString::SkipEmptyParts);
-    QString function = tokens.at(0);
+    m_commandReader.append(bytes);
+    QByteArray replies;
 
-    // TODO: MACK - maybe just call these "update"?
-    if (function == "useContinuousInterface") {
-        if (m_interfaceTypeFinalized) {
-            // TODO: MACK - error string here
+    // Note that the protocol can change partway through the bytes, since an
+    // algorithm may send binary frames right after asking to use them
+    const char* data = nullptr;
+    int size = 0;
+    while (true) {
+        if (m_useBinaryProtocol) {
+            if (!m_commandReader.nextFrame(&data, &size)) {
+                break;
+            }
+            dispatchFrame(data, size, &replies);
         }
         else {
-            m_interfaceType = InterfaceType::CONTINUOUS;
+            if (!m_commandReader.nextLine(&data, &size)) {
+                break;
+            }
+            if (0 < size) {
+                dispatchLine(data, size, &replies);
+            }
         }
-        return ACK_STRING;
-    }
-    else if (function == "setInitialDirection") {
-        char direction = SimUtilities::strToChar(tokens.at(1));
-        setStartingDirection(direction);
-        return ACK_STRING;
-    }
-    else if (function == "setTileTextRowsAndCols") {
-        // TODO: MACK - validation
-        // if (tileTextNumberOfRows < 0 || tileTextNumberOfCols < 0) {
-        //     qCritical().noquote().nospace()
-        //         << "Both tileTextNumberOfRows() and tileTextNumberOfCols() must"
-        //         << " return non-negative integers. Since they return \""
-        //         << tileTextNumberOfRows << "\" and \"" << tileTextNumberOfCols
-        //         << "\", respectively, the tile text dimensions of the mouse"
-        //         << " algorithm \"" << mouseAlgorithm << "\" are invalid.";
-        //     SimUtilities::quit();
-        // }
-        int rows = SimUtilities::strToInt(tokens.at(1));
-        int cols = SimUtilities::strToInt(tokens.at(2));
-        m_view->initTileGraphicText(rows, cols);
-        return ACK_STRING;
-    }
-    else if (function == "setWheelSpeedFraction") {
-        setWheelSpeedFraction(
-            SimUtilities::strToDouble(tokens.at(1)));
-        return ACK_STRING;
-    }
-    else if (function == "updateAllowOmniscience") {
-        m_dynamicOptions.allowOmniscience =
-            SimUtilities::strToBool(tokens.at(1));
-        return ACK_STRING;
-    }
-    else if (function == "updateAutomaticallyClearFog") {
-        m_dynamicOptions.automaticallyClearFog =
-            SimUtilities::strToBool(tokens.at(1));
-        return ACK_STRING;
-    }
-    else if (function == "updateDeclareBothWallHalves") {
-        m_dynamicOptions.declareBothWallHalves =
-            SimUtilities::strToBool(tokens.at(1));
-        return ACK_STRING;
-    }
-    else if (function == "updateSetTileTextWhenDistanceDeclared") {
-        m_dynamicOptions.setTileTextWhenDistanceDeclared =
-            SimUtilities::strToBool(tokens.at(1));
-        return ACK_STRING;
-    }
-    else if (function == "updateSetTileBaseColorWhenDistanceDeclaredCorrectly") {
-        m_dynamicOptions.setTileBaseColorWhenDistanceDeclaredCorrectly =
-            SimUtilities::strToBool(tokens.at(1));
-        return ACK_STRING;
-    }
-    else if (function == "updateDeclareWallOnRead") {
-        m_dynamicOptions.declareWallOnRead =
-            SimUtilities::strToBool(tokens.at(1));
-        return ACK_STRING;
-    }
-    else if (function == "updateUseTileEdgeMovements") {
-        m_dynamicOptions.useTileEdgeMovements =
-            SimUtilities::strToBool(tokens.at(1));
-        return ACK_STRING;
-    }
-    else if (function == "mazeWidth") {
-        return QString::number(m_maze->getWidth());
-    }
-    else if (function == "mazeHeight") {
-        return QString::number(m_maze->getHeight());
-    }
-    else if (function == "isOfficialMaze") {
-        return QString::number(m_maze->isOfficialMaze());
-    }
-    else if (function == "initialDirection") {
-        return QString(QChar(getStartedDirection()));
-    }
-    else if (function == "getRandomFloat") {
-        return QString::number(getRandom());
-    }
-    else if (function == "millis") {
-        return QString::number(millis());
-    }
-    else if (function == "delay") {
-        int milliseconds = SimUtilities::strToInt(tokens.at(1));
-        delay(milliseconds);
-        return ACK_STRING;
-    }
-    else if (function == "setTileColor") {
-        int x = SimUtilities::strToInt(tokens.at(1));
-        int y = SimUtilities::strToInt(tokens.at(2));
-        char color = SimUtilities::strToChar(tokens.at(3));
-        setTileColor(x, y, color);
-        return NO_ACK_STRING;
-    }
-    else if (function == "clearTileColor") {
-        int x = SimUtilities::strToInt(tokens.at(1));
-        int y = SimUtilities::strToInt(tokens.at(2));
-        clearTileColor(x, y);
-        return NO_ACK_STRING;
-    }
-    else if (function == "clearAllTileColor") {
-        clearAllTileColor();
-        return NO_ACK_STRING;
-    }
-    else if (function == "setTileText") {
-        int x = SimUtilities::strToInt(tokens.at(1));
-        int y = SimUtilities::strToInt(tokens.at(2));
-        QString text = "";
-        if (3 < tokens.size()) {
-            text = tokens.at(3);
-        }
-        setTileText(x, y, text);
-        return NO_ACK_STRING;
-    }
-    else if (function == "clearTileText") {
-        int x = SimUtilities::strToInt(tokens.at(1));
-        int y = SimUtilities::strToInt(tokens.at(2));
-        clearTileText(x, y);
-        return NO_ACK_STRING;
-    }
-    else if (function == "clearAllTileText") {
-        clearAllTileText();
-        return NO_ACK_STRING;
-    }
-    else if (function == "declareWall") {
-        int x = SimUtilities::strToInt(tokens.at(1));
-        int y = SimUtilities::strToInt(tokens.at(2));
-        char direction = SimUtilities::strToChar(tokens.at(3));
-        bool wallExists = SimUtilities::strToBool(tokens.at(4));
-        declareWall(x, y, direction, wallExists);
-        return NO_ACK_STRING;
-    }
-    else if (function == "undeclareWall") {
-        int x = SimUtilities::strToInt(tokens.at(1));
-        int y = SimUtilities::strToInt(tokens.at(2));
-        char direction = SimUtilities::strToChar(tokens.at(3));
-        undeclareWall(x, y, direction);
-        return NO_ACK_STRING;
-    }
-    else if (function == "setTileFogginess") {
-        int x = SimUtilities::strToInt(tokens.at(1));
-        int y = SimUtilities::strToInt(tokens.at(2));
-        bool foggy = SimUtilities::strToBool(tokens.at(3));
-        setTileFogginess(x, y, foggy);
-        return NO_ACK_STRING;
-    }
-    else if (function == "declareTileDistance") {
-        int x = SimUtilities::strToInt(tokens.at(1));
-        int y = SimUtilities::strToInt(tokens.at(2));
-        int distance = SimUtilities::strToInt(tokens.at(3));
-        declareTileDistance(x, y, distance);
-        return NO_ACK_STRING;
-    }
-    else if (function == "undeclareTileDistance") {
-        int x = SimUtilities::strToInt(tokens.at(1));
-        int y = SimUtilities::strToInt(tokens.at(2));
-        undeclareTileDistance(x, y);
-        return NO_ACK_STRING;
-    }
-    else if (function == "resetPosition") {
-        resetPosition();
-        return ACK_STRING;
-    }
-    else if (function == "inputButtonPressed") {
-        int inputButton = SimUtilities::strToInt(tokens.at(1));
-        return SimUtilities::boolToStr(
-            inputButtonPressed(inputButton)
-        );
     }
-    else if (function == "acknowledgeInputButtonPressed") {
-        int inputButton = SimUtilities::strToInt(tokens.at(1));
-        acknowledgeInputButtonPressed(inputButton);
-        return ACK_STRING;
-    }
-    else if (function == "getWheelMaxSpeed") {
-        QString name = tokens.at(1);
-        return QString::number(getWheelMaxSpeed(name));
-    }
-    else if (function == "setWheelSpeed") {
-        QString name = tokens.at(1);
-        double rpm = SimUtilities::strToDouble(tokens.at(2));
-        setWheelSpeed(name, rpm);
-        return ACK_STRING;
-    }
-    else if (function == "getWheelEncoderTicksPerRevolution") {
-        QString name = tokens.at(1);
-        return QString::number(
-            getWheelEncoderTicksPerRevolution(name)
-        );
-    }
-    else if (function == "readWheelEncoder") {
-        QString name = tokens.at(1);
-        return QString::number(
-            readWheelEncoder(name)
-        );
-    }
-    else if (function == "resetWheelEncoder") {
-        QString name = tokens.at(1);
-        resetWheelEncoder(name);
-        return ACK_STRING;
-    }
-    else if (function == "readSensor") {
-        QString name = tokens.at(1);
-        return QString::number(readSensor(name));
-    }
-    else if (function == "readGyro") {
-        QString name = tokens.at(1);
-        return QString::number(readGyro());
-    }
-    else if (function == "wallFront") {
-        return SimUtilities::boolToStr(wallFront());
-    }
-    else if (function == "wallRight") {
-        return SimUtilities::boolToStr(wallRight());
-    }
-    else if (function == "wallLeft") {
-        return SimUtilities::boolToStr(wallLeft());
-    }
-    else if (function == "moveForward") {
-        int count = 1;
-        if (1 < tokens.size()) {
-            count = SimUtilities::strToInt(tokens.at(1));
+
+    return replies;
+}
+
+void MouseInterface::dispatchLine(const char* line, int size, QByteArray* replies) {
+    MouseCommand& command = m_command;
+    if (!TextProtocol::decodeCommand(line, size, &command)) {
+        qWarning().noquote().nospace()
+            << "Invalid command from the mouse algorithm: \""
+            << QString::fromUtf8(line, size) << "\"";
+        if (expectsReply(TextProtocol::decodeEntry(line, size))) {
+            TextProtocol::encodeError(replies);
         }
-        moveForward(count);
-        return ACK_STRING;
-    }
-    else if (function == "turnLeft") {
-        turnLeft();
-        return ACK_STRING;
-    }
-    else if (function == "turnRight") {
-        turnRight();
-        return ACK_STRING;
-    }
-    else if (function == "turnAroundLeft") {
-        turnAroundLeft();
-        return ACK_STRING;
-    }
-    else if (function == "turnAroundRight") {
-        turnAroundRight();
-        return ACK_STRING;
-    }
-    else if (function == "originMoveForwardToEdge") {
-        originMoveForwardToEdge();
-        return ACK_STRING;
-    }
-    else if (function == "originTurnLeftInPlace") {
-        originTurnLeftInPlace();
-        return ACK_STRING;
-    }
-    else if (function == "originTurnRightInPlace") {
-        originTurnRightInPlace();
-        return ACK_STRING;
+        return;
     }
-    else if (function == "moveForwardToEdge") {
-        int count = 1;
-        if (1 < tokens.size()) {
-            count = SimUtilities::strToInt(tokens.at(1));
+    const CommandEntry* entry = CommandTable::get(command.opcode);
+    MouseValue reply;
+    if (!execute(command, &reply)) {
+        if (expectsReply(entry)) {
+            TextProtocol::encodeError(replies);
         }
-        moveForwardToEdge(count);
-        return ACK_STRING;
-    }
-    else if (function == "turnLeftToEdge") {
-        turnLeftToEdge();
-        return ACK_STRING;
-    }
-    else if (function == "turnRightToEdge") {
-        turnRightToEdge();
-        return ACK_STRING;
-    }
-    else if (function == "turnAroundLeftToEdge") {
-        turnAroundLeftToEdge();
-        return ACK_STRING;
-    }
-    else if (function == "turnAroundRightToEdge") {
-        turnAroundRightToEdge();
-        return ACK_STRING;
-    }
-    else if (function == "diagonalLeftLeft") {
-        int count = SimUtilities::strToInt(tokens.at(1));
-        diagonalLeftLeft(count);
-        return ACK_STRING;
-    }
-    else if (function == "diagonalLeftRight") {
-        int count = SimUtilities::strToInt(tokens.at(1));
-        diagonalLeftRight(count);
-        return ACK_STRING;
-    }
-    else if (function == "diagonalRightLeft") {
-        int count = SimUtilities::strToInt(tokens.at(1));
-        diagonalRightLeft(count);
-        return ACK_STRING;
-    }
-    else if (function == "diagonalRightRight") {
-        int count = SimUtilities::strToInt(tokens.at(1));
-        diagonalRightRight(count);
-        return ACK_STRING;
-    }
-    else if (function == "currentXTile") {
-        return QString::number(currentXTile());
-    }
-    else if (function == "currentYTile") {
-        return QString::number(currentYTile());
-    }
-    else if (function == "currentDirection") {
-        return QString(QChar(currentDirection()));
+        return;
     }
-    else if (function == "currentXPosMeters") {
-        return QString::number(currentXPosMeters());
+    TextProtocol::encodeReply(entry->schema.reply, reply, replies);
+}
+
+void MouseInterface::dispatchFrame(const char* payload, int size, QByteArray* replies) {
+    MouseCommand& command = m_command;
+    if (!BinaryProtocol::decodeCommand(payload, size, &command)) {
+        qWarning().noquote().nospace()
+            << "Invalid binary command from the mouse algorithm (opcode "
+            << (0 < size ? static_cast<quint8>(payload[0]) : 0) << ")";
+        if (expectsReply(BinaryProtocol::decodeEntry(payload, size))) {
+            BinaryProtocol::encodeError(replies);
+        }
+        return;
     }
-    else if (function == "currentYPosMeters") {
-        return QString::number(currentYPosMeters());
+    const CommandEntry* entry = CommandTable::get(command.opcode);
+    MouseValue reply;
+    if (!execute(command, &reply)) {
+        if (expectsReply(entry)) {
+            BinaryProtocol::encodeError(replies);
+        }
+        return;
     }
-    else if (function == "currentRotationDegrees") {
-        return QString::number(currentRotationDegrees());
+    BinaryProtocol::encodeReply(entry->schema.reply, reply, replies);
+}
+
+bool MouseInterface::expectsReply(const CommandEntry* entry) {
+    return entry != nullptr && entry->schema.reply != ReplyType::NONE;
+}
+
+bool MouseInterface::execute(const MouseCommand& command, MouseValue* reply) {
+
+    // TODO: upforgrabs
+    // These functions should have more sanity checks, e.g., not finalizing
+    // static options more than once, etc. Note that the arguments have
+    // already been checked against the command's schema.
+
+    const MouseValue* args = command.arguments;
+
+    switch (command.opcode) {
+
+        // TODO: MACK - maybe just call these "update"?
+        case Opcode::USE_CONTINUOUS_INTERFACE:
+            if (m_interfaceTypeFinalized) {
+                // TODO: MACK - error string here
+            }
+            else {
+                m_interfaceType = InterfaceType::CONTINUOUS;
+            }
+            break;
+        case Opcode::SET_INITIAL_DIRECTION:
+            setStartingDirection(args[0].character);
+            break;
+        case Opcode::SET_TILE_TEXT_ROWS_AND_COLS:
+            m_view->initTileGraphicText(args[0].integer, args[1].integer);
+            break;
+        case Opcode::SET_WHEEL_SPEED_FRACTION:
+            setWheelSpeedFraction(args[0].real);
+            break;
+        case Opcode::USE_BINARY_PROTOCOL:
+            // The acknowledgement is still sent with the current protocol
+            m_useBinaryProtocol = true;
+            break;
+        case Opcode::USE_SHARED_MEMORY_TRANSPORT:
+            // The algorithm falls back to stdio if this fails
+            if (m_sharedMemoryTransport == nullptr) {
+                return false;
+            }
+            if (!m_sharedMemoryTransportStarted) {
+                m_sharedMemoryTransportStarted = true;
+                // Serve the transport once we're back in the event loop,
+                // i.e., after this command has been acknowledged
+                QTimer::singleShot(0, this, [this](){
+                    serveSharedMemoryTransport();
+                });
+            }
+            break;
+
+        case Opcode::UPDATE_ALLOW_OMNISCIENCE:
+            m_dynamicOptions.allowOmniscience = args[0].boolean;
+            break;
+        case Opcode::UPDATE_AUTOMATICALLY_CLEAR_FOG:
+            m_dynamicOptions.automaticallyClearFog = args[0].boolean;
+            break;
+        case Opcode::UPDATE_DECLARE_BOTH_WALL_HALVES:
+            m_dynamicOptions.declareBothWallHalves = args[0].boolean;
+            break;
+        case Opcode::UPDATE_SET_TILE_TEXT_WHEN_DISTANCE_DECLARED:
+            m_dynamicOptions.setTileTextWhenDistanceDeclared = args[0].boolean;
+            break;
+        case Opcode::UPDATE_SET_TILE_BASE_COLOR_WHEN_DISTANCE_DECLARED_CORRECTLY:
+            m_dynamicOptions.setTileBaseColorWhenDistanceDeclaredCorrectly =
+                args[0].boolean;
+            break;
+        case Opcode::UPDATE_DECLARE_WALL_ON_READ:
+            m_dynamicOptions.declareWallOnRead = args[0].boolean;
+            break;
+        case Opcode::UPDATE_USE_TILE_EDGE_MOVEMENTS:
+            m_dynamicOptions.useTileEdgeMovements = args[0].boolean;
+            break;
+
+        case Opcode::MAZE_WIDTH:
+            reply->integer = m_maze->getWidth();
+            break;
+        case Opcode::MAZE_HEIGHT:
+            reply->integer = m_maze->getHeight();
+            break;
+        case Opcode::IS_OFFICIAL_MAZE:
+            reply->boolean = m_maze->isOfficialMaze();
+            break;
+        case Opcode::INITIAL_DIRECTION:
+            reply->character = getStartedDirection();
+            break;
+        case Opcode::GET_RANDOM_FLOAT:
+            reply->real = getRandom();
+            break;
+        case Opcode::MILLIS:
+            reply->integer = millis();
+            break;
+        case Opcode::DELAY:
+            delay(args[0].integer);
+            break;
+        case Opcode::RESET_POSITION:
+            resetPosition();
+            break;
+        case Opcode::INPUT_BUTTON_PRESSED:
+            reply->boolean = inputButtonPressed(args[0].integer);
+            break;
+        case Opcode::ACKNOWLEDGE_INPUT_BUTTON_PRESSED:
+            acknowledgeInputButtonPressed(args[0].integer);
+            break;
+
+        case Opcode::SET_TILE_COLOR:
+            setTileColor(args[0].integer, args[1].integer, args[2].character);
+            break;
+        case Opcode::CLEAR_TILE_COLOR:
+            clearTileColor(args[0].integer, args[1].integer);
+            break;
+        case Opcode::CLEAR_ALL_TILE_COLOR:
+            clearAllTileColor();
+            break;
+        case Opcode::SET_TILE_TEXT:
+            setTileText(
+                args[0].integer,
+                args[1].integer,
+                2 < command.numArguments ? args[2].string : QString());
+            break;
+        case Opcode::CLEAR_TILE_TEXT:
+            clearTileText(args[0].integer, args[1].integer);
+            break;
+        case Opcode::CLEAR_ALL_TILE_TEXT:
+            clearAllTileText();
+            break;
+        case Opcode::DECLARE_WALL:
+            declareWall(
+                args[0].integer,
+                args[1].integer,
+                args[2].character,
+                args[3].boolean);
+            break;
+        case Opcode::UNDECLARE_WALL:
+            undeclareWall(args[0].integer, args[1].integer, args[2].character);
+            break;
+        case Opcode::SET_TILE_FOGGINESS:
+            setTileFogginess(args[0].integer, args[1].integer, args[2].boolean);
+            break;
+        case Opcode::DECLARE_TILE_DISTANCE:
+            declareTileDistance(args[0].integer, args[1].integer, args[2].integer);
+            break;
+        case Opcode::UNDECLARE_TILE_DISTANCE:
+            undeclareTileDistance(args[0].integer, args[1].integer);
+            break;
+
+        case Opcode::SET_TILE_COLORS:
+            setTileColors(command.records.constData(), command.numRecords);
+            break;
+        case Opcode::FILL_TILE_COLOR:
+            fillTileColor(
+                args[0].integer,
+                args[1].integer,
+                args[2].integer,
+                args[3].integer,
+                args[4].character);
+            break;
+        case Opcode::SET_TILE_TEXTS:
+            setTileTexts(command.records.constData(), command.numRecords);
+            break;
+        case Opcode::FILL_TILE_TEXT:
+            fillTileText(
+                args[0].integer,
+                args[1].integer,
+                args[2].integer,
+                args[3].integer,
+                args[4].string);
+            break;
+        case Opcode::SET_TILE_FOGGINESSES:
+            setTileFogginesses(command.records.constData(), command.numRecords);
+            break;
+        case Opcode::FILL_TILE_FOGGINESS:
+            fillTileFogginess(
+                args[0].integer,
+                args[1].integer,
+                args[2].integer,
+                args[3].integer,
+                args[4].boolean);
+            break;
+        case Opcode::DECLARE_WALLS:
+            declareWalls(command.records.constData(), command.numRecords);
+            break;
+        case Opcode::DECLARE_TILE_DISTANCES:
+            declareTileDistances(command.records.constData(), command.numRecords);
+            break;
+
+        case Opcode::GET_WHEEL_MAX_SPEED:
+            reply->real = getWheelMaxSpeed(args[0].string);
+            break;
+        case Opcode::SET_WHEEL_SPEED:
+            setWheelSpeed(args[0].string, args[1].real);
+            break;
+        case Opcode::GET_WHEEL_ENCODER_TICKS_PER_REVOLUTION:
+            reply->real = getWheelEncoderTicksPerRevolution(args[0].string);
+            break;
+        case Opcode::READ_WHEEL_ENCODER:
+            reply->integer = readWheelEncoder(args[0].string);
+            break;
+        case Opcode::RESET_WHEEL_ENCODER:
+            resetWheelEncoder(args[0].string);
+            break;
+        case Opcode::READ_SENSOR:
+            reply->real = readSensor(args[0].string);
+            break;
+        case Opcode::READ_GYRO:
+            reply->real = readGyro();
+            break;
+
+        case Opcode::WALL_FRONT:
+            reply->boolean = wallFront();
+            break;
+        case Opcode::WALL_RIGHT:
+            reply->boolean = wallRight();
+            break;
+        case Opcode::WALL_LEFT:
+            reply->boolean = wallLeft();
+            break;
+        case Opcode::MOVE_FORWARD:
+            moveForward(0 < command.numArguments ? args[0].integer : 1);
+            break;
+        case Opcode::TURN_LEFT:
+            turnLeft();
+            break;
+        case Opcode::TURN_RIGHT:
+            turnRight();
+            break;
+        case Opcode::TURN_AROUND_LEFT:
+            turnAroundLeft();
+            break;
+        case Opcode::TURN_AROUND_RIGHT:
+            turnAroundRight();
+            break;
+
+        case Opcode::ORIGIN_MOVE_FORWARD_TO_EDGE:
+            originMoveForwardToEdge();
+            break;
+        case Opcode::ORIGIN_TURN_LEFT_IN_PLACE:
+            originTurnLeftInPlace();
+            break;
+        case Opcode::ORIGIN_TURN_RIGHT_IN_PLACE:
+            originTurnRightInPlace();
+            break;
+        case Opcode::MOVE_FORWARD_TO_EDGE:
+            moveForwardToEdge(0 < command.numArguments ? args[0].integer : 1);
+            break;
+        case Opcode::TURN_LEFT_TO_EDGE:
+            turnLeftToEdge();
+            break;
+        case Opcode::TURN_RIGHT_TO_EDGE:
+            turnRightToEdge();
+            break;
+        case Opcode::TURN_AROUND_LEFT_TO_EDGE:
+            turnAroundLeftToEdge();
+            break;
+        case Opcode::TURN_AROUND_RIGHT_TO_EDGE:
+            turnAroundRightToEdge();
+            break;
+        case Opcode::DIAGONAL_LEFT_LEFT:
+            diagonalLeftLeft(args[0].integer);
+            break;
+        case Opcode::DIAGONAL_LEFT_RIGHT:
+            diagonalLeftRight(args[0].integer);
+            break;
+        case Opcode::DIAGONAL_RIGHT_LEFT:
+            diagonalRightLeft(args[0].integer);
+            break;
+        case Opcode::DIAGONAL_RIGHT_RIGHT:
+            diagonalRightRight(args[0].integer);
+            break;
+
+        case Opcode::CURRENT_X_TILE:
+            reply->integer = currentXTile();
+            break;
+        case Opcode::CURRENT_Y_TILE:
+            reply->integer = currentYTile();
+            break;
+        case Opcode::CURRENT_DIRECTION:
+            reply->character = currentDirection();
+            break;
+        case Opcode::CURRENT_X_POS_METERS:
+            reply->real = currentXPosMeters();
+            break;
+        case Opcode::CURRENT_Y_POS_METERS:
+            reply->real = currentYPosMeters();
+            break;
+        case Opcode::CURRENT_ROTATION_DEGREES:
+            reply->real = currentRotationDegrees();
+            break;
+    }
+    return true;
+}
+
+void MouseInterface::serveSharedMemoryTransport() {
+
+    // This loop doesn't return to the event loop until the algorithm exits
+    // (or we're asked to stop), and so it processes the thread's other
+    // events (stdout, input buttons, the process exiting, etc.) itself
+    static const int EVENT_INTERVAL_MICROSECONDS = 1000;
+    QElapsedTimer sinceEvents;
+    sinceEvents.start();
+
+    QByteArray replies;
+    replies.reserve(256);
+    const char* payload = nullptr;
+    int size = 0;
+
+    while (!m_stopRequested) {
+        // Commands written before the segment was closed are still executed,
+        // so that the algorithm's last few (unacknowledged) ones aren't lost
+        bool closed = m_sharedMemoryTransport->isClosed();
+        // While the algorithm isn't reading its replies, we don't read any
+        // more of its commands
+        if (m_sharedMemoryTransport->hasPendingReplies()) {
+            m_sharedMemoryTransport->flushReplies(EVENT_INTERVAL_MICROSECONDS);
+        }
+        else if (m_sharedMemoryTransport->waitForCommands(EVENT_INTERVAL_MICROSECONDS)) {
+            m_sharedMemoryTransport->readCommands(&m_sharedMemoryCommandReader);
+            replies.resize(0);
+            while (m_sharedMemoryCommandReader.nextFrame(&payload, &size)) {
+                dispatchFrame(payload, size, &replies);
+            }
+            if (!replies.isEmpty()) {
+                m_sharedMemoryTransport->writeReplies(replies);
+            }
+        }
+        if (closed) {
+            break;
+        }
+        if (EVENT_INTERVAL_MICROSECONDS <= sinceEvents.nsecsElapsed() / 1000) {
+            QCoreApplication::processEvents();
+            sinceEvents.restart();
+        }
     }
+}
 
-    return ERROR_STRING;
+void MouseInterface::setSharedMemoryTransport(SharedMemoryTransport* transport) {
+    m_sharedMemoryTransport = transport;
 }
 
 void MouseInterface::requestStop() {
     m_stopRequested = true;
+    m_model->getSimTime()->interruptTicks();
+}
+
+void MouseInterface::setRandomSeed(int seed) {
+    m_generator.seed(seed);
+}
+
+void MouseInterface::setInstantMovementsEnabled(bool enabled) {
+    m_instantMovementsEnabled = enabled;
 }
 
 void MouseInterface::inputButtonWasPressed(int button) {
@@ -448,38 +548,24 @@ void MouseInterface::setWheelSpeedFraction(double wheelSpeedFraction) {
 
 
 double MouseInterface::getRandom() {
-    return SimUtilities::getRandom();
+    return SimUtilities::getRandom(&m_generator);
 }
 
 int MouseInterface::millis() {
-    return SimTime::get()->elapsedSimTime().getMilliseconds();
+    return m_model->getSimTime()->elapsedSimTime().getMilliseconds();
 }
 
 void MouseInterface::delay(int milliseconds) {
-    Seconds start = SimTime::get()->elapsedSimTime();
-    while (SimTime::get()->elapsedSimTime() < start + Milliseconds(milliseconds)) {
+    Seconds start = m_model->getSimTime()->elapsedSimTime();
+    while (m_model->getSimTime()->elapsedSimTime() < start + Milliseconds(milliseconds)) {
         BREAK_IF_STOPPED_ELSE_SLEEP_MIN();
     }
 }
 
 void MouseInterface::setTileColor(int x, int y, char color) {
-
-    if (!m_maze->withinMaze(x, y)) {
-        qWarning().noquote().nospace()
-            << "There is no tile at position (" << x << ", " << y << ") and"
-            << " thus you cannot set its color.";
-        return;
+    if (checkTileColor(x, y, color)) {
+        setTileColorImpl(x, y, color);
     }
-
-    if (!CHAR_TO_COLOR().contains(color)) {
-        qWarning().noquote().nospace()
-            << "You cannot set the color of tile (" << x << ", " << y << ") to"
-            << "'" << color << "' since '" << color << "' is not mapped to a"
-            << " color.";
-        return;
-    }
-
-    setTileColorImpl(x, y, color);
 }
 
 void MouseInterface::clearTileColor(int x, int y) {
@@ -495,21 +581,18 @@ void MouseInterface::clearTileColor(int x, int y) {
 }
 
 void MouseInterface::clearAllTileColor() {
+    Color baseColor = STRING_TO_COLOR().value(P()->tileBaseColor());
     for (QPair<int, int> position : m_tilesWithColor) {
-        clearTileColorImpl(position.first, position.second);
+        m_tileUpdates.colors.append({position.first, position.second, baseColor});
     }
+    m_tilesWithColor.clear();
+    applyTileUpdates();
 }
 
 void MouseInterface::setTileText(int x, int y, const QString& text) {
-
-    if (!m_maze->withinMaze(x, y)) {
-        qWarning().noquote().nospace()
-            << "There is no tile at position (" << x << ", " << y << "), and"
-            << " thus you cannot set its text to \"" << text << "\".";
-        return;
+    if (checkTileText(x, y, text)) {
+        setTileTextImpl(x, y, text);
     }
-
-    setTileTextImpl(x, y, text);
 }
 
 void MouseInterface::clearTileText(int x, int y) {
@@ -526,23 +609,15 @@ void MouseInterface::clearTileText(int x, int y) {
 
 void MouseInterface::clearAllTileText() {
     for (QPair<int, int> position : m_tilesWithText) {
-        clearTileTextImpl(position.first, position.second);
+        m_tileUpdates.texts.append({position.first, position.second, {}});
     }
+    m_tilesWithText.clear();
+    applyTileUpdates();
 }
 
 void MouseInterface::declareWall(int x, int y, char direction, bool wallExists) {
 
-    if (!m_maze->withinMaze(x, y)) {
-        qWarning().noquote().nospace()
-            << "There is no tile at position (" << x << ", " << y << "), and"
-            << " thus you cannot declare any of its walls.";
-        return;
-    }
-
-    if (!CHAR_TO_DIRECTION().contains(direction)) {
-        qWarning().noquote().nospace()
-            << "The character '" << direction << "' is not mapped to a valid"
-            << " direction.";
+    if (!checkDeclareWall(x, y, direction)) {
         return;
     }
 
@@ -582,56 +657,187 @@ void MouseInterface::undeclareWall(int x, int y, char direction) {
 }
 
 void MouseInterface::setTileFogginess(int x, int y, bool foggy) {
+    if (checkTileFogginess(x, y)) {
+        m_view->getMazeGraphic()->setTileFogginess(x, y, foggy);
+    }
+}
+
+void MouseInterface::declareTileDistance(int x, int y, int distance) {
 
     if (!m_maze->withinMaze(x, y)) {
         qWarning().noquote().nospace()
             << "There is no tile at position (" << x << ", " << y << "), and"
-            << " thus you cannot set its fogginess.";
+            << " thus you cannot set its distance.";
         return;
     }
 
-    m_view->getMazeGraphic()->setTileFogginess(x, y, foggy);
+    declareTileDistanceImpl(x, y, distance);
 }
 
-void MouseInterface::declareTileDistance(int x, int y, int distance) {
+void MouseInterface::undeclareTileDistance(int x, int y) {
 
     if (!m_maze->withinMaze(x, y)) {
         qWarning().noquote().nospace()
             << "There is no tile at position (" << x << ", " << y << "), and"
-            << " thus you cannot set its distance.";
+            << " thus you cannot clear its distance.";
         return;
     }
 
     if (getDynamicOptions().setTileTextWhenDistanceDeclared) {
-        setTileTextImpl(x, y, (0 <= distance ? QString::number(distance) : "inf"));
+        clearTileTextImpl(x, y);
     }
     if (getDynamicOptions().setTileBaseColorWhenDistanceDeclaredCorrectly) {
-        int actualDistance = m_maze->getTile(x, y)->getDistance();
-        // A negative distance is interpreted to mean infinity
-        if (distance == actualDistance || (distance < 0 && actualDistance < 0)) {
-            setTileColorImpl(x, y,
-                COLOR_TO_CHAR().value(STRING_TO_COLOR().value(P()->distanceCorrectTileBaseColor())));
+        setTileColorImpl(x, y, COLOR_TO_CHAR().value(STRING_TO_COLOR().value(P()->tileBaseColor())));
+    }
+}
+
+void MouseInterface::setTileColors(const MouseValue* records, int numRecords) {
+    for (int i = 0; i < numRecords; i += 1) {
+        const MouseValue* record = records + 3 * i;
+        int x = record[0].integer;
+        int y = record[1].integer;
+        char color = record[2].character;
+        if (checkTileColor(x, y, color)) {
+            m_tileUpdates.colors.append({x, y, CHAR_TO_COLOR().value(color)});
+            m_tilesWithColor.insert({x, y});
         }
     }
+    applyTileUpdates();
 }
 
-void MouseInterface::undeclareTileDistance(int x, int y) {
+void MouseInterface::fillTileColor(int x, int y, int width, int height, char color) {
 
-    if (!m_maze->withinMaze(x, y)) {
+    if (!regionWithinMaze(x, y, width, height)) {
         qWarning().noquote().nospace()
-            << "There is no tile at position (" << x << ", " << y << "), and"
-            << " thus you cannot clear its distance.";
+            << "The " << width << "x" << height << " region at (" << x << ", "
+            << y << ") is not within the maze, and thus you cannot set its"
+            << " color.";
         return;
     }
 
-    if (getDynamicOptions().setTileTextWhenDistanceDeclared) {
-        clearTileTextImpl(x, y);
+    if (!CHAR_TO_COLOR().contains(color)) {
+        qWarning().noquote().nospace()
+            << "You cannot set the color of the " << width << "x" << height
+            << " region at (" << x << ", " << y << ") to '" << color << "'"
+            << " since '" << color << "' is not mapped to a color.";
+        return;
     }
-    if (getDynamicOptions().setTileBaseColorWhenDistanceDeclaredCorrectly) {
-        setTileColorImpl(x, y, COLOR_TO_CHAR().value(STRING_TO_COLOR().value(P()->tileBaseColor())));
+
+    m_view->getMazeGraphic()->fillTileColor(
+        x, y, width, height, CHAR_TO_COLOR().value(color));
+    for (int i = x; i < x + width; i += 1) {
+        for (int j = y; j < y + height; j += 1) {
+            m_tilesWithColor.insert({i, j});
+        }
+    }
+}
+
+void MouseInterface::setTileTexts(const MouseValue* records, int numRecords) {
+    for (int i = 0; i < numRecords; i += 1) {
+        const MouseValue* record = records + 3 * i;
+        int x = record[0].integer;
+        int y = record[1].integer;
+        const QString& text = record[2].string;
+        if (checkTileText(x, y, text)) {
+            m_tileUpdates.texts.append({x, y, filterTileText(text)});
+            m_tilesWithText.insert({x, y});
+        }
+    }
+    applyTileUpdates();
+}
+
+void MouseInterface::fillTileText(
+        int x, int y, int width, int height, const QString& text) {
+
+    if (!regionWithinMaze(x, y, width, height)) {
+        qWarning().noquote().nospace()
+            << "The " << width << "x" << height << " region at (" << x << ", "
+            << y << ") is not within the maze, and thus you cannot set its"
+            << " text to \"" << text << "\".";
+        return;
+    }
+
+    // Nothing is set, so there's nothing to warn about in the text
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    m_view->getMazeGraphic()->fillTileText(
+        x, y, width, height, filterTileText(text));
+    for (int i = x; i < x + width; i += 1) {
+        for (int j = y; j < y + height; j += 1) {
+            m_tilesWithText.insert({i, j});
+        }
     }
 }
 
+void MouseInterface::setTileFogginesses(const MouseValue* records, int numRecords) {
+    for (int i = 0; i < numRecords; i += 1) {
+        const MouseValue* record = records + 3 * i;
+        int x = record[0].integer;
+        int y = record[1].integer;
+        if (checkTileFogginess(x, y)) {
+            m_tileUpdates.fogginesses.append({x, y, record[2].boolean});
+        }
+    }
+    applyTileUpdates();
+}
+
+void MouseInterface::fillTileFogginess(
+        int x, int y, int width, int height, bool foggy) {
+
+    if (!regionWithinMaze(x, y, width, height)) {
+        qWarning().noquote().nospace()
+            << "The " << width << "x" << height << " region at (" << x << ", "
+            << y << ") is not within the maze, and thus you cannot set its"
+            << " fogginess.";
+        return;
+    }
+
+    m_view->getMazeGraphic()->fillTileFogginess(x, y, width, height, foggy);
+}
+
+void MouseInterface::declareWalls(const MouseValue* records, int numRecords) {
+    bool declareBothWallHalves = getDynamicOptions().declareBothWallHalves;
+    for (int i = 0; i < numRecords; i += 1) {
+        const MouseValue* record = records + 4 * i;
+        int x = record[0].integer;
+        int y = record[1].integer;
+        char direction = record[2].character;
+        if (checkDeclareWall(x, y, direction)) {
+            queueDeclaredWall(
+                {
+                    {x, y},
+                    CHAR_TO_DIRECTION().value(direction)
+                },
+                record[3].boolean,
+                declareBothWallHalves
+            );
+        }
+    }
+    applyTileUpdates();
+}
+
+void MouseInterface::declareTileDistances(
+        const MouseValue* distances, int numDistances) {
+
+    if (numDistances != m_maze->getWidth() * m_maze->getHeight()) {
+        qWarning().noquote().nospace()
+            << "You declared " << numDistances << " tile distances, but the"
+            << " maze has " << m_maze->getWidth() * m_maze->getHeight()
+            << " tiles.";
+        return;
+    }
+
+    for (int x = 0; x < m_maze->getWidth(); x += 1) {
+        for (int y = 0; y < m_maze->getHeight(); y += 1) {
+            queueTileDistance(
+                x, y, distances[x * m_maze->getHeight() + y].integer);
+        }
+    }
+    applyTileUpdates();
+}
+
 void MouseInterface::resetPosition() {
     m_mouse->reset();
 }
@@ -668,69 +874,74 @@ double MouseInterface::getWheelMaxSpeed(const QString& name) {
 
     ENSURE_CONTINUOUS_INTERFACE
 
-    if (!m_mouse->hasWheel(name)) {
+    int wheel = m_mouse->getWheelHandle(name);
+    if (wheel == -1) {
         qWarning().noquote().nospace()
             << "There is no wheel called \"" << name << "\" and thus you cannot"
             << " get its max speed.";
         return 0.0;
     }
 
-    return m_mouse->getWheelMaxSpeed(name).getRevolutionsPerMinute();
+    return m_mouse->getWheelMaxSpeed(wheel).getRevolutionsPerMinute();
 }
 
 void MouseInterface::setWheelSpeed(const QString& name, double rpm) {
 
     ENSURE_CONTINUOUS_INTERFACE
 
-    if (!m_mouse->hasWheel(name)) {
+    int wheel = m_mouse->getWheelHandle(name);
+    if (wheel == -1) {
         qWarning().noquote().nospace()
             << "There is no wheel called \"" << name << "\" and thus you cannot"
             << " set its speed.";
         return;
     }
 
-    if (getWheelMaxSpeed(name) < std::abs(rpm)) {
+    double maxRpm = m_mouse->getWheelMaxSpeed(wheel).getRevolutionsPerMinute();
+    if (maxRpm < std::abs(rpm)) {
         qWarning().noquote().nospace()
             << "You're attempting to set the speed of wheel \"" << name << "\""
             << " to " << rpm << " rpm, which has magnitude greater than the max"
-            << " speed of " << getWheelMaxSpeed(name) << " rpm. Thus, the wheel"
+            << " speed of " << maxRpm << " rpm. Thus, the wheel"
             << " speed was not set.";
         return;
     }
 
-    m_mouse->setWheelSpeeds({{name, RevolutionsPerMinute(rpm)}});
+    m_mouse->setWheelSpeed(wheel, RevolutionsPerMinute(rpm));
 }
 
 double MouseInterface::getWheelEncoderTicksPerRevolution(const QString& name) {
 
     ENSURE_CONTINUOUS_INTERFACE
 
-    if (!m_mouse->hasWheel(name)) {
+    int wheel = m_mouse->getWheelHandle(name);
+    if (wheel == -1) {
         qWarning().noquote().nospace()
             << "There is no wheel called \"" << name << "\" and thus you cannot"
             << " get its number of encoder ticks per revolution.";
         return 0.0;
     }
 
-    return m_mouse->getWheelEncoderTicksPerRevolution(name);
+    return m_mouse->getWheelEncoderTicksPerRevolution(wheel);
 }
 
 int MouseInterface::readWheelEncoder(const QString& name) {
 
     ENSURE_CONTINUOUS_INTERFACE
 
-    if (!m_mouse->hasWheel(name)) {
+    int wheel = m_mouse->getWheelHandle(name);
+    if (wheel == -1) {
         qWarning().noquote().nospace()
             << "There is no wheel called \"" << name << "\" and thus you cannot"
             << " read its encoder.";
         return 0;
     }
 
-    switch (m_mouse->getWheelEncoderType(name)) {
+    switch (m_mouse->getWheelEncoderType(wheel)) {
         case EncoderType::ABSOLUTE:
-            return m_mouse->readWheelAbsoluteEncoder(name);
+            return m_mouse->readWheelAbsoluteEncoder(wheel);
         case EncoderType::RELATIVE:
-            return m_mouse->readWheelRelativeEncoder(name);
+            return m_mouse->readWheelRelativeEncoder(wheel);
     }
 }
 
@@ -738,17 +949,18 @@ void MouseInterface::resetWheelEncoder(const QString& name) {
 
     ENSURE_CONTINUOUS_INTERFACE
 
-    if (!m_mouse->hasWheel(name)) {
+    int wheel = m_mouse->getWheelHandle(name);
+    if (wheel == -1) {
         qWarning().noquote().nospace()
             << "There is no wheel called \"" << name << "\" and thus you cannot"
             << " reset its encoder.";
         return;
     }
 
-    if (m_mouse->getWheelEncoderType(name) != EncoderType::RELATIVE) {
+    if (m_mouse->getWheelEncoderType(wheel) != EncoderType::RELATIVE) {
         qWarning().noquote().nospace()
             << "The encoder type of the wheel \"" << name << "\" is \""
-            << ENCODER_TYPE_TO_STRING().value(m_mouse->getWheelEncoderType(name))
+            << ENCODER_TYPE_TO_STRING().value(m_mouse->getWheelEncoderType(wheel))
             << "\". However, you may only reset the wheel encoder if the"
             << " encoder type is \""
             << ENCODER_TYPE_TO_STRING().value(EncoderType::RELATIVE)
@@ -756,21 +968,22 @@ void MouseInterface::resetWheelEncoder(const QString& name) {
         return;
     }
 
-    m_mouse->resetWheelRelativeEncoder(name);
+    m_mouse->resetWheelRelativeEncoder(wheel);
 }
 
 double MouseInterface::readSensor(const QString& name) {
 
     ENSURE_CONTINUOUS_INTERFACE
 
-    if (!m_mouse->hasSensor(name)) {
+    int sensor = m_mouse->getSensorHandle(name);
+    if (sensor == -1) {
         qWarning().noquote().nospace()
             << "There is no sensor called \"" << name << "\" and thus you"
             << " cannot read its value.";
         return 0.0;
     }
 
-    return m_mouse->readSensor(name);
+    return m_mouse->readSensor(sensor);
 }
 
 double MouseInterface::readGyro() {
@@ -1100,25 +1313,7 @@ void MouseInterface::clearTileColorImpl(int x, int y) {
 }
 
 void MouseInterface::setTileTextImpl(int x, int y, const QString& text) {
-
-    // Ensure that all characters are valid
-    QString filtered;
-    for (int i = 0; i < text.size(); i += 1) {
-        QChar c = text.at(i);
-        if (!FontImage::get()->positions().contains(c)) {
-            qWarning().noquote().nospace()
-                << "Unable to set the tile text for unprintable character \""
-                << (c == '\n' ? "\\n" :
-                   (c == '\t' ? "\\t" :
-                   (c == '\r' ? "\\r" : QString(c))))
-                << "\". Using the character \"" << P()->defaultTileTextCharacter()
-                << "\" instead.";
-            c = P()->defaultTileTextCharacter();
-        }
-        filtered += c;
-    }
-
-    m_view->getMazeGraphic()->setTileText(x, y, filtered);
+    m_view->getMazeGraphic()->setTileText(x, y, filterTileText(text));
     m_tilesWithText.insert({x, y});
 }
 
@@ -1127,11 +1322,40 @@ void MouseInterface::clearTileTextImpl(int x, int y) {
     m_tilesWithText.erase({x, y});
 }
 
+void MouseInterface::declareTileDistanceImpl(int x, int y, int distance) {
+    queueTileDistance(x, y, distance);
+    applyTileUpdates();
+}
+
+void MouseInterface::queueTileDistance(int x, int y, int distance) {
+    if (getDynamicOptions().setTileTextWhenDistanceDeclared) {
+        m_tileUpdates.texts.append(
+            {x, y, filterTileText(0 <= distance ? QString::number(distance) : "inf")});
+        m_tilesWithText.insert({x, y});
+    }
+    if (getDynamicOptions().setTileBaseColorWhenDistanceDeclaredCorrectly) {
+        int actualDistance = m_maze->getTile(x, y)->getDistance();
+        // A negative distance is interpreted to mean infinity
+        if (distance == actualDistance || (distance < 0 && actualDistance < 0)) {
+            m_tileUpdates.colors.append(
+                {x, y, STRING_TO_COLOR().value(P()->distanceCorrectTileBaseColor())});
+            m_tilesWithColor.insert({x, y});
+        }
+    }
+}
+
 void MouseInterface::declareWallImpl(
         QPair<QPair<int, int>, Direction> wall, bool wallExists, bool declareBothWallHalves) {
-    m_view->getMazeGraphic()->declareWall(wall.first.first, wall.first.second, wall.second, wallExists); 
+    queueDeclaredWall(wall, wallExists, declareBothWallHalves);
+    applyTileUpdates();
+}
+
+void MouseInterface::queueDeclaredWall(
+        QPair<QPair<int, int>, Direction> wall, bool wallExists, bool declareBothWallHalves) {
+    m_tileUpdates.walls.append(
+        {wall.first.first, wall.first.second, wall.second, wallExists});
     if (declareBothWallHalves && hasOpposingWall(wall)) {
-        declareWallImpl(getOpposingWall(wall), wallExists, false);
+        queueDeclaredWall(getOpposingWall(wall), wallExists, false);
     }
 }
 
@@ -1207,8 +1431,8 @@ void MouseInterface::moveForwardImpl(bool originMoveForwardToEdge) {
     }
 
     // Otherwise, set the crashed state (if it hasn't already been set)
-    else if (!S()->crashed()) {
-        S()->setCrashed();
+    else if (!m_model->getState()->crashed()) {
+        m_model->getState()->setCrashed();
     }
 }
 
@@ -1284,8 +1508,8 @@ void MouseInterface::turnToEdgeImpl(bool turnLeft) {
     }
 
     // Otherwise, set the crashed state (if it hasn't already been set)
-    else if (!S()->crashed()) {
-        S()->setCrashed();
+    else if (!m_model->getState()->crashed()) {
+        m_model->getState()->setCrashed();
     }
 }
 
@@ -1340,6 +1564,100 @@ QPair<QPair<int, int>, Direction> MouseInterface::getOpposingWall(
     }
 }
 
+void MouseInterface::applyTileUpdates() {
+    m_view->getMazeGraphic()->update(m_tileUpdates);
+    m_tileUpdates.clear();
+}
+
+bool MouseInterface::regionWithinMaze(int x, int y, int width, int height) const {
+    // Written so as not to overflow, however large the width and height
+    return (
+        0 <= x && 0 <= y && 0 <= width && 0 <= height &&
+        width <= m_maze->getWidth() - x && height <= m_maze->getHeight() - y
+    );
+}
+
+bool MouseInterface::checkTileColor(int x, int y, char color) const {
+
+    if (!m_maze->withinMaze(x, y)) {
+        qWarning().noquote().nospace()
+            << "There is no tile at position (" << x << ", " << y << ") and"
+            << " thus you cannot set its color.";
+        return false;
+    }
+
+    if (!CHAR_TO_COLOR().contains(color)) {
+        qWarning().noquote().nospace()
+            << "You cannot set the color of tile (" << x << ", " << y << ") to"
+            << "'" << color << "' since '" << color << "' is not mapped to a"
+            << " color.";
+        return false;
+    }
+
+    return true;
+}
+
+bool MouseInterface::checkTileText(int x, int y, const QString& text) const {
+    if (!m_maze->withinMaze(x, y)) {
+        qWarning().noquote().nospace()
+            << "There is no tile at position (" << x << ", " << y << "), and"
+            << " thus you cannot set its text to \"" << text << "\".";
+        return false;
+    }
+    return true;
+}
+
+bool MouseInterface::checkTileFogginess(int x, int y) const {
+    if (!m_maze->withinMaze(x, y)) {
+        qWarning().noquote().nospace()
+            << "There is no tile at position (" << x << ", " << y << "), and"
+            << " thus you cannot set its fogginess.";
+        return false;
+    }
+    return true;
+}
+
+bool MouseInterface::checkDeclareWall(int x, int y, char direction) const {
+
+    if (!m_maze->withinMaze(x, y)) {
+        qWarning().noquote().nospace()
+            << "There is no tile at position (" << x << ", " << y << "), and"
+            << " thus you cannot declare any of its walls.";
+        return false;
+    }
+
+    if (!CHAR_TO_DIRECTION().contains(direction)) {
+        qWarning().noquote().nospace()
+            << "The character '" << direction << "' is not mapped to a valid"
+            << " direction.";
+        return false;
+    }
+
+    return true;
+}
+
+QString MouseInterface::filterTileText(const QString& text) const {
+
+    // Ensure that all characters are valid
+    QString filtered;
+    for (int i = 0; i < text.size(); i += 1) {
+        QChar c = text.at(i);
+        if (!FontImage::get()->contains(c)) {
+            qWarning().noquote().nospace()
+                << "Unable to set the tile text for unprintable character \""
+                << (c == '\n' ? "\\n" :
+                   (c == '\t' ? "\\t" :
+                   (c == '\r' ? "\\r" : QString(c))))
+                << "\". Using the character \"" << P()->defaultTileTextCharacter()
+                << "\" instead.";
+            c = P()->defaultTileTextCharacter();
+        }
+        filtered += c;
+    }
+
+    return filtered;
+}
+
 void MouseInterface::moveForwardTo(const Cartesian& destinationTranslation, const Radians& destinationRotation) {
 
     // This function assumes that we're already facing the correct direction,
@@ -1350,6 +1668,20 @@ void MouseInterface::moveForwardTo(const Cartesian& destinationTranslation, cons
     Degrees initialAngle = delta.getTheta();
     Meters previousDistance = delta.getRho();
 
+    // If possible, skip the simulation and just move the mouse along the line
+    if (m_instantMovementsEnabled) {
+        MetersPerSecond forwardRate = m_mouse->getRatesOfChangeForMoveForward(
+            m_wheelSpeedFraction).first;
+        double speed = std::abs(forwardRate.getMetersPerSecond());
+        moveInstantly(
+            destinationTranslation,
+            destinationRotation,
+            forwardRate,
+            RadiansPerSecond(0),
+            Seconds(speed == 0.0 ? 0.0 : delta.getRho().getMeters() / speed));
+        return;
+    }
+
     // Start the mouse moving forward
     m_mouse->setWheelSpeedsForMoveForward(m_wheelSpeedFraction);
 
@@ -1378,6 +1710,27 @@ void MouseInterface::arcTo(const Cartesian& destinationTranslation, const Radian
     // Determine the inital rotation delta in [-180, 180)
     Radians initialRotationDelta = getRotationDelta(m_mouse->getCurrentRotation(), destinationRotation);
 
+    // If possible, skip the simulation and just move the mouse along the arc
+    if (m_instantMovementsEnabled) {
+        QPair<MetersPerSecond, RadiansPerSecond> ratesOfChange = (
+            0 < initialRotationDelta.getDegreesNotBounded() ?
+            m_mouse->getRatesOfChangeForCurveLeft(
+                m_wheelSpeedFraction * extraWheelSpeedFraction, radius) :
+            m_mouse->getRatesOfChangeForCurveRight(
+                m_wheelSpeedFraction * extraWheelSpeedFraction, radius)
+        );
+        double speed = std::abs(ratesOfChange.second.getRadiansPerSecond());
+        moveInstantly(
+            destinationTranslation,
+            destinationRotation,
+            ratesOfChange.first,
+            ratesOfChange.second,
+            Seconds(
+                speed == 0.0 ? 0.0 :
+                std::abs(initialRotationDelta.getRadiansNotBounded()) / speed));
+        return;
+    }
+
     // Set the speed based on the initial rotation delta
     if (0 < initialRotationDelta.getDegreesNotBounded()) {
         m_mouse->setWheelSpeedsForCurveLeft(
@@ -1408,6 +1761,53 @@ void MouseInterface::turnTo(const Cartesian& destinationTranslation, const Radia
     arcTo(destinationTranslation, destinationRotation, Meters(0), 0.5);
 }
 
+void MouseInterface::moveInstantly(const Cartesian& destinationTranslation, const Radians& destinationRotation,
+        const MetersPerSecond& forwardRate, const RadiansPerSecond& turnRate, const Seconds& duration) {
+
+    // The path is sampled at the same rate that the model would update the
+    // mouse, so that the traversed tiles and the times at which the mouse
+    // leaves the origin and reaches the center match the simulated movement
+    static Seconds timePerUpdate = Seconds(1.0 / P()->mousePositionUpdateRate());
+
+    Cartesian initialTranslation = m_mouse->getCurrentTranslation();
+    Radians initialRotation = m_mouse->getCurrentRotation();
+
+    Seconds previousTime(0);
+    do {
+        // Check if a stop has been requested
+        if (m_stopRequested) {
+            break;
+        }
+        Seconds currentTime = previousTime + timePerUpdate;
+        if (duration < currentTime) {
+            currentTime = duration;
+        }
+
+        // The end of the path is the exact destination
+        Cartesian translation = destinationTranslation;
+        Radians rotation = destinationRotation;
+
+        // Otherwise, the pose is given by the closed form of a line or an arc
+        if (currentTime < duration) {
+            rotation = initialRotation + turnRate * currentTime;
+            if (turnRate.getRadiansPerSecond() == 0.0) {
+                translation = initialTranslation +
+                    Polar(forwardRate * currentTime, initialRotation);
+            }
+            else {
+                double radius = forwardRate.getMetersPerSecond() / turnRate.getRadiansPerSecond();
+                translation = initialTranslation + Cartesian(
+                    Meters(radius * (rotation.getSin() - initialRotation.getSin())),
+                    Meters(radius * (initialRotation.getCos() - rotation.getCos())));
+            }
+        }
+
+        m_model->advanceMouse(currentTime - previousTime, translation, rotation);
+        previousTime = currentTime;
+    }
+    while (previousTime < duration);
+}
+
 Radians MouseInterface::getRotationDelta(const Radians& from, const Radians& to) const {
     static const Degrees lowerBound = Degrees(-180);
     static const Degrees upperBound = Degrees(180);
@@ -1471,7 +1871,7 @@ QPair<Cartesian, Degrees> MouseInterface::getCrashLocation(
 void MouseInterface::doDiagonal(int count, bool startLeft, bool endLeft) {
 
     // Don't do/print anything if the mouse has already crashed
-    if (S()->crashed()) {
+    if (m_model->getState()->crashed()) {
         return;
     }
 
@@ -1532,8 +1932,8 @@ void MouseInterface::doDiagonal(int count, bool startLeft, bool endLeft) {
     turnTo(m_mouse->getCurrentTranslation(), endRotation);
     moveForwardTo(destination + Polar(Meters(P()->wallWidth() / 2.0), m_mouse->getCurrentRotation()), m_mouse->getCurrentRotation());
 
-    if (crash && !S()->crashed()) {
-        S()->setCrashed();
+    if (crash && !m_model->getState()->crashed()) {
+        m_model->getState()->setCrashed();
     }
 }
 
@@ -1,14 +1,24 @@
 #pragma once
 
+#include <QByteArray>
 #include <QMap>
 #include <QObject>
 #include <QPair>
+#include <QVector>
 
+#include <random>
+
+#include "CommandReader.h"
+#include "CommandTable.h"
 #include "DynamicMouseAlgorithmOptions.h"
 #include "InterfaceType.h"
 #include "MazeView.h"
+#include "Model.h"
 #include "Mouse.h"
+#include "MouseCommand.h"
 #include "Param.h"
+#include "SharedMemoryTransport.h"
+#include "TileUpdates.h"
 
 #define ENSURE_DISCRETE_INTERFACE ensureDiscreteInterface(__func__);
 #define ENSURE_CONTINUOUS_INTERFACE ensureContinuousInterface(__func__);
@@ -29,7 +39,8 @@ public:
     MouseInterface(
         const Maze* maze,
         Mouse* mouse,
-        MazeView* view);
+        MazeView* view,
+        Model* model);
 
     // Called when the algo process writes to stdout
     void handleStandardOutput(QString output);
@@ -37,12 +48,30 @@ public:
     // Called when the algo process could not start
     void emitMouseAlgoCannotStart(QString string);
 
-    // Execute a request, return a response
-    QString dispatch(const QString& command);
+    // Called when the algo process writes to stderr; executes every complete
+    // command, in either the text or the binary protocol, and returns the
+    // replies to be written to the process's stdin
+    QByteArray handleStandardError(const QByteArray& bytes);
+
+    // Offer the algorithm a shared memory transport, which it may switch to
+    // instead of stdio; the transport must outlive the interface
+    void setSharedMemoryTransport(SharedMemoryTransport* transport);
 
     // Request that the mouse algorithm exit
     void requestStop();
 
+    // Seeds the generator behind getRandomFloat(), which is otherwise seeded
+    // from the random-seed parameter; each interface has its own, so that a
+    // run's random numbers only depend on its seed
+    void setRandomSeed(int seed);
+
+    // Whether or not DISCRETE movements are performed instantly, i.e., the
+    // sim time, mouse stats, and final pose of each movement are computed up
+    // front rather than by waiting for the simulation thread to animate it.
+    // Only for lock-step mode, in which the model doesn't advance the sim
+    // time on its own.
+    void setInstantMovementsEnabled(bool enabled);
+
     // A user pressed an input button in the UI
     void inputButtonWasPressed(int button);
 
@@ -98,6 +127,22 @@ private:
     void declareTileDistance(int x, int y, int distance);
     void undeclareTileDistance(int x, int y);
 
+    // Bulk tile appearance. The list methods take records (each the
+    // arguments of the corresponding single-tile method), which are checked
+    // one by one, and the fill methods apply to every tile of the rectangle
+    // whose lower left tile is (x, y). Each command is applied all at once.
+    void setTileColors(const MouseValue* records, int numRecords);
+    void fillTileColor(int x, int y, int width, int height, char color);
+    void setTileTexts(const MouseValue* records, int numRecords);
+    void fillTileText(int x, int y, int width, int height, const QString& text);
+    void setTileFogginesses(const MouseValue* records, int numRecords);
+    void fillTileFogginess(int x, int y, int width, int height, bool foggy);
+    void declareWalls(const MouseValue* records, int numRecords);
+
+    // Declares the distance of every tile, column by column, i.e., the
+    // distance of tile (x, y) is distances[x * mazeHeight + y]
+    void declareTileDistances(const MouseValue* distances, int numDistances);
+
     // Reset position of the mouse
     void resetPosition();
 
@@ -177,10 +222,48 @@ private:
 
     // ************************ END PUBLIC INTERFACE ********************* //
 
+    // Execute a request, and append its response (if any) to replies. An
+    // error is only ever sent in place of a reply that the algorithm is
+    // waiting for; anything else that goes wrong is just logged, since an
+    // unexpected reply would be read as the reply to a later command.
+    void dispatchLine(const char* line, int size, QByteArray* replies);
+    void dispatchFrame(const char* payload, int size, QByteArray* replies);
+    static bool expectsReply(const CommandEntry* entry);
+
+    // Execute a decoded command, storing the value of its reply (if any);
+    // returns false if the command can't be executed
+    bool execute(const MouseCommand& command, MouseValue* reply);
+
+    // Executes commands from the shared memory transport until the
+    // algorithm exits or a stop is requested
+    void serveSharedMemoryTransport();
+
     // Pointers to various simulator objects
     const Maze* m_maze;
     Mouse* m_mouse;
     MazeView* m_view;
+    Model* m_model;
+
+    // Splits the algorithm's stderr into commands
+    CommandReader m_commandReader;
+
+    // The command being executed, which is reused so that the records of
+    // bulk commands don't need to be allocated every time
+    MouseCommand m_command;
+
+    // Whether or not the algorithm has switched to the binary protocol
+    bool m_useBinaryProtocol;
+
+    // The optional shared memory transport, and its commands
+    SharedMemoryTransport* m_sharedMemoryTransport;
+    bool m_sharedMemoryTransportStarted;
+    CommandReader m_sharedMemoryCommandReader;
+
+    // Whether or not DISCRETE movements are performed instantly
+    bool m_instantMovementsEnabled;
+
+    // The generator behind getRandomFloat()
+    std::mt19937 m_generator;
 
     // The interface type (DISCRETE or CONTINUOUS)
     InterfaceType m_interfaceType;
@@ -206,6 +289,25 @@ private:
     std::set<QPair<int, int>> m_tilesWithColor;
     std::set<QPair<int, int>> m_tilesWithText;
 
+    // The tile changes of the command being executed, which are applied all
+    // at once, and which are reused so that they don't need to be allocated
+    // every time
+    TileUpdates m_tileUpdates;
+    void applyTileUpdates();
+
+    // Whether the rectangle whose lower left tile is (x, y) is in the maze
+    bool regionWithinMaze(int x, int y, int width, int height) const;
+
+    // Helper methods for checking the arguments of the tile methods, which
+    // warn and return false if the tile can't be changed
+    bool checkTileColor(int x, int y, char color) const;
+    bool checkTileText(int x, int y, const QString& text) const;
+    bool checkTileFogginess(int x, int y) const;
+    bool checkDeclareWall(int x, int y, char direction) const;
+
+    // Replaces (and warns about) every character that can't be displayed
+    QString filterTileText(const QString& text) const;
+
     // Helper methods for checking particular conditions and failing hard
     void ensureDiscreteInterface(const QString& callingFunction) const;
     void ensureContinuousInterface(const QString& callingFunction) const;
@@ -224,6 +326,10 @@ private:
     void clearTileColorImpl(int x, int y);
     void setTileTextImpl(int x, int y, const QString& text);
     void clearTileTextImpl(int x, int y);
+    void declareTileDistanceImpl(int x, int y, int distance);
+    void queueTileDistance(int x, int y, int distance);
+    void queueDeclaredWall(
+        QPair<QPair<int, int>, Direction> wall, bool wallExists, bool declareBothWallHalves);
     void declareWallImpl(
         QPair<QPair<int, int>, Direction> wall, bool wallExists, bool declareBothWallHalves);
     void undeclareWallImpl(
@@ -251,6 +357,12 @@ private:
         const Meters& radius, double extraWheelSpeedFraction);
     void turnTo(const Cartesian& destinationTranslation, const Radians& destinationRotation);
 
+    // Performs a movement instantly, as if the mouse had moved along a line or
+    // arc (given by the rates of change) for the given duration, and then been
+    // teleported to the destination; the path is sampled once per model tick
+    void moveInstantly(const Cartesian& destinationTranslation, const Radians& destinationRotation,
+        const MetersPerSecond& forwardRate, const RadiansPerSecond& turnRate, const Seconds& duration);
+
     // Returns the angle with from "from" to "to", with values in [-180, 180) degrees
     Radians getRotationDelta(const Radians& from, const Radians& to) const;
 
@@ -7,6 +7,7 @@
 #include "Assert.h"
 #include "EncoderType.h"
 #include "GeometryUtilities.h"
+#include "SensorModel.h"
 #include "SimUtilities.h"
 #include "units/RevolutionsPerMinute.h"
 
@@ -37,6 +38,7 @@ const QString MouseParser::SENSOR_TAG = "Sensor";
 const QString MouseParser::RADIUS_TAG = "Radius";
 const QString MouseParser::RANGE_TAG = "Range";
 const QString MouseParser::HALF_WIDTH_TAG = "Half-Width";
+const QString MouseParser::MODEL_TAG = "Model";
 
 MouseParser::MouseParser(const QString& filePath, bool* success) :
         m_forwardDirection(Radians(0)),
@@ -173,7 +175,6 @@ QMap<QString, Wheel> MouseParser::getWheels(
 QMap<QString, Sensor> MouseParser::getSensors(
         const Cartesian& initialTranslation,
         const Radians& initialRotation,
-        const Maze& maze,
         bool* success) {
 
     Cartesian alignmentTranslation = initialTranslation - m_centerOfMass;
@@ -192,6 +193,7 @@ QMap<QString, Sensor> MouseParser::getSensors(
         double x = getDoubleIfHasDouble(position, X_TAG, success);
         double y = getDoubleIfHasDouble(position, Y_TAG, success);
         double direction = getDoubleIfHasDouble(sensor, DIRECTION_TAG, success);
+        SensorModel model = getSensorModelIfValid(sensor, success);
 
         if (success) {
             sensors.insert(
@@ -206,7 +208,7 @@ QMap<QString, Sensor> MouseParser::getSensors(
                         alignmentRotation,
                         initialTranslation),
                     Degrees(direction) + alignmentRotation,
-                    maze));
+                    model));
         }
     }
 
@@ -268,6 +270,27 @@ EncoderType MouseParser::getEncoderTypeIfValid(const QDomElement& element, bool*
     return encoderType;
 }
 
+SensorModel MouseParser::getSensorModelIfValid(const QDomElement& element, bool* success) {
+    // The model is optional, since most mice were written before there was
+    // more than one; those get the original, ray-cast model
+    QDomElement modelElement = element.firstChildElement(MODEL_TAG);
+    if (modelElement.isNull()) {
+        return SensorModel::RAYS;
+    }
+    QString modelString = modelElement.text();
+    if (!STRING_TO_SENSOR_MODEL().contains(modelString)) {
+        qWarning().noquote().nospace()
+            << "The sensor model \"" << modelString << "\" is not valid."
+            << " The only valid sensor models are \""
+            << SENSOR_MODEL_TO_STRING().value(SensorModel::RAYS)
+            << "\" and \""
+            << SENSOR_MODEL_TO_STRING().value(SensorModel::CONE) << "\".";
+        *success = false;
+        return SensorModel::RAYS;
+    }
+    return STRING_TO_SENSOR_MODEL().value(modelString);
+}
+
 Cartesian MouseParser::alignVertex(const Cartesian& vertex, const Cartesian& alignmentTranslation,
         const Radians& alignmentRotation, const Cartesian& rotationPoint) {
     Cartesian translated = GeometryUtilities::translateVertex(vertex, alignmentTranslation);
@@ -38,7 +38,6 @@ public:
     QMap<QString, Sensor> getSensors(
         const Cartesian& initialTranslation,
         const Radians& initialRotation,
-        const Maze& maze,
         bool* success);
 
 private:
@@ -52,6 +51,7 @@ private:
         const QDomElement& element, const QString& tag, bool* success);
     QDomElement getContainerElement(const QDomElement& element, const QString& tag, bool* success);
     EncoderType getEncoderTypeIfValid(const QDomElement& element, bool* success);
+    SensorModel getSensorModelIfValid(const QDomElement& element, bool* success);
 
     Cartesian alignVertex(const Cartesian& vertex, const Cartesian& alignmentTranslation,
         const Radians& alignmentRotation, const Cartesian& rotationPoint);
@@ -77,6 +77,7 @@ private:
     static const QString RADIUS_TAG;
     static const QString RANGE_TAG;
     static const QString HALF_WIDTH_TAG;
+    static const QString MODEL_TAG;
 
     template<class T>
     QString getNameIfNonemptyAndUnique(
@@ -0,0 +1,97 @@
+#include "Opcode.h"
+
+#include "ContainerUtilities.h"
+
+namespace mms {
+
+const QMap<Opcode, QString>& OPCODE_TO_STRING() {
+    static const QMap<Opcode, QString> map = {
+        {Opcode::USE_CONTINUOUS_INTERFACE, "useContinuousInterface"},
+        {Opcode::SET_INITIAL_DIRECTION, "setInitialDirection"},
+        {Opcode::SET_TILE_TEXT_ROWS_AND_COLS, "setTileTextRowsAndCols"},
+        {Opcode::SET_WHEEL_SPEED_FRACTION, "setWheelSpeedFraction"},
+        {Opcode::USE_BINARY_PROTOCOL, "useBinaryProtocol"},
+        {Opcode::USE_SHARED_MEMORY_TRANSPORT, "useSharedMemoryTransport"},
+        {Opcode::UPDATE_ALLOW_OMNISCIENCE, "updateAllowOmniscience"},
+        {Opcode::UPDATE_AUTOMATICALLY_CLEAR_FOG, "updateAutomaticallyClearFog"},
+        {Opcode::UPDATE_DECLARE_BOTH_WALL_HALVES, "updateDeclareBothWallHalves"},
+        {Opcode::UPDATE_SET_TILE_TEXT_WHEN_DISTANCE_DECLARED,
+            "updateSetTileTextWhenDistanceDeclared"},
+        {Opcode::UPDATE_SET_TILE_BASE_COLOR_WHEN_DISTANCE_DECLARED_CORRECTLY,
+            "updateSetTileBaseColorWhenDistanceDeclaredCorrectly"},
+        {Opcode::UPDATE_DECLARE_WALL_ON_READ, "updateDeclareWallOnRead"},
+        {Opcode::UPDATE_USE_TILE_EDGE_MOVEMENTS, "updateUseTileEdgeMovements"},
+        {Opcode::MAZE_WIDTH, "mazeWidth"},
+        {Opcode::MAZE_HEIGHT, "mazeHeight"},
+        {Opcode::IS_OFFICIAL_MAZE, "isOfficialMaze"},
+        {Opcode::INITIAL_DIRECTION, "initialDirection"},
+        {Opcode::GET_RANDOM_FLOAT, "getRandomFloat"},
+        {Opcode::MILLIS, "millis"},
+        {Opcode::DELAY, "delay"},
+        {Opcode::RESET_POSITION, "resetPosition"},
+        {Opcode::INPUT_BUTTON_PRESSED, "inputButtonPressed"},
+        {Opcode::ACKNOWLEDGE_INPUT_BUTTON_PRESSED, "acknowledgeInputButtonPressed"},
+        {Opcode::SET_TILE_COLOR, "setTileColor"},
+        {Opcode::CLEAR_TILE_COLOR, "clearTileColor"},
+        {Opcode::CLEAR_ALL_TILE_COLOR, "clearAllTileColor"},
+        {Opcode::SET_TILE_TEXT, "setTileText"},
+        {Opcode::CLEAR_TILE_TEXT, "clearTileText"},
+        {Opcode::CLEAR_ALL_TILE_TEXT, "clearAllTileText"},
+        {Opcode::DECLARE_WALL, "declareWall"},
+        {Opcode::UNDECLARE_WALL, "undeclareWall"},
+        {Opcode::SET_TILE_FOGGINESS, "setTileFogginess"},
+        {Opcode::DECLARE_TILE_DISTANCE, "declareTileDistance"},
+        {Opcode::UNDECLARE_TILE_DISTANCE, "undeclareTileDistance"},
+        {Opcode::SET_TILE_COLORS, "setTileColors"},
+        {Opcode::FILL_TILE_COLOR, "fillTileColor"},
+        {Opcode::SET_TILE_TEXTS, "setTileTexts"},
+        {Opcode::FILL_TILE_TEXT, "fillTileText"},
+        {Opcode::SET_TILE_FOGGINESSES, "setTileFogginesses"},
+        {Opcode::FILL_TILE_FOGGINESS, "fillTileFogginess"},
+        {Opcode::DECLARE_WALLS, "declareWalls"},
+        {Opcode::DECLARE_TILE_DISTANCES, "declareTileDistances"},
+        {Opcode::GET_WHEEL_MAX_SPEED, "getWheelMaxSpeed"},
+        {Opcode::SET_WHEEL_SPEED, "setWheelSpeed"},
+        {Opcode::GET_WHEEL_ENCODER_TICKS_PER_REVOLUTION,
+            "getWheelEncoderTicksPerRevolution"},
+        {Opcode::READ_WHEEL_ENCODER, "readWheelEncoder"},
+        {Opcode::RESET_WHEEL_ENCODER, "resetWheelEncoder"},
+        {Opcode::READ_SENSOR, "readSensor"},
+        {Opcode::READ_GYRO, "readGyro"},
+        {Opcode::WALL_FRONT, "wallFront"},
+        {Opcode::WALL_RIGHT, "wallRight"},
+        {Opcode::WALL_LEFT, "wallLeft"},
+        {Opcode::MOVE_FORWARD, "moveForward"},
+        {Opcode::TURN_LEFT, "turnLeft"},
+        {Opcode::TURN_RIGHT, "turnRight"},
+        {Opcode::TURN_AROUND_LEFT, "turnAroundLeft"},
+        {Opcode::TURN_AROUND_RIGHT, "turnAroundRight"},
+        {Opcode::ORIGIN_MOVE_FORWARD_TO_EDGE, "originMoveForwardToEdge"},
+        {Opcode::ORIGIN_TURN_LEFT_IN_PLACE, "originTurnLeftInPlace"},
+        {Opcode::ORIGIN_TURN_RIGHT_IN_PLACE, "originTurnRightInPlace"},
+        {Opcode::MOVE_FORWARD_TO_EDGE, "moveForwardToEdge"},
+        {Opcode::TURN_LEFT_TO_EDGE, "turnLeftToEdge"},
+        {Opcode::TURN_RIGHT_TO_EDGE, "turnRightToEdge"},
+        {Opcode::TURN_AROUND_LEFT_TO_EDGE, "turnAroundLeftToEdge"},
+        {Opcode::TURN_AROUND_RIGHT_TO_EDGE, "turnAroundRightToEdge"},
+        {Opcode::DIAGONAL_LEFT_LEFT, "diagonalLeftLeft"},
+        {Opcode::DIAGONAL_LEFT_RIGHT, "diagonalLeftRight"},
+        {Opcode::DIAGONAL_RIGHT_LEFT, "diagonalRightLeft"},
+        {Opcode::DIAGONAL_RIGHT_RIGHT, "diagonalRightRight"},
+        {Opcode::CURRENT_X_TILE, "currentXTile"},
+        {Opcode::CURRENT_Y_TILE, "currentYTile"},
+        {Opcode::CURRENT_DIRECTION, "currentDirection"},
+        {Opcode::CURRENT_X_POS_METERS, "currentXPosMeters"},
+        {Opcode::CURRENT_Y_POS_METERS, "currentYPosMeters"},
+        {Opcode::CURRENT_ROTATION_DEGREES, "currentRotationDegrees"},
+    };
+    return map;
+}
+
+const QMap<QString, Opcode>& STRING_TO_OPCODE() {
+    static const QMap<QString, Opcode> map =
+        ContainerUtilities::inverse(OPCODE_TO_STRING());
+    return map;
+}
+
+} // namespace mms
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <QDebug>
+#include <QMap>
+#include <QString>
+
+namespace mms {
+
+// The commands that a mouse algorithm can send to the simulator. The values
+// are the opcodes of the binary protocol, and thus must never change (new
+// commands get new values); the templates in src/mouse/templates define the
+// same values.
+enum class Opcode : quint8 {
+
+    // Static options
+    USE_CONTINUOUS_INTERFACE = 1,
+    SET_INITIAL_DIRECTION = 2,
+    SET_TILE_TEXT_ROWS_AND_COLS = 3,
+    SET_WHEEL_SPEED_FRACTION = 4,
+    USE_BINARY_PROTOCOL = 5,
+    USE_SHARED_MEMORY_TRANSPORT = 6,
+
+    // Dynamic options
+    UPDATE_ALLOW_OMNISCIENCE = 10,
+    UPDATE_AUTOMATICALLY_CLEAR_FOG = 11,
+    UPDATE_DECLARE_BOTH_WALL_HALVES = 12,
+    UPDATE_SET_TILE_TEXT_WHEN_DISTANCE_DECLARED = 13,
+    UPDATE_SET_TILE_BASE_COLOR_WHEN_DISTANCE_DECLARED_CORRECTLY = 14,
+    UPDATE_DECLARE_WALL_ON_READ = 15,
+    UPDATE_USE_TILE_EDGE_MOVEMENTS = 16,
+
+    // Any interface
+    MAZE_WIDTH = 20,
+    MAZE_HEIGHT = 21,
+    IS_OFFICIAL_MAZE = 22,
+    INITIAL_DIRECTION = 23,
+    GET_RANDOM_FLOAT = 24,
+    MILLIS = 25,
+    DELAY = 26,
+    RESET_POSITION = 27,
+    INPUT_BUTTON_PRESSED = 28,
+    ACKNOWLEDGE_INPUT_BUTTON_PRESSED = 29,
+
+    // Tile appearance
+    SET_TILE_COLOR = 30,
+    CLEAR_TILE_COLOR = 31,
+    CLEAR_ALL_TILE_COLOR = 32,
+    SET_TILE_TEXT = 33,
+    CLEAR_TILE_TEXT = 34,
+    CLEAR_ALL_TILE_TEXT = 35,
+    DECLARE_WALL = 36,
+    UNDECLARE_WALL = 37,
+    SET_TILE_FOGGINESS = 38,
+    DECLARE_TILE_DISTANCE = 39,
+    UNDECLARE_TILE_DISTANCE = 40,
+
+    // Bulk tile appearance, i.e., many tiles per command
+    SET_TILE_COLORS = 41,
+    FILL_TILE_COLOR = 42,
+    SET_TILE_TEXTS = 43,
+    FILL_TILE_TEXT = 44,
+    SET_TILE_FOGGINESSES = 45,
+    FILL_TILE_FOGGINESS = 46,
+    DECLARE_WALLS = 47,
+    DECLARE_TILE_DISTANCES = 48,
+
+    // Continuous interface
+    GET_WHEEL_MAX_SPEED = 50,
+    SET_WHEEL_SPEED = 51,
+    GET_WHEEL_ENCODER_TICKS_PER_REVOLUTION = 52,
+    READ_WHEEL_ENCODER = 53,
+    RESET_WHEEL_ENCODER = 54,
+    READ_SENSOR = 55,
+    READ_GYRO = 56,
+
+    // Basic discrete interface
+    WALL_FRONT = 60,
+    WALL_RIGHT = 61,
+    WALL_LEFT = 62,
+    MOVE_FORWARD = 63,
+    TURN_LEFT = 64,
+    TURN_RIGHT = 65,
+    TURN_AROUND_LEFT = 66,
+    TURN_AROUND_RIGHT = 67,
+
+    // Special discrete interface
+    ORIGIN_MOVE_FORWARD_TO_EDGE = 70,
+    ORIGIN_TURN_LEFT_IN_PLACE = 71,
+    ORIGIN_TURN_RIGHT_IN_PLACE = 72,
+    MOVE_FORWARD_TO_EDGE = 73,
+    TURN_LEFT_TO_EDGE = 74,
+    TURN_RIGHT_TO_EDGE = 75,
+    TURN_AROUND_LEFT_TO_EDGE = 76,
+    TURN_AROUND_RIGHT_TO_EDGE = 77,
+    DIAGONAL_LEFT_LEFT = 78,
+    DIAGONAL_LEFT_RIGHT = 79,
+    DIAGONAL_RIGHT_LEFT = 80,
+    DIAGONAL_RIGHT_RIGHT = 81,
+
+    // Omniscience
+    CURRENT_X_TILE = 90,
+    CURRENT_Y_TILE = 91,
+    CURRENT_DIRECTION = 92,
+    CURRENT_X_POS_METERS = 93,
+    CURRENT_Y_POS_METERS = 94,
+    CURRENT_ROTATION_DEGREES = 95,
+};
+
+// Maps each opcode to the name of the command in the text protocol
+const QMap<Opcode, QString>& OPCODE_TO_STRING();
+const QMap<QString, Opcode>& STRING_TO_OPCODE();
+
+inline QDebug operator<<(QDebug stream, Opcode opcode) {
+    stream.noquote() << OPCODE_TO_STRING().value(opcode);
+    return stream;
+}
+
+} // namespace mms
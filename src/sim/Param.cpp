@@ -45,6 +45,8 @@ Param::Param() {
         "default-zoomed-map-scale", 0.1, m_minZoomedMapScale, m_maxZoomedMapScale);
     m_defaultRotateZoomedMap = ParamParser::getBoolIfHasBool(
         "default-rotate-zoomed-map", false);
+    m_maxFrameRate = ParamParser::getIntIfHasIntAndInRange(
+        "max-frame-rate", 60, 1, 240);
     m_tileBaseColor = ParamParser::getStringIfHasStringAndIsColor(
         "tile-base-color", COLOR_TO_STRING().value(Color::BLACK));
     m_tileWallColor = ParamParser::getStringIfHasStringAndIsColor(
@@ -130,6 +132,8 @@ Param::Param() {
         "number-of-circle-approximation-points", 8, 3, 30);
     m_numberOfSensorEdgePoints = ParamParser::getIntIfHasIntAndInRange(
         "number-of-sensor-edge-points", 3, 2, 10);
+    m_useSharedMemoryTransport = ParamParser::getBoolIfHasBool(
+        "use-shared-memory-transport", true);
 
     // Maze Parameters
     m_wallWidth = ParamParser::getDoubleIfHasDoubleAndInRange(
@@ -170,6 +174,10 @@ bool Param::defaultRotateZoomedMap() {
     return m_defaultRotateZoomedMap;
 }
 
+int Param::maxFrameRate() {
+    return m_maxFrameRate;
+}
+
 QString Param::tileBaseColor() {
     return m_tileBaseColor;
 }
@@ -322,6 +330,10 @@ int Param::numberOfSensorEdgePoints() {
     return m_numberOfSensorEdgePoints;
 }
 
+bool Param::useSharedMemoryTransport() {
+    return m_useSharedMemoryTransport;
+}
+
 double Param::wallWidth() {
     return m_wallWidth;
 }
@@ -23,6 +23,7 @@ public:
     double maxZoomedMapScale();
     double defaultZoomedMapScale();
     bool defaultRotateZoomedMap();
+    int maxFrameRate();
     QString tileBaseColor();
     QString tileWallColor();
     QString tileCornerColor();
@@ -63,6 +64,7 @@ public:
     bool printLateCollisionDetections();
     int numberOfCircleApproximationPoints();
     int numberOfSensorEdgePoints();
+    bool useSharedMemoryTransport();
 
     // Maze parameters
     double wallWidth();
@@ -86,6 +88,7 @@ private:
     double m_maxZoomedMapScale;
     double m_defaultZoomedMapScale;
     bool m_defaultRotateZoomedMap;
+    int m_maxFrameRate;
     QString m_tileBaseColor;
     QString m_tileWallColor;
     QString m_tileCornerColor;
@@ -126,6 +129,7 @@ private:
     bool m_printLateCollisionDetections;
     int m_numberOfCircleApproximationPoints;
     int m_numberOfSensorEdgePoints;
+    bool m_useSharedMemoryTransport;
 
     // Maze parameters
     double m_wallWidth;
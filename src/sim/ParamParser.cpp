@@ -2,7 +2,6 @@
 
 #include "Assert.h"
 #include "Color.h"
-#include "ConfigDialog.h"
 #include "ConfigDialogField.h"
 #include "Direction.h"
 #include "LayoutType.h"
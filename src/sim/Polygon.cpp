@@ -3,60 +3,58 @@
 #include <QtMath>
 
 #include "Assert.h"
-#include "GeometryUtilities.h"
 #include "SimUtilities.h"
 #include "polypartition/polypartition.h"
 #include "units/Polar.h"
 
 namespace mms {
 
-Polygon::Polygon() {
+Polygon::Polygon() :
+    m_triangulated(false) {
 }
 
-Polygon::Polygon(const Polygon& polygon) :
-    m_vertices(polygon.getVertices()) {
-    // If the polygon being copyed has already been triangulated, we should
-    // grab the triangles, lest we have to re-triangulate in the future. If not,
-    // we can be lazy, in case the triangles for this polygon aren't needed.
-    if (polygon.alreadyPerformedTriangulation()) {
-        m_triangles = polygon.getTriangles();
-    }
-    else {
-        // Uncomment to log untriangulated polygon copies
-        /*
-        static int i = 0;
-        i += 1;
-        if (i % 100 == 0) {
-            qInfo().noquote().nospace()
-                << "Untriangulated polygon copies count: %v", i);
-        }
-        */
-    }
+Polygon::Polygon(std::initializer_list<Cartesian> vertices) :
+    Polygon(VertexArray(vertices.begin(), vertices.end())) {
+}
+
+Polygon::Polygon(const QVector<Cartesian>& vertices) :
+    Polygon(VertexArray(vertices.constData(), vertices.constData() + vertices.size())) {
 }
 
-Polygon::Polygon(QVector<Cartesian> vertices) :
+Polygon::Polygon(const VertexArray& vertices) :
     m_vertices(vertices),
+    m_triangulated(false) {
     // Postpone triangulation until we absolutely have to do it.
-    m_triangles({}) {
     ASSERT_LE(3, m_vertices.size());
     // If the number of vertices is three, the triangulation is trivial
     if (m_vertices.size() == 3) {
-        m_triangles = {{
+        m_triangles.append({
             m_vertices.at(0),
             m_vertices.at(1),
             m_vertices.at(2),
-        }};
+        });
+        m_triangulated = true;
     }
 }
 
-QVector<Cartesian> Polygon::getVertices() const {
+Polygon Polygon::starShaped(const VertexArray& vertices, int center) {
+    ASSERT_LE(0, center);
+    ASSERT_LT(center, vertices.size());
+    Polygon polygon(vertices);
+    polygon.m_triangles = fan(vertices, center);
+    polygon.m_triangulated = true;
+    return polygon;
+}
+
+const Polygon::VertexArray& Polygon::getVertices() const {
     return m_vertices;
 }
 
-QVector<Triangle> Polygon::getTriangles() const {
+const Polygon::TriangleArray& Polygon::getTriangles() const {
     // Lazy initialization here
-    if (m_triangles.size() == 0) {
+    if (!m_triangulated) {
         m_triangles = triangulate(m_vertices);
+        m_triangulated = true;
     }
     return m_triangles;
 }
@@ -81,53 +79,117 @@ MetersSquared Polygon::area() const {
 }
 
 Polygon Polygon::translate(const Coordinate& translation) const {
+    return transform(Transform::translation(translation.getVector()));
+}
 
-    QVector<Cartesian> vertices;
-    for (const Cartesian& vertex : m_vertices) {
-        vertices.push_back(GeometryUtilities::translateVertex(vertex, translation));
-    }
+Polygon Polygon::rotateAroundPoint(const Angle& angle, const Coordinate& point) const {
+    return transform(Transform::rotationAround(
+        angle.getCos(), angle.getSin(), point.getVector()));
+}
 
-    QVector<Triangle> triangles;
-    for (const Triangle& triangle : m_triangles) {
-        triangles.push_back({
-            GeometryUtilities::translateVertex(triangle.p1, translation),
-            GeometryUtilities::translateVertex(triangle.p2, translation),
-            GeometryUtilities::translateVertex(triangle.p3, translation),
-        });
-    }
+Polygon Polygon::transform(const Transform& transform) const {
+
+    // The corners of the triangles are contiguous, just like the vertices, so
+    // each can be transformed in a single pass
+    static_assert(
+        sizeof(Triangle) == 3 * sizeof(Cartesian),
+        "Triangle must be exactly three Cartesians");
+
+    Polygon polygon;
+    polygon.m_vertices.resize(m_vertices.size());
+    transform.apply(
+        m_vertices.constData(),
+        m_vertices.size(),
+        polygon.m_vertices.data());
+    polygon.m_triangles.resize(m_triangles.size());
+    transform.apply(
+        &m_triangles.constData()->p1,
+        3 * m_triangles.size(),
+        &polygon.m_triangles.data()->p1);
+    polygon.m_triangulated = m_triangulated;
+    return polygon;
+}
 
-    return Polygon(vertices, triangles);
+Polygon::TriangleArray Polygon::triangulate(const VertexArray& vertices) {
+    if (vertices.size() < 3) {
+        return {};
+    }
+    if (isConvex(vertices)) {
+        return fan(vertices, 0);
+    }
+    return earClip(vertices);
 }
 
-Polygon Polygon::rotateAroundPoint(const Angle& angle, const Coordinate& point) const {
+bool Polygon::isConvex(const VertexArray& vertices) {
 
-    QVector<Cartesian> vertices;
-    for (const Cartesian& vertex : m_vertices) {
-        vertices.push_back(GeometryUtilities::rotateVertexAroundPoint(vertex, angle, point));
-    }
+    // A polygon is convex if it always turns the same way, and if it doesn't
+    // wind around more than once, which would be the case if, e.g., it were a
+    // pentagram. The latter is true if the x and y components of the edges
+    // each change sign at most twice. Collinear vertices are allowed.
 
-    QVector<Triangle> triangles;
-    for (const Triangle& triangle : m_triangles) {
-        triangles.push_back({
-            GeometryUtilities::rotateVertexAroundPoint(triangle.p1, angle, point),
-            GeometryUtilities::rotateVertexAroundPoint(triangle.p2, angle, point),
-            GeometryUtilities::rotateVertexAroundPoint(triangle.p3, angle, point),
-        });
+    int n = vertices.size();
+    if (n < 3) {
+        return false;
     }
 
-    return Polygon(vertices, triangles);
-}
+    double turn = 0.0;
+    int xSignChanges = 0;
+    int ySignChanges = 0;
+    double previousDx = 0.0;
+    double previousDy = 0.0;
+
+    // Start with the last edge, so that we also compare it with the first
+    units::Vector previousEdge = vertices.at(0).getVector() - vertices.at(n - 1).getVector();
+    for (int i = 0; i < n; i += 1) {
+        units::Vector edge =
+            vertices.at((i + 1) % n).getVector() - vertices.at(i).getVector();
+
+        double cross = previousEdge.cross(edge).value();
+        if (cross != 0.0) {
+            if (cross * turn < 0.0) {
+                return false;
+            }
+            turn = cross;
+        }
 
-Polygon::Polygon(QVector<Cartesian> vertices, QVector<Triangle> triangles) :
-    m_vertices(vertices),
-    m_triangles(triangles) {
+        double dx = edge.x().value();
+        double dy = edge.y().value();
+        if (dx != 0.0) {
+            if (dx * previousDx < 0.0) {
+                xSignChanges += 1;
+            }
+            previousDx = dx;
+        }
+        if (dy != 0.0) {
+            if (dy * previousDy < 0.0) {
+                ySignChanges += 1;
+            }
+            previousDy = dy;
+        }
+
+        previousEdge = edge;
+    }
+
+    // Note that we don't count the sign change between the last and first
+    // edges, so a convex polygon may have at most two changes in either
+    return xSignChanges <= 2 && ySignChanges <= 2;
 }
 
-bool Polygon::alreadyPerformedTriangulation() const {
-    return 0 < m_triangles.size();
+Polygon::TriangleArray Polygon::fan(const VertexArray& vertices, int center) {
+    int n = vertices.size();
+    TriangleArray triangles;
+    triangles.reserve(n - 2);
+    for (int i = 1; i + 1 < n; i += 1) {
+        triangles.append({
+            vertices.at(center),
+            vertices.at((center + i) % n),
+            vertices.at((center + i + 1) % n),
+        });
+    }
+    return triangles;
 }
 
-QVector<Triangle> Polygon::triangulate(QVector<Cartesian> vertices) {
+Polygon::TriangleArray Polygon::earClip(const VertexArray& vertices) {
 
     // Populate the TPPLPoly
     TPPLPoly tpplPoly;
@@ -144,9 +206,9 @@ QVector<Triangle> Polygon::triangulate(QVector<Cartesian> vertices) {
     triangulator.Triangulate_EC(&tpplPoly, &result);
 
     // Populate the output vector
-    QVector<Triangle> triangles;
+    TriangleArray triangles;
     for (auto it = result.begin(); it != result.end(); it++) {
-        triangles.push_back({
+        triangles.append({
             Cartesian(Meters((*it)[0].x), Meters((*it)[0].y)),
             Cartesian(Meters((*it)[1].x), Meters((*it)[1].y)),
             Cartesian(Meters((*it)[2].x), Meters((*it)[2].y)),
@@ -2,6 +2,10 @@
 
 #include <QVector>
 
+#include <initializer_list>
+
+#include "SmallVector.h"
+#include "Transform.h"
 #include "Triangle.h"
 #include "units/Angle.h"
 #include "units/Cartesian.h"
@@ -12,40 +16,62 @@ class Polygon {
 
 public:
 
-    Polygon();
-    Polygon(const Polygon& polygon);
-    Polygon(QVector<Cartesian> vertices);
+    // Polygons with at most this many vertices (which includes every part of
+    // the mouse, and every tile polygon) are stored entirely inline, so that
+    // creating, copying, and transforming them never allocates
+    static const int INLINE_VERTICES = 12;
+    using VertexArray = SmallVector<Cartesian, INLINE_VERTICES>;
+    using TriangleArray = SmallVector<Triangle, INLINE_VERTICES - 2>;
 
-    QVector<Cartesian> getVertices() const;
-    QVector<Triangle> getTriangles() const;
+    Polygon();
+    Polygon(std::initializer_list<Cartesian> vertices);
+    Polygon(const QVector<Cartesian>& vertices);
+    Polygon(const VertexArray& vertices);
+
+    // Creates a polygon that's star-shaped about one of its vertices, i.e.,
+    // every point of which is visible from that vertex (e.g., a sensor's view
+    // from the sensor, or any convex polygon from any of its vertices). Its
+    // triangulation is simply a fan around that vertex, so, unlike the
+    // general triangulation, it's cheap and doesn't allocate.
+    static Polygon starShaped(const VertexArray& vertices, int center = 0);
+
+    // Note that these are views into the polygon, and are thus only valid for
+    // as long as the polygon itself
+    const VertexArray& getVertices() const;
+    const TriangleArray& getTriangles() const;
 
     MetersSquared area() const;
 
     Polygon translate(const Coordinate& translation) const;
     Polygon rotateAroundPoint(const Angle& angle, const Coordinate& point) const;
 
+    // Returns the result of applying the transform to every vertex (and every
+    // triangle, so that the result needn't be triangulated again); compose
+    // transforms with Transform::then to apply several in one pass
+    Polygon transform(const Transform& transform) const;
+
 private:
 
-    QVector<Cartesian> m_vertices;
+    VertexArray m_vertices;
 
     // We're lazy about triangulation, since it's expensive and not always
     // necessary. The "mutable" keyword allows us to assign m_triangles in the
-    // const function getTriangles().
-    mutable QVector<Triangle> m_triangles;
-
-    // This special constructor makes it so that rotate and translate don't
-    // require re-triangulation. We keep it private since it's pretty easy to
-    // abuse the fact that the triangles argument should be the triangulation
-    // of the polygon specified by the vertices argument.
-    Polygon(QVector<Cartesian> vertices, QVector<Triangle> triangles);
-
-    // Tells us whether or not the polygon has already performed triangulation.
-    // This is used in the copy constructor, and allows us to be lazy without
-    // throwing away information.
-    bool alreadyPerformedTriangulation() const;
-
-    // Actually peforms the triangulation of the polygon.
-    static QVector<Triangle> triangulate(QVector<Cartesian> vertices);
+    // const function getTriangles(). Note that, since copying a polygon copies
+    // the triangles, and rotate and translate transform them, we only ever
+    // triangulate once, no matter how the polygon is transformed. A polygon
+    // may have no triangles at all (e.g., if it's degenerate), so whether or
+    // not it's been triangulated is tracked separately.
+    mutable TriangleArray m_triangles;
+    mutable bool m_triangulated;
+
+    // Actually peforms the triangulation of the polygon. Almost every polygon
+    // is convex (tiles, circles, the convex hull, etc.), in which case we fan
+    // the triangles around the first vertex, in linear time; everything else
+    // falls back to ear clipping, which is quadratic, and allocates.
+    static TriangleArray triangulate(const VertexArray& vertices);
+    static bool isConvex(const VertexArray& vertices);
+    static TriangleArray fan(const VertexArray& vertices, int center);
+    static TriangleArray earClip(const VertexArray& vertices);
 
 };
 
@@ -15,6 +15,7 @@ namespace mms {
 Sensor::Sensor() :
     m_range(Meters(0)),
     m_halfWidth(Radians(0)),
+    m_model(SensorModel::RAYS),
     m_initialPosition(Cartesian(Meters(0), Meters(0))),
     m_initialDirection(Radians(0)) {
 }
@@ -25,9 +26,10 @@ Sensor::Sensor(
         const Angle& halfWidth,
         const Coordinate& position,
         const Angle& direction,
-        const Maze& maze) :
+        SensorModel model) :
         m_range(range),
         m_halfWidth(halfWidth),
+        m_model(model),
         m_initialPosition(position),
         m_initialDirection(direction) {
 
@@ -36,15 +38,16 @@ Sensor::Sensor(
         position, radius, P()->numberOfCircleApproximationPoints());
 
     // Create the polygon for the view of the sensor
-    QVector<Cartesian> view;
-    view.push_back(position);
+    Polygon::VertexArray view;
+    view.append(position);
     for (double i = -1; i <= 1; i += 2.0 / (P()->numberOfSensorEdgePoints() - 1)) {
-        view.push_back(Polar(range, (Radians(halfWidth) * i) + direction) + position);
+        view.append(Polar(range, (Radians(halfWidth) * i) + direction) + position);
     }
-    m_initialViewPolygon = Polygon(view);
+    m_initialViewPolygon = Polygon::starShaped(view);
+}
 
-    // Initialize the sensor reading
-    updateReading(m_initialPosition, m_initialDirection, maze);
+SensorModel Sensor::getModel() const {
+    return m_model;
 }
 
 Cartesian Sensor::getInitialPosition() const {
@@ -70,23 +73,24 @@ Polygon Sensor::getCurrentViewPolygon(
     return getViewPolygon(currentPosition, currentDirection, maze);
 }
 
-double Sensor::read() const {
-    return m_currentReading;
-}
-
-void Sensor::updateReading(
+double Sensor::getReading(
         const Cartesian& currentPosition,
         const Radians& currentDirection,
-        const Maze& maze) {
+        const Maze& maze) const {
 
-    m_currentReading = std::max(
+    if (m_model == SensorModel::CONE) {
+        return getConeReading(currentPosition, currentDirection, maze);
+    }
+
+    double reading = std::max(
         0.0,
         1.0 -
             getViewPolygon(currentPosition, currentDirection, maze).area() /
             getInitialViewPolygon().area());
 
-    ASSERT_LE(0.0, m_currentReading);
-    ASSERT_LE(m_currentReading, 1.0);
+    ASSERT_LE(0.0, reading);
+    ASSERT_LE(reading, 1.0);
+    return reading;
 }
 
 Polygon Sensor::getViewPolygon(
@@ -96,18 +100,23 @@ Polygon Sensor::getViewPolygon(
 
     // TODO: MACK - this can be deduped with getCurrentViewPolygon
 
-    // Calling this function causes triangulation of a polygon
-
-    static Meters halfWallWidth = Meters(P()->wallWidth() / 2.0);
-    static Meters tileLength = Meters(P()->wallLength() + P()->wallWidth());
+    static units::Length halfWallWidth = units::Length(P()->wallWidth() / 2.0);
+    static units::Length tileLength = units::Length(P()->wallLength() + P()->wallWidth());
 
-    QVector<Cartesian> polygon {currentPosition};
+    // The view is star-shaped about the position of the sensor, since each
+    // of the other vertices is the end of a ray cast from there
+    Polygon::VertexArray polygon;
+    polygon.append(currentPosition);
 
+    units::Vector position = currentPosition.getVector();
+    units::Length range = units::Length(m_range.getMeters());
     for (double i = -1; i <= 1; i += 2.0 / (P()->numberOfSensorEdgePoints() - 1)) {
-        polygon.push_back(
+        units::Angle direction = units::Angle(
+            (currentDirection + (m_halfWidth * i)).getRadiansZeroTo2pi());
+        polygon.append(
             GeometryUtilities::castRay(
-                currentPosition,
-                currentPosition + Polar(m_range, currentDirection + (m_halfWidth * i)),
+                position,
+                position + units::Vector::fromPolar(range, direction),
                 maze,
                 halfWallWidth,
                 tileLength
@@ -115,7 +124,36 @@ Polygon Sensor::getViewPolygon(
         );
     }
 
-    return Polygon(polygon);
+    return Polygon::starShaped(polygon);
+}
+
+double Sensor::getConeReading(
+        const Cartesian& currentPosition,
+        const Radians& currentDirection,
+        const Maze& maze) const {
+
+    static units::Length halfWallWidth = units::Length(P()->wallWidth() / 2.0);
+    static units::Length tileLength = units::Length(P()->wallLength() + P()->wallWidth());
+
+    units::Length range = units::Length(m_range.getMeters());
+    units::Angle halfWidth = units::Angle(m_halfWidth.getRadiansNotBounded());
+
+    // The area of the entire view cone, i.e., a sector of a circle
+    units::Area viewArea = range * range * halfWidth.value();
+    if (viewArea.value() <= 0.0) {
+        return 0.0;
+    }
+
+    units::Area visibleArea = GeometryUtilities::getVisibleConeArea(
+        currentPosition.getVector(),
+        units::Angle(currentDirection.getRadiansNotBounded()),
+        halfWidth,
+        range,
+        maze,
+        halfWallWidth,
+        tileLength);
+
+    return std::min(1.0, std::max(0.0, 1.0 - visibleArea / viewArea));
 }
 
 } // namespace mms
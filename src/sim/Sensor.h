@@ -9,6 +9,7 @@
 
 #include "Maze.h"
 #include "Polygon.h"
+#include "SensorModel.h"
 
 namespace mms {
 
@@ -22,8 +23,9 @@ public:
         const Angle& halfWidth,
         const Coordinate& position,
         const Angle& direction,
-        const Maze& maze);
+        SensorModel model);
 
+    SensorModel getModel() const;
     Cartesian getInitialPosition() const;
     Radians getInitialDirection() const;
     const Polygon& getInitialPolygon() const;
@@ -33,27 +35,34 @@ public:
         const Radians& currentDirection,
         const Maze& maze) const;
 
-    double read() const;
-    void updateReading(
+    // Returns the reading of the sensor at the given position and direction,
+    // from 0.0 (completely free) to 1.0 (completely blocked). This is fairly
+    // expensive, so the Mouse only calls it when a reading is requested.
+    double getReading(
         const Cartesian& currentPosition,
         const Radians& currentDirection,
-        const Maze& maze);
+        const Maze& maze) const;
 
 private:
     Meters m_range;
     Degrees m_halfWidth;
+    SensorModel m_model;
 
     Cartesian m_initialPosition;
     Radians m_initialDirection;
     Polygon m_initialPolygon;
     Polygon m_initialViewPolygon;
 
-    double m_currentReading;
-
     Polygon getViewPolygon(
         const Cartesian& currentPosition,
         const Radians& currentDirection,
         const Maze& maze) const;
+
+    // The exact reading, computed from the visible area of the view cone
+    double getConeReading(
+        const Cartesian& currentPosition,
+        const Radians& currentDirection,
+        const Maze& maze) const;
 };
 
 } // namespace mms
@@ -0,0 +1,21 @@
+#include "SensorModel.h"
+
+#include "ContainerUtilities.h"
+
+namespace mms {
+
+const QMap<SensorModel, QString>& SENSOR_MODEL_TO_STRING() {
+    static const QMap<SensorModel, QString> map = {
+        {SensorModel::RAYS, "RAYS"},
+        {SensorModel::CONE, "CONE"},
+    };
+    return map;
+}
+
+const QMap<QString, SensorModel>& STRING_TO_SENSOR_MODEL() {
+    static const QMap<QString, SensorModel> map =
+        ContainerUtilities::inverse(SENSOR_MODEL_TO_STRING());
+    return map;
+}
+
+} // namespace mms
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QDebug>
+#include <QMap>
+#include <QString>
+
+#include "ContainerUtilities.h"
+
+namespace mms {
+
+// How a sensor's reading is computed: either by sampling its view with a
+// number of rays (see numberOfSensorEdgePoints), or by computing the exact
+// visible area of its view cone
+enum class SensorModel {
+    RAYS,
+    CONE,
+};
+
+const QMap<SensorModel, QString>& SENSOR_MODEL_TO_STRING();
+const QMap<QString, SensorModel>& STRING_TO_SENSOR_MODEL();
+
+inline QDebug operator<<(QDebug stream, SensorModel sensorModel) {
+    stream.noquote() << SENSOR_MODEL_TO_STRING().value(sensorModel);
+    return stream;
+}
+
+} // namespace mms
@@ -1,8 +1,6 @@
 #include "SettingsMouseAlgos.h"
 
 #include "Assert.h"
-#include "ConfigDialog.h"
-#include "ConfigDialogField.h"
 #include "Settings.h"
 
 namespace mms {
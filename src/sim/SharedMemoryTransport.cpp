@@ -0,0 +1,258 @@
+#include "SharedMemoryTransport.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QThread>
+#include <QtGlobal>
+
+#include <climits>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+namespace mms {
+
+// The counters are shared with another process, and so must be plain,
+// lock-free 32-bit values
+static_assert(
+    sizeof(std::atomic<quint32>) == sizeof(quint32) && ATOMIC_INT_LOCK_FREE == 2,
+    "Shared memory counters must be lock-free 32-bit integers");
+
+const char* const SharedMemoryTransport::ENVIRONMENT_VARIABLE = "MMS_SHARED_MEMORY";
+
+SharedMemoryTransport::SharedMemoryTransport() :
+        m_memory(nullptr),
+        m_pendingPosition(0) {
+#ifdef Q_OS_UNIX
+    QString name = nextName();
+    QByteArray encodedName = name.toLatin1();
+    int fd = shm_open(encodedName.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        return;
+    }
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, SEGMENT_SIZE) == 0) {
+        memory = mmap(
+            nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(encodedName.constData());
+        return;
+    }
+
+    // The segment is zero-filled, so only the header needs initializing
+    m_name = name;
+    m_memory = static_cast<char*>(memory);
+    counter(VERSION_OFFSET)->store(VERSION);
+    counter(CAPACITY_OFFSET)->store(CAPACITY);
+    counter(MAGIC_OFFSET)->store(MAGIC);
+#endif
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+#ifdef Q_OS_UNIX
+    if (m_memory != nullptr) {
+        close();
+        munmap(m_memory, SEGMENT_SIZE);
+        shm_unlink(m_name.toLatin1().constData());
+    }
+#endif
+}
+
+bool SharedMemoryTransport::isValid() const {
+    return m_memory != nullptr;
+}
+
+QString SharedMemoryTransport::getName() const {
+    return m_name;
+}
+
+bool SharedMemoryTransport::waitForCommands(int timeoutMicroseconds) {
+
+    std::atomic<quint32>* head = counter(COMMAND_HEAD_OFFSET);
+    quint32 tail = counter(COMMAND_TAIL_OFFSET)->load(std::memory_order_relaxed);
+    for (int i = 0; i < SPIN_ITERATIONS; i += 1) {
+        if (head->load(std::memory_order_acquire) != tail) {
+            return true;
+        }
+    }
+
+    // The algorithm checks the sleeping flag after advancing the head, and
+    // we check the head after setting the flag, so it can't miss us
+    std::atomic<quint32>* sleeping = counter(COMMAND_SLEEPING_OFFSET);
+    sleeping->store(1);
+    quint32 observed = head->load();
+    if (observed == tail && !isClosed()) {
+        wait(head, observed, timeoutMicroseconds);
+    }
+    sleeping->store(0, std::memory_order_relaxed);
+    return head->load(std::memory_order_acquire) != tail;
+}
+
+void SharedMemoryTransport::readCommands(CommandReader* reader) {
+    quint32 head = counter(COMMAND_HEAD_OFFSET)->load(std::memory_order_acquire);
+    quint32 tail = counter(COMMAND_TAIL_OFFSET)->load(std::memory_order_relaxed);
+    quint32 available = head - tail;
+    if (CAPACITY < available) {
+        closeCorrupted();
+        return;
+    }
+    if (available == 0) {
+        return;
+    }
+    quint32 start = tail & (CAPACITY - 1);
+    quint32 first = qMin(available, CAPACITY - start);
+    reader->append(commandData() + start, static_cast<int>(first));
+    if (first < available) {
+        reader->append(commandData(), static_cast<int>(available - first));
+    }
+    counter(COMMAND_TAIL_OFFSET)->store(head, std::memory_order_release);
+}
+
+void SharedMemoryTransport::writeReplies(const QByteArray& replies) {
+    if (!hasPendingReplies()) {
+        m_pendingReplies.resize(0);
+        m_pendingPosition = 0;
+        m_sinceRepliesRead.start();
+    }
+    m_pendingReplies.append(replies);
+    writePendingReplies();
+}
+
+bool SharedMemoryTransport::hasPendingReplies() const {
+    return m_pendingPosition < m_pendingReplies.size();
+}
+
+void SharedMemoryTransport::flushReplies(int timeoutMicroseconds) {
+    if (writePendingReplies() || !hasPendingReplies()) {
+        return;
+    }
+    if (REPLY_TIMEOUT_MILLISECONDS <= m_sinceRepliesRead.elapsed()) {
+        qWarning().noquote()
+            << "The mouse algorithm stopped reading its replies from the"
+            << "shared memory segment, and so it is being closed.";
+        close();
+        return;
+    }
+    // The algorithm doesn't wake us when it reads, so this just sleeps
+    std::atomic<quint32>* tail = counter(REPLY_TAIL_OFFSET);
+    wait(tail, tail->load(std::memory_order_acquire), timeoutMicroseconds);
+    writePendingReplies();
+}
+
+bool SharedMemoryTransport::writePendingReplies() {
+
+    // If the algorithm is gone, nobody will read the replies
+    if (isClosed()) {
+        m_pendingReplies.resize(0);
+        m_pendingPosition = 0;
+        return false;
+    }
+
+    std::atomic<quint32>* head = counter(REPLY_HEAD_OFFSET);
+    quint32 written = head->load(std::memory_order_relaxed);
+    quint32 read = counter(REPLY_TAIL_OFFSET)->load(std::memory_order_acquire);
+    if (CAPACITY < written - read) {
+        closeCorrupted();
+        return false;
+    }
+    quint32 space = CAPACITY - (written - read);
+    quint32 remaining = static_cast<quint32>(m_pendingReplies.size() - m_pendingPosition);
+    if (space == 0 || remaining == 0) {
+        return false;
+    }
+
+    quint32 count = qMin(remaining, space);
+    quint32 start = written & (CAPACITY - 1);
+    quint32 first = qMin(count, CAPACITY - start);
+    const char* bytes = m_pendingReplies.constData() + m_pendingPosition;
+    std::memcpy(replyData() + start, bytes, first);
+    std::memcpy(replyData(), bytes + first, count - first);
+    head->store(written + count);
+    if (counter(REPLY_SLEEPING_OFFSET)->load() != 0) {
+        wake(head);
+    }
+
+    m_pendingPosition += static_cast<int>(count);
+    m_sinceRepliesRead.start();
+    return true;
+}
+
+void SharedMemoryTransport::close() {
+    counter(CLOSED_OFFSET)->store(1);
+    wake(counter(COMMAND_HEAD_OFFSET));
+    wake(counter(REPLY_HEAD_OFFSET));
+}
+
+bool SharedMemoryTransport::isClosed() const {
+    return counter(CLOSED_OFFSET)->load(std::memory_order_acquire) != 0;
+}
+
+void SharedMemoryTransport::closeCorrupted() {
+    if (!isClosed()) {
+        qWarning().noquote()
+            << "The mouse algorithm corrupted the shared memory segment, and so"
+            << "it is being closed.";
+        close();
+    }
+}
+
+std::atomic<quint32>* SharedMemoryTransport::counter(int offset) const {
+    return reinterpret_cast<std::atomic<quint32>*>(m_memory + offset);
+}
+
+char* SharedMemoryTransport::commandData() const {
+    return m_memory + DATA_OFFSET;
+}
+
+char* SharedMemoryTransport::replyData() const {
+    return m_memory + DATA_OFFSET + CAPACITY;
+}
+
+void SharedMemoryTransport::wait(
+        std::atomic<quint32>* address, quint32 expected, int timeoutMicroseconds) {
+#ifdef Q_OS_LINUX
+    // Note that, since the segment is shared between processes, this can't
+    // be a FUTEX_PRIVATE_FLAG operation
+    struct timespec timeout;
+    timeout.tv_sec = timeoutMicroseconds / 1000000;
+    timeout.tv_nsec = (timeoutMicroseconds % 1000000) * 1000;
+    syscall(
+        SYS_futex, reinterpret_cast<quint32*>(address),
+        FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else
+    Q_UNUSED(address);
+    Q_UNUSED(expected);
+    QThread::usleep(qMin(timeoutMicroseconds, 100));
+#endif
+}
+
+void SharedMemoryTransport::wake(std::atomic<quint32>* address) {
+#ifdef Q_OS_LINUX
+    syscall(
+        SYS_futex, reinterpret_cast<quint32*>(address),
+        FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    Q_UNUSED(address);
+#endif
+}
+
+QString SharedMemoryTransport::nextName() {
+    static std::atomic<int> count(0);
+    return QString("/mms-%1-%2")
+        .arg(QCoreApplication::applicationPid())
+        .arg(count.fetch_add(1));
+}
+
+} // namespace mms
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+#include "CommandReader.h"
+
+namespace mms {
+
+// An optional alternative to stderr and stdin for algorithms running on the
+// same machine as the simulator: a shared memory segment containing a pair of
+// single-producer, single-consumer byte rings, one for commands and one for
+// replies, each carrying the frames of the binary protocol. Waiting for data
+// spins briefly and then sleeps on a futex (on Linux; other platforms poll),
+// so that neither side needs a system call while the other is busy.
+//
+// The segment's layout, which src/mouse/templates/c++/SharedMemory.h
+// duplicates, is as follows, with all offsets in bytes and all values u32:
+//   0: magic, 4: version, 8: the capacity of each ring, 12: closed
+//   64, 128, 192: the command ring's head, tail, and sleeping flag
+//   256, 320, 384: the reply ring's head, tail, and sleeping flag
+//   512: the command ring's data, followed by the reply ring's data
+// A head (tail) is the number of bytes ever written to (read from) its ring,
+// and a sleeping flag is set while the consumer is waiting on the head.
+class SharedMemoryTransport {
+
+public:
+
+    // The environment variable that gives the algorithm the segment's name
+    static const char* const ENVIRONMENT_VARIABLE;
+
+    // Creates the segment; it's only usable if isValid() returns true
+    SharedMemoryTransport();
+    ~SharedMemoryTransport();
+
+    SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+    SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+    bool isValid() const;
+    QString getName() const;
+
+    // Waits for at most timeout microseconds, returning whether or not any
+    // command bytes are available
+    bool waitForCommands(int timeoutMicroseconds);
+
+    // Moves all available command bytes into reader. If the ring's head and
+    // tail don't make sense, the algorithm has corrupted the segment, and so
+    // the transport is closed.
+    void readCommands(CommandReader* reader);
+
+    // Writes as many of the replies as fit in the ring, and keeps the rest,
+    // which flushReplies() writes once the algorithm has made space for them
+    void writeReplies(const QByteArray& replies);
+
+    // Whether or not some replies haven't been written yet; while that's the
+    // case, no more commands should be read, so that an algorithm that never
+    // reads its replies can't make us buffer an unbounded number of them
+    bool hasPendingReplies() const;
+
+    // Writes as many of the pending replies as fit, waiting at most timeout
+    // microseconds for space if none do. If the algorithm doesn't make any
+    // space for REPLY_TIMEOUT_MILLISECONDS, it's presumably deadlocked
+    // (e.g., blocked writing commands rather than reading replies), and so
+    // the transport is closed.
+    void flushReplies(int timeoutMicroseconds);
+
+    // Marks the segment as closed, waking up the algorithm if necessary; the
+    // algorithm also closes the segment when it exits
+    void close();
+    bool isClosed() const;
+
+private:
+
+    static const quint32 MAGIC = 0x314D4D53; // "SMM1", little-endian
+    static const quint32 VERSION = 1;
+    static const quint32 CAPACITY = 1 << 16;
+
+    static const int MAGIC_OFFSET = 0;
+    static const int VERSION_OFFSET = 4;
+    static const int CAPACITY_OFFSET = 8;
+    static const int CLOSED_OFFSET = 12;
+    static const int COMMAND_HEAD_OFFSET = 64;
+    static const int COMMAND_TAIL_OFFSET = 128;
+    static const int COMMAND_SLEEPING_OFFSET = 192;
+    static const int REPLY_HEAD_OFFSET = 256;
+    static const int REPLY_TAIL_OFFSET = 320;
+    static const int REPLY_SLEEPING_OFFSET = 384;
+    static const int DATA_OFFSET = 512;
+    static const int SEGMENT_SIZE = DATA_OFFSET + 2 * CAPACITY;
+
+    // How many times to check for data before sleeping
+    static const int SPIN_ITERATIONS = 4096;
+
+    // How long to wait for the algorithm to read its replies
+    static const int REPLY_TIMEOUT_MILLISECONDS = 5000;
+
+    QString m_name;
+    char* m_memory;
+
+    // The replies that didn't fit in the ring yet, from m_pendingPosition on,
+    // and how long it's been since the algorithm last made space for them
+    QByteArray m_pendingReplies;
+    int m_pendingPosition;
+    QElapsedTimer m_sinceRepliesRead;
+
+    // Writes as many pending replies as fit, returning whether any did
+    bool writePendingReplies();
+
+    // Closes the segment because a ring's head and tail don't make sense
+    void closeCorrupted();
+
+    std::atomic<quint32>* counter(int offset) const;
+    char* commandData() const;
+    char* replyData() const;
+
+    // Sleeps while *address equals expected, for at most the timeout, and
+    // wakes up any such sleepers, respectively
+    static void wait(
+        std::atomic<quint32>* address, quint32 expected, int timeoutMicroseconds);
+    static void wake(std::atomic<quint32>* address);
+
+    // Returns a segment name that's unique to this process and call
+    static QString nextName();
+
+};
+
+} // namespace mms
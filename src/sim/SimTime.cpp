@@ -1,20 +1,15 @@
 #include "SimTime.h"
 
-#include "Assert.h"
 #include "SimUtilities.h"
 
 namespace mms {
 
-SimTime* SimTime::INSTANCE = nullptr;
-
-void SimTime::init() {
-    ASSERT_TR(INSTANCE == nullptr);
-    INSTANCE = new SimTime();
-}
-
-SimTime* SimTime::get() {
-    ASSERT_FA(INSTANCE == nullptr);
-    return INSTANCE;
+SimTime::SimTime() :
+        m_lockStepEnabled(false),
+        m_ticksRequested(0),
+        m_ticksCompleted(0),
+        m_ticksInterrupted(false) {
+    reset();
 }
 
 Seconds SimTime::startTimestamp() {
@@ -36,10 +31,60 @@ void SimTime::incrementElapsedSimTime(const Duration& duration) {
 void SimTime::reset() {
     m_startTimestamp = Seconds(SimUtilities::getHighResTimestamp());
     m_elapsedSimTime = Seconds(0);
+    m_tickMutex.lock();
+    m_ticksRequested = m_ticksCompleted;
+    m_ticksInterrupted = false;
+    m_tickMutex.unlock();
 }
 
-SimTime::SimTime() {
-    reset();
+bool SimTime::lockStepEnabled() {
+    return m_lockStepEnabled;
+}
+
+void SimTime::setLockStepEnabled(bool enabled) {
+    m_lockStepEnabled = enabled;
+}
+
+bool SimTime::awaitTick() {
+    m_tickMutex.lock();
+    if (m_ticksRequested == m_ticksCompleted) {
+        m_ticksRequested += 1;
+        m_tickRequestedCondition.wakeAll();
+    }
+    // There's no timeout, since giving up on the tick and then requesting
+    // another could let the model perform one more tick than requested
+    while (m_ticksCompleted < m_ticksRequested && !m_ticksInterrupted) {
+        m_tickCompletedCondition.wait(&m_tickMutex);
+    }
+    bool completed = m_ticksCompleted == m_ticksRequested;
+    m_tickMutex.unlock();
+    return completed;
+}
+
+void SimTime::interruptTicks() {
+    m_tickMutex.lock();
+    m_ticksInterrupted = true;
+    m_tickCompletedCondition.wakeAll();
+    m_tickMutex.unlock();
+}
+
+bool SimTime::awaitTickRequest(const Duration& timeout) {
+    m_tickMutex.lock();
+    while (m_ticksRequested == m_ticksCompleted) {
+        if (!m_tickRequestedCondition.wait(&m_tickMutex, timeout.getMilliseconds())) {
+            m_tickMutex.unlock();
+            return false;
+        }
+    }
+    m_tickMutex.unlock();
+    return true;
+}
+
+void SimTime::completeTick() {
+    m_tickMutex.lock();
+    m_ticksCompleted += 1;
+    m_tickCompletedCondition.wakeAll();
+    m_tickMutex.unlock();
 }
 
 } // namespace mms
@@ -1,15 +1,19 @@
 #pragma once
 
+#include <QMutex>
+#include <QWaitCondition>
+
 #include "units/Seconds.h"
 
 namespace mms {
 
+// The sim time of a single simulation; each Model owns one, so that several
+// simulations can run at once (see Model::getSimTime)
 class SimTime {
 
 public:
 
-    static void init();
-    static SimTime* get();
+    SimTime();
 
     Seconds startTimestamp();
     Seconds elapsedRealTime();
@@ -18,18 +22,45 @@ public:
     void incrementElapsedSimTime(const Duration& duration);
     void reset();
 
-private:
+    // In lock-step mode, sim time advances in fixed ticks, and only while the
+    // algorithm is blocked on a command; the wall clock is never consulted,
+    // so identical runs produce identical sim times
+    bool lockStepEnabled();
+    void setLockStepEnabled(bool enabled);
 
-    // A private constructor is used to ensure
-    // only one instance of this class exists
-    SimTime();
+    // Called by the algorithm side while it's blocked on a command: requests
+    // a single tick and waits for the model to perform it, returning false if
+    // the wait was interrupted first. If a previously requested tick hasn't
+    // been performed yet, no new tick is requested, so that the algorithm
+    // never misses a tick, even if it was interrupted while waiting for it.
+    bool awaitTick();
 
-    // A pointer to the actual instance of the class
-    static SimTime* INSTANCE;
+    // Ends any current (and future) waits in awaitTick(), for when ticks will
+    // never be performed, e.g., because the algorithm was stopped or the
+    // mouse crashed; reset() undoes this. Note that pausing doesn't interrupt
+    // the wait, since the tick is simply performed once the model resumes.
+    void interruptTicks();
+
+    // Called by the model: waits (at most timeout) for a tick to be requested,
+    // and returns whether or not one was; the request stays pending until
+    // completeTick() is called, once the tick has been performed
+    bool awaitTickRequest(const Duration& timeout);
+    void completeTick();
+
+private:
 
     Seconds m_startTimestamp;
     Seconds m_elapsedSimTime;
 
+    // Lock-step handshake between the algorithm and the model
+    bool m_lockStepEnabled;
+    QMutex m_tickMutex;
+    QWaitCondition m_tickRequestedCondition;
+    QWaitCondition m_tickCompletedCondition;
+    unsigned long long m_ticksRequested;
+    unsigned long long m_ticksCompleted;
+    bool m_ticksInterrupted;
+
 };
 
 } // namespace mms
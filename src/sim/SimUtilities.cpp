@@ -1,10 +1,12 @@
 #include "SimUtilities.h"
 
 #include <QDateTime>
+#include <QMutex>
 #include <QRegExp>
 #include <QThread>
 #include <QTime>
 
+#include <cmath>
 #include <limits>
 #include <random>
 
@@ -19,8 +21,13 @@ void SimUtilities::quit() {
 }
 
 int SimUtilities::randomInt() {
+    // The generator is shared by all simulations, which may run concurrently
+    static QMutex mutex;
     static std::mt19937 generator(P()->randomSeed());
-    return generator();
+    mutex.lock();
+    int value = generator();
+    mutex.unlock();
+    return value;
 }
 
 int SimUtilities::randomNonNegativeInt(int max) {
@@ -35,6 +42,14 @@ int SimUtilities::randomNonNegativeInt(int max) {
 }
 
 double SimUtilities::getRandom() {
+    return toRandomDouble(randomInt());
+}
+
+double SimUtilities::getRandom(std::mt19937* generator) {
+    return toRandomDouble(static_cast<int>((*generator)()));
+}
+
+double SimUtilities::toRandomDouble(int value) {
     
     // The '- 1' ensures that the random number is never 1.
     // This matches the python implementation where random is [0,1).
@@ -43,7 +58,7 @@ double SimUtilities::getRandom() {
     // the condition if this function returns 1.
     
     static int max = std::mt19937().max();
-    return std::abs(static_cast<double>(randomInt()) - 1) / static_cast<double>(max);
+    return std::abs(static_cast<double>(value) - 1) / static_cast<double>(max);
 }
 
 void SimUtilities::sleep(const Duration& duration) {
@@ -105,21 +120,27 @@ QString SimUtilities::boolToStr(bool value) {
     return value ? "true" : "false";
 }
 
-QVector<TriangleGraphic> SimUtilities::polygonToTriangleGraphics(
+quint8 SimUtilities::toColorByte(double value) {
+    return static_cast<quint8>(std::round(255.0 * std::min(std::max(value, 0.0), 1.0)));
+}
+
+void SimUtilities::polygonToTriangleGraphics(
         const Polygon& polygon,
         Color color,
-        double alpha) {
-    QVector<Triangle> triangles = polygon.getTriangles();
-    QVector<TriangleGraphic> triangleGraphics;
-    RGB colorValues = COLOR_TO_RGB().value(color);
-    for (Triangle triangle : triangles) {
-        triangleGraphics.push_back({
-            {triangle.p1.getX().getMeters(), triangle.p1.getY().getMeters(), colorValues, alpha},
-            {triangle.p2.getX().getMeters(), triangle.p2.getY().getMeters(), colorValues, alpha},
-            {triangle.p3.getX().getMeters(), triangle.p3.getY().getMeters(), colorValues, alpha}
+        double alpha,
+        QVector<TriangleGraphic>* buffer) {
+    RGB rgb = COLOR_TO_RGB().value(color);
+    quint8 r = toColorByte(rgb.r);
+    quint8 g = toColorByte(rgb.g);
+    quint8 b = toColorByte(rgb.b);
+    quint8 a = toColorByte(alpha);
+    for (const Triangle& triangle : polygon.getTriangles()) {
+        buffer->push_back({
+            {static_cast<float>(triangle.p1.getX().getMeters()), static_cast<float>(triangle.p1.getY().getMeters()), r, g, b, a},
+            {static_cast<float>(triangle.p2.getX().getMeters()), static_cast<float>(triangle.p2.getY().getMeters()), r, g, b, a},
+            {static_cast<float>(triangle.p3.getX().getMeters()), static_cast<float>(triangle.p3.getY().getMeters()), r, g, b, a}
         });
     }
-    return triangleGraphics;
 }
 
 } // namespace mms
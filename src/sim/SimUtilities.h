@@ -6,6 +6,7 @@
 #include <QVector>
 
 #include <algorithm>
+#include <random>
 
 #include "Color.h"
 #include "Polygon.h"
@@ -30,8 +31,10 @@ public:
     // Returns a random integer
     static int randomNonNegativeInt(int max = 0);
 
-    // Returns a double in [0.0, 1.0]
+    // Returns a double in [0.0, 1.0], from the generator shared by every
+    // simulation, or from the given one, respectively
     static double getRandom();
+    static double getRandom(std::mt19937* generator);
 
     // Sleeps the current thread for ms milliseconds
     static void sleep(const Duration& duration);
@@ -55,11 +58,16 @@ public:
     static double strToDouble(const QString& str);
     static QString boolToStr(bool value);
 
-    // Converts a polygon to a vector of triangle graphics
-    static QVector<TriangleGraphic> polygonToTriangleGraphics(
+    // Converts a color or alpha value in [0.0, 1.0] to the byte stored in a
+    // VertexGraphic
+    static quint8 toColorByte(double value);
+
+    // Converts a polygon to triangle graphics, which are appended to buffer
+    static void polygonToTriangleGraphics(
         const Polygon& polygon,
         Color color,
-        double alpha);
+        double alpha,
+        QVector<TriangleGraphic>* buffer);
 
     // A simple pair-comparitor function
     template <class T>
@@ -73,6 +81,10 @@ public:
         return *std::min_element(pairs.begin(), pairs.end(), lessThan<T>);
     }
 
+private:
+
+    static double toRandomDouble(int value);
+
 };
 
 } // namespace mms
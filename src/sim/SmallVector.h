@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace mms {
+
+// A vector that stores up to N elements inline (i.e., within the object
+// itself), and only allocates once it grows beyond that. Unlike QVector, it's
+// never implicitly shared, so copies are independent and there's nothing to
+// detach, and moving it steals any heap storage rather than copying. Only
+// trivially copyable elements are supported, so that copying and growing are
+// just a memcpy.
+template <class T, int N>
+class SmallVector {
+
+    static_assert(0 < N, "SmallVector must have some inline storage");
+    static_assert(
+        std::is_trivially_copyable<T>::value,
+        "SmallVector elements must be trivially copyable");
+
+public:
+
+    SmallVector() :
+        m_data(inlineData()),
+        m_size(0),
+        m_capacity(N) {
+    }
+
+    SmallVector(const T* first, const T* last) : SmallVector() {
+        append(first, static_cast<int>(last - first));
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector() {
+        append(other.m_data, other.m_size);
+    }
+
+    SmallVector(SmallVector&& other) noexcept : SmallVector() {
+        steal(&other);
+    }
+
+    ~SmallVector() {
+        if (!isInline()) {
+            std::free(m_data);
+        }
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            m_size = 0;
+            append(other.m_data, other.m_size);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            if (!isInline()) {
+                std::free(m_data);
+                m_data = inlineData();
+                m_capacity = N;
+            }
+            m_size = 0;
+            steal(&other);
+        }
+        return *this;
+    }
+
+    int size() const {
+        return m_size;
+    }
+
+    bool isEmpty() const {
+        return m_size == 0;
+    }
+
+    const T& at(int i) const {
+        return m_data[i];
+    }
+
+    T& operator[](int i) {
+        return m_data[i];
+    }
+
+    const T& operator[](int i) const {
+        return m_data[i];
+    }
+
+    const T& first() const {
+        return m_data[0];
+    }
+
+    const T& last() const {
+        return m_data[m_size - 1];
+    }
+
+    T* data() {
+        return m_data;
+    }
+
+    const T* constData() const {
+        return m_data;
+    }
+
+    T* begin() {
+        return m_data;
+    }
+
+    T* end() {
+        return m_data + m_size;
+    }
+
+    const T* begin() const {
+        return m_data;
+    }
+
+    const T* end() const {
+        return m_data + m_size;
+    }
+
+    void append(const T& value) {
+        if (m_size == m_capacity) {
+            // The value might be one of our own elements, which would be
+            // freed by the reallocation
+            T copy = value;
+            reserve(2 * m_capacity);
+            m_data[m_size] = copy;
+        }
+        else {
+            m_data[m_size] = value;
+        }
+        m_size += 1;
+    }
+
+    void reserve(int capacity) {
+        if (capacity <= m_capacity) {
+            return;
+        }
+        T* data = static_cast<T*>(std::malloc(capacity * sizeof(T)));
+        if (data == nullptr) {
+            throw std::bad_alloc();
+        }
+        std::memcpy(static_cast<void*>(data), m_data, m_size * sizeof(T));
+        if (!isInline()) {
+            std::free(m_data);
+        }
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    // Changes the number of elements; note that, unlike QVector, any new
+    // elements are left uninitialized, since they're meant to be overwritten
+    void resize(int size) {
+        reserve(size);
+        m_size = size;
+    }
+
+    // Removes all of the elements, but keeps any heap storage
+    void clear() {
+        m_size = 0;
+    }
+
+private:
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type m_inline[N];
+    T* m_data;
+    int m_size;
+    int m_capacity;
+
+    T* inlineData() {
+        return reinterpret_cast<T*>(m_inline);
+    }
+
+    bool isInline() const {
+        return m_data == reinterpret_cast<const T*>(m_inline);
+    }
+
+    void append(const T* values, int count) {
+        reserve(m_size + count);
+        if (0 < count) {
+            std::memcpy(static_cast<void*>(m_data + m_size), values, count * sizeof(T));
+        }
+        m_size += count;
+    }
+
+    // Takes the elements of other, which is left empty; assumes that this
+    // vector is empty and inline
+    void steal(SmallVector* other) {
+        if (other->isInline()) {
+            append(other->m_data, other->m_size);
+        }
+        else {
+            m_data = other->m_data;
+            m_capacity = other->m_capacity;
+            m_size = other->m_size;
+            other->m_data = other->inlineData();
+            other->m_capacity = N;
+        }
+        other->m_size = 0;
+    }
+
+};
+
+} // namespace mms
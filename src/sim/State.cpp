@@ -2,19 +2,6 @@
 
 namespace mms {
 
-State* S() {
-    return State::getInstance();
-}
-
-// Definition of the variable for linking
-State* State::INSTANCE = nullptr;
-State* State::getInstance() {
-    if (nullptr == INSTANCE) {
-        INSTANCE = new State();
-    }
-    return INSTANCE;
-}
-
 State::State() {
     m_crashed = false;
 }
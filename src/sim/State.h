@@ -2,16 +2,13 @@
 
 namespace mms {
 
-// Wrapper for the static call to State::getInstance()
-class State;
-State* S();
-
+// The state of a single simulation; each Model owns one, so that several
+// simulations can run at once (see Model::getState)
 class State {
 
 public:
 
-    // Returns a pointer to the singleton state object
-    static State* getInstance();
+    State();
 
     // TODO: MACK - should be a property of the mouse
     bool crashed();
@@ -19,12 +16,6 @@ public:
 
 private:
 
-    // A private constructor is used to ensure only one instance of this class exists
-    State();
-
-    // A pointer to the actual instance of the class
-    static State* INSTANCE;
-
     bool m_crashed;
 };
 
@@ -0,0 +1,185 @@
+#include "TextProtocol.h"
+
+#include <QString>
+
+#include <cstring>
+#include <limits>
+
+#include "CommandTable.h"
+
+namespace mms {
+
+bool TextProtocol::decodeCommand(const char* line, int size, MouseCommand* command) {
+
+    int position = 0;
+    const char* token = nullptr;
+    int tokenSize = 0;
+    if (!nextToken(line, size, &position, &token, &tokenSize)) {
+        return false;
+    }
+    const CommandEntry* entry = CommandTable::get(token, tokenSize);
+    if (entry == nullptr) {
+        return false;
+    }
+    command->opcode = entry->opcode;
+    const CommandSchema& schema = entry->schema;
+
+    int numArguments = 0;
+    while (numArguments < schema.arguments.size() &&
+           nextToken(line, size, &position, &token, &tokenSize)) {
+        if (!parseValue(
+                schema.arguments.at(numArguments),
+                token,
+                tokenSize,
+                &command->arguments[numArguments])) {
+            return false;
+        }
+        numArguments += 1;
+    }
+    if (!schema.acceptsNumArguments(numArguments)) {
+        return false;
+    }
+    command->numArguments = numArguments;
+
+    // Commands without records ignore any remaining tokens, as they always
+    // have (e.g., "setTileText 0 0 a b" sets the text to "a")
+    if (schema.record.isEmpty()) {
+        command->numRecords = 0;
+        return true;
+    }
+
+    // Any remaining tokens are records, which must all be complete
+    int numValues = 0;
+    while (nextToken(line, size, &position, &token, &tokenSize)) {
+        ValueType type = schema.record.at(numValues % schema.record.size());
+        if (!parseValue(type, token, tokenSize, command->recordValue(numValues))) {
+            return false;
+        }
+        numValues += 1;
+    }
+    if (numValues % schema.record.size() != 0) {
+        return false;
+    }
+    command->numRecords = numValues / schema.record.size();
+    return true;
+}
+
+const CommandEntry* TextProtocol::decodeEntry(const char* line, int size) {
+    int position = 0;
+    const char* token = nullptr;
+    int tokenSize = 0;
+    if (!nextToken(line, size, &position, &token, &tokenSize)) {
+        return nullptr;
+    }
+    return CommandTable::get(token, tokenSize);
+}
+
+void TextProtocol::encodeReply(
+        ReplyType type, const MouseValue& value, QByteArray* output) {
+    switch (type) {
+        case ReplyType::NONE:
+            return;
+        case ReplyType::ACK:
+            output->append("ACK");
+            break;
+        case ReplyType::INT:
+            output->append(QByteArray::number(value.integer));
+            break;
+        case ReplyType::DOUBLE:
+            output->append(QByteArray::number(value.real));
+            break;
+        case ReplyType::CHAR:
+            output->append(value.character);
+            break;
+        case ReplyType::BOOL:
+            output->append(value.boolean ? "true" : "false");
+            break;
+    }
+    output->append('\n');
+}
+
+void TextProtocol::encodeError(QByteArray* output) {
+    output->append("!\n");
+}
+
+bool TextProtocol::nextToken(
+        const char* line, int size, int* position, const char** token, int* tokenSize) {
+    int i = *position;
+    while (i < size && line[i] == ' ') {
+        i += 1;
+    }
+    if (i == size) {
+        *position = i;
+        return false;
+    }
+    int start = i;
+    while (i < size && line[i] != ' ') {
+        i += 1;
+    }
+    *token = line + start;
+    *tokenSize = i - start;
+    *position = i;
+    return true;
+}
+
+bool TextProtocol::parseValue(
+        ValueType type, const char* token, int size, MouseValue* value) {
+    bool ok = true;
+    switch (type) {
+        case ValueType::INT:
+            ok = parseInt(token, size, &value->integer);
+            break;
+        case ValueType::DOUBLE:
+            value->real = QByteArray::fromRawData(token, size).toDouble(&ok);
+            break;
+        case ValueType::CHAR:
+            ok = (size == 1);
+            value->character = token[0];
+            break;
+        case ValueType::BOOL:
+            value->boolean = equals(token, size, "true");
+            ok = value->boolean || equals(token, size, "false");
+            break;
+        case ValueType::STRING:
+            value->string = QString::fromUtf8(token, size);
+            break;
+    }
+    return ok;
+}
+
+bool TextProtocol::parseInt(const char* token, int size, int* value) {
+    int position = 0;
+    bool negative = false;
+    if (position < size && (token[position] == '-' || token[position] == '+')) {
+        negative = (token[position] == '-');
+        position += 1;
+    }
+    if (position == size) {
+        return false;
+    }
+    qint64 magnitude = 0;
+    for (; position < size; position += 1) {
+        char c = token[position];
+        if (c < '0' || '9' < c) {
+            return false;
+        }
+        magnitude = 10 * magnitude + (c - '0');
+        if (static_cast<qint64>(std::numeric_limits<int>::max()) + 1 < magnitude) {
+            return false;
+        }
+    }
+    qint64 result = negative ? -magnitude : magnitude;
+    if (result < std::numeric_limits<int>::min() ||
+        std::numeric_limits<int>::max() < result) {
+        return false;
+    }
+    *value = static_cast<int>(result);
+    return true;
+}
+
+bool TextProtocol::equals(const char* token, int size, const char* string) {
+    return static_cast<int>(std::strlen(string)) == size &&
+        std::memcmp(token, string, size) == 0;
+}
+
+} // namespace mms
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QByteArray>
+
+#include "CommandTable.h"
+#include "MouseCommand.h"
+
+namespace mms {
+
+// The original, line-based protocol: a command is its name followed by its
+// space-separated arguments, and a reply is a single line. It's what every
+// algorithm starts out speaking, and what algorithms that never ask for the
+// binary protocol (e.g., those written against older templates) keep using.
+// A bulk command's records simply follow its arguments, e.g.,
+// "setTileColors 0 0 G 0 1 R".
+class TextProtocol {
+
+public:
+
+    // The TextProtocol class is not constructible
+    TextProtocol() = delete;
+
+    // Decodes a line (without its newline) into command, returning false if
+    // the command doesn't exist or its arguments don't match its schema. Any
+    // tokens after the arguments of a command without records are ignored.
+    // The line is tokenized in place, and only STRING (decoded as UTF-8) and
+    // DOUBLE arguments are ever copied out of it.
+    static bool decodeCommand(const char* line, int size, MouseCommand* command);
+
+    // Returns the entry of the command that the line names, without decoding
+    // its arguments, or nullptr if there's no such command
+    static const CommandEntry* decodeEntry(const char* line, int size);
+
+    // Appends the reply line for a successful command to output; nothing is
+    // appended for commands of type NONE
+    static void encodeReply(ReplyType type, const MouseValue& value, QByteArray* output);
+
+    // Appends the reply line for a command that couldn't be decoded
+    static void encodeError(QByteArray* output);
+
+private:
+
+    // Finds the next space-separated token at or after position, advancing
+    // position past it, and returns false if there are no more tokens
+    static bool nextToken(
+        const char* line, int size, int* position, const char** token, int* tokenSize);
+
+    static bool parseValue(ValueType type, const char* token, int size, MouseValue* value);
+    static bool parseInt(const char* token, int size, int* value);
+    static bool equals(const char* token, int size, const char* string);
+
+};
+
+} // namespace mms
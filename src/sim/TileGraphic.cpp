@@ -2,6 +2,8 @@
 
 #include <QPair>
 
+#include <algorithm>
+
 #include "Color.h"
 #include "FontImage.h"
 #include "Param.h"
@@ -69,6 +71,22 @@ void TileGraphic::setText(const QString& text) {
     updateText();
 }
 
+Color TileGraphic::getColor() const {
+    return m_color;
+}
+
+const QMap<Direction, bool>& TileGraphic::getDeclaredWalls() const {
+    return m_declaredWalls;
+}
+
+bool TileGraphic::isFoggy() const {
+    return m_foggy;
+}
+
+const QString& TileGraphic::getText() const {
+    return m_text;
+}
+
 void TileGraphic::setWallTruthVisible(bool visible) {
     m_wallTruthVisible = visible;
     updateWalls();
@@ -140,6 +158,13 @@ void TileGraphic::drawTextures() {
     updateText();
 }
 
+void TileGraphic::drawInstance() const {
+    // The tile's instance already exists, so we just have to populate it
+    updateColor();
+    updateWalls();
+    updateFog();
+}
+
 void TileGraphic::updateColor() const {
     m_bufferInterface->updateTileGraphicBaseColor(
         m_tile->getX(),
@@ -167,39 +192,31 @@ void TileGraphic::updateText() const {
     // First, retrieve the maximum number of rows and cols of text allowed
     QPair<int, int> maxRowsAndCols =
         m_bufferInterface->getTileGraphicTextMaxSize();
-
-    // Then, generate the rows of text that will be displayed
-    QVector<QString> rowsOfText;
-
-    // Split the text into rows
-    QString remaining = m_text;
-    while (!remaining.isEmpty() && rowsOfText.size() < maxRowsAndCols.first) {
-        QString row = remaining.left(maxRowsAndCols.second);
-        rowsOfText.append(row);
-        remaining = remaining.mid(maxRowsAndCols.second);
+    int maxRows = maxRowsAndCols.first;
+    int maxCols = maxRowsAndCols.second;
+
+    // The text is split into rows of (at most) maxCols characters, of which
+    // (at most) maxRows are displayed. Since this is called for every tile
+    // whenever its text changes, we just index into the text, rather than
+    // actually splitting it.
+    int numRows = 0;
+    if (0 < maxCols) {
+        numRows = std::min((m_text.size() + maxCols - 1) / maxCols, maxRows);
     }
 
     // For all possible character positions, insert some character
     // (blank if necessary) into the tile text cpu buffer
-    for (int row = 0; row < maxRowsAndCols.first; row += 1) {
-        for (int col = 0; col < maxRowsAndCols.second; col += 1) {
-            int numRows = std::min(
-                static_cast<int>(rowsOfText.size()),
-                maxRowsAndCols.first
-            );
-            int numCols = std::min(
-                static_cast<int>(row < rowsOfText.size() ? rowsOfText.at(row).size() : 0),
-                maxRowsAndCols.second
-            );
+    for (int row = 0; row < maxRows; row += 1) {
+        int numCols = 0;
+        if (row < numRows) {
+            numCols = std::min(m_text.size() - row * maxCols, maxCols);
+        }
+        for (int col = 0; col < maxCols; col += 1) {
             QChar c = ' ';
-            if (
-                m_tileTextVisible &&
-                row < rowsOfText.size() &&
-                col < rowsOfText.at(row).size()
-            ) {
-                c = rowsOfText.at(row).at(col).toLatin1();
+            if (m_tileTextVisible && col < numCols) {
+                c = m_text.at(row * maxCols + col).toLatin1();
             }
-            ASSERT_TR(FontImage::get()->positions().contains(c));
+            ASSERT_TR(FontImage::get()->contains(c));
             m_bufferInterface->updateTileGraphicText(
                 m_tile->getX(),
                 m_tile->getY(),
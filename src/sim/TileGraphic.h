@@ -29,6 +29,11 @@ public:
     void setFogginess(bool foggy);
     void setText(const QString& text);
 
+    Color getColor() const;
+    const QMap<Direction, bool>& getDeclaredWalls() const;
+    bool isFoggy() const;
+    const QString& getText() const;
+
     void setWallTruthVisible(bool visible);
     void setTileColorsVisible(bool visible);
     void setTileFogVisible(bool visible);
@@ -37,6 +42,7 @@ public:
     // TODO: MACK - rename these to "reload" or something
     void drawPolygons() const;
     void drawTextures();
+    void drawInstance() const;
 
     // TODO: MACK - do I need these anymore?
     // TODO: MACK - rename these to "refresh" or something
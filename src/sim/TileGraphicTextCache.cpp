@@ -1,9 +1,15 @@
 #include "TileGraphicTextCache.h"
 
-#include "FontImage.h"
+#include "Assert.h"
 
 namespace mms {
 
+TileGraphicTextCache::TileGraphicTextCache() :
+        m_tileGraphicTextMaxSize(0, 0),
+        m_rowOffsetHalves(0),
+        m_colOffsetHalves(0) {
+}
+
 void TileGraphicTextCache::init(
         const Distance& wallLength,
         const Distance& wallWidth,
@@ -11,45 +17,14 @@ void TileGraphicTextCache::init(
         double borderFraction,
         TileTextAlignment tileTextAlignment) {
 
+    ASSERT_LE(0, tileGraphicTextMaxSize.first);
+    ASSERT_LE(0, tileGraphicTextMaxSize.second);
+    ASSERT_LE(tileGraphicTextMaxSize.first, MAX_ROWS_OR_COLS);
+    ASSERT_LE(tileGraphicTextMaxSize.second, MAX_ROWS_OR_COLS);
+
     m_wallLength = wallLength;
     m_wallWidth = wallWidth;
     m_tileGraphicTextMaxSize = tileGraphicTextMaxSize;
-    m_tileGraphicTextPositions = buildPositionCache(borderFraction, tileTextAlignment);
-}
-
-QPair<int, int> TileGraphicTextCache::getTileGraphicTextMaxSize() const {
-    return m_tileGraphicTextMaxSize;
-}
-
-QPair<double, double> TileGraphicTextCache::getFontImageCharacterPosition(QChar c) const {
-    ASSERT_TR(FontImage::get()->positions().contains(c));
-    return FontImage::get()->positions().value(c);
-}
-
-QPair<Cartesian, Cartesian> TileGraphicTextCache::getTileGraphicTextPosition(
-        int x, int y, int numRows, int numCols, int row, int col) const {
-
-    // Get the character position in the maze for the starting tile
-    QPair<Cartesian, Cartesian> textPosition = m_tileGraphicTextPositions.value(
-        {
-            {numRows, numCols},
-            {row, col}
-        }
-    );
-
-    // Now get the character position in the maze for *this* tile
-    Meters tileLength = m_wallLength + m_wallWidth;
-    Cartesian offset = Cartesian(tileLength * x, tileLength * y);
-    Cartesian LL = textPosition.first + offset;
-    Cartesian UR = textPosition.second + offset;
-
-    return {LL, UR};
-}
-
-QMap<
-    QPair<QPair<int, int>, QPair<int, int>>,
-    QPair<Cartesian, Cartesian>> TileGraphicTextCache::buildPositionCache(
-        double borderFraction, TileTextAlignment tileTextAlignment) {
 
     // The tile graphic text could look like either of the following, depending
     // on the layout, border, and max size
@@ -72,10 +47,6 @@ QMap<
     //     *[A]--------------------------*-*    *[A]--------------------------*-*
     //     *-*---------------------------*-*    *-*---------------------------*-*
 
-    QMap<
-        QPair<QPair<int, int>, QPair<int, int>>,
-        QPair<Cartesian, Cartesian>> positionCache;
-
     int maxRows = m_tileGraphicTextMaxSize.first;
     int maxCols = m_tileGraphicTextMaxSize.second;
 
@@ -95,71 +66,75 @@ QMap<
     else {
         characterWidth = characterHeight / 2.0;
     }
+    m_characterSize = Cartesian(characterWidth, characterHeight);
 
     // Now we get the scaled diagonal (note that we'll only shrink in at most one direction)
     Cartesian scalingOffset = Cartesian(
         (CD.getX() - characterWidth * maxCols) / 2.0,
         (CD.getY() - characterHeight * maxRows) / 2.0
     );
-    Cartesian E = C + scalingOffset;
-
-    // For all numbers of rows displayed
-    for (int numRows = 0; numRows <= maxRows; numRows += 1) {
-
-        // For all numbers of columns displayed
-        for (int numCols = 0; numCols <= maxCols; numCols += 1) {
-
-            // For each visible row and col
-            for (int row = 0; row <= maxRows; row += 1) {
-                for (int col = 0; col <= maxCols; col += 1) {
-
-                    Cartesian LL = Cartesian(Meters(0), Meters(0));
-                    Cartesian UR = Cartesian(Meters(0), Meters(0));
-
-                    if (row < numRows && col < numCols) {
-
-                        double rowOffset = 0.0;
-                        if (CENTER_STAR_ALIGNMENTS().contains(tileTextAlignment)) {
-                            rowOffset = static_cast<double>(maxRows - numRows) / 2.0;
-                        }
-                        else if (UPPER_STAR_ALIGNMENTS().contains(tileTextAlignment)) {
-                            rowOffset = static_cast<double>(maxRows - numRows);
-                        }
-
-                        double colOffset = 0.0;
-                        if (STAR_CENTER_ALIGNMENTS().contains(tileTextAlignment)) {
-                            colOffset = static_cast<double>(maxCols - numCols) / 2.0;
-                        }
-                        else if (STAR_RIGHT_ALIGNMENTS().contains(tileTextAlignment)) {
-                            colOffset = static_cast<double>(maxCols - numCols);
-                        }
-
-                        LL = Cartesian(
-                            Meters(E.getX() + characterWidth * (col + colOffset)),
-                            Meters(E.getY() + characterHeight * ((numRows - row - 1) + rowOffset))
-                        );
-                        UR = Cartesian(
-                            Meters(E.getX() + characterWidth * (col + colOffset + 1)),
-                            Meters(E.getY() + characterHeight * ((numRows - row - 1) + rowOffset + 1))
-                        );
-                    }
-
-                    positionCache.insert(
-                        {
-                            // The number of rows/cols to be drawn
-                            {numRows, numCols},
-                            // The row and col of the current character
-                            {row, col}
-                        },
-                        // The lower left and upper right texture coordinate
-                        {LL, UR}
-                    );
-                }
-            }
-        }
+    m_textOrigin = C + scalingOffset;
+
+    // Finally, the alignment determines where the unused rows and cols go
+    m_rowOffsetHalves = 0;
+    if (CENTER_STAR_ALIGNMENTS().contains(tileTextAlignment)) {
+        m_rowOffsetHalves = 1;
+    }
+    else if (UPPER_STAR_ALIGNMENTS().contains(tileTextAlignment)) {
+        m_rowOffsetHalves = 2;
     }
+    m_colOffsetHalves = 0;
+    if (STAR_CENTER_ALIGNMENTS().contains(tileTextAlignment)) {
+        m_colOffsetHalves = 1;
+    }
+    else if (STAR_RIGHT_ALIGNMENTS().contains(tileTextAlignment)) {
+        m_colOffsetHalves = 2;
+    }
+}
+
+QPair<int, int> TileGraphicTextCache::getTileGraphicTextMaxSize() const {
+    return m_tileGraphicTextMaxSize;
+}
+
+Cartesian TileGraphicTextCache::getTextOrigin() const {
+    return m_textOrigin;
+}
 
-    return positionCache;
+Cartesian TileGraphicTextCache::getCharacterSize() const {
+    return m_characterSize;
+}
+
+QPair<int, int> TileGraphicTextCache::getTileGraphicTextCell(
+        int numRows, int numCols, int row, int col) const {
+    // Rows are counted from the top, but positions from the bottom
+    int maxRows = m_tileGraphicTextMaxSize.first;
+    int maxCols = m_tileGraphicTextMaxSize.second;
+    return {
+        2 * col + m_colOffsetHalves * (maxCols - numCols),
+        2 * (numRows - row - 1) + m_rowOffsetHalves * (maxRows - numRows)
+    };
+}
+
+QPair<Cartesian, Cartesian> TileGraphicTextCache::getTileGraphicTextPosition(
+        int x, int y, int numRows, int numCols, int row, int col) const {
+
+    // Locations that aren't displayed are collapsed onto the origin
+    if (numRows <= row || numCols <= col) {
+        Cartesian origin = Cartesian(Meters(0), Meters(0));
+        return {origin, origin};
+    }
+
+    // Get the character position in the maze for the starting tile ...
+    QPair<int, int> cell = getTileGraphicTextCell(numRows, numCols, row, col);
+    Cartesian LL = m_textOrigin + Cartesian(
+        m_characterSize.getX() * (cell.first / 2.0),
+        m_characterSize.getY() * (cell.second / 2.0));
+    Cartesian UR = LL + m_characterSize;
+
+    // ... and then for *this* tile
+    Meters tileLength = m_wallLength + m_wallWidth;
+    Cartesian offset = Cartesian(tileLength * x, tileLength * y);
+    return {LL + offset, UR + offset};
 }
 
 } // namespace mms
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <QChar>
-#include <QMap>
 #include <QPair>
 
 #include "TileTextAlignment.h"
@@ -12,7 +10,13 @@ namespace mms {
 class TileGraphicTextCache {
 
 public:
-    
+
+    // The positions of the characters are stored in half characters, in
+    // bytes, which limits the number of rows and columns of text
+    static const int MAX_ROWS_OR_COLS = 127;
+
+    TileGraphicTextCache();
+
     // Initialize the cache
     void init(
         const Distance& wallLength,
@@ -24,8 +28,15 @@ public:
     // Returns the max number of rows and columns of tile graphic text
     QPair<int, int> getTileGraphicTextMaxSize() const;
 
-    // Return a characters starting and ending position in the font image
-    QPair<double, double> getFontImageCharacterPosition(QChar c) const;
+    // The lower left corner of the text area of the starting tile, namely
+    // tile (0, 0), and the size of each character
+    Cartesian getTextOrigin() const;
+    Cartesian getCharacterSize() const;
+
+    // Retrieve the position of a particular location, as the column and row
+    // of its lower left corner within the text area, in half characters
+    QPair<int, int> getTileGraphicTextCell(
+        int numRows, int numCols, int row, int col) const;
 
     // Retrieve the LL and UR coordinates for a particular location
     QPair<Cartesian, Cartesian> getTileGraphicTextPosition(
@@ -40,18 +51,15 @@ private:
     // The max rows and cols of text per tile
     QPair<int, int> m_tileGraphicTextMaxSize;
 
-    // A map of the number of rows/cols to be displayed and the current row/col
-    // to the LL/UR text coordinates for the starting tile, namely tile (0, 0)
-    QMap<
-        QPair<QPair<int, int>, QPair<int, int>>,
-        QPair<Cartesian, Cartesian>> m_tileGraphicTextPositions;
-
-    // Just a helper method for building the text position cache
-    QMap<
-        QPair<QPair<int, int>, QPair<int, int>>,
-        QPair<Cartesian, Cartesian>> buildPositionCache(
-            double borderFraction,
-            TileTextAlignment tiletextAlignment);
+    // The text area of the starting tile, and the size of each character
+    Cartesian m_textOrigin;
+    Cartesian m_characterSize;
+
+    // How much of the unused rows and cols are placed below and to the left
+    // of the text, respectively, in halves (i.e., 0, 1, or 2), as determined
+    // by the alignment. These are all we need to compute any position.
+    int m_rowOffsetHalves;
+    int m_colOffsetHalves;
 };
 
 } // namespace mms
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace mms {
+
+// The state of a single tile, from which the GPU builds the tile's appearance
+// when drawing each tile as an instance of the shared TileMeshVertex mesh. As
+// with VertexGraphic, color and alpha values are bytes in [0, 255], which the
+// GPU normalizes back to [0.0, 1.0].
+struct TileInstance {
+    float x;              // x position of the tile
+    float y;              // y position of the tile
+    quint8 r;             // red value of the base
+    quint8 g;             // green value of the base
+    quint8 b;             // blue value of the base
+    quint8 fog;           // alpha value of the fog
+    quint8 walls[4][4];   // rgba values of each wall, in DIRECTIONS() order
+    quint8 edges[4];      // 255 if the tile is on the west, east, south, or
+                          // north edge of the maze, respectively, else 0
+};
+
+static_assert(sizeof(TileInstance) == 32, "TileInstance must be packed");
+
+} // namespace mms
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace mms {
+
+// A vertex of the mesh that's shared by every tile when tiles are drawn as
+// instances. Tiles on the edges of the maze are slightly larger than the
+// others (their outer walls are a full wall width), so each vertex also says
+// how far it moves on such tiles, and which part of the tile it belongs to,
+// so that the GPU can pick its color from the TileInstance.
+struct TileMeshVertex {
+    float x;                 // x position, relative to the tile's position
+    float y;                 // y position, relative to the tile's position
+    float edgeOffsets[4];    // displacement in x on west and east edge tiles,
+                             // and in y on south and north edge tiles
+    quint8 wallSelector[4];  // 255 for the wall this vertex belongs to, in
+                             // DIRECTIONS() order, else 0
+    quint8 partSelector[4];  // 255 if this vertex belongs to the base, a
+                             // corner, or the fog, respectively, else 0
+};
+
+static_assert(sizeof(TileMeshVertex) == 32, "TileMeshVertex must be packed");
+
+} // namespace mms
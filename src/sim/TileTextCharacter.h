@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace mms {
+
+// A single character slot of a tile's text, from which the GPU places the
+// character's quad within the tile, and picks its glyph from the font image.
+// Positions are in half characters (since centered text may be offset by
+// half a character) from the lower left corner of the tile's text area.
+struct TileTextCharacter {
+    quint8 glyph;   // index of the character in the font image
+    quint8 column;  // horizontal position of the character
+    quint8 row;     // vertical position of the character
+    quint8 visible; // 255 if the character is drawn, else 0
+};
+
+static_assert(sizeof(TileTextCharacter) == 4, "TileTextCharacter must be packed");
+
+} // namespace mms
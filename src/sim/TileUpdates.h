@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+#include "Color.h"
+#include "Direction.h"
+
+namespace mms {
+
+// A batch of changes to the tiles of a MazeGraphic, which MazeGraphic::update
+// applies all at once, so that the view never shows part of a batch. The
+// changes of each kind are applied in order, so a later change to the same
+// tile wins.
+struct TileUpdates {
+
+    template <typename T>
+    struct Value {
+        int x;
+        int y;
+        T value;
+    };
+
+    struct Wall {
+        int x;
+        int y;
+        Direction direction;
+        bool isWall;
+    };
+
+    QVector<Value<Color>> colors;
+    QVector<Value<QString>> texts;
+    QVector<Value<bool>> fogginesses;
+    QVector<Wall> walls;
+
+    // Keeps the capacity, so that a batch can be reused without allocating
+    void clear() {
+        colors.resize(0);
+        texts.resize(0);
+        fogginesses.resize(0);
+        walls.resize(0);
+    }
+};
+
+} // namespace mms
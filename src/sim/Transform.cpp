@@ -0,0 +1,59 @@
+#include "Transform.h"
+
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MMS_TRANSFORM_SSE2
+#endif
+
+namespace mms {
+
+// The batch kernel treats an array of Cartesians as an array of interleaved
+// x and y values (in meters)
+static_assert(
+    sizeof(Cartesian) == 2 * sizeof(double) &&
+    std::is_standard_layout<Cartesian>::value &&
+    std::is_trivially_copyable<Cartesian>::value,
+    "Cartesian must be exactly two doubles");
+
+void Transform::apply(const Cartesian* input, int count, Cartesian* output) const {
+
+    const double* in = reinterpret_cast<const double*>(input);
+    double* out = reinterpret_cast<double*>(output);
+    double tx = m_translation.x().value();
+    double ty = m_translation.y().value();
+
+#ifdef MMS_TRANSFORM_SSE2
+
+    // With each vertex in a register as [x, y], the transformed vertex is
+    // [xx, yy] * [x, y] + [xy, yx] * [y, x] + [tx, ty], i.e., two multiplies,
+    // two adds, and a shuffle per vertex. Note that _mm_set_pd takes its
+    // arguments from the high element to the low element.
+    __m128d diagonal = _mm_set_pd(m_yy, m_xx);
+    __m128d antidiagonal = _mm_set_pd(m_yx, m_xy);
+    __m128d translation = _mm_set_pd(ty, tx);
+    for (int i = 0; i < count; i += 1) {
+        __m128d vertex = _mm_loadu_pd(in + 2 * i);
+        __m128d swapped = _mm_shuffle_pd(vertex, vertex, 1);
+        __m128d result = _mm_add_pd(
+            _mm_add_pd(
+                _mm_mul_pd(diagonal, vertex),
+                _mm_mul_pd(antidiagonal, swapped)),
+            translation);
+        _mm_storeu_pd(out + 2 * i, result);
+    }
+
+#else
+
+    for (int i = 0; i < count; i += 1) {
+        double x = in[2 * i];
+        double y = in[2 * i + 1];
+        out[2 * i] = m_xx * x + m_xy * y + tx;
+        out[2 * i + 1] = m_yx * x + m_yy * y + ty;
+    }
+
+#endif
+}
+
+} // namespace mms
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "units/Cartesian.h"
+#include "units/Quantity.h"
+
+namespace mms {
+
+// An affine transform of the plane, which maps the vector v to M v + t, where
+// M is a 2x2 matrix and t is a translation. Rotations are given by their
+// cosine and sine, so that the trig functions are computed just once per
+// transform, rather than once per vertex, and a sequence of transforms can be
+// composed into a single one before being applied.
+class Transform {
+
+public:
+
+    // The identity transform
+    constexpr Transform() :
+        m_xx(1.0), m_xy(0.0),
+        m_yx(0.0), m_yy(1.0),
+        m_translation() {
+    }
+
+    static constexpr Transform translation(units::Vector delta) {
+        return Transform(1.0, 0.0, 0.0, 1.0, delta);
+    }
+
+    // Counterclockwise rotation about the origin and about point, respectively
+    static constexpr Transform rotation(double cosAngle, double sinAngle) {
+        return Transform(cosAngle, -sinAngle, sinAngle, cosAngle, units::Vector());
+    }
+    static constexpr Transform rotationAround(
+            double cosAngle, double sinAngle, units::Vector point) {
+        return Transform(
+            cosAngle, -sinAngle, sinAngle, cosAngle,
+            point - rotateVector(cosAngle, -sinAngle, sinAngle, cosAngle, point));
+    }
+
+    // Returns the transform that applies this transform, and then other
+    constexpr Transform then(const Transform& other) const {
+        return Transform(
+            other.m_xx * m_xx + other.m_xy * m_yx,
+            other.m_xx * m_xy + other.m_xy * m_yy,
+            other.m_yx * m_xx + other.m_yy * m_yx,
+            other.m_yx * m_xy + other.m_yy * m_yy,
+            other.apply(m_translation));
+    }
+
+    // The entries of the matrix M, and the translation t
+    constexpr double xx() const {
+        return m_xx;
+    }
+    constexpr double xy() const {
+        return m_xy;
+    }
+    constexpr double yx() const {
+        return m_yx;
+    }
+    constexpr double yy() const {
+        return m_yy;
+    }
+    constexpr units::Vector translation() const {
+        return m_translation;
+    }
+
+    constexpr units::Vector apply(units::Vector vector) const {
+        return rotateVector(m_xx, m_xy, m_yx, m_yy, vector) + m_translation;
+    }
+
+    // Transforms count vertices from input to output, which may be the same
+    // array, in a single (vectorized, if possible) pass. This is the kernel
+    // for transforming polygons, whose vertices and triangles are both just
+    // contiguous arrays of Cartesians.
+    void apply(const Cartesian* input, int count, Cartesian* output) const;
+
+private:
+
+    double m_xx;
+    double m_xy;
+    double m_yx;
+    double m_yy;
+    units::Vector m_translation;
+
+    constexpr Transform(
+            double xx, double xy, double yx, double yy, units::Vector translation) :
+        m_xx(xx), m_xy(xy),
+        m_yx(yx), m_yy(yy),
+        m_translation(translation) {
+    }
+
+    static constexpr units::Vector rotateVector(
+            double xx, double xy, double yx, double yy, units::Vector vector) {
+        return units::Vector(
+            vector.x() * xx + vector.y() * xy,
+            vector.x() * yx + vector.y() * yy);
+    }
+
+};
+
+} // namespace mms
@@ -1,14 +1,22 @@
 #pragma once
 
-#include "RGB.h"
+#include <QtGlobal>
 
 namespace mms {
 
+// Vertices are uploaded to the GPU every time they change, so they're kept
+// compact: single precision positions, which are plenty for a maze measured
+// in meters, and color and alpha values as bytes in [0, 255], which the GPU
+// normalizes back to [0.0, 1.0]
 struct VertexGraphic {
-    double x; // x position
-    double y; // y position
-    RGB rgb;  // rgb values
-    double a; // alpha value
+    float x;  // x position
+    float y;  // y position
+    quint8 r; // red value
+    quint8 g; // green value
+    quint8 b; // blue value
+    quint8 a; // alpha value
 };
 
+static_assert(sizeof(VertexGraphic) == 12, "VertexGraphic must be packed");
+
 } // namespace mms
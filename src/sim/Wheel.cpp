@@ -1,7 +1,6 @@
 #include "Wheel.h"
 
 #include <QVector>
-#include <QtMath>
 
 #include "GeometryUtilities.h"
 
@@ -12,13 +11,9 @@ Wheel::Wheel() :
     m_halfWidth(Meters(0)),
     m_initialPosition(Cartesian(Meters(0), Meters(0))),
     m_initialDirection(Radians(0)),
-    m_speedIndicatorPolygonNeedsToBeUpdated(false),
-    m_angularVelocity(RadiansPerSecond(0.0)),
     m_maxAngularVelocityMagnitude(RadiansPerSecond(0)),
     m_encoderType(EncoderType::ABSOLUTE),
-    m_encoderTicksPerRevolution(0),
-    m_absoluteRotation(Radians(0)),
-    m_relativeRotation(Radians(0)) {
+    m_encoderTicksPerRevolution(0) {
 }
 
 Wheel::Wheel(
@@ -33,13 +28,9 @@ Wheel::Wheel(
         m_halfWidth(Meters(width) / 2.0),
         m_initialPosition(position),
         m_initialDirection(direction),
-        m_speedIndicatorPolygonNeedsToBeUpdated(true),
-        m_angularVelocity(RadiansPerSecond(0.0)),
         m_maxAngularVelocityMagnitude(maxAngularVelocityMagnitude),
         m_encoderType(encoderType),
-        m_encoderTicksPerRevolution(encoderTicksPerRevolution),
-        m_absoluteRotation(Radians(0)),
-        m_relativeRotation(Radians(0)) {
+        m_encoderTicksPerRevolution(encoderTicksPerRevolution) {
 
     // Create the initial wheel polygon
     QVector<Cartesian> polygon;
@@ -69,27 +60,10 @@ const Polygon& Wheel::getInitialPolygon() const {
     return m_initialPolygon;
 }
 
-const Polygon& Wheel::getSpeedIndicatorPolygon() const {
-    if (m_speedIndicatorPolygonNeedsToBeUpdated) {
-        m_speedIndicatorPolygon = getSpeedIndicatorPolygon(m_angularVelocity);
-        m_speedIndicatorPolygonNeedsToBeUpdated = false;
-    }
-    return m_speedIndicatorPolygon;
-}
-
-RadiansPerSecond Wheel::getAngularVelocity() const {
-    return m_angularVelocity;
-}
-
 RadiansPerSecond Wheel::getMaxAngularVelocityMagnitude() const {
     return m_maxAngularVelocityMagnitude;
 }
 
-void Wheel::setAngularVelocity(const AngularVelocity& angularVelocity) {
-    m_angularVelocity = angularVelocity;
-    m_speedIndicatorPolygonNeedsToBeUpdated = true;
-}
-
 EncoderType Wheel::getEncoderType() const {
     return m_encoderType;
 }
@@ -98,27 +72,6 @@ double Wheel::getEncoderTicksPerRevolution() const {
     return m_encoderTicksPerRevolution;
 }
 
-int Wheel::readAbsoluteEncoder() const {
-    return static_cast<int>(std::floor(
-        m_encoderTicksPerRevolution * m_absoluteRotation.getRadiansZeroTo2pi() / (2 * M_PI)));
-}
-
-int Wheel::readRelativeEncoder() const {
-    // We use std::trunc instead of std::floor so we round towards zero in the
-    // case of a negative relative rotation
-    return static_cast<int>(std::trunc(
-        m_encoderTicksPerRevolution * m_relativeRotation.getRadiansNotBounded() / (2 * M_PI)));
-}
-
-void Wheel::resetRelativeEncoder() {
-    m_relativeRotation = Radians(0);
-}
-
-void Wheel::updateRotation(const Angle& angle) {
-    m_absoluteRotation += angle;
-    m_relativeRotation += angle;
-}
-
 Polygon Wheel::getSpeedIndicatorPolygon(const AngularVelocity& angularVelocity) const {
     double fractionOfMaxSpeed = 0.0;
     if (0.0 < getMaxAngularVelocityMagnitude().getRadiansPerSecond()) {
@@ -26,20 +26,20 @@ public:
     Cartesian getInitialPosition() const;
     Radians getInitialDirection() const;
     const Polygon& getInitialPolygon() const;
-    const Polygon& getSpeedIndicatorPolygon() const;
+
+    // Returns the speed indicator polygon for the given angular velocity,
+    // positioned like the initial polygon
+    Polygon getSpeedIndicatorPolygon(const AngularVelocity& angularVelocity) const;
 
     // Motor
-    RadiansPerSecond getAngularVelocity() const;
     RadiansPerSecond getMaxAngularVelocityMagnitude() const;
-    void setAngularVelocity(const AngularVelocity& angularVelocity);
 
     // Encoder
     EncoderType getEncoderType() const;
     double getEncoderTicksPerRevolution() const;
-    int readAbsoluteEncoder() const;
-    int readRelativeEncoder() const;
-    void resetRelativeEncoder();
-    void updateRotation(const Angle& angle);
+
+    // Note that the wheel's speed and rotation, which change every tick, are
+    // kept by the Mouse in flat tables, rather than here
 
 private:
 
@@ -49,21 +49,13 @@ private:
     Cartesian m_initialPosition;
     Radians m_initialDirection;
     Polygon m_initialPolygon;
-    mutable Polygon m_speedIndicatorPolygon;
-    mutable bool m_speedIndicatorPolygonNeedsToBeUpdated;
 
     // Motor
-    RadiansPerSecond m_angularVelocity;
     RadiansPerSecond m_maxAngularVelocityMagnitude;
 
     // Encoder
     EncoderType m_encoderType;
     double m_encoderTicksPerRevolution;
-    Radians m_absoluteRotation;
-    Radians m_relativeRotation;
-
-    // Helper function for updating the speed indicator polygon
-    Polygon getSpeedIndicatorPolygon(const AngularVelocity& angularVelocity) const;
 };
 
 } // namespace mms
@@ -7,6 +7,7 @@
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QProcessEnvironment>
 #include <QSplitter>
 #include <QTabWidget>
 #include <QVBoxLayout>
@@ -19,9 +20,8 @@
 #include "SettingsMazeAlgos.h"
 #include "SettingsMouseAlgos.h"
 #include "SettingsRecent.h"
-#include "SimTime.h"
+#include "SharedMemoryTransport.h"
 #include "SimUtilities.h"
-#include "State.h"
 
 namespace mms {
 
@@ -550,20 +550,20 @@ QPair<QStringList, QVector<QVariant>> Window::getRunStats() const {
         values.append(m_mouse->getCurrentDiscretizedTranslation().first);
         values.append(m_mouse->getCurrentDiscretizedTranslation().second);
         values.append(DIRECTION_TO_STRING().value(m_mouse->getCurrentDiscretizedRotation()));
-        values.append(SimUtilities::formatDuration(SimTime::get()->elapsedRealTime()));
-        values.append(SimUtilities::formatDuration(SimTime::get()->elapsedSimTime()));
+        values.append(SimUtilities::formatDuration(m_model.getSimTime()->elapsedRealTime()));
+        values.append(SimUtilities::formatDuration(m_model.getSimTime()->elapsedSimTime()));
         values.append(
             stats.timeOfOriginDeparture.getSeconds() < 0
             ? "NONE"
             : SimUtilities::formatDuration(
-                SimTime::get()->elapsedSimTime() - stats.timeOfOriginDeparture)
+                m_model.getSimTime()->elapsedSimTime() - stats.timeOfOriginDeparture)
         );
         values.append(
             stats.bestTimeToCenter.getSeconds() < 0
             ? "NONE"
             : SimUtilities::formatDuration(stats.bestTimeToCenter)
         );
-        values.append((S()->crashed() ? "TRUE" : "FALSE"));
+        values.append((m_model.getState()->crashed() ? "TRUE" : "FALSE"));
     }
 
     return {keys, values};
@@ -1361,16 +1361,20 @@ void Window::mouseAlgoRunStart() {
     MouseInterface* newMouseInterface = new MouseInterface(
         m_maze,
         newMouse,
-        newView
+        newView,
+        &m_model
     );
 
     // Clear the output, and jump to it
     m_mouseAlgoRunOutput->clear();
     m_mouseAlgoOutputTabWidget->setCurrentWidget(m_mouseAlgoRunOutput);
 
-    // Append the random seed to the command
+    // Append the random seed to the command; the interface's random numbers
+    // use the same seed
+    int seed = m_mouseAlgoSeedWidget->next();
+    newMouseInterface->setRandomSeed(seed);
     command += " ";
-    command += QString::number(m_mouseAlgoSeedWidget->next());
+    command += QString::number(seed);
 
     // The thread on which the mouse interface will execute
     QThread* newMouseAlgoThread = new QThread();
@@ -1383,6 +1387,26 @@ void Window::mouseAlgoRunStart() {
         // Create the subprocess on which we'll execute the mouse algorithm
         QProcess* newProcess = new QProcess();
 
+        // Offer the algorithm a faster alternative to stdio, passing it the
+        // name of the shared memory segment via its environment
+        SharedMemoryTransport* newTransport = nullptr;
+        if (P()->useSharedMemoryTransport()) {
+            newTransport = new SharedMemoryTransport();
+            if (newTransport->isValid()) {
+                QProcessEnvironment environment =
+                    QProcessEnvironment::systemEnvironment();
+                environment.insert(
+                    SharedMemoryTransport::ENVIRONMENT_VARIABLE,
+                    newTransport->getName());
+                newProcess->setProcessEnvironment(environment);
+                newMouseInterface->setSharedMemoryTransport(newTransport);
+            }
+            else {
+                delete newTransport;
+                newTransport = nullptr;
+            }
+        }
+
         // Ideally, we could call readAllStandardOutput() and appendPlainText()
         // within the same lambda. Unfortunately, this isn't possible:
         // - readAllStandardOutput() and readAllStandardError() aren't thread
@@ -1418,13 +1442,10 @@ void Window::mouseAlgoRunStart() {
             // prevent the UI from freezing during a blocking mouse action
             newMouseInterface,
             [=](){
-                QString text = newProcess->readAllStandardError();
-                QStringList lines = getLines(text, &m_stderrBuffer);
-                for (const QString& line : lines) {
-                    QString response = newMouseInterface->dispatch(line);
-                    if (!response.isEmpty()) {
-                        newProcess->write((response + "\n").toStdString().c_str());
-                    }
+                QByteArray replies = newMouseInterface->handleStandardError(
+                    newProcess->readAllStandardError());
+                if (!replies.isEmpty()) {
+                    newProcess->write(replies);
                 }
             }
         );
@@ -1524,6 +1545,20 @@ void Window::mouseAlgoRunStart() {
             }
         );
 
+        // Once the algorithm exits, stop serving the shared memory transport
+        if (newTransport != nullptr) {
+            connect(
+                newProcess,
+                static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(
+                    &QProcess::finished
+                ),
+                newMouseInterface,
+                [=](){
+                    newTransport->close();
+                }
+            );
+        }
+
         // When the thread finishes, clean everything up
         connect(newMouseAlgoThread, &QThread::finished, this, [=](){
             newProcess->terminate();
@@ -1531,6 +1566,7 @@ void Window::mouseAlgoRunStart() {
             delete newProcess;
             delete newMouseAlgoThread;
             delete newMouseInterface;
+            delete newTransport;
             delete newMouseGraphic;
             delete newView;
             delete newMouse;
@@ -1613,7 +1649,6 @@ void Window::mouseAlgoRunStop() {
     // "mouseless" state (note that the objects themselves get deleted in a
     // separate callback). Note that we do this *after* stopping the algo
     // thread so that we can be sure no more stderr will be emitted.
-    m_stderrBuffer.clear();
     m_map.setMouseGraphic(nullptr);
     m_map.setView(m_truth);
     m_model.removeMouse();
@@ -1721,36 +1756,4 @@ QVector<ConfigDialogField> Window::mouseAlgoGetFields() {
     };
 }
 
-QStringList Window::getLines(const QString& text, QStringList* buffer) {
-
-    // TODO: upforgrabs
-    // Determine whether or not this function is perf sensitive. If so,
-    // refactor this so that we're not copying QStrings between lists.
-
-    // Separate the text by line
-    QStringList parts = SimUtilities::splitLines(text);
-
-    // We'll return list of complete lines
-    QStringList lines;
-
-    // If the text has at least one newline character, we definitely have a
-    // complete line; combine it with the contents of the buffer and append
-    // it to the list of lines to be returned
-    if (1 < parts.size()) {
-        lines.append(buffer->join("") + parts.at(0));
-        buffer->clear();
-    }
-
-    // All newline-separated parts in the text are lines
-    for (int i = 1; i < parts.size() - 1; i += 1) {
-        lines.append(parts.at(i));
-    }
-
-    // Store the last part of the text (empty string if the text ended
-    // with newline) in the buffer, to be combined with future input
-    buffer->append(parts.at(parts.size() - 1));
-
-    return lines;
-}
-
 } // namespace mms
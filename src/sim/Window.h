@@ -167,7 +167,6 @@ private:
     QThread* m_mouseAlgoThread;
 
     // Mouse algo running
-    QStringList m_stderrBuffer;
     QProcess* m_mouseAlgoRunProcess;
     QPushButton* m_mouseAlgoRunButton;
     QLabel* m_mouseAlgoRunStatus;
@@ -185,10 +184,6 @@ private:
     void mouseAlgoRefresh(const QString& name = "");
     QVector<ConfigDialogField> mouseAlgoGetFields();
 
-    // Given some text (and a buffer containing past input), return
-    // all complete lines and append remaining text to the buffer
-    QStringList getLines(const QString& text, QStringList* buffer);
-
     // ----- Misc ----- //
 
     QTimer m_headerRefreshTimer;
@@ -0,0 +1,28 @@
+# The simulator core, minus everything that requires QtWidgets or OpenGL, for
+# the targets that run the simulator without its window
+
+# shm_open, for the shared memory transport, lives in librt on older glibc
+unix:!macx: LIBS += -lrt
+
+INCLUDEPATH += $$PWD
+
+SIM_SOURCES = $$files($$PWD/*.cpp, true)
+SIM_SOURCES -= $$PWD/ConfigDialog.cpp
+SIM_SOURCES -= $$PWD/Driver.cpp
+SIM_SOURCES -= $$PWD/Main.cpp
+SIM_SOURCES -= $$PWD/Map.cpp
+SIM_SOURCES -= $$PWD/MazeFilesTab.cpp
+SIM_SOURCES -= $$PWD/RandomSeedWidget.cpp
+SIM_SOURCES -= $$PWD/Screen.cpp
+SIM_SOURCES -= $$PWD/Window.cpp
+
+SIM_HEADERS = $$files($$PWD/*.h, true)
+SIM_HEADERS -= $$PWD/ConfigDialog.h
+SIM_HEADERS -= $$PWD/Map.h
+SIM_HEADERS -= $$PWD/MazeFilesTab.h
+SIM_HEADERS -= $$PWD/RandomSeedWidget.h
+SIM_HEADERS -= $$PWD/Window.h
+
+SOURCES += $$SIM_SOURCES
+HEADERS += $$SIM_HEADERS
+RESOURCES += $$PWD/images.qrc
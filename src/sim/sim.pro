@@ -13,6 +13,9 @@ CONFIG += qt
 # Turn these on - fix a bunch of warnings
 CONFIG += warn_off
 
+# shm_open, for the shared memory transport, lives in librt on older glibc
+unix:!macx: LIBS += -lrt
+
 SOURCES += $$files(*.cpp, true)
 HEADERS += $$files(*.h, true)
 RESOURCES = images.qrc
@@ -9,9 +9,6 @@ namespace mms {
 Angle::Angle() : m_radians(0) {
 }
 
-Angle::~Angle() {
-}
-
 double Angle::getRadiansZeroTo2pi() const {
     return getRadians(true);
 }
@@ -5,7 +5,6 @@ namespace mms {
 class Angle {
 
 public:
-    virtual ~Angle() = 0;
     double getRadiansZeroTo2pi() const;
     double getDegreesZeroTo360() const;
     double getRadiansNotBounded() const;
@@ -16,6 +15,7 @@ public:
 
 protected:
     Angle();
+    ~Angle() = default;
     double m_radians;
 
 private:
@@ -7,9 +7,6 @@ namespace mms {
 AngularVelocity::AngularVelocity() : m_radiansPerSecond(0) {
 }
 
-AngularVelocity::~AngularVelocity() {
-}
-
 double AngularVelocity::getRadiansPerSecond() const {
     return m_radiansPerSecond;
 }
@@ -8,7 +8,6 @@ namespace mms {
 class AngularVelocity {
 
 public:
-    virtual ~AngularVelocity() = 0;
     double getRadiansPerSecond() const;
     double getDegreesPerSecond() const;
     double getRevolutionsPerMinute() const;
@@ -19,6 +18,7 @@ public:
 
 protected:
     AngularVelocity();
+    ~AngularVelocity() = default;
     double m_radiansPerSecond;
 
 };
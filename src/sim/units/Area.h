@@ -5,11 +5,11 @@ namespace mms {
 class Area {
 
 public:
-    virtual ~Area() = 0;
     double getMetersSquared() const;
 
 protected:
     Area();
+    ~Area() = default;
     double m_metersSquared;
 
 };
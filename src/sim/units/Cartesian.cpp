@@ -17,6 +17,11 @@ Cartesian::Cartesian(const Coordinate& coordinate) {
     m_y = coordinate.getY();
 }
 
+Cartesian::Cartesian(const units::Vector& vector) {
+    m_x = Meters(vector.x().value());
+    m_y = Meters(vector.y().value());
+}
+
 Cartesian Cartesian::operator+(const Coordinate& coordinate) const {
     return Cartesian(getX() + coordinate.getX(), getY() + coordinate.getY());
 }
@@ -10,6 +10,7 @@ public:
     Cartesian();
     Cartesian(const Distance& x, const Distance& y);
     Cartesian(const Coordinate& coordinate);
+    Cartesian(const units::Vector& vector);
     Cartesian operator+(const Coordinate& coordinate) const;
     Cartesian operator-(const Coordinate& coordinate) const;
     Cartesian operator*(double factor) const;
@@ -7,9 +7,6 @@ namespace mms {
 Coordinate::Coordinate() : m_x(Meters(0.0)), m_y(Meters(0.0)) {
 }
 
-Coordinate::~Coordinate() {
-}
-
 Meters Coordinate::getX() const {
     return m_x;
 }
@@ -26,6 +23,12 @@ Radians Coordinate::getTheta() const {
     return Radians(std::atan2(m_y.getMeters(), m_x.getMeters()));
 }
 
+units::Vector Coordinate::getVector() const {
+    return units::Vector(
+        units::Length(m_x.getMeters()),
+        units::Length(m_y.getMeters()));
+}
+
 bool Coordinate::operator==(const Coordinate& coordinate) const {
     return (getX() == coordinate.getX() && getY() == coordinate.getY());
 }
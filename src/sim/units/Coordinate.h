@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Meters.h"
+#include "Quantity.h"
 #include "Radians.h"
 
 namespace mms {
@@ -8,17 +9,18 @@ namespace mms {
 class Coordinate { // Synonymous to vector
 
 public:
-    virtual ~Coordinate() = 0;
     Meters getX() const;
     Meters getY() const;
     Meters getRho() const;
     Radians getTheta() const;
+    units::Vector getVector() const;
     bool operator==(const Coordinate& coordinate) const;
     bool operator!=(const Coordinate& coordinate) const;
     bool operator<(const Coordinate& coordinate) const;
 
 protected:
     Coordinate();
+    ~Coordinate() = default;
     Meters m_x;
     Meters m_y;
 
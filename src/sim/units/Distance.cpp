@@ -5,9 +5,6 @@ namespace mms {
 Distance::Distance() : m_meters(0.0) {
 }
 
-Distance::~Distance() {
-}
-
 double Distance::getMeters() const {
     return m_meters;
 }
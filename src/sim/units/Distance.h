@@ -8,7 +8,6 @@ namespace mms {
 class Distance {
 
 public:
-    virtual ~Distance() = 0;
     double getMeters() const;
     double getCentimeters() const;
     bool operator==(const Distance& distance) const;
@@ -18,6 +17,7 @@ public:
 
 protected:
     Distance();
+    ~Distance() = default;
     double m_meters;
 
 };
@@ -5,9 +5,6 @@ namespace mms {
 Duration::Duration() : m_seconds(0) {
 }
 
-Duration::~Duration() {
-}
-
 double Duration::getSeconds() const {
     return m_seconds;
 }
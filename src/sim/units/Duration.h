@@ -5,7 +5,6 @@ namespace mms {
 class Duration {
 
 public:
-    virtual ~Duration() = 0;
     double getSeconds() const;
     double getMilliseconds() const;
     double getMicroseconds() const;
@@ -13,6 +12,7 @@ public:
 
 protected:
     Duration();
+    ~Duration() = default;
     double m_seconds;
 
 };
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+namespace mms {
+namespace units {
+
+// A physical quantity, whose dimension (the exponents of length, time, and
+// angle) is part of its type. Just like the classes in this directory, this
+// makes it impossible to, e.g., add a length to a duration, but without any
+// runtime cost: a Quantity is exactly the size of a double, is trivially
+// copyable, has no virtual functions, and every operation is inline and
+// constexpr. The value is always stored in SI units (meters, seconds, and
+// radians), so there are no conversions in the hot paths.
+template <int L, int T, int A>
+class Quantity {
+
+public:
+    constexpr Quantity() : m_value(0.0) {
+    }
+
+    constexpr explicit Quantity(double value) : m_value(value) {
+    }
+
+    constexpr double value() const {
+        return m_value;
+    }
+
+    constexpr Quantity operator+(Quantity other) const {
+        return Quantity(m_value + other.m_value);
+    }
+
+    constexpr Quantity operator-(Quantity other) const {
+        return Quantity(m_value - other.m_value);
+    }
+
+    constexpr Quantity operator-() const {
+        return Quantity(-m_value);
+    }
+
+    constexpr Quantity operator*(double factor) const {
+        return Quantity(m_value * factor);
+    }
+
+    constexpr Quantity operator/(double factor) const {
+        return Quantity(m_value / factor);
+    }
+
+    // The ratio of two quantities of the same dimension is just a number
+    constexpr double operator/(Quantity other) const {
+        return m_value / other.m_value;
+    }
+
+    template <int L2, int T2, int A2>
+    constexpr Quantity<L + L2, T + T2, A + A2> operator*(Quantity<L2, T2, A2> other) const {
+        return Quantity<L + L2, T + T2, A + A2>(m_value * other.value());
+    }
+
+    template <int L2, int T2, int A2>
+    constexpr Quantity<L - L2, T - T2, A - A2> operator/(Quantity<L2, T2, A2> other) const {
+        return Quantity<L - L2, T - T2, A - A2>(m_value / other.value());
+    }
+
+    Quantity& operator+=(Quantity other) {
+        m_value += other.m_value;
+        return *this;
+    }
+
+    Quantity& operator-=(Quantity other) {
+        m_value -= other.m_value;
+        return *this;
+    }
+
+    constexpr bool operator==(Quantity other) const {
+        return m_value == other.m_value;
+    }
+
+    constexpr bool operator!=(Quantity other) const {
+        return m_value != other.m_value;
+    }
+
+    constexpr bool operator<(Quantity other) const {
+        return m_value < other.m_value;
+    }
+
+    constexpr bool operator<=(Quantity other) const {
+        return m_value <= other.m_value;
+    }
+
+    constexpr bool operator>(Quantity other) const {
+        return m_value > other.m_value;
+    }
+
+    constexpr bool operator>=(Quantity other) const {
+        return m_value >= other.m_value;
+    }
+
+private:
+    double m_value;
+
+};
+
+template <int L, int T, int A>
+constexpr Quantity<L, T, A> operator*(double factor, Quantity<L, T, A> quantity) {
+    return quantity * factor;
+}
+
+template <int L, int T, int A>
+inline Quantity<L, T, A> abs(Quantity<L, T, A> quantity) {
+    return Quantity<L, T, A>(std::abs(quantity.value()));
+}
+
+using Scalar = Quantity<0, 0, 0>;
+using Length = Quantity<1, 0, 0>;
+using Area = Quantity<2, 0, 0>;
+using Time = Quantity<0, 1, 0>;
+using Angle = Quantity<0, 0, 1>;
+using Velocity = Quantity<1, -1, 0>;
+using AngularVelocity = Quantity<0, -1, 1>;
+
+static_assert(sizeof(Length) == sizeof(double), "Quantity must be a bare double");
+static_assert(std::is_trivially_copyable<Length>::value, "Quantity must be trivially copyable");
+
+inline double sin(Angle angle) {
+    return std::sin(angle.value());
+}
+
+inline double cos(Angle angle) {
+    return std::cos(angle.value());
+}
+
+// A two dimensional vector (i.e., a position or a displacement)
+class Vector {
+
+public:
+    constexpr Vector() : m_x(), m_y() {
+    }
+
+    constexpr Vector(Length x, Length y) : m_x(x), m_y(y) {
+    }
+
+    // Creates the vector with magnitude rho in the direction theta
+    static Vector fromPolar(Length rho, Angle theta) {
+        return Vector(rho * cos(theta), rho * sin(theta));
+    }
+
+    constexpr Length x() const {
+        return m_x;
+    }
+
+    constexpr Length y() const {
+        return m_y;
+    }
+
+    constexpr Vector operator+(Vector other) const {
+        return Vector(m_x + other.m_x, m_y + other.m_y);
+    }
+
+    constexpr Vector operator-(Vector other) const {
+        return Vector(m_x - other.m_x, m_y - other.m_y);
+    }
+
+    constexpr Vector operator*(double factor) const {
+        return Vector(m_x * factor, m_y * factor);
+    }
+
+    constexpr bool operator==(Vector other) const {
+        return m_x == other.m_x && m_y == other.m_y;
+    }
+
+    constexpr bool operator!=(Vector other) const {
+        return !(*this == other);
+    }
+
+    // Returns this vector rotated counterclockwise about the origin, given
+    // the cosine and sine of the angle, so that they may be computed just
+    // once when rotating many vectors by the same angle
+    constexpr Vector rotate(double cosAngle, double sinAngle) const {
+        return Vector(
+            m_x * cosAngle - m_y * sinAngle,
+            m_x * sinAngle + m_y * cosAngle);
+    }
+
+    // The z component of the cross product of this vector and other
+    constexpr Area cross(Vector other) const {
+        return m_x * other.m_y - m_y * other.m_x;
+    }
+
+private:
+    Length m_x;
+    Length m_y;
+
+};
+
+static_assert(std::is_trivially_copyable<Vector>::value, "Vector must be trivially copyable");
+
+} // namespace units
+} // namespace mms
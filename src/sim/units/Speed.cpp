@@ -5,9 +5,6 @@ namespace mms {
 Speed::Speed() : m_metersPerSecond(0) {
 }
 
-Speed::~Speed() {
-}
-
 double Speed::getMetersPerSecond() const {
     return m_metersPerSecond;
 }
@@ -5,12 +5,12 @@ namespace mms {
 class Speed {
 
 public:
-    virtual ~Speed() = 0;
     double getMetersPerSecond() const;
     bool operator<(const Speed& speed) const;
 
 protected:
     Speed();
+    ~Speed() = default;
     double m_metersPerSecond;
 
 };
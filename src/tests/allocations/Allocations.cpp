@@ -0,0 +1,165 @@
+#include "Allocations.h"
+
+#include <QDir>
+#include <QVector>
+#include <QtMath>
+
+#include <cstdlib>
+
+#include "units/Meters.h"
+#include "units/Quantity.h"
+#include "units/Radians.h"
+
+#include "GeometryUtilities.h"
+#include "Mouse.h"
+#include "MouseGraphic.h"
+#include "Param.h"
+#include "TriangleGraphic.h"
+
+using namespace mms;
+
+// We count allocations by interposing the C allocator, which both operator
+// new and Qt's containers use. Only allocations made by the counting thread,
+// while it's counting, are counted. This relies on glibc, which exports the
+// underlying allocator under another name.
+#if defined(__GLIBC__)
+
+namespace {
+
+thread_local bool t_counting = false;
+thread_local int t_allocations = 0;
+
+} // namespace
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+
+void* malloc(size_t size) __THROW {
+    if (t_counting) {
+        t_allocations += 1;
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) __THROW {
+    if (t_counting) {
+        t_allocations += 1;
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) __THROW {
+    if (t_counting) {
+        t_allocations += 1;
+    }
+    return __libc_realloc(pointer, size);
+}
+
+} // extern "C"
+
+#endif
+
+namespace {
+
+// Returns the number of heap allocations made while calling function
+template <typename Function>
+int countAllocations(Function function) {
+#if defined(__GLIBC__)
+    t_allocations = 0;
+    t_counting = true;
+    function();
+    t_counting = false;
+    return t_allocations;
+#else
+    function();
+    return 0;
+#endif
+}
+
+} // namespace
+
+void Allocations::initTestCase() {
+    m_maze = Maze::fromFile(QFINDTESTDATA("../../../res/maze/apec2002.num"));
+    QVERIFY(m_maze != nullptr);
+}
+
+void Allocations::cleanupTestCase() {
+    delete m_maze;
+}
+
+void Allocations::drawingMouseDoesNotAllocate_data() {
+    QTest::addColumn<QString>("mouseFile");
+    QDir dir(QFINDTESTDATA("../../../res/mouse"));
+    for (const QString& name : dir.entryList({"*.xml"}, QDir::Files, QDir::Name)) {
+        QTest::newRow(qPrintable(name)) << dir.filePath(name);
+    }
+}
+
+void Allocations::drawingMouseDoesNotAllocate() {
+#if !defined(__GLIBC__)
+    QSKIP("Counting allocations requires glibc");
+#endif
+    QFETCH(QString, mouseFile);
+
+    Mouse mouse(m_maze);
+    QVERIFY(mouse.reload(mouseFile));
+    MouseGraphic graphic(&mouse);
+    QVERIFY(!graphic.getStaticTriangles()->isEmpty());
+
+    // The first frame sizes the buffer, initializes the lazy statics, etc.
+    QVector<TriangleGraphic> buffer;
+    graphic.draw(
+        mouse.getInitialTranslation(),
+        mouse.getCurrentRotation(),
+        &buffer);
+    QVERIFY(!buffer.isEmpty());
+    int triangles = buffer.size();
+
+    // Every frame after that, wherever the mouse is, must reuse the buffer
+    for (int i = 1; i <= 10; i += 1) {
+        buffer.clear();
+        Cartesian translation = mouse.getInitialTranslation() +
+            Cartesian(Meters(0.01 * i), Meters(0.02 * i));
+        Radians rotation = mouse.getCurrentRotation() + Radians(0.3 * i);
+        QCOMPARE(countAllocations([&]() {
+            graphic.draw(translation, rotation, &buffer);
+        }), 0);
+        QCOMPARE(buffer.size(), triangles);
+    }
+}
+
+void Allocations::coneAreaDoesNotAllocate() {
+#if !defined(__GLIBC__)
+    QSKIP("Counting allocations requires glibc");
+#endif
+    units::Length halfWallWidth = units::Length(P()->wallWidth() / 2.0);
+    units::Length tileLength =
+        units::Length(P()->wallLength() + P()->wallWidth());
+    units::Angle halfWidth = units::Angle(M_PI / 4.0);
+    units::Length range = tileLength * 2.0;
+    auto getArea = [&](int x, int y) {
+        units::Vector apex =
+            units::Vector(tileLength * (x + 0.5), tileLength * (y + 0.5));
+        units::Angle direction = units::Angle(x + 2.0 * y);
+        return GeometryUtilities::getVisibleConeArea(
+            apex, direction, halfWidth, range, *m_maze, halfWallWidth, tileLength);
+    };
+
+    // The first pass grows the storage to fit the busiest cone, after which
+    // no cone may allocate
+    for (int x = 0; x < m_maze->getWidth(); x += 1) {
+        for (int y = 0; y < m_maze->getHeight(); y += 1) {
+            QVERIFY(0.0 < getArea(x, y).value());
+        }
+    }
+    for (int x = 0; x < m_maze->getWidth(); x += 1) {
+        for (int y = 0; y < m_maze->getHeight(); y += 1) {
+            QCOMPARE(countAllocations([&]() { getArea(x, y); }), 0);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(Allocations)
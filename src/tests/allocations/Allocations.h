@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QtTest/QtTest>
+
+#include "Maze.h"
+
+class Allocations: public QObject {
+
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Once warmed up, drawing a frame of the mouse (including the rays cast
+    // for the sensor views) must not touch the heap at all
+    void drawingMouseDoesNotAllocate_data();
+    void drawingMouseDoesNotAllocate();
+
+    // Once the storage for the faces near the apex has grown to fit, the
+    // exact cone model's readings must not touch the heap either
+    void coneAreaDoesNotAllocate();
+
+private:
+
+    mms::Maze* m_maze;
+
+};
@@ -0,0 +1,331 @@
+#include "CastRay.h"
+
+#include <QDir>
+#include <QtMath>
+
+#include <functional>
+#include <random>
+
+#include "units/Meters.h"
+#include "units/Polar.h"
+#include "units/Radians.h"
+
+#include "GeometryUtilities.h"
+#include "Param.h"
+
+using namespace mms;
+
+namespace {
+
+// The implementation of GeometryUtilities::castRay from before the migration
+// to units::Quantity and the grid DDA, kept verbatim (save for the helper) as
+// a baseline
+
+bool legacyIsOnTileEdge(
+        const Meters& position, const Meters& halfWallWidth, const Meters& tileLength) {
+    Meters tileLengthMinusHalfWallWidth = tileLength - halfWallWidth;
+    Meters mod = Meters(std::fmod(position.getMeters(), tileLength.getMeters()));
+    return (mod < halfWallWidth || tileLengthMinusHalfWallWidth < mod);
+}
+
+Cartesian legacyCastRay(
+        const Cartesian& start, const Cartesian& end, const Maze& maze,
+        const Meters& halfWallWidth, const Meters& tileLength) {
+
+    Meters dx = end.getX() - start.getX();
+    Meters dy = end.getY() - start.getY();
+
+    QPair<int, int> direction = {
+        (0 < dx.getMeters() ? 1 : -1),
+        (0 < dy.getMeters() ? 1 : -1)
+    };
+
+    Cartesian logicalShift = Cartesian(
+        halfWallWidth * direction.first  * -1,
+        halfWallWidth * direction.second * -1
+    );
+
+    Meters cx = start.getX();
+    Meters cy = start.getY();
+
+    int sx = static_cast<int>(std::floor((start - logicalShift).getX() / tileLength));
+    int sy = static_cast<int>(std::floor((start - logicalShift).getY() / tileLength));
+
+    int px = (direction.first  == 1 ? 1 : 0);
+    int py = (direction.second == 1 ? 1 : 0);
+
+    int ox = px;
+    int oy = py;
+
+    int ix = direction.first;
+    int iy = direction.second;
+
+    Meters nx = tileLength * (sx + ox) + logicalShift.getX();
+    Meters ny = tileLength * (sy + oy) + logicalShift.getY();
+
+    Direction wx = (direction.first  == 1 ? Direction::EAST  : Direction::WEST );
+    Direction wy = (direction.second == 1 ? Direction::NORTH : Direction::SOUTH);
+
+    static std::function<bool(const Meters&, const Meters&)> east = [](const Meters& nx, const Meters& ex) {
+        return nx < ex;
+    };
+    static std::function<bool(const Meters&, const Meters&)> west = [](const Meters& nx, const Meters& ex) {
+        return ex < nx;
+    };
+    static std::function<bool(const Meters&, const Meters&)> north = [](const Meters& ny, const Meters& ey) {
+        return ny < ey;
+    };
+    static std::function<bool(const Meters&, const Meters&)> south = [](const Meters& ny, const Meters& ey) {
+        return ey < ny;
+    };
+    std::function<bool(const Meters&, const Meters&)>* bx = (direction.first  == 1 ? &east  : &west );
+    std::function<bool(const Meters&, const Meters&)>* by = (direction.second == 1 ? &north : &south);
+
+    while ((*bx)(nx, end.getX()) || (*by)(ny, end.getY())) {
+        if (std::abs((nx - cx) / dx) < std::abs((ny - cy) / dy)) {
+            cy = cy + (nx - cx) * (dy / dx);
+            cx = nx;
+            int x = sx + ox - px;
+            int y = sy + oy - py;
+            if (legacyIsOnTileEdge(cy, halfWallWidth, tileLength) ||
+                    (maze.withinMaze(x, y) && maze.getTile(x, y)->isWall(wx))) {
+                return Cartesian(cx, cy);
+            }
+            ox += ix;
+            nx = tileLength * (sx + ox) + logicalShift.getX();
+        }
+        else {
+            cx = cx + (ny - cy) * (dx / dy);
+            cy = ny;
+            int x = sx + ox - px;
+            int y = sy + oy - py;
+            if (legacyIsOnTileEdge(cx, halfWallWidth, tileLength) ||
+                    (maze.withinMaze(x, y) && maze.getTile(x, y)->isWall(wy))) {
+                return Cartesian(cx, cy);
+            }
+            oy += iy;
+            ny = tileLength * (sy + oy) + logicalShift.getY();
+        }
+    }
+
+    return end;
+}
+
+// The implementation of GeometryUtilities::castRay from after the migration
+// to units::Quantity, but before the grid DDA, kept verbatim (save for the
+// helper, and the comments) so that both steps can be measured
+
+bool quantityIsOnTileEdge(
+        units::Length position, units::Length halfWallWidth, units::Length tileLength) {
+    units::Length tileLengthMinusHalfWallWidth = tileLength - halfWallWidth;
+    units::Length mod = units::Length(std::fmod(position.value(), tileLength.value()));
+    return (mod < halfWallWidth || tileLengthMinusHalfWallWidth < mod);
+}
+
+units::Vector quantityCastRay(
+        units::Vector start, units::Vector end, const Maze& maze,
+        units::Length halfWallWidth, units::Length tileLength) {
+
+    units::Length dx = end.x() - start.x();
+    units::Length dy = end.y() - start.y();
+
+    QPair<int, int> direction = {
+        (0 < dx.value() ? 1 : -1),
+        (0 < dy.value() ? 1 : -1)
+    };
+
+    units::Vector logicalShift = units::Vector(
+        halfWallWidth * direction.first  * -1,
+        halfWallWidth * direction.second * -1
+    );
+
+    units::Length cx = start.x();
+    units::Length cy = start.y();
+
+    int sx = static_cast<int>(std::floor((start - logicalShift).x() / tileLength));
+    int sy = static_cast<int>(std::floor((start - logicalShift).y() / tileLength));
+
+    int px = (direction.first  == 1 ? 1 : 0);
+    int py = (direction.second == 1 ? 1 : 0);
+
+    int ox = px;
+    int oy = py;
+
+    int ix = direction.first;
+    int iy = direction.second;
+
+    units::Length nx = tileLength * (sx + ox) + logicalShift.x();
+    units::Length ny = tileLength * (sy + oy) + logicalShift.y();
+
+    Direction wx = (direction.first  == 1 ? Direction::EAST  : Direction::WEST );
+    Direction wy = (direction.second == 1 ? Direction::NORTH : Direction::SOUTH);
+
+    auto beforeEnd = [](units::Length next, units::Length last, int direction) {
+        return (direction == 1 ? next < last : last < next);
+    };
+
+    while (
+        beforeEnd(nx, end.x(), direction.first) ||
+        beforeEnd(ny, end.y(), direction.second)
+    ) {
+        if (std::abs((nx - cx) / dx) < std::abs((ny - cy) / dy)) {
+            cy = cy + (nx - cx) * (dy / dx);
+            cx = nx;
+            int x = sx + ox - px;
+            int y = sy + oy - py;
+            if (quantityIsOnTileEdge(cy, halfWallWidth, tileLength) ||
+                    (maze.withinMaze(x, y) && maze.getTile(x, y)->isWall(wx))) {
+                return units::Vector(cx, cy);
+            }
+            ox += ix;
+            nx = tileLength * (sx + ox) + logicalShift.x();
+        }
+        else {
+            cx = cx + (ny - cy) * (dx / dy);
+            cy = ny;
+            int x = sx + ox - px;
+            int y = sy + oy - py;
+            if (quantityIsOnTileEdge(cx, halfWallWidth, tileLength) ||
+                    (maze.withinMaze(x, y) && maze.getTile(x, y)->isWall(wy))) {
+                return units::Vector(cx, cy);
+            }
+            oy += iy;
+            ny = tileLength * (sy + oy) + logicalShift.y();
+        }
+    }
+
+    return end;
+}
+
+Meters halfWallWidth() {
+    return Meters(P()->wallWidth() / 2.0);
+}
+
+Meters tileLength() {
+    return Meters(P()->wallLength() + P()->wallWidth());
+}
+
+QVector<QVector<QPair<units::Vector, units::Vector>>> toVectors(
+        const QVector<QVector<QPair<Cartesian, Cartesian>>>& rays) {
+    QVector<QVector<QPair<units::Vector, units::Vector>>> vectors;
+    for (int i = 0; i < rays.size(); i += 1) {
+        vectors.append({});
+        for (const auto& ray : rays.at(i)) {
+            vectors.last().append({ray.first.getVector(), ray.second.getVector()});
+        }
+    }
+    return vectors;
+}
+
+} // namespace
+
+void CastRay::initTestCase() {
+    QDir dir(QFINDTESTDATA("../../../res/maze"));
+    QVERIFY(dir.exists());
+
+    // Rays of roughly sensor length, from random points in each maze, in
+    // random directions; the seed is fixed so that runs are comparable. Every
+    // tenth ray is parallel to an axis, since those are special cases.
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> thetas(0.0, 2 * M_PI);
+    for (const QString& name : dir.entryList({"*.num"}, QDir::Files, QDir::Name)) {
+        Maze* maze = Maze::fromFile(dir.filePath(name));
+        QVERIFY2(maze != nullptr, qPrintable(name));
+        std::uniform_real_distribution<double> xs(
+            0.0, maze->getWidth() * tileLength().getMeters());
+        std::uniform_real_distribution<double> ys(
+            0.0, maze->getHeight() * tileLength().getMeters());
+        QVector<QPair<Cartesian, Cartesian>> rays;
+        for (int i = 0; i < 1000; i += 1) {
+            Cartesian start(Meters(xs(generator)), Meters(ys(generator)));
+            if (i % 10 == 0) {
+                Meters length = Meters(i % 20 == 0 ? 0.25 : -0.25);
+                Cartesian ray = (i % 40 < 20
+                    ? Cartesian(length, Meters(0))
+                    : Cartesian(Meters(0), length));
+                rays.append({start, start + ray});
+            }
+            else {
+                Polar ray(Meters(0.25), Radians(thetas(generator)));
+                rays.append({start, start + ray});
+            }
+        }
+        m_mazes.append(maze);
+        m_rays.append(rays);
+    }
+    QVERIFY(!m_mazes.isEmpty());
+}
+
+void CastRay::cleanupTestCase() {
+    qDeleteAll(m_mazes);
+}
+
+void CastRay::matchesLegacyImplementation() {
+    for (int i = 0; i < m_mazes.size(); i += 1) {
+        for (const auto& ray : m_rays.at(i)) {
+            Cartesian expected = legacyCastRay(
+                ray.first, ray.second, *m_mazes.at(i), halfWallWidth(), tileLength());
+            Cartesian actual = GeometryUtilities::castRay(
+                ray.first, ray.second, *m_mazes.at(i), halfWallWidth(), tileLength());
+            QCOMPARE(actual.getX().getMeters(), expected.getX().getMeters());
+            QCOMPARE(actual.getY().getMeters(), expected.getY().getMeters());
+            units::Vector quantity = quantityCastRay(
+                ray.first.getVector(),
+                ray.second.getVector(),
+                *m_mazes.at(i),
+                units::Length(halfWallWidth().getMeters()),
+                units::Length(tileLength().getMeters()));
+            QCOMPARE(quantity.x().value(), expected.getX().getMeters());
+            QCOMPARE(quantity.y().value(), expected.getY().getMeters());
+        }
+    }
+}
+
+void CastRay::benchmarkLegacyImplementation() {
+    Meters wall = halfWallWidth();
+    Meters tile = tileLength();
+    double sum = 0.0;
+    QBENCHMARK {
+        for (int i = 0; i < m_mazes.size(); i += 1) {
+            for (const auto& ray : m_rays.at(i)) {
+                sum += legacyCastRay(
+                    ray.first, ray.second, *m_mazes.at(i), wall, tile).getX().getMeters();
+            }
+        }
+    }
+    QVERIFY(0.0 < sum);
+}
+
+void CastRay::benchmarkQuantityImplementation() {
+    units::Length wall = units::Length(halfWallWidth().getMeters());
+    units::Length tile = units::Length(tileLength().getMeters());
+    QVector<QVector<QPair<units::Vector, units::Vector>>> rays = toVectors(m_rays);
+    double sum = 0.0;
+    QBENCHMARK {
+        for (int i = 0; i < m_mazes.size(); i += 1) {
+            for (const auto& ray : rays.at(i)) {
+                sum += quantityCastRay(
+                    ray.first, ray.second, *m_mazes.at(i), wall, tile).x().value();
+            }
+        }
+    }
+    QVERIFY(0.0 < sum);
+}
+
+void CastRay::benchmark() {
+    units::Length wall = units::Length(halfWallWidth().getMeters());
+    units::Length tile = units::Length(tileLength().getMeters());
+    QVector<QVector<QPair<units::Vector, units::Vector>>> rays = toVectors(m_rays);
+    double sum = 0.0;
+    QBENCHMARK {
+        for (int i = 0; i < m_mazes.size(); i += 1) {
+            for (const auto& ray : rays.at(i)) {
+                sum += GeometryUtilities::castRay(
+                    ray.first, ray.second, *m_mazes.at(i), wall, tile).x().value();
+            }
+        }
+    }
+    QVERIFY(0.0 < sum);
+}
+
+QTEST_GUILESS_MAIN(CastRay)
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QPair>
+#include <QVector>
+#include <QtTest/QtTest>
+
+#include "units/Cartesian.h"
+
+#include "Maze.h"
+
+class CastRay: public QObject {
+
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    // The templated quantity and grid DDA implementations must agree with
+    // the original
+    void matchesLegacyImplementation();
+
+    // The cost of casting the same rays before the migration to
+    // units::Quantity, after it, and with the grid DDA
+    void benchmarkLegacyImplementation();
+    void benchmarkQuantityImplementation();
+    void benchmark();
+
+private:
+
+    // Every .num maze, along with the rays to cast in it
+    QVector<mms::Maze*> m_mazes;
+    QVector<QVector<QPair<mms::Cartesian, mms::Cartesian>>> m_rays;
+
+};
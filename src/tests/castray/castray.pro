@@ -0,0 +1,14 @@
+QT += testlib
+QT += xml
+QT -= gui
+CONFIG += testcase
+
+include(../../sim/core.pri)
+
+SOURCES += $$files(*.cpp, true)
+HEADERS += $$files(*.h, true)
+
+DESTDIR = build
+MOC_DIR = build
+OBJECTS_DIR = build
+RCC_DIR = build
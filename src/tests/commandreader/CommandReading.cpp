@@ -0,0 +1,389 @@
+#include "CommandReading.h"
+
+#include <QByteArray>
+#include <QVector>
+
+#include <limits>
+
+#include "BinaryProtocol.h"
+#include "CommandReader.h"
+#include "MouseCommand.h"
+#include "Opcode.h"
+#include "TextProtocol.h"
+
+using namespace mms;
+
+namespace {
+
+QVector<QByteArray> readLines(CommandReader* reader) {
+    QVector<QByteArray> lines;
+    const char* line = nullptr;
+    int size = 0;
+    while (reader->nextLine(&line, &size)) {
+        lines.append(QByteArray(line, size));
+    }
+    return lines;
+}
+
+QVector<QByteArray> readFrames(CommandReader* reader) {
+    QVector<QByteArray> payloads;
+    const char* payload = nullptr;
+    int size = 0;
+    while (reader->nextFrame(&payload, &size)) {
+        payloads.append(QByteArray(payload, size));
+    }
+    return payloads;
+}
+
+QByteArray frame(const QByteArray& payload) {
+    QByteArray bytes;
+    bytes.append(static_cast<char>(payload.size() & 0xFF));
+    bytes.append(static_cast<char>(payload.size() >> 8));
+    bytes.append(payload);
+    return bytes;
+}
+
+bool decode(const QByteArray& line, MouseCommand* command) {
+    return TextProtocol::decodeCommand(line.constData(), line.size(), command);
+}
+
+bool decodeBinary(const QByteArray& payload, MouseCommand* command) {
+    return BinaryProtocol::decodeCommand(
+        payload.constData(), payload.size(), command);
+}
+
+QByteArray opcode(Opcode value) {
+    return QByteArray(1, static_cast<char>(value));
+}
+
+QByteArray int32(int value) {
+    quint32 bits = static_cast<quint32>(value);
+    QByteArray bytes;
+    for (int i = 0; i < 4; i += 1) {
+        bytes.append(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+    return bytes;
+}
+
+} // namespace
+
+void CommandReading::linesAreSplit() {
+    CommandReader reader;
+    reader.append(QByteArray("wallFront\nmoveForward 2\n\nwallLeft"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"wallFront", "moveForward 2", ""}));
+    reader.append(QByteArray("\n"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"wallLeft"}));
+}
+
+void CommandReading::linesEndWithCarriageReturns() {
+    CommandReader reader;
+    reader.append(QByteArray("wallFront\r\nwallLeft\r\r\n\r\nturn\rRight\n"));
+    QCOMPARE(
+        readLines(&reader),
+        QVector<QByteArray>({"wallFront", "wallLeft", "", "", "turn", "Right"}));
+
+    // A carriage return at the end of the bytes ends the line right away,
+    // and a newline that arrives next belongs to it, rather than being an
+    // empty line of its own
+    reader.append(QByteArray("wallRight\r"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"wallRight"}));
+    reader.append(QByteArray("\n"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>());
+    reader.append(QByteArray("\nwallBack\r"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"", "wallBack"}));
+    reader.append(QByteArray("moveForward\n"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"moveForward"}));
+
+    // Many lines that end with lone carriage returns, before any newline
+    QByteArray bytes;
+    QVector<QByteArray> expected;
+    for (int i = 0; i < 100; i += 1) {
+        expected.append(QByteArray::number(i));
+        bytes += expected.last() + "\r";
+    }
+    reader.append(bytes + "last\n");
+    expected.append("last");
+    QCOMPARE(readLines(&reader), expected);
+}
+
+void CommandReading::linesSpanAppends() {
+    CommandReader reader;
+    reader.append(QByteArray("setTile"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>());
+    reader.append(QByteArray("Color 1 2"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>());
+    reader.append(QByteArray(" G\nwall"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"setTileColor 1 2 G"}));
+    reader.append(QByteArray("Front\nwallLeft\n"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"wallFront", "wallLeft"}));
+}
+
+void CommandReading::linesArriveOneByteAtATime() {
+    QByteArray bytes("setTileText 0 0 abc\r\nwallFront\n\nturnLeft\rmoveForward\n");
+    CommandReader reader;
+    QVector<QByteArray> lines;
+    for (int i = 0; i < bytes.size(); i += 1) {
+        reader.append(bytes.constData() + i, 1);
+        lines += readLines(&reader);
+    }
+    QCOMPARE(
+        lines,
+        QVector<QByteArray>(
+            {"setTileText 0 0 abc", "wallFront", "", "turnLeft", "moveForward"}));
+}
+
+void CommandReading::consumedBytesAreDiscarded() {
+
+    // The partial line after the consumed ones has already been scanned, so
+    // after they're discarded, scanning must resume where it left off (and
+    // not past the end of the new bytes, nor before the line's start)
+    CommandReader reader;
+    reader.append(QByteArray("a\nbb\nccc"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"a", "bb"}));
+    reader.append(QByteArray("c\ndd"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"cccc"}));
+    reader.append(QByteArray("d"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>());
+    reader.append(QByteArray("\n"));
+    QCOMPARE(readLines(&reader), QVector<QByteArray>({"ddd"}));
+
+    // Many more bytes than the initial capacity, consumed as they go
+    QByteArray line(1000, 'x');
+    for (int i = 0; i < 100; i += 1) {
+        reader.append(line);
+        reader.append(QByteArray("\n"));
+        QCOMPARE(readLines(&reader), QVector<QByteArray>({line}));
+    }
+}
+
+void CommandReading::framesSpanAppends() {
+    QVector<QByteArray> payloads = {
+        QByteArray(1, '\x17'),
+        QByteArray("\x21\n\r\n", 4),
+        QByteArray(300, '\x0a'),
+        QByteArray(),
+    };
+    QByteArray bytes;
+    for (const QByteArray& payload : payloads) {
+        bytes += frame(payload);
+    }
+    for (int chunk = 1; chunk <= 5; chunk += 1) {
+        CommandReader reader;
+        QVector<QByteArray> actual;
+        for (int i = 0; i < bytes.size(); i += chunk) {
+            reader.append(bytes.constData() + i, qMin(chunk, bytes.size() - i));
+            actual += readFrames(&reader);
+        }
+        QCOMPARE(actual, payloads);
+    }
+}
+
+void CommandReading::linesThenFrames() {
+
+    // The binary frames follow the line that asks for them in the same
+    // buffer, and their payloads contain newlines, which aren't lines
+    QByteArray first = QByteArray("\x3d\n\n", 3);
+    QByteArray second = QByteArray("\x3e\r\n", 3);
+    QByteArray bytes = "useBinaryProtocol\n" + frame(first) + frame(second);
+
+    CommandReader reader;
+    reader.append(bytes.left(bytes.size() - 2));
+    const char* line = nullptr;
+    int size = 0;
+    QVERIFY(reader.nextLine(&line, &size));
+    QCOMPARE(QByteArray(line, size), QByteArray("useBinaryProtocol"));
+    QCOMPARE(readFrames(&reader), QVector<QByteArray>({first}));
+    reader.append(bytes.right(2));
+    QCOMPARE(readFrames(&reader), QVector<QByteArray>({second}));
+
+    // The line that asks for frames may end with a carriage return and a
+    // newline that arrive separately, and the newline isn't part of a frame
+    CommandReader split;
+    split.append(QByteArray("useBinaryProtocol\r"));
+    QCOMPARE(readLines(&split), QVector<QByteArray>({"useBinaryProtocol"}));
+    split.append("\n" + frame(first));
+    QCOMPARE(readFrames(&split), QVector<QByteArray>({first}));
+}
+
+void CommandReading::textCommandsAreDecoded() {
+    MouseCommand command;
+
+    QVERIFY(decode("setTileColor 1 2 G", &command));
+    QCOMPARE(command.opcode, Opcode::SET_TILE_COLOR);
+    QCOMPARE(command.numArguments, 3);
+    QCOMPARE(command.arguments[0].integer, 1);
+    QCOMPARE(command.arguments[1].integer, 2);
+    QCOMPARE(command.arguments[2].character, 'G');
+
+    // Runs of spaces separate tokens just like single ones
+    QVERIFY(decode("  setTileColor  -3 4   R  ", &command));
+    QCOMPARE(command.numArguments, 3);
+    QCOMPARE(command.arguments[0].integer, -3);
+    QCOMPARE(command.arguments[2].character, 'R');
+
+    // Optional arguments may be omitted
+    QVERIFY(decode("setTileText 0 0", &command));
+    QCOMPARE(command.opcode, Opcode::SET_TILE_TEXT);
+    QCOMPARE(command.numArguments, 2);
+    QVERIFY(decode("setTileText 0 0 abc", &command));
+    QCOMPARE(command.numArguments, 3);
+    QCOMPARE(command.arguments[2].string, QString("abc"));
+
+    QVERIFY(decode("setWheelSpeedFraction 0.25", &command));
+    QCOMPARE(command.arguments[0].real, 0.25);
+    QVERIFY(decode("updateAllowOmniscience true", &command));
+    QCOMPARE(command.arguments[0].boolean, true);
+    QVERIFY(decode("wallFront", &command));
+    QCOMPARE(command.opcode, Opcode::WALL_FRONT);
+    QCOMPARE(command.numArguments, 0);
+
+    // Tokens after the arguments are ignored, as they always have been
+    QVERIFY(decode("setTileText 0 0 a b", &command));
+    QCOMPARE(command.numArguments, 3);
+    QCOMPARE(command.arguments[2].string, QString("a"));
+    QVERIFY(decode("setTileColor 1 2 G extra", &command));
+    QCOMPARE(command.arguments[2].character, 'G');
+    QVERIFY(decode("wallFront 1", &command));
+    QCOMPARE(command.opcode, Opcode::WALL_FRONT);
+    QCOMPARE(command.numArguments, 0);
+}
+
+void CommandReading::stringsAreUtf8InBothProtocols() {
+    MouseCommand command;
+    QByteArray text("caf\xc3\xa9");
+
+    QVERIFY(decode("setTileText 0 0 " + text, &command));
+    QCOMPARE(command.arguments[2].string, QString::fromUtf8(text));
+
+    QByteArray payload = opcode(Opcode::SET_TILE_TEXT) + int32(0) + int32(0) +
+        QByteArray(1, static_cast<char>(text.size())) + text;
+    QVERIFY(decodeBinary(payload, &command));
+    QCOMPARE(command.arguments[2].string, QString::fromUtf8(text));
+}
+
+void CommandReading::textIntegersRejectOverflow_data() {
+    QTest::addColumn<QByteArray>("token");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("value");
+    QTest::newRow("zero") << QByteArray("0") << true << 0;
+    QTest::newRow("plus") << QByteArray("+5") << true << 5;
+    QTest::newRow("leading zeros") << QByteArray("-007") << true << -7;
+    QTest::newRow("max") << QByteArray("2147483647") << true
+        << std::numeric_limits<int>::max();
+    QTest::newRow("min") << QByteArray("-2147483648") << true
+        << std::numeric_limits<int>::min();
+    QTest::newRow("max + 1") << QByteArray("2147483648") << false << 0;
+    QTest::newRow("min - 1") << QByteArray("-2147483649") << false << 0;
+    QTest::newRow("huge") << QByteArray("99999999999999999999999") << false << 0;
+    QTest::newRow("sign only") << QByteArray("-") << false << 0;
+    QTest::newRow("trailing garbage") << QByteArray("12a") << false << 0;
+    QTest::newRow("double") << QByteArray("1.0") << false << 0;
+}
+
+void CommandReading::textIntegersRejectOverflow() {
+    QFETCH(QByteArray, token);
+    QFETCH(bool, valid);
+    QFETCH(int, value);
+    MouseCommand command;
+    QCOMPARE(decode("moveForward " + token, &command), valid);
+    if (valid) {
+        QCOMPARE(command.numArguments, 1);
+        QCOMPARE(command.arguments[0].integer, value);
+    }
+}
+
+void CommandReading::textArgumentsMustMatchSchema() {
+    MouseCommand command;
+    for (const char* line : {
+            "",
+            "   ",
+            "bogus",
+            "WallFront",
+            "setTileColor 1 2",
+            "setTileColor 1 2 GG",
+            "setTileColor a 2 G",
+            "setWheelSpeedFraction fast",
+            "updateAllowOmniscience maybe",
+            "updateAllowOmniscience True"}) {
+        QVERIFY2(!decode(QByteArray(line), &command), line);
+    }
+}
+
+void CommandReading::textRecordsAreDecoded() {
+    MouseCommand command;
+
+    QVERIFY(decode("setTileColors 0 1 R 2 3 G", &command));
+    QCOMPARE(command.opcode, Opcode::SET_TILE_COLORS);
+    QCOMPARE(command.numArguments, 0);
+    QCOMPARE(command.numRecords, 2);
+    QCOMPARE(command.recordValue(0)->integer, 0);
+    QCOMPARE(command.recordValue(1)->integer, 1);
+    QCOMPARE(command.recordValue(2)->character, 'R');
+    QCOMPARE(command.recordValue(3)->integer, 2);
+    QCOMPARE(command.recordValue(4)->integer, 3);
+    QCOMPARE(command.recordValue(5)->character, 'G');
+
+    // No records at all is fine, and the count doesn't leak from before
+    QVERIFY(decode("setTileColors", &command));
+    QCOMPARE(command.numRecords, 0);
+
+    QVERIFY(decode("declareTileDistances 4 -1 7", &command));
+    QCOMPARE(command.numRecords, 3);
+    QCOMPARE(command.recordValue(1)->integer, -1);
+}
+
+void CommandReading::textRecordsMustBeComplete() {
+    MouseCommand command;
+    for (const char* line : {
+            "setTileColors 0 1 R 2 3",
+            "setTileColors 0 1 R 2",
+            "setTileColors 0",
+            "setTileColors 0 1 RR",
+            "setTileFogginesses 0 1 true 2 3 yes",
+            "declareWalls 0 0 n true 1 1 e",
+            "declareTileDistances 1 2 x"}) {
+        QVERIFY2(!decode(QByteArray(line), &command), line);
+    }
+}
+
+void CommandReading::binaryRecordsAreDecoded() {
+    MouseCommand command;
+
+    QByteArray payload = opcode(Opcode::SET_TILE_COLORS) +
+        int32(0) + int32(1) + "R" + int32(-2) + int32(3) + "G";
+    QVERIFY(decodeBinary(payload, &command));
+    QCOMPARE(command.opcode, Opcode::SET_TILE_COLORS);
+    QCOMPARE(command.numRecords, 2);
+    QCOMPARE(command.recordValue(2)->character, 'R');
+    QCOMPARE(command.recordValue(3)->integer, -2);
+    QCOMPARE(command.recordValue(5)->character, 'G');
+
+    QVERIFY(decodeBinary(opcode(Opcode::DECLARE_TILE_DISTANCES), &command));
+    QCOMPARE(command.numRecords, 0);
+}
+
+void CommandReading::binaryRecordsMustBeComplete() {
+    MouseCommand command;
+
+    // Every truncation of a valid command, except at a record boundary, must
+    // be rejected, including those in the middle of a value
+    QByteArray payload = opcode(Opcode::DECLARE_WALLS) +
+        int32(0) + int32(0) + "n" + QByteArray(1, '\x01') +
+        int32(1) + int32(1) + "e" + QByteArray(1, '\x00');
+    int recordSize = 4 + 4 + 1 + 1;
+    QVERIFY(decodeBinary(payload, &command));
+    QCOMPARE(command.numRecords, 2);
+    for (int size = 1; size < payload.size(); size += 1) {
+        bool boundary = (size - 1) % recordSize == 0;
+        QCOMPARE(decodeBinary(payload.left(size), &command), boundary);
+        if (boundary) {
+            QCOMPARE(command.numRecords, (size - 1) / recordSize);
+        }
+    }
+
+    // A record's bool must be a bool
+    payload[payload.size() - 1] = 2;
+    QVERIFY(!decodeBinary(payload, &command));
+}
+
+QTEST_GUILESS_MAIN(CommandReading)
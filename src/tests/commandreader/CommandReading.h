@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QtTest/QtTest>
+
+class CommandReading: public QObject {
+
+    Q_OBJECT
+
+private slots:
+
+    // Lines end with a newline, a carriage return and newline, or a lone
+    // carriage return, and exclude it, no matter how the bytes arrive
+    void linesAreSplit();
+    void linesEndWithCarriageReturns();
+    void linesSpanAppends();
+    void linesArriveOneByteAtATime();
+
+    // Consumed bytes are discarded by the next append, which must not lose
+    // (or rescan past) the bytes that haven't been consumed yet
+    void consumedBytesAreDiscarded();
+
+    // Frames may be split anywhere, including in their headers, and an
+    // algorithm may switch from lines to frames in the middle of a buffer
+    void framesSpanAppends();
+    void linesThenFrames();
+
+    // The text protocol's parsing of arguments
+    void textCommandsAreDecoded();
+    void textIntegersRejectOverflow_data();
+    void textIntegersRejectOverflow();
+    void textArgumentsMustMatchSchema();
+
+    // The same command decodes to the same string in either protocol
+    void stringsAreUtf8InBothProtocols();
+
+    // Records follow the arguments, and a partial record (at the end of a
+    // command) is rejected by both protocols rather than silently dropped
+    void textRecordsAreDecoded();
+    void textRecordsMustBeComplete();
+    void binaryRecordsAreDecoded();
+    void binaryRecordsMustBeComplete();
+
+};
@@ -0,0 +1,88 @@
+#include "CommandLookup.h"
+
+#include <QByteArray>
+#include <QMapIterator>
+
+#include "CommandTable.h"
+#include "Opcode.h"
+
+using namespace mms;
+
+namespace {
+
+const CommandEntry* get(const QByteArray& name) {
+    return CommandTable::get(name.constData(), name.size());
+}
+
+// The entry that a name must be looked up as, which is nullptr unless the
+// name is actually that of some command
+const CommandEntry* expected(const QByteArray& name) {
+    QString string = QString::fromLatin1(name);
+    if (!STRING_TO_OPCODE().contains(string)) {
+        return nullptr;
+    }
+    return CommandTable::get(STRING_TO_OPCODE().value(string));
+}
+
+} // namespace
+
+void CommandLookup::namesAndOpcodesRoundTrip() {
+    QMapIterator<Opcode, QString> iterator(OPCODE_TO_STRING());
+    while (iterator.hasNext()) {
+        auto pair = iterator.next();
+        const CommandEntry* byOpcode = CommandTable::get(pair.key());
+        QVERIFY2(byOpcode != nullptr, qPrintable(pair.value()));
+        QCOMPARE(byOpcode->opcode, pair.key());
+        QCOMPARE(byOpcode->name, pair.value().toLatin1());
+        QCOMPARE(CommandTable::get(static_cast<quint8>(pair.key())), byOpcode);
+        QCOMPARE(get(pair.value().toLatin1()), byOpcode);
+    }
+}
+
+void CommandLookup::namesAreLookedUpByLength() {
+    QMapIterator<Opcode, QString> iterator(OPCODE_TO_STRING());
+    while (iterator.hasNext()) {
+        auto pair = iterator.next();
+        QByteArray name = pair.value().toLatin1();
+        QByteArray line = name + " 1 2 3\n";
+        QCOMPARE(
+            CommandTable::get(line.constData(), name.size()),
+            CommandTable::get(pair.key()));
+    }
+}
+
+void CommandLookup::unknownNamesAreRejected() {
+    for (const char* name : {"", " ", "foo", "wallfront", "WALLFRONT", "!"}) {
+        QCOMPARE(get(QByteArray(name)), static_cast<const CommandEntry*>(nullptr));
+    }
+    QMapIterator<Opcode, QString> iterator(OPCODE_TO_STRING());
+    while (iterator.hasNext()) {
+        QByteArray name = iterator.next().value().toLatin1();
+        QVector<QByteArray> nearMisses = {
+            name.left(name.size() - 1),
+            name.left(1),
+            name + "x",
+            name + " ",
+            " " + name,
+            name.toUpper(),
+        };
+        for (int i = 0; i < name.size(); i += 1) {
+            QByteArray changed = name;
+            changed[i] = changed.at(i) ^ 0x01;
+            nearMisses.append(changed);
+        }
+        for (const QByteArray& nearMiss : nearMisses) {
+            QVERIFY2(get(nearMiss) == expected(nearMiss), nearMiss.constData());
+        }
+    }
+}
+
+void CommandLookup::unknownOpcodesAreRejected() {
+    for (int opcode = 0; opcode < 256; opcode += 1) {
+        bool known = OPCODE_TO_STRING().contains(static_cast<Opcode>(opcode));
+        const CommandEntry* entry = CommandTable::get(static_cast<quint8>(opcode));
+        QCOMPARE(entry != nullptr, known);
+    }
+}
+
+QTEST_GUILESS_MAIN(CommandLookup)
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QtTest/QtTest>
+
+class CommandLookup: public QObject {
+
+    Q_OBJECT
+
+private slots:
+
+    // Every command can be looked up by its name and by its opcode, and
+    // both lookups give the same entry
+    void namesAndOpcodesRoundTrip();
+
+    // Names are looked up by their given length only, so that they can be
+    // looked up in place, in the middle of a line
+    void namesAreLookedUpByLength();
+
+    // Anything else, including names that differ from a command's by a
+    // single character, isn't a command
+    void unknownNamesAreRejected();
+    void unknownOpcodesAreRejected();
+
+};
@@ -0,0 +1,236 @@
+#include "ConeArea.h"
+
+#include <QDir>
+#include <QtMath>
+
+#include <algorithm>
+#include <random>
+
+#include "units/Quantity.h"
+
+#include "Direction.h"
+#include "GeometryUtilities.h"
+#include "Param.h"
+
+using namespace mms;
+
+namespace {
+
+// A sensor's view cone
+struct Cone {
+    units::Vector apex;
+    units::Angle direction;
+    units::Angle halfWidth;
+    units::Length range;
+};
+
+units::Length halfWallWidth() {
+    return units::Length(P()->wallWidth() / 2.0);
+}
+
+units::Length tileLength() {
+    return units::Length(P()->wallLength() + P()->wallWidth());
+}
+
+double exactArea(const Cone& cone, const Maze& maze) {
+    return GeometryUtilities::getVisibleConeArea(
+        cone.apex, cone.direction, cone.halfWidth, cone.range, maze,
+        halfWallWidth(), tileLength()).value();
+}
+
+// The area of the fan of triangles between the ends of numRays rays, evenly
+// spaced across the cone, i.e., what the RAYS model computes with
+// numberOfSensorEdgePoints == numRays
+double raysArea(const Cone& cone, const Maze& maze, int numRays) {
+    double area = 0.0;
+    units::Vector previous;
+    for (int i = 0; i < numRays; i += 1) {
+        units::Angle angle =
+            cone.direction + cone.halfWidth * (2.0 * i / (numRays - 1) - 1.0);
+        units::Vector end = GeometryUtilities::castRay(
+            cone.apex,
+            cone.apex + units::Vector::fromPolar(cone.range, angle),
+            maze,
+            halfWallWidth(),
+            tileLength()) - cone.apex;
+        if (0 < i) {
+            area += previous.cross(end).value() / 2.0;
+        }
+        previous = end;
+    }
+    return area;
+}
+
+// The center of tile (x, y)
+units::Vector tileCenter(int x, int y) {
+    return units::Vector(tileLength() * (x + 0.5), tileLength() * (y + 0.5));
+}
+
+} // namespace
+
+void ConeArea::initTestCase() {
+    QDir dir(QFINDTESTDATA("../../../res/maze"));
+    QVERIFY(dir.exists());
+    for (const QString& name : dir.entryList({"*.num"}, QDir::Files, QDir::Name)) {
+        Maze* maze = Maze::fromFile(dir.filePath(name));
+        QVERIFY2(maze != nullptr, qPrintable(name));
+        m_mazes.append(maze);
+    }
+    QVERIFY(!m_mazes.isEmpty());
+}
+
+void ConeArea::cleanupTestCase() {
+    qDeleteAll(m_mazes);
+}
+
+void ConeArea::matchesManyRays_data() {
+    QTest::addColumn<int>("index");
+    QDir dir(QFINDTESTDATA("../../../res/maze"));
+    QStringList names = dir.entryList({"*.num"}, QDir::Files, QDir::Name);
+    for (int i = 0; i < names.size(); i += 1) {
+        QTest::newRow(qPrintable(names.at(i))) << i;
+    }
+}
+
+void ConeArea::matchesManyRays() {
+    QFETCH(int, index);
+    const Maze& maze = *m_mazes.at(index);
+
+    // Cones from random points within the tiles, of every width up to a full
+    // circle, and of ranges that reach a few tiles away; the seed is fixed
+    // so that runs are comparable
+    std::mt19937 generator(index);
+    std::uniform_int_distribution<int> xs(0, maze.getWidth() - 1);
+    std::uniform_int_distribution<int> ys(0, maze.getHeight() - 1);
+    double h = halfWallWidth().value();
+    double t = tileLength().value();
+    std::uniform_real_distribution<double> offsets(h + 0.001, t - h - 0.001);
+    std::uniform_real_distribution<double> directions(0.0, 2 * M_PI);
+    std::uniform_real_distribution<double> halfWidths(0.01, M_PI);
+    std::uniform_real_distribution<double> ranges(0.01, 3 * t);
+
+    const int numRays = 20000;
+    for (int i = 0; i < 20; i += 1) {
+        int x = xs(generator);
+        int y = ys(generator);
+        Cone cone = {
+            units::Vector(
+                units::Length(x * t + offsets(generator)),
+                units::Length(y * t + offsets(generator))),
+            units::Angle(directions(generator)),
+            units::Angle(halfWidths(generator)),
+            units::Length(ranges(generator)),
+        };
+
+        // Where the nearest obstacle is the same for adjacent rays, the area
+        // between them is exact (or, where neither hits anything, off by a
+        // negligible sliver of the range circle). Where it changes, the area
+        // between them may be entirely wrong, but that's at most the sector
+        // between them, and only a handful of such changes are ever close
+        // enough to the ends of the faces for that to matter.
+        double r = cone.range.value();
+        double spacing = 2 * cone.halfWidth.value() / (numRays - 1);
+        double tolerance = 10 * r * r * spacing / 2.0;
+
+        double expected = raysArea(cone, maze, numRays);
+        double actual = exactArea(cone, maze);
+        QString message = QString("cone %1: %2 vs %3").arg(i).arg(actual).arg(expected);
+        QVERIFY2(std::abs(actual - expected) <= tolerance, qPrintable(message));
+        QVERIFY(actual <= r * r * cone.halfWidth.value() * (1 + 1e-12));
+    }
+}
+
+void ConeArea::openConeIsFullyVisible() {
+
+    // Nothing is closer to the center of a tile than its walls, so a cone
+    // that doesn't reach them sees all of its area, i.e., reads 0
+    const Maze& maze = *m_mazes.first();
+    double clearance = tileLength().value() / 2.0 - halfWallWidth().value();
+    for (double halfWidth : {0.01, 0.3, M_PI / 2.0, 2.0, M_PI}) {
+        for (double direction : {0.0, 0.5, M_PI / 2.0, 4.0, 1.5 * M_PI, 6.0}) {
+            Cone cone = {
+                tileCenter(0, 0),
+                units::Angle(direction),
+                units::Angle(halfWidth),
+                units::Length(0.99 * clearance),
+            };
+            double viewArea = std::pow(cone.range.value(), 2) * halfWidth;
+            QCOMPARE(exactArea(cone, maze), viewArea);
+        }
+    }
+}
+
+void ConeArea::wallStraightAhead_data() {
+    QTest::addColumn<double>("halfWidth");
+    QTest::addColumn<double>("rangeOverDistance");
+    for (double halfWidth : {0.1, M_PI / 6.0, M_PI / 4.0}) {
+        for (double rangeOverDistance : {0.5, 1.02, 1.2, 2.0}) {
+            QByteArray name = QByteArray::number(halfWidth) + " radians, " +
+                QByteArray::number(rangeOverDistance) + " times as far";
+            QTest::newRow(name.constData()) << halfWidth << rangeOverDistance;
+        }
+    }
+}
+
+void ConeArea::wallStraightAhead() {
+    QFETCH(double, halfWidth);
+    QFETCH(double, rangeOverDistance);
+
+    // A cone from the center of a tile in the top row, pointing north at the
+    // outer wall, which is at a distance d. Since the cone is no wider than a
+    // right angle, it can't reach the tile's other walls, so the rays within
+    // beta of north, where cos(beta) == d / r, hit the wall, and the others
+    // reach their full range. Thus, the visible area is the triangle between
+    // the apex and the wall, and the sectors on either side of it.
+    const Maze& maze = *m_mazes.first();
+    int y = maze.getHeight() - 1;
+    QVERIFY(maze.getTile(0, y)->isWall(Direction::NORTH));
+    double d = tileLength().value() / 2.0 - halfWallWidth().value();
+    double r = rangeOverDistance * d;
+    double beta = (r <= d ? 0.0 : std::min(halfWidth, std::acos(d / r)));
+    double expected = d * d * std::tan(beta) + r * r * (halfWidth - beta);
+
+    Cone cone = {
+        tileCenter(0, y),
+        units::Angle(M_PI / 2.0),
+        units::Angle(halfWidth),
+        units::Length(r),
+    };
+    QCOMPARE(exactArea(cone, maze), expected);
+}
+
+void ConeArea::blockedApexSeesNothing() {
+    const Maze& maze = *m_mazes.first();
+    double t = tileLength().value();
+    Cone cone = {
+        units::Vector(),
+        units::Angle(1.0),
+        units::Angle(M_PI / 4.0),
+        units::Length(t),
+    };
+
+    // Inside the post at the corner of the first four tiles
+    cone.apex = units::Vector(units::Length(t), units::Length(t));
+    QCOMPARE(exactArea(cone, maze), 0.0);
+
+    // Inside the outer wall, to the west of the first tile
+    cone.apex = units::Vector(units::Length(0.0), units::Length(t / 2.0));
+    QCOMPARE(exactArea(cone, maze), 0.0);
+}
+
+void ConeArea::benchmark() {
+    const Maze& maze = *m_mazes.first();
+    Cone cone = {
+        tileCenter(0, 0),
+        units::Angle(M_PI / 4.0),
+        units::Angle(M_PI / 8.0),
+        units::Length(2 * tileLength().value()),
+    };
+    double sum = 0.0;
+    QBENCHMARK {
+        sum += exactArea(cone, maze);
+    }
+    QVERIFY(0.0 < sum);
+}
+
+QTEST_GUILESS_MAIN(ConeArea)
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QVector>
+#include <QtTest/QtTest>
+
+#include "Maze.h"
+
+class ConeArea: public QObject {
+
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    // The exact area must agree with the area of the view sampled by very
+    // many rays (i.e., the RAYS model, in the limit), wherever the cone is
+    void matchesManyRays_data();
+    void matchesManyRays();
+
+    // Cases whose areas can be worked out by hand
+    void openConeIsFullyVisible();
+    void wallStraightAhead_data();
+    void wallStraightAhead();
+    void blockedApexSeesNothing();
+
+    // The cost of computing the area of a typical cone
+    void benchmark();
+
+private:
+
+    // Every .num maze
+    QVector<mms::Maze*> m_mazes;
+
+};
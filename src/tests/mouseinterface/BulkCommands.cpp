@@ -0,0 +1,301 @@
+#include "BulkCommands.h"
+
+#include <QMutexLocker>
+#include <QRegularExpression>
+
+#include "Color.h"
+#include "Direction.h"
+#include "Opcode.h"
+#include "Param.h"
+
+using namespace mms;
+
+void BulkCommands::initTestCase() {
+    m_maze = Maze::fromFile(QFINDTESTDATA("../../../res/maze/apec2002.num"));
+    QVERIFY(m_maze != nullptr);
+    QCOMPARE(m_maze->getWidth(), 16);
+    QCOMPARE(m_maze->getHeight(), 16);
+}
+
+void BulkCommands::cleanupTestCase() {
+    delete m_maze;
+}
+
+void BulkCommands::init() {
+    m_mouse = new Mouse(m_maze);
+    m_view = new MazeView(m_maze, false, true, true, true, false);
+    m_model = new Model();
+    m_interface = new MouseInterface(m_maze, m_mouse, m_view, m_model);
+}
+
+void BulkCommands::cleanup() {
+    delete m_interface;
+    delete m_model;
+    delete m_view;
+    delete m_mouse;
+}
+
+void BulkCommands::fillsWithinMazeAreApplied_data() {
+    QTest::addColumn<int>("x");
+    QTest::addColumn<int>("y");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::newRow("whole maze") << 0 << 0 << 16 << 16;
+    QTest::newRow("lower left tile") << 0 << 0 << 1 << 1;
+    QTest::newRow("upper right tile") << 15 << 15 << 1 << 1;
+    QTest::newRow("inside") << 3 << 4 << 2 << 5;
+    QTest::newRow("column") << 7 << 0 << 1 << 16;
+    QTest::newRow("row") << 0 << 9 << 16 << 1;
+}
+
+void BulkCommands::fillsWithinMazeAreApplied() {
+    QFETCH(int, x);
+    QFETCH(int, y);
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QString region = QString("%1 %2 %3 %4").arg(x).arg(y).arg(width).arg(height);
+    for (const char* format : {
+            "fillTileColor %1 R\n",
+            "fillTileText %1 abc\n",
+            "fillTileFogginess %1 false\n"}) {
+        QCOMPARE(run(QString(format).arg(region).toLatin1()), QByteArray());
+        QVERIFY(m_view->isDirty());
+    }
+
+    // Every tile of the region is set, and every other tile (including those
+    // just past each edge of the region) is untouched
+    for (int i = 0; i < m_maze->getWidth(); i += 1) {
+        for (int j = 0; j < m_maze->getHeight(); j += 1) {
+            bool inside = x <= i && i < x + width && y <= j && j < y + height;
+            if (inside) {
+                QCOMPARE(tile(i, j).getColor(), CHAR_TO_COLOR().value('R'));
+                QCOMPARE(tile(i, j).getText(), QString("abc"));
+                QCOMPARE(tile(i, j).isFoggy(), false);
+            }
+            else {
+                QVERIFY2(isUntouched(i, j), qPrintable(
+                    QString("(%1, %2)").arg(i).arg(j)));
+            }
+        }
+    }
+}
+
+void BulkCommands::fillsOutsideMazeAreRejected_data() {
+    QTest::addColumn<QByteArray>("region");
+    QTest::newRow("negative width") << QByteArray("0 0 -1 1");
+    QTest::newRow("negative height") << QByteArray("0 0 1 -1");
+    QTest::newRow("negative x") << QByteArray("-1 0 2 2");
+    QTest::newRow("negative y") << QByteArray("0 -1 2 2");
+    QTest::newRow("past the right") << QByteArray("15 0 2 1");
+    QTest::newRow("past the top") << QByteArray("0 15 1 2");
+    QTest::newRow("outside") << QByteArray("16 16 1 1");
+    QTest::newRow("overflowing width") << QByteArray("1 0 2147483647 1");
+    QTest::newRow("overflowing height") << QByteArray("0 1 1 2147483647");
+    QTest::newRow("both negative") << QByteArray("5 5 -3 -3");
+}
+
+void BulkCommands::fillsOutsideMazeAreRejected() {
+    QFETCH(QByteArray, region);
+    for (const char* format : {
+            "fillTileColor %1 R\n",
+            "fillTileText %1 abc\n",
+            "fillTileFogginess %1 false\n"}) {
+        QByteArray line = QString(format).arg(QString::fromLatin1(region)).toLatin1();
+        QTest::ignoreMessage(
+            QtWarningMsg, QRegularExpression("is not within the maze"));
+        QCOMPARE(run(line), QByteArray());
+        QVERIFY2(!m_view->isDirty(), line.constData());
+    }
+}
+
+void BulkCommands::emptyFillsDoNothing() {
+    QCOMPARE(run("fillTileColor 3 3 0 5 R\n"), QByteArray());
+    QVERIFY(!m_view->isDirty());
+    QCOMPARE(run("fillTileText 3 3 5 0 abc\n"), QByteArray());
+    QVERIFY(!m_view->isDirty());
+    QCOMPARE(run("fillTileFogginess 16 16 0 0 false\n"), QByteArray());
+    QVERIFY(!m_view->isDirty());
+}
+
+void BulkCommands::listsApplyEveryRecord() {
+
+    // The first record for (1, 1) is overridden by the last, and the record
+    // for (16, 0) is skipped
+    QTest::ignoreMessage(
+        QtWarningMsg, QRegularExpression("^There is no tile at position \\(16, 0\\)"));
+    QCOMPARE(
+        run("setTileColors 0 0 R 1 1 G 16 0 B 15 15 Y 1 1 O\n"),
+        QByteArray());
+    QCOMPARE(tile(0, 0).getColor(), CHAR_TO_COLOR().value('R'));
+    QCOMPARE(tile(15, 15).getColor(), CHAR_TO_COLOR().value('Y'));
+    QCOMPARE(tile(1, 1).getColor(), CHAR_TO_COLOR().value('O'));
+    QVERIFY(isUntouched(0, 1));
+    QVERIFY(isUntouched(1, 0));
+    QVERIFY(isUntouched(15, 14));
+
+    QCOMPARE(run("setTileTexts 0 0 abc 15 0 d 2 3 ef\n"), QByteArray());
+    QCOMPARE(tile(0, 0).getText(), QString("abc"));
+    QCOMPARE(tile(15, 0).getText(), QString("d"));
+    QCOMPARE(tile(2, 3).getText(), QString("ef"));
+    QVERIFY(isUntouched(2, 2));
+
+    QCOMPARE(
+        run("setTileFogginesses 0 0 false 0 15 false 0 15 true 4 4 false\n"),
+        QByteArray());
+    QCOMPARE(tile(0, 0).isFoggy(), false);
+    QCOMPARE(tile(0, 15).isFoggy(), true);
+    QCOMPARE(tile(4, 4).isFoggy(), false);
+    QCOMPARE(tile(4, 5).isFoggy(), true);
+}
+
+void BulkCommands::wallsApplyEveryRecord() {
+    QCOMPARE(
+        run("declareWalls 0 0 n true 3 3 e false 15 15 s true 0 0 w true\n"),
+        QByteArray());
+
+    // Both halves of each wall are declared, except on the edge of the maze
+    QMap<Direction, bool> expected[16][16];
+    expected[0][0] = {{Direction::NORTH, true}, {Direction::WEST, true}};
+    expected[0][1] = {{Direction::SOUTH, true}};
+    expected[3][3] = {{Direction::EAST, false}};
+    expected[4][3] = {{Direction::WEST, false}};
+    expected[15][15] = {{Direction::SOUTH, true}};
+    expected[15][14] = {{Direction::NORTH, true}};
+    for (int x = 0; x < 16; x += 1) {
+        for (int y = 0; y < 16; y += 1) {
+            QVERIFY2(
+                tile(x, y).getDeclaredWalls() == expected[x][y],
+                qPrintable(QString("(%1, %2)").arg(x).arg(y)));
+        }
+    }
+}
+
+void BulkCommands::clearAllClearsEveryTile() {
+    QCOMPARE(
+        run("setTileColor 2 3 R\n"
+            "setTileColors 9 9 G\n"
+            "fillTileColor 5 5 2 2 B\n"
+            "setTileText 2 3 abc\n"
+            "setTileTexts 9 9 d\n"
+            "fillTileText 5 5 2 2 ef\n"
+            "clearAllTileColor\n"
+            "clearAllTileText\n"),
+        QByteArray());
+    for (int x = 0; x < m_maze->getWidth(); x += 1) {
+        for (int y = 0; y < m_maze->getHeight(); y += 1) {
+            QVERIFY2(isUntouched(x, y), qPrintable(
+                QString("(%1, %2)").arg(x).arg(y)));
+        }
+    }
+}
+
+void BulkCommands::tileDistancesMustCoverMaze_data() {
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("valid");
+    QTest::newRow("none") << 0 << false;
+    QTest::newRow("one") << 1 << false;
+    QTest::newRow("one too few") << 255 << false;
+    QTest::newRow("exact") << 256 << true;
+    QTest::newRow("one too many") << 257 << false;
+}
+
+void BulkCommands::tileDistancesMustCoverMaze() {
+    QFETCH(int, count);
+    QFETCH(bool, valid);
+    QByteArray line = "declareTileDistances";
+    for (int i = 0; i < count; i += 1) {
+        line += " " + QByteArray::number(i % 30);
+    }
+    if (!valid) {
+        QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression(
+                QString("^You declared %1 tile distances").arg(count)));
+    }
+    QCOMPARE(run(line + "\n"), QByteArray());
+    QCOMPARE(m_view->isDirty(), valid);
+
+    // The distances are given column by column
+    for (int x = 0; x < m_maze->getWidth(); x += 1) {
+        for (int y = 0; y < m_maze->getHeight(); y += 1) {
+            QCOMPARE(
+                tile(x, y).getText(),
+                valid ? QString::number((x * 16 + y) % 30) : QString());
+        }
+    }
+}
+
+void BulkCommands::partialRecordsAreRejected() {
+    for (const char* line : {
+            "setTileColors 0 0 R 1 1",
+            "setTileTexts 0 0 abc 1",
+            "setTileFogginesses 0 0 false 1 1",
+            "declareWalls 0 0 n true 1 1 e"}) {
+        QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("^Invalid command from the mouse algorithm"));
+        QCOMPARE(run(QByteArray(line) + "\n"), QByteArray());
+        QVERIFY2(!m_view->isDirty(), line);
+    }
+
+    for (int x = 0; x < m_maze->getWidth(); x += 1) {
+        for (int y = 0; y < m_maze->getHeight(); y += 1) {
+            QVERIFY(isUntouched(x, y));
+        }
+    }
+
+    // Whereas the complete records alone are applied
+    QCOMPARE(run("setTileColors 0 0 R 1 1 G\n"), QByteArray());
+    QCOMPARE(tile(0, 0).getColor(), CHAR_TO_COLOR().value('R'));
+    QCOMPARE(tile(1, 1).getColor(), CHAR_TO_COLOR().value('G'));
+}
+
+void BulkCommands::partialBinaryRecordsAreRejected() {
+    QVERIFY(!run("useBinaryProtocol\n").isEmpty());
+
+    // One complete record, (1, 2, 'R'), followed by part of another
+    QByteArray payload(1, static_cast<char>(Opcode::SET_TILE_COLORS));
+    payload += QByteArray("\x01\x00\x00\x00\x02\x00\x00\x00R", 9);
+    payload += QByteArray("\x03\x00\x00\x00", 4);
+    QByteArray frame;
+    frame.append(static_cast<char>(payload.size()));
+    frame.append('\0');
+    frame += payload;
+
+    QTest::ignoreMessage(
+        QtWarningMsg,
+        QRegularExpression("^Invalid binary command from the mouse algorithm"));
+    QCOMPARE(run(frame), QByteArray());
+    QVERIFY(!m_view->isDirty());
+    QVERIFY(isUntouched(1, 2));
+
+    // Without the partial record, the frame is fine
+    payload.chop(4);
+    frame[0] = static_cast<char>(payload.size());
+    frame.chop(4);
+    QCOMPARE(run(frame), QByteArray());
+    QCOMPARE(tile(1, 2).getColor(), CHAR_TO_COLOR().value('R'));
+}
+
+QByteArray BulkCommands::run(const QByteArray& commands) {
+    {
+        QMutexLocker locker(m_view->getMutex());
+        m_view->clearDirtyRanges();
+    }
+    return m_interface->handleStandardError(commands);
+}
+
+const TileGraphic& BulkCommands::tile(int x, int y) {
+    return m_view->getMazeGraphic()->getTileGraphic(x, y);
+}
+
+bool BulkCommands::isUntouched(int x, int y) {
+    return (
+        tile(x, y).getColor() == STRING_TO_COLOR().value(P()->tileBaseColor()) &&
+        tile(x, y).getDeclaredWalls().isEmpty() &&
+        tile(x, y).isFoggy() &&
+        tile(x, y).getText().isEmpty()
+    );
+}
+
+QTEST_GUILESS_MAIN(BulkCommands)
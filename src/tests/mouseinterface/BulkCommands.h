@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QtTest/QtTest>
+
+#include "Maze.h"
+#include "MazeView.h"
+#include "TileGraphic.h"
+#include "Model.h"
+#include "Mouse.h"
+#include "MouseInterface.h"
+
+class BulkCommands: public QObject {
+
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    // The fill commands apply to every tile of a rectangle that's within the
+    // maze, and to nothing at all otherwise
+    void fillsWithinMazeAreApplied_data();
+    void fillsWithinMazeAreApplied();
+    void fillsOutsideMazeAreRejected_data();
+    void fillsOutsideMazeAreRejected();
+    void emptyFillsDoNothing();
+
+    // The list commands apply every valid record, skipping the others
+    void listsApplyEveryRecord();
+    void wallsApplyEveryRecord();
+
+    // The clearAll commands clear every tile that was set, however it was set
+    void clearAllClearsEveryTile();
+
+    // Exactly one distance must be declared for every tile
+    void tileDistancesMustCoverMaze_data();
+    void tileDistancesMustCoverMaze();
+
+    // A command with a partial record is rejected as a whole, in either
+    // protocol, rather than applying the complete records
+    void partialRecordsAreRejected();
+    void partialBinaryRecordsAreRejected();
+
+private:
+
+    mms::Maze* m_maze;
+    mms::Mouse* m_mouse;
+    mms::MazeView* m_view;
+    mms::Model* m_model;
+    mms::MouseInterface* m_interface;
+
+    // Runs the commands, returning the replies, after which the view is dirty
+    // if and only if they changed any tiles
+    QByteArray run(const QByteArray& commands);
+
+    // The state of the tile at (x, y)
+    const mms::TileGraphic& tile(int x, int y);
+
+    // Whether the tile at (x, y) has the state it starts with
+    bool isUntouched(int x, int y);
+
+};
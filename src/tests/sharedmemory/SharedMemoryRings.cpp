@@ -0,0 +1,142 @@
+#include "SharedMemoryRings.h"
+
+#include <atomic>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "../../mouse/templates/c++/SharedMemory.h"
+
+#include "CommandReader.h"
+
+using namespace mms;
+
+namespace {
+
+// The capacity of each ring, and the offsets of the command ring's head and
+// tail (see SharedMemoryTransport.h)
+const int CAPACITY = 1 << 16;
+const int COMMAND_HEAD_OFFSET = 64;
+const int COMMAND_TAIL_OFFSET = 128;
+
+QByteArray frame(const QByteArray& payload) {
+    QByteArray bytes;
+    bytes.append(static_cast<char>(payload.size() & 0xFF));
+    bytes.append(static_cast<char>(payload.size() >> 8));
+    bytes.append(payload);
+    return bytes;
+}
+
+} // namespace
+
+void SharedMemoryRings::init() {
+    m_transport = new SharedMemoryTransport();
+    m_algorithm = new SharedMemory();
+    if (!m_transport->isValid()) {
+        QSKIP("Shared memory isn't supported on this platform");
+    }
+    QVERIFY(m_algorithm->open(m_transport->getName().toLatin1().constData()));
+}
+
+void SharedMemoryRings::cleanup() {
+    delete m_algorithm;
+    delete m_transport;
+}
+
+void SharedMemoryRings::commandsWrapAround() {
+
+    // The frames are written a few at a time, and their sizes don't divide
+    // the capacity, so the wrap lands somewhere different each time around
+    CommandReader reader;
+    const char* payload = nullptr;
+    int size = 0;
+    int total = 0;
+    for (int i = 0; total < 4 * CAPACITY; i += 4) {
+        QVector<QByteArray> payloads;
+        for (int j = 0; j < 1 + i % 3; j += 1) {
+            payloads.append(pattern(i + j, 1 + ((i + j) * 37) % 300));
+            QByteArray bytes = frame(payloads.last());
+            m_algorithm->write(bytes.constData(), bytes.size());
+            total += bytes.size();
+        }
+        QVERIFY(m_transport->waitForCommands(0));
+        m_transport->readCommands(&reader);
+        for (const QByteArray& expected : payloads) {
+            QVERIFY(reader.nextFrame(&payload, &size));
+            QCOMPARE(QByteArray(payload, size), expected);
+        }
+        QVERIFY(!reader.nextFrame(&payload, &size));
+    }
+    QVERIFY(!m_transport->isClosed());
+}
+
+void SharedMemoryRings::repliesWrapAround() {
+    int total = 0;
+    for (int i = 0; total < 4 * CAPACITY; i += 1) {
+        QByteArray expected = pattern(i, 1 + (i * 53) % 700);
+        m_transport->writeReplies(expected);
+        QVERIFY(!m_transport->hasPendingReplies());
+        QByteArray actual(expected.size(), '\0');
+        m_algorithm->read(actual.data(), actual.size());
+        QCOMPARE(actual, expected);
+        total += expected.size();
+    }
+}
+
+void SharedMemoryRings::repliesWaitForSpace() {
+
+    // Only a ring's worth of the replies fits at first
+    QByteArray expected = pattern(0, CAPACITY + 1000);
+    m_transport->writeReplies(expected);
+    QVERIFY(m_transport->hasPendingReplies());
+    m_transport->flushReplies(0);
+    QVERIFY(m_transport->hasPendingReplies());
+
+    // Once the algorithm has read some of them, the rest fit
+    QByteArray actual(expected.size(), '\0');
+    m_algorithm->read(actual.data(), 5000);
+    m_transport->flushReplies(0);
+    QVERIFY(!m_transport->hasPendingReplies());
+    m_algorithm->read(actual.data() + 5000, actual.size() - 5000);
+    QCOMPARE(actual, expected);
+    QVERIFY(!m_transport->isClosed());
+}
+
+void SharedMemoryRings::corruptedHeadClosesTransport() {
+#ifdef Q_OS_UNIX
+    QByteArray name = m_transport->getName().toLatin1();
+    int fd = shm_open(name.constData(), O_RDWR, 0600);
+    QVERIFY(fd != -1);
+    void* memory = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    QVERIFY(memory != MAP_FAILED);
+    char* bytes = static_cast<char*>(memory);
+    std::atomic<quint32>* head =
+        reinterpret_cast<std::atomic<quint32>*>(bytes + COMMAND_HEAD_OFFSET);
+    std::atomic<quint32>* tail =
+        reinterpret_cast<std::atomic<quint32>*>(bytes + COMMAND_TAIL_OFFSET);
+    head->store(tail->load() + CAPACITY + 1);
+    munmap(memory, 4096);
+
+    CommandReader reader;
+    const char* payload = nullptr;
+    int size = 0;
+    QVERIFY(m_transport->waitForCommands(0));
+    m_transport->readCommands(&reader);
+    QVERIFY(m_transport->isClosed());
+    QVERIFY(!reader.nextFrame(&payload, &size));
+#endif
+}
+
+QByteArray SharedMemoryRings::pattern(int index, int size) {
+    QByteArray bytes(size, '\0');
+    for (int i = 0; i < size; i += 1) {
+        bytes[i] = static_cast<char>((index * 31 + i * 7) & 0xFF);
+    }
+    return bytes;
+}
+
+QTEST_GUILESS_MAIN(SharedMemoryRings)
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtTest/QtTest>
+
+#include "SharedMemoryTransport.h"
+
+// The algorithm's end of the transport, from the C++ mouse template
+class SharedMemory;
+
+class SharedMemoryRings: public QObject {
+
+    Q_OBJECT
+
+private slots:
+
+    // Each test gets a fresh segment, opened by both ends
+    void init();
+    void cleanup();
+
+    // Frames must survive the rings' heads and tails wrapping around, no
+    // matter where in a frame the wrap happens
+    void commandsWrapAround();
+    void repliesWrapAround();
+
+    // Replies that don't fit are kept until the algorithm makes space
+    void repliesWaitForSpace();
+
+    // A head that's more than a ring's capacity past its tail can only come
+    // from a corrupted segment, which must be closed rather than read
+    void corruptedHeadClosesTransport();
+
+private:
+
+    mms::SharedMemoryTransport* m_transport;
+    SharedMemory* m_algorithm;
+
+    // A recognizable pattern of bytes, different for each index
+    static QByteArray pattern(int index, int size);
+
+};
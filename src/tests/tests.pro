@@ -1,2 +1,9 @@
 TEMPLATE = subdirs
 SUBDIRS += example
+SUBDIRS += castray
+SUBDIRS += allocations
+SUBDIRS += sharedmemory
+SUBDIRS += commandtable
+SUBDIRS += commandreader
+SUBDIRS += mouseinterface
+SUBDIRS += conearea